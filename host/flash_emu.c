@@ -0,0 +1,873 @@
+/*******************************************************************************
+*   McMaster PRESET (www.mcmasterneudose.ca)
+*
+*   Data Acquisition Module - DAM
+*   Flight Firmware
+*
+*   @file       flash_emu.c
+*   @desc       Host build NOR flash model attached to the XQspiPs stand-in
+*   @author     Sameer Suleman
+*   @date       October 16, 2026
+*
+*******************************************************************************/
+
+/*******************************************************************************
+*   Includes
+*******************************************************************************/
+#define _GNU_SOURCE                 /* memfd_create */
+#include "flash_emu.h"
+
+/* STD Includes */
+#include <fcntl.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+/*******************************************************************************
+*   Constant Definitions
+*******************************************************************************/
+/* Commands understood by the model */
+#define FLASH_EMU_CMD_READ          0x03
+#define FLASH_EMU_CMD_FAST_READ     0x0B
+#define FLASH_EMU_CMD_DUAL_READ     0x3B
+#define FLASH_EMU_CMD_QUAD_READ     0x6B
+#define FLASH_EMU_CMD_QUAD_IO_READ  0xEB
+#define FLASH_EMU_CMD_READ_ID       0x9F
+#define FLASH_EMU_CMD_READ_SFDP     0x5A
+#define FLASH_EMU_CMD_READ_STATUS   0x05
+#define FLASH_EMU_CMD_WRITE_ENABLE  0x06
+#define FLASH_EMU_CMD_WRITE_DISABLE 0x04
+#define FLASH_EMU_CMD_PAGE_PROGRAM  0x02
+#define FLASH_EMU_CMD_QUAD_PROGRAM  0x32
+#define FLASH_EMU_CMD_ERASE_4K      0x20
+#define FLASH_EMU_CMD_ERASE_32K     0x52
+#define FLASH_EMU_CMD_ERASE_64K     0xD8
+#define FLASH_EMU_CMD_CHIP_ERASE    0xC7
+#define FLASH_EMU_CMD_CHIP_ERASE_2  0x60
+#define FLASH_EMU_CMD_WRITE_EAR     0xC5
+#define FLASH_EMU_CMD_READ_EAR      0xC8
+#define FLASH_EMU_CMD_BANK_WRITE    0x17
+#define FLASH_EMU_CMD_BANK_READ     0x16
+
+/* 4 byte address opcodes */
+#define FLASH_EMU_CMD_READ_4B       0x13
+#define FLASH_EMU_CMD_FAST_READ_4B  0x0C
+#define FLASH_EMU_CMD_DUAL_READ_4B  0x3C
+#define FLASH_EMU_CMD_QUAD_READ_4B  0x6C
+#define FLASH_EMU_CMD_QUAD_IO_READ_4B 0xEC
+#define FLASH_EMU_CMD_PROGRAM_4B    0x12
+#define FLASH_EMU_CMD_QUAD_PROGRAM_4B 0x34
+#define FLASH_EMU_CMD_ERASE_4K_4B   0x21
+#define FLASH_EMU_CMD_ERASE_32K_4B  0x5C
+#define FLASH_EMU_CMD_ERASE_64K_4B  0xDC
+
+/* Status register bits */
+#define FLASH_EMU_SR_WIP            0x01
+#define FLASH_EMU_SR_WEL            0x02
+
+/*******************************************************************************
+*   Global Variables
+*******************************************************************************/
+static const FlashEmu_Part_t FlashEmu_Parts[] = {
+    /* Name         JEDEC ID              Size        Page  tPP   t4K     t32K    t64K    tCE(ms) SFDP 4B Bank  Sus   Res   tSUS tRS */
+    { "n25q128",    { 0x20, 0xBA, 0x18 }, 0x1000000,  256,  500,  250000, 0,      700000, 170000, 0,   0, 0,    0x75, 0x7A, 30,  64  },
+    { "s25fl164k",  { 0x01, 0x40, 0x17 }, 0x800000,   256,  700,  50000,  300000, 500000, 30000,  6,   0, 0,    0x75, 0x7A, 40,  128 },
+    { "w25q128jv",  { 0xEF, 0x40, 0x18 }, 0x1000000,  256,  400,  45000,  120000, 150000, 40000,  6,   0, 0,    0x75, 0x7A, 20,  64  },
+    { "mx25l12835f",{ 0xC2, 0x20, 0x18 }, 0x1000000,  256,  330,  30000,  150000, 280000, 50000,  6,   0, 0,    0xB0, 0x30, 20,  320 },
+    { "is25lp128",  { 0x9D, 0x60, 0x18 }, 0x1000000,  256,  200,  70000,  100000, 150000, 45000,  6,   0, 0,    0x75, 0x7A, 100, 128 },
+    { "mt25ql02g",  { 0x20, 0xBA, 0x22 }, 0x10000000, 256,  120,  50000,  100000, 150000, 600000, 6,   1, 0xC5, 0x75, 0x7A, 30,  64  },
+};
+
+/* SFDP time units, microseconds */
+static const u32 FlashEmu_EraseUnitsUs[4] = { 1000, 16000, 128000, 1000000 };
+static const u32 FlashEmu_ProgramUnitsUs[2] = { 8, 64 };
+static const u32 FlashEmu_ChipUnitsUs[4] = { 16000, 256000, 4000000, 64000000 };
+static const u32 FlashEmu_SuspendUnitsUs[3] = { 1, 8, 64 };     /* Unit codes 1 to 3, code 0 is 128ns */
+
+/*******************************************************************************
+*   Local Functions
+*******************************************************************************/
+
+/**
+ * Controller clock in nanoseconds, so busy periods follow simulated time too
+ */
+static u64 FlashEmu_NowNs(void)
+{
+    return XQspiPsHost_TimeNs();
+}
+
+/**
+ * Check whether a program or erase is still running
+ */
+static int FlashEmu_IsBusy(FlashEmu_t *EmuPtr)
+{
+    return FlashEmu_NowNs() < EmuPtr->BusyUntilNs;
+}
+
+/**
+ * Start a busy period of about TypicalUs, jittered by +/-10%
+ */
+static void FlashEmu_StartBusy(FlashEmu_t *EmuPtr, u64 TypicalUs)
+{
+    u64 Jitter = TypicalUs / 10U;
+    u64 BusyUs = TypicalUs - Jitter + (Jitter > 0 ? (u64)rand_r(&EmuPtr->Seed) % (2U * Jitter + 1U) : 0);
+
+    EmuPtr->BusyUntilNs = FlashEmu_NowNs() + BusyUs * 1000ULL;
+}
+
+/**
+ * Freeze the running program or erase on the suspend opcode
+ */
+static void FlashEmu_Suspend(FlashEmu_t *EmuPtr)
+{
+    u64 Now = FlashEmu_NowNs();
+
+    if (EmuPtr->Suspended || !FlashEmu_IsBusy(EmuPtr)) {
+        return;
+    }
+
+    // Too soon after a start or resume, the operation keeps running
+    if (Now - EmuPtr->RunningSinceNs < (u64)EmuPtr->Part->ResumeIntervalUs * 1000ULL) {
+        EmuPtr->Stats.IgnoredCommands++;
+        return;
+    }
+
+    EmuPtr->RemainingNs = EmuPtr->BusyUntilNs - Now;
+    EmuPtr->SuspendedAtNs = Now;
+    EmuPtr->Suspended = 1;
+    EmuPtr->Stats.Suspends++;
+
+    // Typically half the worst case latency to reach the suspended state
+    FlashEmu_StartBusy(EmuPtr, EmuPtr->Part->SuspendUs / 2U);
+}
+
+/**
+ * Restart a suspended program or erase for the time it had left
+ */
+static void FlashEmu_Resume(FlashEmu_t *EmuPtr)
+{
+    u64 Now = FlashEmu_NowNs();
+
+    if (!EmuPtr->Suspended) {
+        return;
+    }
+
+    // A resume during the suspend latency picks up where the suspend lands
+    if (EmuPtr->BusyUntilNs > Now) {
+        Now = EmuPtr->BusyUntilNs;
+    }
+
+    EmuPtr->Stats.SuspendedUs += (Now - EmuPtr->SuspendedAtNs) / 1000ULL;
+    EmuPtr->BusyUntilNs = Now + EmuPtr->RemainingNs;
+    EmuPtr->RunningSinceNs = Now;
+    EmuPtr->Suspended = 0;
+}
+
+/**
+ * Commit the latched page program data when CS rises
+ */
+static void FlashEmu_CommitProgram(FlashEmu_t *EmuPtr)
+{
+    u32 PageSize = EmuPtr->Part->PageSize;
+    u32 PageBase = (EmuPtr->Address % EmuPtr->Size) & ~(PageSize - 1U);
+    u32 Count = (EmuPtr->PageCount < PageSize) ? EmuPtr->PageCount : PageSize;
+    u32 Index;
+
+    if (!(EmuPtr->Status & FLASH_EMU_SR_WEL) || Count == 0) {
+        return;
+    }
+
+    if (EmuPtr->Suspended) {
+        EmuPtr->Stats.IgnoredCommands++;
+        return;
+    }
+
+    // Unlatched bytes are 0xFF and leave the cells alone
+    for (Index = 0; Index < PageSize; Index++) {
+        EmuPtr->Image[(PageBase + Index) * EmuPtr->Stride] &= EmuPtr->PageBuf[Index];
+    }
+
+    EmuPtr->Status &= (u8)~FLASH_EMU_SR_WEL;
+    EmuPtr->Stats.PagePrograms++;
+    EmuPtr->Stats.BytesProgrammed += Count;
+
+    // Program time grows with the bytes programmed, 1/4 tPP at minimum
+    FlashEmu_StartBusy(EmuPtr, (u64)EmuPtr->Part->ProgramUs * (PageSize + 3U * Count) / (4U * PageSize));
+    EmuPtr->RunningSinceNs = FlashEmu_NowNs();
+    EmuPtr->Stats.ProgramBusyUs += (EmuPtr->BusyUntilNs - FlashEmu_NowNs()) / 1000ULL;
+}
+
+/**
+ * Erase the addressed block (Size 0 for the whole chip) when CS rises
+ */
+static void FlashEmu_CommitErase(FlashEmu_t *EmuPtr, u32 Size, u64 TypicalUs)
+{
+    u32 Base = 0;
+    u32 Index;
+
+    if (!(EmuPtr->Status & FLASH_EMU_SR_WEL) || TypicalUs == 0) {
+        return;
+    }
+
+    if (EmuPtr->Suspended) {
+        EmuPtr->Stats.IgnoredCommands++;
+        return;
+    }
+
+    if (Size == 0) {
+        Size = EmuPtr->Size;
+    } else {
+        Base = (EmuPtr->Address % EmuPtr->Size) & ~(Size - 1U);
+    }
+
+    if (EmuPtr->Stride == 1U) {
+        memset(EmuPtr->Image + Base, 0xFF, Size);
+    } else {
+        for (Index = 0; Index < Size; Index++) {
+            EmuPtr->Image[(Base + Index) * EmuPtr->Stride] = 0xFF;
+        }
+    }
+
+    EmuPtr->Status &= (u8)~FLASH_EMU_SR_WEL;
+    EmuPtr->Stats.Erases++;
+    EmuPtr->Stats.BytesErased += Size;
+
+    FlashEmu_StartBusy(EmuPtr, TypicalUs);
+    EmuPtr->RunningSinceNs = FlashEmu_NowNs();
+    EmuPtr->Stats.EraseBusyUs += (EmuPtr->BusyUntilNs - FlashEmu_NowNs()) / 1000ULL;
+}
+
+/**
+ * Store a little endian word in SFDP space
+ */
+static void FlashEmu_PutWord(u8 *Dest, u32 Word)
+{
+    Dest[0] = (u8)Word;
+    Dest[1] = (u8)(Word >> 8);
+    Dest[2] = (u8)(Word >> 16);
+    Dest[3] = (u8)(Word >> 24);
+}
+
+/**
+ * Encode a typical time as the SFDP 5 bit count and unit index
+ */
+static u32 FlashEmu_EncodeTime(u64 TimeUs, const u32 *UnitsUs, u32 Units, u32 CountBits)
+{
+    u32 Unit;
+    u64 Count = 1;
+
+    for (Unit = 0; Unit < Units; Unit++) {
+        Count = (TimeUs + UnitsUs[Unit] - 1U) / UnitsUs[Unit];
+        if (Count <= (1U << CountBits)) {
+            break;
+        }
+    }
+
+    if (Unit == Units) {
+        Unit = Units - 1U;
+        Count = 1U << CountBits;
+    }
+    if (Count == 0) {
+        Count = 1;
+    }
+
+    return (u32)(Count - 1U) | (Unit << CountBits);
+}
+
+/**
+ * Generate the part's SFDP header and basic flash parameter table
+ * Reads advertised are the ones this model decodes: 1-1-2, 1-1-4 and
+ * 1-4-4 with a mode byte and 4 dummy clocks.
+ */
+static void FlashEmu_BuildSfdp(FlashEmu_t *EmuPtr)
+{
+    const FlashEmu_Part_t *Part = EmuPtr->Part;
+    u8 *Table = &EmuPtr->Sfdp[0x30];
+    u32 Sizes[4] = { 0x1000U, 0x8000U, 0x10000U, 0 };
+    u32 Times[4] = { Part->Erase4kUs, Part->Erase32kUs, Part->Erase64kUs, 0 };
+    u8 Cmds[4] = { FLASH_EMU_CMD_ERASE_4K, FLASH_EMU_CMD_ERASE_32K, FLASH_EMU_CMD_ERASE_64K, 0 };
+    u8 Cmds4BBySize[4] = { FLASH_EMU_CMD_ERASE_4K_4B, FLASH_EMU_CMD_ERASE_32K_4B, FLASH_EMU_CMD_ERASE_64K_4B, 0 };
+    u8 Cmds4B[4] = { 0xFF, 0xFF, 0xFF, 0xFF };
+    u32 Dwords = (Part->SfdpMinor >= 5) ? 16U : 9U;
+    u32 EraseTimes = 1U;                    /* Max erase time = 4 x typical */
+    u32 Slot = 0;
+    u32 Index;
+    u32 PageShift = 0;
+    u32 Latency;
+    u32 Interval;
+
+    memset(EmuPtr->Sfdp, 0xFF, sizeof(EmuPtr->Sfdp));
+
+    // Header and a parameter header pointing at the basic table
+    memcpy(EmuPtr->Sfdp, "SFDP", 4);
+    EmuPtr->Sfdp[4] = Part->SfdpMinor;
+    EmuPtr->Sfdp[5] = 1;
+    EmuPtr->Sfdp[6] = 0;
+    EmuPtr->Sfdp[8] = 0x00;
+    EmuPtr->Sfdp[9] = Part->SfdpMinor;
+    EmuPtr->Sfdp[10] = 1;
+    EmuPtr->Sfdp[11] = (u8)Dwords;
+    EmuPtr->Sfdp[12] = 0x30;
+    EmuPtr->Sfdp[13] = 0x00;
+    EmuPtr->Sfdp[14] = 0x00;
+    EmuPtr->Sfdp[15] = 0xFF;
+
+    // 1: 4KB erase, 3 (or 3 and 4) byte addressing, 1-1-2, 1-4-4 and 1-1-4 reads
+    FlashEmu_PutWord(&Table[0], 0xFF800000U | (1U << 22) | (1U << 21) | ((Part->Size > 0x1000000U) ? (1U << 17) : 0) |
+                                (1U << 16) | ((u32)FLASH_EMU_CMD_ERASE_4K << 8) | (1U << 2) | 0x1U);
+    // 2: density in bits
+    FlashEmu_PutWord(&Table[4], Part->Size * 8U - 1U);
+    // 3: 1-4-4 (mode 2, dummy 4 clocks) and 1-1-4 (dummy 8 clocks)
+    FlashEmu_PutWord(&Table[8], ((u32)FLASH_EMU_CMD_QUAD_READ << 24) | (8U << 16) |
+                                ((u32)FLASH_EMU_CMD_QUAD_IO_READ << 8) | (2U << 5) | 4U);
+    // 4: 1-1-2 (dummy 8 clocks), no 1-2-2
+    FlashEmu_PutWord(&Table[12], ((u32)FLASH_EMU_CMD_DUAL_READ << 8) | 8U);
+    // 5 to 7: no 2-2-2 or 4-4-4
+    FlashEmu_PutWord(&Table[16], 0xFFFFFFEEU);
+    FlashEmu_PutWord(&Table[20], 0x0000FFFFU);
+    FlashEmu_PutWord(&Table[24], 0x0000FFFFU);
+
+    // 8 and 9: erase types, 10: their typical times
+    memset(&Table[28], 0, 8);
+    for (Index = 0; Index < 4; Index++) {
+        if (Times[Index] == 0) {
+            continue;
+        }
+        Table[28 + Slot * 2U] = (u8)__builtin_ctz(Sizes[Index]);
+        Table[29 + Slot * 2U] = Cmds[Index];
+        EraseTimes |= FlashEmu_EncodeTime(Times[Index], FlashEmu_EraseUnitsUs, 4, 5) << (4U + 7U * Slot);
+        Cmds4B[Slot] = Cmds4BBySize[Index];
+        Slot++;
+    }
+
+    // 4 byte address instruction table: reads, programs and the erase types above
+    if (EmuPtr->Native4Byte) {
+        EmuPtr->Sfdp[6] = 1;
+        EmuPtr->Sfdp[16] = 0x84;
+        EmuPtr->Sfdp[17] = 0;
+        EmuPtr->Sfdp[18] = 1;
+        EmuPtr->Sfdp[19] = 2;
+        EmuPtr->Sfdp[20] = 0xC0;
+        EmuPtr->Sfdp[21] = 0x00;
+        EmuPtr->Sfdp[22] = 0x00;
+        EmuPtr->Sfdp[23] = 0xFF;
+
+        FlashEmu_PutWord(&EmuPtr->Sfdp[0xC0], 0xFFF00000U | (((1U << Slot) - 1U) << 9) |
+                                              (1U << 7) | (1U << 6) | (1U << 5) | (1U << 4) | (1U << 2) | (1U << 1) | 1U);
+        FlashEmu_PutWord(&EmuPtr->Sfdp[0xC4], (u32)Cmds4B[0] | ((u32)Cmds4B[1] << 8) |
+                                              ((u32)Cmds4B[2] << 16) | ((u32)Cmds4B[3] << 24));
+    }
+
+    if (Dwords < 16U) {
+        return;
+    }
+
+    FlashEmu_PutWord(&Table[36], EraseTimes);
+
+    // 11: page size, tPP (max = 4 x typical) and chip erase time
+    while ((1U << PageShift) < Part->PageSize) {
+        PageShift++;
+    }
+    FlashEmu_PutWord(&Table[40], (FlashEmu_EncodeTime((u64)Part->ChipEraseMs * 1000U, FlashEmu_ChipUnitsUs, 4, 5) << 24) |
+                                 (FlashEmu_EncodeTime(Part->ProgramUs, FlashEmu_ProgramUnitsUs, 2, 5) << 8) |
+                                 (PageShift << 4) | 1U);
+
+    // 12 to 16: no suspend, no deep power down, defaults elsewhere
+    for (Index = 11; Index < 16; Index++) {
+        FlashEmu_PutWord(&Table[Index * 4U], 0xFFFFFFFFU);
+    }
+
+    // 12 and 13: the same suspend latency, resume interval and opcodes for programs and erases
+    if (Part->SuspendCmd != 0) {
+        Latency = FlashEmu_EncodeTime(Part->SuspendUs, FlashEmu_SuspendUnitsUs, 3, 5);
+        Latency = (Latency & 0x1FU) | (((Latency >> 5) + 1U) << 5);
+        Interval = (Part->ResumeIntervalUs + 63U) / 64U;
+        Interval = (Interval > 16U) ? 15U : (Interval > 0 ? Interval - 1U : 0);
+
+        FlashEmu_PutWord(&Table[44], (Latency << 24) | (Interval << 20) | (Latency << 13) | (Interval << 9) | (1U << 8));
+        FlashEmu_PutWord(&Table[48], ((u32)Part->SuspendCmd << 24) | ((u32)Part->ResumeCmd << 16) |
+                                     ((u32)Part->SuspendCmd << 8) | Part->ResumeCmd);
+    }
+}
+
+/**
+ * Chip select asserted, start decoding a new command
+ */
+static void FlashEmu_Select(void *Ref)
+{
+    FlashEmu_t *EmuPtr = (FlashEmu_t *)Ref;
+
+    EmuPtr->Phase = FLASH_EMU_PHASE_CMD;
+    EmuPtr->Address = 0;
+    EmuPtr->DataIndex = 0;
+    EmuPtr->PageCount = 0;
+}
+
+/**
+ * Chip select released
+ */
+static void FlashEmu_Deselect(void *Ref)
+{
+    FlashEmu_t *EmuPtr = (FlashEmu_t *)Ref;
+    const FlashEmu_Part_t *Part = EmuPtr->Part;
+
+    if (EmuPtr->Phase == FLASH_EMU_PHASE_DATA) {
+        switch (EmuPtr->Cmd) {
+            case FLASH_EMU_CMD_ERASE_4K:
+            case FLASH_EMU_CMD_ERASE_4K_4B:
+                FlashEmu_CommitErase(EmuPtr, 0x1000U, Part->Erase4kUs);
+                break;
+            case FLASH_EMU_CMD_ERASE_32K:
+            case FLASH_EMU_CMD_ERASE_32K_4B:
+                FlashEmu_CommitErase(EmuPtr, 0x8000U, Part->Erase32kUs);
+                break;
+            case FLASH_EMU_CMD_ERASE_64K:
+            case FLASH_EMU_CMD_ERASE_64K_4B:
+                FlashEmu_CommitErase(EmuPtr, 0x10000U, Part->Erase64kUs);
+                break;
+            case FLASH_EMU_CMD_CHIP_ERASE:
+            case FLASH_EMU_CMD_CHIP_ERASE_2:
+                FlashEmu_CommitErase(EmuPtr, 0, (u64)Part->ChipEraseMs * 1000ULL);
+                break;
+            case FLASH_EMU_CMD_PAGE_PROGRAM:
+            case FLASH_EMU_CMD_QUAD_PROGRAM:
+            case FLASH_EMU_CMD_PROGRAM_4B:
+            case FLASH_EMU_CMD_QUAD_PROGRAM_4B:
+                FlashEmu_CommitProgram(EmuPtr);
+                break;
+            case FLASH_EMU_CMD_WRITE_ENABLE:
+                EmuPtr->Status |= FLASH_EMU_SR_WEL;
+                break;
+            case FLASH_EMU_CMD_WRITE_DISABLE:
+                EmuPtr->Status &= (u8)~FLASH_EMU_SR_WEL;
+                break;
+            default:
+                // Suspend / resume opcodes differ between vendors
+                if (Part->SuspendCmd != 0 && EmuPtr->Cmd == Part->SuspendCmd) {
+                    FlashEmu_Suspend(EmuPtr);
+                } else if (Part->SuspendCmd != 0 && EmuPtr->Cmd == Part->ResumeCmd) {
+                    FlashEmu_Resume(EmuPtr);
+                }
+                break;
+        }
+    }
+
+    EmuPtr->Phase = FLASH_EMU_PHASE_CMD;
+}
+
+/**
+ * Latch the opcode and set up the address, dummy and data phases
+ */
+static void FlashEmu_Decode(FlashEmu_t *EmuPtr, u8 Cmd)
+{
+    u32 AddrBytes = 0;
+    u32 DummyBytes = 0;
+
+    EmuPtr->Cmd = Cmd;
+    EmuPtr->Address = 0;
+    EmuPtr->AddrLanes = 1;
+    EmuPtr->DataLanes = 1;
+
+    // A busy part only answers status reads, and suspends where it can
+    if (FlashEmu_IsBusy(EmuPtr) && Cmd != FLASH_EMU_CMD_READ_STATUS &&
+        (EmuPtr->Part->SuspendCmd == 0 || Cmd != EmuPtr->Part->SuspendCmd)) {
+        EmuPtr->Stats.IgnoredCommands++;
+        EmuPtr->Phase = FLASH_EMU_PHASE_IGNORE;
+        return;
+    }
+
+    switch (Cmd) {
+        case FLASH_EMU_CMD_READ:
+            AddrBytes = 3;
+            break;
+        case FLASH_EMU_CMD_FAST_READ:
+            AddrBytes = 3;
+            DummyBytes = 1;
+            break;
+        case FLASH_EMU_CMD_DUAL_READ:
+            AddrBytes = 3;
+            DummyBytes = 1;
+            EmuPtr->DataLanes = 2;
+            break;
+        case FLASH_EMU_CMD_QUAD_READ:
+            AddrBytes = 3;
+            DummyBytes = 1;
+            EmuPtr->DataLanes = 4;
+            break;
+        case FLASH_EMU_CMD_QUAD_IO_READ:
+            // Mode byte plus 4 dummy clocks, all on four lanes
+            AddrBytes = 3;
+            DummyBytes = 3;
+            EmuPtr->AddrLanes = 4;
+            EmuPtr->DataLanes = 4;
+            break;
+        case FLASH_EMU_CMD_PAGE_PROGRAM:
+            AddrBytes = 3;
+            memset(EmuPtr->PageBuf, 0xFF, sizeof(EmuPtr->PageBuf));
+            break;
+        case FLASH_EMU_CMD_QUAD_PROGRAM:
+            AddrBytes = 3;
+            EmuPtr->DataLanes = 4;
+            memset(EmuPtr->PageBuf, 0xFF, sizeof(EmuPtr->PageBuf));
+            break;
+        case FLASH_EMU_CMD_ERASE_4K:
+        case FLASH_EMU_CMD_ERASE_32K:
+        case FLASH_EMU_CMD_ERASE_64K:
+            AddrBytes = 3;
+            break;
+        case FLASH_EMU_CMD_READ_SFDP:
+            AddrBytes = 3;
+            DummyBytes = 1;
+            break;
+        case FLASH_EMU_CMD_READ_STATUS:
+            EmuPtr->Stats.StatusReads++;
+            break;
+        default:
+            break;
+    }
+
+    // 4 byte address opcodes, only on parts that have them
+    if (EmuPtr->Native4Byte) {
+        switch (Cmd) {
+            case FLASH_EMU_CMD_READ_4B:
+                AddrBytes = 4;
+                break;
+            case FLASH_EMU_CMD_FAST_READ_4B:
+                AddrBytes = 4;
+                DummyBytes = 1;
+                break;
+            case FLASH_EMU_CMD_DUAL_READ_4B:
+                AddrBytes = 4;
+                DummyBytes = 1;
+                EmuPtr->DataLanes = 2;
+                break;
+            case FLASH_EMU_CMD_QUAD_READ_4B:
+                AddrBytes = 4;
+                DummyBytes = 1;
+                EmuPtr->DataLanes = 4;
+                break;
+            case FLASH_EMU_CMD_QUAD_IO_READ_4B:
+                AddrBytes = 4;
+                DummyBytes = 3;
+                EmuPtr->AddrLanes = 4;
+                EmuPtr->DataLanes = 4;
+                break;
+            case FLASH_EMU_CMD_PROGRAM_4B:
+                AddrBytes = 4;
+                memset(EmuPtr->PageBuf, 0xFF, sizeof(EmuPtr->PageBuf));
+                break;
+            case FLASH_EMU_CMD_QUAD_PROGRAM_4B:
+                AddrBytes = 4;
+                EmuPtr->DataLanes = 4;
+                memset(EmuPtr->PageBuf, 0xFF, sizeof(EmuPtr->PageBuf));
+                break;
+            case FLASH_EMU_CMD_ERASE_4K_4B:
+            case FLASH_EMU_CMD_ERASE_32K_4B:
+            case FLASH_EMU_CMD_ERASE_64K_4B:
+                AddrBytes = 4;
+                break;
+            default:
+                break;
+        }
+    }
+
+    EmuPtr->AddrBytes = AddrBytes;
+    if (AddrBytes > 0) {
+        EmuPtr->Phase = FLASH_EMU_PHASE_ADDR;
+        EmuPtr->Count = AddrBytes;
+    } else {
+        EmuPtr->Phase = FLASH_EMU_PHASE_DATA;
+    }
+
+    EmuPtr->DummyBytes = DummyBytes;
+}
+
+/**
+ * Handle the next data phase byte, returns the byte driven on MISO
+ */
+static u8 FlashEmu_DataOut(FlashEmu_t *EmuPtr, u8 TxByte)
+{
+    u8 Data = 0xFF;
+
+    switch (EmuPtr->Cmd) {
+        case FLASH_EMU_CMD_READ:
+        case FLASH_EMU_CMD_FAST_READ:
+        case FLASH_EMU_CMD_DUAL_READ:
+        case FLASH_EMU_CMD_QUAD_READ:
+        case FLASH_EMU_CMD_QUAD_IO_READ:
+        case FLASH_EMU_CMD_READ_4B:
+        case FLASH_EMU_CMD_FAST_READ_4B:
+        case FLASH_EMU_CMD_DUAL_READ_4B:
+        case FLASH_EMU_CMD_QUAD_READ_4B:
+        case FLASH_EMU_CMD_QUAD_IO_READ_4B:
+            Data = EmuPtr->Image[(EmuPtr->Address % EmuPtr->Size) * EmuPtr->Stride];
+            EmuPtr->Address++;
+            break;
+        case FLASH_EMU_CMD_READ_ID:
+            Data = (EmuPtr->DataIndex < 3) ? EmuPtr->Part->JedecId[EmuPtr->DataIndex] : 0x00;
+            break;
+        case FLASH_EMU_CMD_READ_SFDP:
+            Data = EmuPtr->Sfdp[EmuPtr->Address % FLASH_EMU_SFDP_SIZE];
+            EmuPtr->Address++;
+            break;
+        case FLASH_EMU_CMD_READ_STATUS:
+            Data = EmuPtr->Status | (FlashEmu_IsBusy(EmuPtr) ? FLASH_EMU_SR_WIP : 0);
+            break;
+        case FLASH_EMU_CMD_WRITE_EAR:
+        case FLASH_EMU_CMD_BANK_WRITE:
+            // Only the part's own bank register opcode, EAR writes need WEL
+            if (EmuPtr->DataIndex == 0 && EmuPtr->Cmd == EmuPtr->Part->BankCmd &&
+                (EmuPtr->Cmd != FLASH_EMU_CMD_WRITE_EAR || (EmuPtr->Status & FLASH_EMU_SR_WEL))) {
+                EmuPtr->Bank = TxByte;
+                EmuPtr->Status &= (u8)~FLASH_EMU_SR_WEL;
+                EmuPtr->Stats.BankWrites++;
+            }
+            break;
+        case FLASH_EMU_CMD_READ_EAR:
+        case FLASH_EMU_CMD_BANK_READ:
+            if (EmuPtr->Part->BankCmd != 0) {
+                Data = EmuPtr->Bank;
+            }
+            break;
+        case FLASH_EMU_CMD_PAGE_PROGRAM:
+        case FLASH_EMU_CMD_QUAD_PROGRAM:
+        case FLASH_EMU_CMD_PROGRAM_4B:
+        case FLASH_EMU_CMD_QUAD_PROGRAM_4B:
+            // Bytes past the end of the page wrap to its start
+            EmuPtr->PageBuf[(EmuPtr->Address + EmuPtr->PageCount) & (EmuPtr->Part->PageSize - 1U)] = TxByte;
+            EmuPtr->PageCount++;
+            break;
+        default:
+            break;
+    }
+
+    EmuPtr->DataIndex++;
+    return Data;
+}
+
+/**
+ * One byte clocked by the controller
+ */
+static u8 FlashEmu_Exchange(void *Ref, u8 TxByte, u32 *Lanes)
+{
+    FlashEmu_t *EmuPtr = (FlashEmu_t *)Ref;
+    u8 RxByte = 0xFF;
+
+    switch (EmuPtr->Phase) {
+        case FLASH_EMU_PHASE_CMD:
+            *Lanes = 1;
+            FlashEmu_Decode(EmuPtr, TxByte);
+            break;
+
+        case FLASH_EMU_PHASE_ADDR:
+            *Lanes = EmuPtr->AddrLanes;
+            EmuPtr->Address = (EmuPtr->Address << 8) | TxByte;
+            if (--EmuPtr->Count == 0) {
+                // 3 byte addresses land in the current bank of a large part
+                if (EmuPtr->AddrBytes == 3 && EmuPtr->Cmd != FLASH_EMU_CMD_READ_SFDP && EmuPtr->Size > 0x1000000U) {
+                    EmuPtr->Address |= (u32)EmuPtr->Bank << 24;
+                }
+                EmuPtr->Count = EmuPtr->DummyBytes;
+                EmuPtr->Phase = (EmuPtr->Count > 0) ? FLASH_EMU_PHASE_DUMMY : FLASH_EMU_PHASE_DATA;
+            }
+            break;
+
+        case FLASH_EMU_PHASE_DUMMY:
+            *Lanes = EmuPtr->AddrLanes;
+            if (--EmuPtr->Count == 0) {
+                EmuPtr->Phase = FLASH_EMU_PHASE_DATA;
+            }
+            break;
+
+        case FLASH_EMU_PHASE_DATA:
+            *Lanes = EmuPtr->DataLanes;
+            RxByte = FlashEmu_DataOut(EmuPtr, TxByte);
+            break;
+
+        case FLASH_EMU_PHASE_IGNORE:
+            break;
+    }
+
+    return RxByte;
+}
+
+/**
+ * Whether the frame has reached its data phase, parallel controllers stripe from there
+ */
+static u32 FlashEmu_InData(void *Ref)
+{
+    return ((FlashEmu_t *)Ref)->Phase == FLASH_EMU_PHASE_DATA;
+}
+
+/**
+ * Reset the model state for a part, before its image is attached
+ */
+static void FlashEmu_Init(FlashEmu_t *EmuPtr, const FlashEmu_Part_t *PartPtr, u32 Seed)
+{
+    memset(EmuPtr, 0, sizeof(*EmuPtr));
+    EmuPtr->Part = PartPtr;
+    EmuPtr->Size = PartPtr->Size;
+    EmuPtr->Fd = -1;
+    EmuPtr->Stride = 1;
+    EmuPtr->Seed = Seed;
+    EmuPtr->Native4Byte = PartPtr->Native4Byte;
+
+    FlashEmu_BuildSfdp(EmuPtr);
+
+    EmuPtr->Device.Ref = EmuPtr;
+    EmuPtr->Device.Select = FlashEmu_Select;
+    EmuPtr->Device.Exchange = FlashEmu_Exchange;
+    EmuPtr->Device.Deselect = FlashEmu_Deselect;
+    EmuPtr->Device.InData = FlashEmu_InData;
+}
+
+/**
+ * Map Size bytes of the image file shared, or of an anonymous memory file
+ * when ImagePath is NULL. Bytes past the old end of the file start erased.
+ */
+static XStatus FlashEmu_MapImage(FlashEmu_t *EmuPtr, const char *ImagePath, u32 Size)
+{
+    struct stat St;
+    void *Map;
+    off_t OldSize;
+
+    if (ImagePath != NULL) {
+        EmuPtr->Fd = open(ImagePath, O_RDWR | O_CREAT, 0644);
+    } else {
+        EmuPtr->Fd = memfd_create("flash_emu", 0);
+    }
+
+    if (EmuPtr->Fd < 0 || fstat(EmuPtr->Fd, &St) != 0) {
+        return XST_FAILURE;
+    }
+
+    OldSize = St.st_size;
+    if (OldSize < (off_t)Size && ftruncate(EmuPtr->Fd, Size) != 0) {
+        close(EmuPtr->Fd);
+        EmuPtr->Fd = -1;
+        return XST_FAILURE;
+    }
+
+    Map = mmap(NULL, Size, PROT_READ | PROT_WRITE, MAP_SHARED, EmuPtr->Fd, 0);
+    if (Map == MAP_FAILED) {
+        close(EmuPtr->Fd);
+        EmuPtr->Fd = -1;
+        return XST_FAILURE;
+    }
+
+    EmuPtr->Map = (u8 *)Map;
+    EmuPtr->MapSize = Size;
+    EmuPtr->Image = EmuPtr->Map;
+
+    // Newly created flash is erased
+    if (OldSize < (off_t)Size) {
+        memset(EmuPtr->Map + OldSize, 0xFF, Size - (u32)OldSize);
+    }
+
+    return XST_SUCCESS;
+}
+
+/*******************************************************************************
+*   Functions
+*******************************************************************************/
+
+/**
+ * Look up a part by name, NULL selects the default part
+ */
+const FlashEmu_Part_t *FlashEmu_FindPart(const char *Name)
+{
+    u32 Index;
+
+    if (Name == NULL) {
+        return &FlashEmu_Parts[0];
+    }
+
+    for (Index = 0; Index < sizeof(FlashEmu_Parts) / sizeof(FlashEmu_Parts[0]); Index++) {
+        if (strcmp(FlashEmu_Parts[Index].Name, Name) == 0) {
+            return &FlashEmu_Parts[Index];
+        }
+    }
+
+    return NULL;
+}
+
+/**
+ * Create the flash model
+ * ImagePath names the backing image file, created erased (0xFF) if missing
+ * or shorter than the part. NULL gives an erased anonymous image.
+ */
+XStatus FlashEmu_Open(FlashEmu_t *EmuPtr, const char *ImagePath, const FlashEmu_Part_t *PartPtr)
+{
+    if (PartPtr == NULL) {
+        return XST_INVALID_PARAM;
+    }
+
+    FlashEmu_Init(EmuPtr, PartPtr, 1);
+
+    return FlashEmu_MapImage(EmuPtr, ImagePath, PartPtr->Size);
+}
+
+/**
+ * Create two flash models wired as a dual configuration
+ * The image holds both parts as the driver addresses them: interleaved byte
+ * by byte when Parallel is set (lower part on even addresses), otherwise the
+ * lower part followed by the upper one. Each model works on its own bytes in
+ * place, so the image also backs the controller's linear window.
+ */
+XStatus FlashEmu_OpenPair(FlashEmu_t *LowerPtr, FlashEmu_t *UpperPtr, const char *ImagePath,
+                          const FlashEmu_Part_t *PartPtr, u32 Parallel)
+{
+    XStatus Status;
+
+    if (PartPtr == NULL) {
+        return XST_INVALID_PARAM;
+    }
+
+    FlashEmu_Init(LowerPtr, PartPtr, 1);
+    FlashEmu_Init(UpperPtr, PartPtr, 2);
+
+    Status = FlashEmu_MapImage(LowerPtr, ImagePath, 2U * PartPtr->Size);
+    if (Status != XST_SUCCESS) {
+        return Status;
+    }
+
+    if (Parallel) {
+        LowerPtr->Stride = 2;
+        UpperPtr->Stride = 2;
+        UpperPtr->Image = LowerPtr->Map + 1;
+    } else {
+        UpperPtr->Image = LowerPtr->Map + PartPtr->Size;
+    }
+
+    return XST_SUCCESS;
+}
+
+/**
+ * Turn the part's 4 byte address opcodes on or off, models older large
+ * parts that can only reach past 16MB through the bank register
+ */
+void FlashEmu_SetNative4Byte(FlashEmu_t *EmuPtr, u32 Enable)
+{
+    EmuPtr->Native4Byte = (Enable && EmuPtr->Part->Native4Byte) ? 1U : 0U;
+    FlashEmu_BuildSfdp(EmuPtr);
+}
+
+/**
+ * Unmap the image and close its file
+ */
+void FlashEmu_Close(FlashEmu_t *EmuPtr)
+{
+    // The upper part of a pair borrows the lower part's mapping
+    if (EmuPtr->Map != NULL) {
+        munmap(EmuPtr->Map, EmuPtr->MapSize);
+        EmuPtr->Map = NULL;
+    }
+    EmuPtr->Image = NULL;
+
+    if (EmuPtr->Fd >= 0) {
+        close(EmuPtr->Fd);
+        EmuPtr->Fd = -1;
+    }
+}
@@ -0,0 +1,170 @@
+/*******************************************************************************
+*   McMaster PRESET (www.mcmasterneudose.ca)
+*
+*   Data Acquisition Module - DAM
+*   Flight Firmware
+*
+*   @file       flash_emu.h
+*   @desc       Host build NOR flash model attached to the XQspiPs stand-in
+*   @author     Sameer Suleman
+*   @date       October 16, 2026
+*
+*   <pre>
+*
+*   The flash contents live in an image file that is mmap'd shared, so the
+*   same memory backs both I/O mode commands and the controller's linear
+*   (XIP) window, and survives between host runs.
+*
+*   Program operations follow NOR semantics (bits only go 1 -> 0) and keep
+*   the part busy (WIP set, other commands ignored) for a time derived
+*   from the part's typical tPP, scaled by the bytes programmed and jittered
+*   by +/-10%. Erases set their block back to 0xFF and stay busy for the
+*   part's typical erase time with the same jitter.
+*
+*   Parts that can suspend take their suspend opcode while an erase or
+*   program runs: the part goes busy for about half its tSUS and then reads
+*   ready with the operation frozen, and the resume opcode restarts it for
+*   the time it had left. A suspend within the part's resume interval of
+*   the operation starting or resuming is ignored, as is a program or erase
+*   while suspended.
+*
+*   Each part answers READ SFDP (0x5A) with a JESD216 table generated from
+*   its description, so identification can be exercised for every vendor
+*   without capturing dumps from hardware.
+*
+*   Two parts can share one image as a dual stacked or dual parallel pair,
+*   laid out the way the driver addresses the pair.
+*
+*   Parts over 16MB take 3 byte address commands relative to their bank
+*   (extended address) register, and 4 byte address opcodes when the part
+*   has them. Native 4 byte opcodes can be switched off to model older
+*   parts that only have the bank register.
+*
+*   </pre>
+*
+*******************************************************************************/
+
+/*******************************************************************************
+*   Prevent circular dependency
+*   DO NOT REMOVE
+*******************************************************************************/
+#ifndef FLASH_EMU_H
+#define FLASH_EMU_H
+
+/*******************************************************************************
+*   Includes
+*******************************************************************************/
+#include "xil_types.h"
+#include "xstatus.h"
+#include "xqspips.h"
+
+/*******************************************************************************
+*   Constant Definitions
+*******************************************************************************/
+#define FLASH_EMU_MAX_PAGE_SIZE     1024
+#define FLASH_EMU_SFDP_SIZE         256
+
+/*******************************************************************************
+*   Datatype Definitions
+*******************************************************************************/
+/* Static description of an emulated part */
+typedef struct {
+    const char *Name;
+    u8 JedecId[3];                  /* Manufacturer, memory type, capacity */
+    u32 Size;                       /* Bytes */
+    u32 PageSize;                   /* Bytes */
+    u32 ProgramUs;                  /* Typical full page program time (tPP) */
+    u32 Erase4kUs;                  /* Typical erase times, 0 if the opcode is unsupported */
+    u32 Erase32kUs;
+    u32 Erase64kUs;
+    u32 ChipEraseMs;
+    u8 SfdpMinor;                   /* JESD216 revision 1.x, tables from 1.6 carry timings */
+    u8 Native4Byte;                 /* Has 4 byte address opcodes (and a 4BAIT table) */
+    u8 BankCmd;                     /* Bank / extended address register write opcode, 0 if none */
+    u8 SuspendCmd;                  /* Program / erase suspend opcode, 0 if the part can't suspend */
+    u8 ResumeCmd;
+    u32 SuspendUs;                  /* Worst case suspend latency (tSUS) */
+    u32 ResumeIntervalUs;           /* Run time needed after a start or resume before a suspend is taken */
+} FlashEmu_Part_t;
+
+/* Operation counters */
+typedef struct {
+    u32 PagePrograms;
+    u64 BytesProgrammed;
+    u64 ProgramBusyUs;              /* Total modelled program time */
+    u32 Erases;                     /* Block and chip erases accepted */
+    u64 BytesErased;
+    u64 EraseBusyUs;                /* Total modelled erase time */
+    u32 StatusReads;
+    u32 IgnoredCommands;            /* Commands sent while busy */
+    u32 BankWrites;                 /* Bank / extended address register writes accepted */
+    u32 Suspends;                   /* Programs and erases suspended */
+    u64 SuspendedUs;                /* Total time operations spent suspended */
+} FlashEmu_Stats_t;
+
+/* Command decoder phase */
+typedef enum {
+    FLASH_EMU_PHASE_CMD = 0,
+    FLASH_EMU_PHASE_ADDR,
+    FLASH_EMU_PHASE_DUMMY,
+    FLASH_EMU_PHASE_DATA,
+    FLASH_EMU_PHASE_IGNORE
+} FlashEmu_Phase_t;
+
+typedef struct {
+    const FlashEmu_Part_t *Part;
+    u8 *Image;                      /* First byte of this part in the mmap'd image */
+    u32 Stride;                     /* Image bytes per flash byte, 2 for parallel pairs */
+    u32 Size;
+    u8 *Map;                        /* Image mapping, NULL when borrowed from the other part of a pair */
+    u32 MapSize;
+    int Fd;                         /* Image (or anonymous memory) file, -1 when borrowed */
+    XQspiPsHost_Device Device;      /* Callbacks handed to the controller */
+
+    /* Current CS frame */
+    FlashEmu_Phase_t Phase;
+    u8 Cmd;
+    u32 Count;                      /* Bytes left in the address or dummy phase */
+    u32 Address;
+    u32 AddrBytes;
+    u32 DummyBytes;
+    u32 DataIndex;
+    u32 AddrLanes;
+    u32 DataLanes;
+
+    /* Device state */
+    u8 Status;                      /* Status register, WIP is derived from BusyUntilNs */
+    u8 Bank;                        /* Address bits 31:24 for 3 byte address commands */
+    u8 Native4Byte;                 /* 4 byte address opcodes enabled */
+    u64 BusyUntilNs;                /* XQspiPsHost_TimeNs time the running operation ends */
+    u8 Suspended;                   /* A program or erase is suspended */
+    u64 RemainingNs;                /* Busy time the suspended operation has left */
+    u64 SuspendedAtNs;
+    u64 RunningSinceNs;             /* When the running operation started or last resumed */
+    u32 Seed;                       /* Timing jitter */
+    u8 Sfdp[FLASH_EMU_SFDP_SIZE];   /* SFDP space, built from the part description */
+    u8 PageBuf[FLASH_EMU_MAX_PAGE_SIZE];
+    u32 PageCount;                  /* Bytes latched by the current page program */
+
+    FlashEmu_Stats_t Stats;
+} FlashEmu_t;
+
+/*******************************************************************************
+*   Function Prototypes
+*******************************************************************************/
+const FlashEmu_Part_t *FlashEmu_FindPart(const char *Name);
+XStatus FlashEmu_Open(FlashEmu_t *EmuPtr, const char *ImagePath, const FlashEmu_Part_t *PartPtr);
+XStatus FlashEmu_OpenPair(FlashEmu_t *LowerPtr, FlashEmu_t *UpperPtr, const char *ImagePath,
+                          const FlashEmu_Part_t *PartPtr, u32 Parallel);
+void FlashEmu_Close(FlashEmu_t *EmuPtr);
+void FlashEmu_SetNative4Byte(FlashEmu_t *EmuPtr, u32 Enable);
+
+/* Default models wired up by the XQspiPs stand-in */
+FlashEmu_t *XQspiPsHost_GetFlash(void);
+FlashEmu_t *XQspiPsHost_GetUpperFlash(void);
+
+/*******************************************************************************
+*   Prevent circular dependency
+*   DO NOT REMOVE
+*******************************************************************************/
+#endif /* FLASH_EMU_H */
@@ -0,0 +1,19 @@
+/*******************************************************************************
+*   McMaster PRESET (www.mcmasterneudose.ca)
+*
+*   Data Acquisition Module - DAM
+*   Flight Firmware
+*
+*   @file       platform.h
+*   @desc       Host build stand-in for the Vitis platform init helpers
+*   @author     Sameer Suleman
+*   @date       October 16, 2026
+*
+*******************************************************************************/
+#ifndef PLATFORM_H
+#define PLATFORM_H
+
+static inline void init_platform(void) { }
+static inline void cleanup_platform(void) { }
+
+#endif /* PLATFORM_H */
@@ -0,0 +1,25 @@
+/*******************************************************************************
+*   McMaster PRESET (www.mcmasterneudose.ca)
+*
+*   Data Acquisition Module - DAM
+*   Flight Firmware
+*
+*   @file       sleep.h
+*   @desc       Host build stand-in for the Xilinx BSP delay functions
+*   @author     Sameer Suleman
+*   @date       October 16, 2026
+*
+*******************************************************************************/
+#ifndef SLEEP_H
+#define SLEEP_H
+
+#include <unistd.h>
+#include "xil_types.h"
+
+/* Delays follow the controller's clock, so they cost no real time when
+ * XQSPIPS_HOST_VIRTUAL_TIME is set */
+int XQspiPsHost_Usleep(u32 Us);
+
+#define usleep(Us)          XQspiPsHost_Usleep(Us)
+
+#endif /* SLEEP_H */
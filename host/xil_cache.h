@@ -0,0 +1,22 @@
+/*******************************************************************************
+*   McMaster PRESET (www.mcmasterneudose.ca)
+*
+*   Data Acquisition Module - DAM
+*   Flight Firmware
+*
+*   @file       xil_cache.h
+*   @desc       Host build stand-in for the Xilinx BSP cache maintenance
+*   @author     Sameer Suleman
+*   @date       October 16, 2026
+*
+*******************************************************************************/
+#ifndef XIL_CACHE_H
+#define XIL_CACHE_H
+
+#include "xil_types.h"
+
+/* Host caches are coherent with the emulated flash image */
+static inline void Xil_DCacheInvalidateRange(INTPTR adr, u32 len) { (void)adr; (void)len; }
+static inline void Xil_DCacheFlushRange(INTPTR adr, u32 len) { (void)adr; (void)len; }
+
+#endif /* XIL_CACHE_H */
@@ -0,0 +1,20 @@
+/*******************************************************************************
+*   McMaster PRESET (www.mcmasterneudose.ca)
+*
+*   Data Acquisition Module - DAM
+*   Flight Firmware
+*
+*   @file       xil_printf.h
+*   @desc       Host build stand-in for the Xilinx BSP console output
+*   @author     Sameer Suleman
+*   @date       October 16, 2026
+*
+*******************************************************************************/
+#ifndef XIL_PRINTF_H
+#define XIL_PRINTF_H
+
+#include <stdio.h>
+
+#define xil_printf  printf
+
+#endif /* XIL_PRINTF_H */
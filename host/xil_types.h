@@ -0,0 +1,41 @@
+/*******************************************************************************
+*   McMaster PRESET (www.mcmasterneudose.ca)
+*
+*   Data Acquisition Module - DAM
+*   Flight Firmware
+*
+*   @file       xil_types.h
+*   @desc       Host build stand-in for the Xilinx BSP basic types
+*   @author     Sameer Suleman
+*   @date       October 16, 2026
+*
+*******************************************************************************/
+#ifndef XIL_TYPES_H
+#define XIL_TYPES_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+typedef uint8_t     u8;
+typedef uint16_t    u16;
+typedef uint32_t    u32;
+typedef uint64_t    u64;
+typedef int8_t      s8;
+typedef int16_t     s16;
+typedef int32_t     s32;
+typedef int64_t     s64;
+typedef uintptr_t   UINTPTR;
+typedef intptr_t    INTPTR;
+
+#ifndef TRUE
+#define TRUE        1U
+#endif
+
+#ifndef FALSE
+#define FALSE       0U
+#endif
+
+#define XIL_COMPONENT_IS_READY      0x11111111U
+#define XIL_COMPONENT_IS_STARTED    0x22222222U
+
+#endif /* XIL_TYPES_H */
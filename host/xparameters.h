@@ -0,0 +1,28 @@
+/*******************************************************************************
+*   McMaster PRESET (www.mcmasterneudose.ca)
+*
+*   Data Acquisition Module - DAM
+*   Flight Firmware
+*
+*   @file       xparameters.h
+*   @desc       Host build stand-in for the generated ZedBoard hardware parameters
+*   @author     Sameer Suleman
+*   @date       October 16, 2026
+*
+*******************************************************************************/
+#ifndef XPARAMETERS_H
+#define XPARAMETERS_H
+
+#define XPAR_XQSPIPS_NUM_INSTANCES          1
+#define XPAR_XQSPIPS_0_DEVICE_ID            0
+#define XPAR_XQSPIPS_0_BASEADDR             0xE000D000
+#define XPAR_XQSPIPS_0_QSPI_CLK_FREQ_HZ     200000000
+#define XPAR_XQSPIPS_0_QSPI_MODE            0
+#define XPAR_XQSPIPS_0_INTR                 51
+
+/* The linear window is backed by the emulated flash image on the host */
+#include "xil_types.h"
+UINTPTR XQspiPsHost_LinearBase(void);
+#define XPAR_PS7_QSPI_LINEAR_0_S_AXI_BASEADDR   XQspiPsHost_LinearBase()
+
+#endif /* XPARAMETERS_H */
@@ -0,0 +1,249 @@
+/*******************************************************************************
+*   McMaster PRESET (www.mcmasterneudose.ca)
+*
+*   Data Acquisition Module - DAM
+*   Flight Firmware
+*
+*   @file       xqspips.h
+*   @desc       Host build stand-in for the Xilinx XQspiPs driver
+*   @author     Sameer Suleman
+*   @date       October 16, 2026
+*
+*   <pre>
+*
+*   Mirrors the subset of the XQspiPs API used by pld_qspi.c so the driver
+*   can be built and measured on Linux. Transfers are shifted through an
+*   attached device model at the bus rate derived from the clock prescaler,
+*   and interrupt mode transfers are serviced from a worker thread that
+*   plays the role of the QSPI interrupt line.
+*
+*   The FIFO registers work too: TXD_00 to TXD_11 writes shift 4 or 1 to 3
+*   bytes, RXD returns them (short writes at the top of the word), SR
+*   reports the FIFO levels and CR's SSCTRL drives chip select, for code
+*   that runs the FIFOs itself instead of calling XQspiPs_PolledTransfer.
+*   RXNEMPTY is raised once the RX FIFO reaches the RXWR threshold.
+*
+*   Host only extensions are prefixed XQspiPsHost_.
+*
+*   </pre>
+*
+*******************************************************************************/
+
+/*******************************************************************************
+*   Prevent circular dependency
+*   DO NOT REMOVE
+*******************************************************************************/
+#ifndef XQSPIPS_H
+#define XQSPIPS_H
+
+/*******************************************************************************
+*   Includes
+*******************************************************************************/
+#include "xil_types.h"
+#include "xstatus.h"
+
+/*******************************************************************************
+*   Constant Definitions
+*******************************************************************************/
+/* FIFO depth in 32 bit words */
+#define XQSPIPS_FIFO_DEPTH              63
+
+/* Configuration options */
+#define XQSPIPS_CLK_ACTIVE_LOW_OPTION   0x2
+#define XQSPIPS_CLK_PHASE_1_OPTION      0x4
+#define XQSPIPS_FORCE_SSELECT_OPTION    0x10
+#define XQSPIPS_MANUAL_START_OPTION     0x20
+#define XQSPIPS_LQSPI_MODE_OPTION       0x80
+#define XQSPIPS_HOLD_B_DRIVE_OPTION     0x100
+
+/* Clock prescalers, SCLK = reference clock / (2 << Prescaler) */
+#define XQSPIPS_CLK_PRESCALE_2          0x00
+#define XQSPIPS_CLK_PRESCALE_4          0x01
+#define XQSPIPS_CLK_PRESCALE_8          0x02
+#define XQSPIPS_CLK_PRESCALE_16         0x03
+#define XQSPIPS_CLK_PRESCALE_32         0x04
+#define XQSPIPS_CLK_PRESCALE_64         0x05
+#define XQSPIPS_CLK_PRESCALE_128        0x06
+#define XQSPIPS_CLK_PRESCALE_256        0x07
+
+/* Connection modes */
+#define XQSPIPS_CONNECTION_MODE_SINGLE      0
+#define XQSPIPS_CONNECTION_MODE_STACKED     1
+#define XQSPIPS_CONNECTION_MODE_PARALLEL    2
+
+/* Register offsets */
+#define XQSPIPS_CR_OFFSET               0x00
+#define XQSPIPS_SR_OFFSET               0x04
+#define XQSPIPS_IER_OFFSET              0x08
+#define XQSPIPS_IDR_OFFSET              0x0C
+#define XQSPIPS_IMR_OFFSET              0x10
+#define XQSPIPS_ER_OFFSET               0x14
+#define XQSPIPS_DR_OFFSET               0x18
+#define XQSPIPS_TXD_00_OFFSET           0x1C
+#define XQSPIPS_RXD_OFFSET              0x20
+#define XQSPIPS_SICR_OFFSET             0x24
+#define XQSPIPS_TXWR_OFFSET             0x28
+#define XQSPIPS_RXWR_OFFSET             0x2C
+#define XQSPIPS_GPIO_OFFSET             0x30
+#define XQSPIPS_LPBK_DLY_ADJ_OFFSET     0x38
+#define XQSPIPS_TXD_01_OFFSET           0x80
+#define XQSPIPS_TXD_10_OFFSET           0x84
+#define XQSPIPS_TXD_11_OFFSET           0x88
+#define XQSPIPS_LQSPI_CR_OFFSET         0xA0
+#define XQSPIPS_LQSPI_SR_OFFSET         0xA4
+#define XQSPIPS_MOD_ID_OFFSET           0xFC
+#define XQSPIPS_REG_SPACE               0x100
+
+/* Control register */
+#define XQSPIPS_CR_MANSTRT_MASK         0x00010000      /* Start shifting the TX FIFO (manual start) */
+#define XQSPIPS_CR_MANSTRTEN_MASK       0x00008000      /* Manual start enable */
+#define XQSPIPS_CR_SSFORCE_MASK         0x00004000      /* Manual chip select */
+#define XQSPIPS_CR_SSCTRL_MASK          0x00000400      /* Chip select, 0 asserts it */
+
+/* Status / interrupt register bits */
+#define XQSPIPS_IXR_TXUF_MASK           0x00000040      /* TX FIFO underflow */
+#define XQSPIPS_IXR_RXFULL_MASK         0x00000020      /* RX FIFO full */
+#define XQSPIPS_IXR_RXNEMPTY_MASK       0x00000010      /* RX FIFO not empty */
+#define XQSPIPS_IXR_TXFULL_MASK         0x00000008      /* TX FIFO full */
+#define XQSPIPS_IXR_TXOW_MASK           0x00000004      /* TX FIFO below the watermark */
+#define XQSPIPS_IXR_RXOVR_MASK          0x00000001      /* RX FIFO overflow, write 1 to clear */
+
+/* Linear mode configuration register */
+#define XQSPIPS_LQSPI_CR_LINEAR_MASK    0x80000000
+#define XQSPIPS_LQSPI_CR_TWO_MEM_MASK   0x40000000
+#define XQSPIPS_LQSPI_CR_SEP_BUS_MASK   0x20000000
+#define XQSPIPS_LQSPI_CR_U_PAGE_MASK    0x10000000
+#define XQSPIPS_LQSPI_CR_MODE_EN_MASK   0x02000000
+#define XQSPIPS_LQSPI_CR_MODE_ON_MASK   0x01000000
+#define XQSPIPS_LQSPI_CR_MODE_BITS_MASK 0x00FF0000
+#define XQSPIPS_LQSPI_CR_DUMMY_MASK     0x00000700
+#define XQSPIPS_LQSPI_CR_DUMMY_SHIFT    8
+#define XQSPIPS_LQSPI_CR_INST_MASK      0x000000FF
+
+/* Loopback delay adjust register */
+#define XQSPIPS_LPBK_DLY_ADJ_USE_LPBK_MASK  0x00000020
+
+/* Watermark reset values */
+#define XQSPIPS_TXWR_RESET_VALUE        0x01
+#define XQSPIPS_RXWR_RESET_VALUE        0x01
+
+/*******************************************************************************
+*   Datatype Definitions
+*******************************************************************************/
+typedef void (*XQspiPs_StatusHandler)(void *CallBackRef, u32 StatusEvent, unsigned ByteCount);
+
+typedef struct {
+    u16 DeviceId;
+    u32 BaseAddress;
+    u32 InputClockHz;
+    u8  ConnectionMode;
+} XQspiPs_Config;
+
+typedef struct {
+    XQspiPs_Config Config;
+    u32 IsReady;
+    u8 *SendBufferPtr;
+    u8 *RecvBufferPtr;
+    u32 RequestedBytes;
+    u32 RemainingBytes;
+    u32 IsBusy;
+    XQspiPs_StatusHandler StatusHandler;
+    void *StatusRef;
+    u32 ShiftReadData;
+    u32 IsManualstart;
+    u32 IsManualChipselect;
+} XQspiPs;
+
+/* Device model on the other end of the bus (host only) */
+typedef struct {
+    void *Ref;
+    void (*Select)(void *Ref);                      /* CS asserted */
+    u8   (*Exchange)(void *Ref, u8 TxByte, u32 *Lanes);  /* One byte shifted, Lanes = data lines used */
+    void (*Deselect)(void *Ref);                    /* CS released */
+    u32  (*InData)(void *Ref);                      /* Past command, address and dummy bytes (parallel striping), may be NULL */
+} XQspiPsHost_Device;
+
+/* Bus and interrupt accounting (host only) */
+typedef struct {
+    u64 BusTimeNs;              /* Simulated time the bus spent shifting bytes */
+    u64 BytesShifted;           /* Bytes clocked through the controller */
+    u32 Transfers;              /* CS frames started */
+    u32 Interrupts;             /* Simulated interrupts raised */
+    u64 IsrCpuNs;               /* CPU time spent inside XQspiPs_InterruptHandler */
+    u64 CompletionLatencyNs;    /* Sum of last-byte-on-bus to status handler delays */
+    u64 CompletionLatencyMaxNs; /* Worst completion latency seen */
+    u32 Completions;            /* Interrupt mode transfers completed */
+    u32 FifoRefills;            /* Bus stalls between FIFO loads */
+    u64 FifoGapNs;              /* Simulated time the bus sat idle in those stalls */
+    u32 BitErrors;              /* Read bytes corrupted by the sampling error model */
+    u64 FifoAccesses;           /* SR, CR, RXWR, TXD and RXD accesses made by the CPU, the ones
+                                 * XQspiPs_PolledTransfer and XQspiPs_SetSlaveSelect make included */
+} XQspiPsHost_Stats;
+
+/*******************************************************************************
+*   Macros
+*******************************************************************************/
+#define XQspiPs_ReadReg(BaseAddress, RegOffset) \
+    XQspiPsHost_ReadReg((BaseAddress), (RegOffset))
+#define XQspiPs_WriteReg(BaseAddress, RegOffset, RegisterValue) \
+    XQspiPsHost_WriteReg((BaseAddress), (RegOffset), (RegisterValue))
+
+#define XQspiPs_Enable(InstancePtr) \
+    XQspiPs_WriteReg((InstancePtr)->Config.BaseAddress, XQSPIPS_ER_OFFSET, 1U)
+#define XQspiPs_Disable(InstancePtr) \
+    XQspiPs_WriteReg((InstancePtr)->Config.BaseAddress, XQSPIPS_ER_OFFSET, 0U)
+
+#define XQspiPs_SetTXWatermark(InstancePtr, Value) \
+    XQspiPs_WriteReg((InstancePtr)->Config.BaseAddress, XQSPIPS_TXWR_OFFSET, (Value))
+#define XQspiPs_GetTXWatermark(InstancePtr) \
+    XQspiPs_ReadReg((InstancePtr)->Config.BaseAddress, XQSPIPS_TXWR_OFFSET)
+#define XQspiPs_SetRXWatermark(InstancePtr, Value) \
+    XQspiPs_WriteReg((InstancePtr)->Config.BaseAddress, XQSPIPS_RXWR_OFFSET, (Value))
+#define XQspiPs_GetRXWatermark(InstancePtr) \
+    XQspiPs_ReadReg((InstancePtr)->Config.BaseAddress, XQSPIPS_RXWR_OFFSET)
+
+#define XQspiPs_IsManualStart(InstancePtr)          ((InstancePtr)->IsManualstart)
+#define XQspiPs_IsManualChipSelect(InstancePtr)     ((InstancePtr)->IsManualChipselect)
+
+/*******************************************************************************
+*   Function Prototypes
+*******************************************************************************/
+/* XQspiPs API subset */
+XQspiPs_Config *XQspiPs_LookupConfig(u16 DeviceId);
+s32 XQspiPs_CfgInitialize(XQspiPs *InstancePtr, const XQspiPs_Config *ConfigPtr, u32 EffectiveAddr);
+s32 XQspiPs_SelfTest(XQspiPs *InstancePtr);
+void XQspiPs_Reset(XQspiPs *InstancePtr);
+
+s32 XQspiPs_SetOptions(XQspiPs *InstancePtr, u32 Options);
+u32 XQspiPs_GetOptions(XQspiPs *InstancePtr);
+s32 XQspiPs_SetClkPrescaler(XQspiPs *InstancePtr, u8 Prescaler);
+u8 XQspiPs_GetClkPrescaler(XQspiPs *InstancePtr);
+s32 XQspiPs_SetSlaveSelect(XQspiPs *InstancePtr);
+s32 XQspiPs_SetLqspiConfigReg(XQspiPs *InstancePtr, u32 RegValue);
+u32 XQspiPs_GetLqspiConfigReg(XQspiPs *InstancePtr);
+
+s32 XQspiPs_PolledTransfer(XQspiPs *InstancePtr, u8 *SendBufPtr, u8 *RecvBufPtr, u32 ByteCount);
+s32 XQspiPs_Transfer(XQspiPs *InstancePtr, u8 *SendBufPtr, u8 *RecvBufPtr, u32 ByteCount);
+void XQspiPs_SetStatusHandler(XQspiPs *InstancePtr, void *CallBackRef, XQspiPs_StatusHandler FuncPtr);
+void XQspiPs_InterruptHandler(void *InstancePtr);
+
+/* Register file */
+u32 XQspiPsHost_ReadReg(u32 BaseAddress, u32 RegOffset);
+void XQspiPsHost_WriteReg(u32 BaseAddress, u32 RegOffset, u32 RegisterValue);
+
+/* Host only extensions */
+void XQspiPsHost_AttachDevice(const XQspiPsHost_Device *DevicePtr);
+void XQspiPsHost_AttachUpperDevice(const XQspiPsHost_Device *DevicePtr);
+void XQspiPsHost_SetLinearWindow(u8 *WindowPtr, u32 Size);
+UINTPTR XQspiPsHost_LinearBase(void);
+void XQspiPsHost_GetStats(XQspiPsHost_Stats *StatsPtr);
+void XQspiPsHost_ResetStats(void);
+u64 XQspiPsHost_TimeNs(void);
+void XQspiPsHost_SetTrace(u8 *MosiPtr, u8 *MisoPtr, u32 Size);
+u32 XQspiPsHost_GetTraceLength(void);
+
+/*******************************************************************************
+*   Prevent circular dependency
+*   DO NOT REMOVE
+*******************************************************************************/
+#endif /* XQSPIPS_H */
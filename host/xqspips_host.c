@@ -0,0 +1,1290 @@
+/*******************************************************************************
+*   McMaster PRESET (www.mcmasterneudose.ca)
+*
+*   Data Acquisition Module - DAM
+*   Flight Firmware
+*
+*   @file       xqspips_host.c
+*   @desc       Host build stand-in for the Xilinx XQspiPs driver
+*   @author     Sameer Suleman
+*   @date       October 16, 2026
+*
+*   <pre>
+*
+*   Models a single QSPI controller:
+*   - bytes are exchanged with the attached device model one at a time, and
+*     the bus time of each byte is derived from the reference clock, the
+*     prescaler and the number of data lanes the device reports
+*   - polled transfers spin the calling thread for the bus time, like the
+*     real XQspiPs_PolledTransfer busy-waits on the FIFO. The bus idles
+*     between FIFO loads while the CPU drains RX and refills TX, which is
+*     modelled as a fixed gap after every XQSPIPS_FIFO_DEPTH words
+*   - interrupt mode transfers are shifted by a worker thread which sleeps
+*     for the bus time and raises the TX threshold interrupt each time the
+*     TX FIFO level drops below the programmed watermark
+*
+*   - register level transfers shift each TXD write as it is made, starting
+*     when the bus finishes the previous word, and time stamp the word that
+*     lands in the RX FIFO. SR shows it once the bus gets there (RXNEMPTY
+*     once RXWR words have landed), and RXD reads wait for it. CS follows CR's SSCTRL with manual chip select, and
+*     otherwise drops when the last word is read back. Manual start is not
+*     modelled, words shift as soon as they are written
+*
+*   XQSPIPS_HOST_FIFO_GAP_NS in the environment overrides the FIFO refill
+*   gap. With XQSPIPS_HOST_VIRTUAL_TIME set, nothing waits in real time:
+*   bus time, refill gaps, usleep(), the flash busy periods and FIFO
+*   register accesses (XQSPIPS_HOST_REG_NS each, default 30) advance a
+*   simulated clock, which XTime_GetTime reads back. Runs then finish as
+*   fast as the host allows and repeat exactly, and every timing the
+*   application measures is simulated board time.
+*
+*   Read data sampling fails above 40MHz SCLK unless the loopback clock is
+*   selected in LPBK_DLY_ADJ, and at any SCLK above XQSPIPS_HOST_ERROR_HZ.
+*   Failing samples flip one bit in XQSPIPS_HOST_ERROR_PPM (default 1000)
+*   of the bytes read back, from a fixed seed, so clock tuning can be
+*   exercised repeatably.
+*
+*   XQspiPs_PolledTransfer and XQspiPs_SetSlaveSelect charge the register
+*   accesses the Xilinx driver makes: a CR read-modify-write for chip select
+*   on each side of the frame plus enable and disable, and a TXD write, SR
+*   poll and RXD read per FIFO word. TXD writes overlap the bus and the
+*   drain of each full FIFO is the refill gap, but the driver only drains
+*   RX once TX has run empty, so the last load's drain adds to the bus time
+*   along with the chip select and enable accesses.
+*
+*   XQspiPsHost_SetTrace records every byte clocked (MOSI, and the sampled
+*   MISO) so tests can compare the bus traffic of two code paths exactly.
+*
+*   Unless another device is attached, the controller is wired to the flash
+*   model in flash_emu.c. XQSPIPS_HOST_IMAGE in the environment names its
+*   backing image file (otherwise the image is anonymous and starts erased)
+*   and XQSPIPS_HOST_PART selects the emulated part. With the device
+*   detached, MISO reads back 0xFF (pulled high).
+*
+*   XQSPIPS_HOST_DUAL=parallel or stacked wires a second, identical part as
+*   the upper memory. LQSPI_CR routes I/O mode frames the way the hardware
+*   does: the lower part only without TWO_MEM, the part picked by U_PAGE
+*   when stacked, and both with SEP_BUS (parallel). Parallel frames send
+*   command, address and dummy bytes to both parts, then alternate data
+*   bytes between them, lower first; each pair of data bytes takes one byte
+*   time. The hardware finds the data phase from its own instruction
+*   decoding, the model asks the lower part instead.
+*
+*   </pre>
+*
+*******************************************************************************/
+
+/*******************************************************************************
+*   Includes
+*******************************************************************************/
+#include "xqspips.h"
+
+/* STD Includes */
+#include <pthread.h>
+#include <stdlib.h>
+#include <sys/mman.h>
+#include <sys/prctl.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+/* Xilinx Includes */
+#include "xparameters.h"
+
+/* Host Includes */
+#include "flash_emu.h"
+
+/*******************************************************************************
+*   Preprocessor Macros
+*******************************************************************************/
+#define XQSPIPS_HOST_FIFO_BYTES     (XQSPIPS_FIFO_DEPTH * 4)
+#define XQSPIPS_HOST_LINEAR_MAX     0x1000000U      /* Linear window per part, 3 byte addresses */
+#define XQSPIPS_HOST_LOWER          0x1U            /* Frame targets */
+#define XQSPIPS_HOST_UPPER          0x2U
+#define XQSPIPS_HOST_BOTH           (XQSPIPS_HOST_LOWER | XQSPIPS_HOST_UPPER)
+#define XQSPIPS_HOST_FIFO_GAP_NS    2000U           /* RX drain + TX refill of a full FIFO, ~32 AXI accesses each way */
+#define XQSPIPS_HOST_VIRTUAL_EPOCH  1000000000ULL   /* Simulated clock start, keeps 0 free as a "never" time */
+#define XQSPIPS_HOST_LPBK_MIN_HZ    40000000ULL     /* Fastest SCLK sampled correctly without the loopback clock */
+#define XQSPIPS_HOST_ERROR_PPM      1000U           /* Default corrupted bytes per million while sampling fails */
+#define XQSPIPS_HOST_REG_NS         30U             /* CPU time of one SR / CR / TXD / RXD access */
+#define XQSPIPS_HOST_POLLED_SETUP   6U              /* XQspiPs_PolledTransfer CR and ER accesses per frame */
+#define XQSPIPS_HOST_POLLED_WORD    3U              /* XQspiPs_PolledTransfer TXD, SR and RXD accesses per word */
+#define XQSPIPS_HOST_POLLED_DRAIN   2U              /* Of those, the SR and RXD accesses made after the bus stops */
+
+/*******************************************************************************
+*   Datatype Definitions
+*******************************************************************************/
+/* Word shifted by a TXD write, waiting to be read back through RXD */
+typedef struct {
+    u32 Word;
+    u64 StartNs;                            /* Bus starts shifting it */
+    u64 ReadyNs;                            /* It lands in the RX FIFO */
+} XQspiPsHost_Word_t;
+
+typedef struct {
+    pthread_mutex_t Lock;
+    pthread_cond_t Wake;
+    pthread_t IrqThread;
+    int IrqThreadRunning;
+
+    u32 Regs[XQSPIPS_REG_SPACE / 4];
+    u32 Options;
+    u8 Prescaler;
+
+    XQspiPsHost_Device Device[2];           /* Lower and upper memory */
+    int HasDevice[2];
+    int Selected;
+    u32 Targets;                            /* XQSPIPS_HOST_LOWER / _UPPER of the current frame */
+    u32 DataBytes;                          /* Parallel data bytes shifted in the current frame */
+
+    /* Interrupt mode transfer in flight */
+    XQspiPs *Active;
+    u32 ActiveBytes;
+    u8 TxFifo[XQSPIPS_HOST_FIFO_BYTES];
+    u32 TxHead;
+    u32 TxCount;
+    u8 RxFifo[XQSPIPS_HOST_FIFO_BYTES];
+    u32 RxCount;
+    u64 LastByteNs;
+    u64 BusDeadlineNs;
+
+    /* Register level transfer */
+    XQspiPsHost_Word_t RxWords[XQSPIPS_FIFO_DEPTH];
+    u32 RxWordHead;
+    u32 RxWordCount;
+    u32 FrameWords;                         /* TXD writes since CS was asserted */
+    u64 FifoFreeNs;                         /* Bus done with the last TXD write */
+    u64 FifoCarryPs;                        /* Sub-ns remainder of FifoFreeNs */
+
+    /* Bus trace */
+    u8 *TraceMosi;
+    u8 *TraceMiso;
+    u32 TraceSize;
+    u32 TraceLength;                        /* Bytes clocked since tracing started, may exceed TraceSize */
+
+    /* Linear (XIP) window */
+    u8 *LinearWindow;
+    u32 LinearSize;
+
+    /* Timing model */
+    pthread_once_t TimingOnce;
+    int Virtual;                            /* XQSPIPS_HOST_VIRTUAL_TIME set */
+    u64 VirtualNs;                          /* Simulated clock, atomic */
+    u64 FifoGapNs;
+    u64 RegNs;
+
+    /* Read data sampling errors */
+    u64 ErrorHz;                            /* SCLK above which samples fail, 0 for none */
+    u32 ErrorPpm;
+    u32 ErrorSeed;
+
+    u64 BusTimePs;
+    XQspiPsHost_Stats Stats;
+} XQspiPsHost_t;
+
+/*******************************************************************************
+*   Global Variables
+*******************************************************************************/
+static XQspiPs_Config XQspiPsHost_ConfigTable[XPAR_XQSPIPS_NUM_INSTANCES] = {
+    {
+        XPAR_XQSPIPS_0_DEVICE_ID,
+        XPAR_XQSPIPS_0_BASEADDR,
+        XPAR_XQSPIPS_0_QSPI_CLK_FREQ_HZ,
+        XPAR_XQSPIPS_0_QSPI_MODE
+    }
+};
+
+static FlashEmu_t XQspiPsHost_Flash[2];
+
+static XQspiPsHost_t Host = {
+    .Lock = PTHREAD_MUTEX_INITIALIZER,
+    .Wake = PTHREAD_COND_INITIALIZER,
+    .Prescaler = XQSPIPS_CLK_PRESCALE_8,
+    .TimingOnce = PTHREAD_ONCE_INIT,
+};
+
+/*******************************************************************************
+*   Local Functions
+*******************************************************************************/
+
+/**
+ * Read a clock in nanoseconds
+ */
+static u64 XQspiPsHost_NowNs(clockid_t Clock)
+{
+    struct timespec Ts;
+
+    clock_gettime(Clock, &Ts);
+    return (u64)Ts.tv_sec * 1000000000ULL + (u64)Ts.tv_nsec;
+}
+
+/**
+ * Pick the timing model from the environment, once
+ */
+static void XQspiPsHost_LoadTiming(void)
+{
+    const char *Gap = getenv("XQSPIPS_HOST_FIFO_GAP_NS");
+    const char *ErrorHz = getenv("XQSPIPS_HOST_ERROR_HZ");
+    const char *ErrorPpm = getenv("XQSPIPS_HOST_ERROR_PPM");
+    const char *Reg = getenv("XQSPIPS_HOST_REG_NS");
+
+    Host.FifoGapNs = (Gap != NULL && Gap[0] != '\0') ? strtoull(Gap, NULL, 0) : XQSPIPS_HOST_FIFO_GAP_NS;
+    Host.RegNs = (Reg != NULL && Reg[0] != '\0') ? strtoull(Reg, NULL, 0) : XQSPIPS_HOST_REG_NS;
+    Host.Virtual = (getenv("XQSPIPS_HOST_VIRTUAL_TIME") != NULL);
+    Host.VirtualNs = XQSPIPS_HOST_VIRTUAL_EPOCH;
+    Host.ErrorHz = (ErrorHz != NULL && ErrorHz[0] != '\0') ? strtoull(ErrorHz, NULL, 0) : 0;
+    Host.ErrorPpm = (ErrorPpm != NULL && ErrorPpm[0] != '\0') ? (u32)strtoul(ErrorPpm, NULL, 0) : XQSPIPS_HOST_ERROR_PPM;
+    Host.ErrorSeed = 1;
+}
+
+/**
+ * Make sure the timing model is loaded, safe with or without Lock held
+ */
+static void XQspiPsHost_InitTiming(void)
+{
+    pthread_once(&Host.TimingOnce, XQspiPsHost_LoadTiming);
+}
+
+/**
+ * Move the simulated clock forward to at least DeadlineNs
+ */
+static void XQspiPsHost_AdvanceTo(u64 DeadlineNs)
+{
+    u64 Now = __atomic_load_n(&Host.VirtualNs, __ATOMIC_ACQUIRE);
+
+    while (Now < DeadlineNs &&
+           !__atomic_compare_exchange_n(&Host.VirtualNs, &Now, DeadlineNs, 0, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE)) {
+        // Another thread moved the clock, retry against its value
+    }
+}
+
+/**
+ * Current SCLK frequency
+ */
+static u64 XQspiPsHost_SclkHz(void)
+{
+    return (u64)XQspiPsHost_ConfigTable[0].InputClockHz / (2ULL << Host.Prescaler);
+}
+
+/**
+ * Corrupt a sampled byte when the capture clock can't keep up, Lock held
+ */
+static u8 XQspiPsHost_Sample(u8 RxByte)
+{
+    u64 SclkHz = XQspiPsHost_SclkHz();
+    u32 Loopback = Host.Regs[XQSPIPS_LPBK_DLY_ADJ_OFFSET / 4] & XQSPIPS_LPBK_DLY_ADJ_USE_LPBK_MASK;
+
+    if ((SclkHz > XQSPIPS_HOST_LPBK_MIN_HZ && !Loopback) || (Host.ErrorHz != 0 && SclkHz > Host.ErrorHz)) {
+        if ((u32)rand_r(&Host.ErrorSeed) % 1000000U < Host.ErrorPpm) {
+            RxByte ^= (u8)(1U << (rand_r(&Host.ErrorSeed) & 7));
+            Host.Stats.BitErrors++;
+        }
+    }
+
+    return RxByte;
+}
+
+/**
+ * Memories an I/O mode frame goes to, from the LQSPI_CR memory selection
+ */
+static u32 XQspiPsHost_Targets(void)
+{
+    u32 Config = Host.Regs[XQSPIPS_LQSPI_CR_OFFSET / 4];
+
+    if (!(Config & XQSPIPS_LQSPI_CR_TWO_MEM_MASK)) {
+        return XQSPIPS_HOST_LOWER;
+    }
+
+    if (Config & XQSPIPS_LQSPI_CR_SEP_BUS_MASK) {
+        return XQSPIPS_HOST_BOTH;
+    }
+
+    return (Config & XQSPIPS_LQSPI_CR_U_PAGE_MASK) ? XQSPIPS_HOST_UPPER : XQSPIPS_HOST_LOWER;
+}
+
+/**
+ * Assert chip select towards the device models, Lock held
+ */
+static void XQspiPsHost_Select(void)
+{
+    u32 Index;
+
+    if (!Host.Selected) {
+        Host.Selected = 1;
+        Host.Targets = XQspiPsHost_Targets();
+        Host.DataBytes = 0;
+        Host.FrameWords = 0;
+        Host.Stats.Transfers++;
+        for (Index = 0; Index < 2; Index++) {
+            if ((Host.Targets & (1U << Index)) && Host.HasDevice[Index] && Host.Device[Index].Select != NULL) {
+                Host.Device[Index].Select(Host.Device[Index].Ref);
+            }
+        }
+    }
+}
+
+/**
+ * Release chip select towards the device models, Lock held
+ */
+static void XQspiPsHost_Deselect(void)
+{
+    u32 Index;
+
+    if (Host.Selected) {
+        Host.Selected = 0;
+        for (Index = 0; Index < 2; Index++) {
+            if ((Host.Targets & (1U << Index)) && Host.HasDevice[Index] && Host.Device[Index].Deselect != NULL) {
+                Host.Device[Index].Deselect(Host.Device[Index].Ref);
+            }
+        }
+    }
+}
+
+/**
+ * Clock one byte through the device models, Lock held
+ */
+static u8 XQspiPsHost_Exchange(u8 TxByte, u64 *TimePsPtr)
+{
+    XQspiPsHost_Device *Lower = &Host.Device[0];
+    XQspiPsHost_Device *Upper = &Host.Device[1];
+    u32 Lanes = 1;
+    u32 Unused;
+    u8 RxByte = 0xFF;
+
+    Host.Stats.BytesShifted++;
+
+    if (Host.Targets == XQSPIPS_HOST_BOTH) {
+        if (Host.HasDevice[0] && Lower->InData != NULL && Lower->InData(Lower->Ref)) {
+            // Data phase, odd bytes belong to the upper part and share the lower byte's time
+            if (Host.DataBytes++ & 1U) {
+                return XQspiPsHost_Sample(Host.HasDevice[1] ? Upper->Exchange(Upper->Ref, TxByte, &Unused) : 0xFF);
+            }
+            RxByte = Lower->Exchange(Lower->Ref, TxByte, &Lanes);
+        } else {
+            // Command, address and dummy bytes reach both parts
+            if (Host.HasDevice[1]) {
+                Upper->Exchange(Upper->Ref, TxByte, &Unused);
+            }
+            if (Host.HasDevice[0]) {
+                RxByte = Lower->Exchange(Lower->Ref, TxByte, &Lanes);
+            }
+        }
+    } else if (Host.Targets == XQSPIPS_HOST_UPPER) {
+        if (Host.HasDevice[1]) {
+            RxByte = Upper->Exchange(Upper->Ref, TxByte, &Lanes);
+        }
+    } else if (Host.HasDevice[0]) {
+        RxByte = Lower->Exchange(Lower->Ref, TxByte, &Lanes);
+    }
+
+    *TimePsPtr += (8000000000000ULL / Lanes) / XQspiPsHost_SclkHz();
+
+    return XQspiPsHost_Sample(RxByte);
+}
+
+/**
+ * Clock one byte through the bus, Lock held
+ * Returns the byte sampled on MISO and adds the byte time to *TimePsPtr.
+ */
+static u8 XQspiPsHost_Shift(u8 TxByte, u64 *TimePsPtr)
+{
+    u8 RxByte = XQspiPsHost_Exchange(TxByte, TimePsPtr);
+
+    if (Host.TraceMosi != NULL) {
+        if (Host.TraceLength < Host.TraceSize) {
+            Host.TraceMosi[Host.TraceLength] = TxByte;
+            if (Host.TraceMiso != NULL) {
+                Host.TraceMiso[Host.TraceLength] = RxByte;
+            }
+        }
+        Host.TraceLength++;
+    }
+
+    return RxByte;
+}
+
+/**
+ * Busy-wait until an absolute XQspiPsHost_TimeNs time
+ */
+static void XQspiPsHost_SpinUntil(u64 DeadlineNs)
+{
+    if (Host.Virtual) {
+        XQspiPsHost_AdvanceTo(DeadlineNs);
+        return;
+    }
+
+    while (XQspiPsHost_TimeNs() < DeadlineNs) {
+        // Burn the CPU like a polled FIFO loop would
+    }
+}
+
+/**
+ * Busy-wait for a number of nanoseconds
+ */
+static void XQspiPsHost_Spin(u64 Ns)
+{
+    XQspiPsHost_SpinUntil(XQspiPsHost_TimeNs() + Ns);
+}
+
+/**
+ * Sleep until an absolute XQspiPsHost_TimeNs time
+ */
+static void XQspiPsHost_SleepUntil(u64 DeadlineNs)
+{
+    struct timespec Ts;
+
+    if (Host.Virtual) {
+        XQspiPsHost_AdvanceTo(DeadlineNs);
+        return;
+    }
+
+    Ts.tv_sec = (time_t)(DeadlineNs / 1000000000ULL);
+    Ts.tv_nsec = (long)(DeadlineNs % 1000000000ULL);
+    while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &Ts, NULL) != 0) {
+        // Interrupted, keep sleeping
+    }
+}
+
+/**
+ * Account bus time, Lock held
+ */
+static u64 XQspiPsHost_AddBusTime(u64 TimePs)
+{
+    Host.BusTimePs += TimePs;
+    Host.Stats.BusTimeNs = Host.BusTimePs / 1000ULL;
+    return TimePs / 1000ULL;
+}
+
+/**
+ * Worker thread standing in for the controller's interrupt line
+ * Shifts the TX FIFO out until its level drops below the watermark (or it
+ * empties on the last chunk), waits for the bus time and raises the interrupt.
+ */
+static void *XQspiPsHost_IrqThread(void *Arg)
+{
+    (void)Arg;
+
+    // Wake up on the modelled bus time rather than the default 50us slack
+    prctl(PR_SET_TIMERSLACK, 1UL, 0UL, 0UL, 0UL);
+
+    pthread_mutex_lock(&Host.Lock);
+    for (;;) {
+        XQspiPs *InstancePtr;
+        u64 TimePs = 0;
+        u64 CpuStart;
+        u64 Now;
+        u64 Deadline;
+        u32 Watermark;
+
+        while (Host.Active == NULL || (Host.TxCount == 0 && Host.RxCount == 0)) {
+            pthread_cond_wait(&Host.Wake, &Host.Lock);
+        }
+
+        InstancePtr = Host.Active;
+
+        // The bus stalls while the FIFO is empty, so never run ahead of now
+        Now = XQspiPsHost_TimeNs();
+        if (Host.BusDeadlineNs < Now) {
+            Host.BusDeadlineNs = Now;
+        }
+
+        Watermark = Host.Regs[XQSPIPS_TXWR_OFFSET / 4];
+
+        while (Host.TxCount > 0) {
+            u32 LevelWords = (Host.TxCount + 3) / 4;
+
+            if (LevelWords < Watermark && InstancePtr->RemainingBytes > 0) {
+                break;
+            }
+
+            Host.RxFifo[Host.RxCount++] = XQspiPsHost_Shift(Host.TxFifo[Host.TxHead], &TimePs);
+            Host.TxHead = (Host.TxHead + 1) % XQSPIPS_HOST_FIFO_BYTES;
+            Host.TxCount--;
+        }
+
+        Host.BusDeadlineNs += XQspiPsHost_AddBusTime(TimePs);
+        Deadline = Host.BusDeadlineNs;
+
+        pthread_mutex_unlock(&Host.Lock);
+        XQspiPsHost_SleepUntil(Deadline);
+        pthread_mutex_lock(&Host.Lock);
+
+        Host.LastByteNs = XQspiPsHost_TimeNs();
+        Host.Stats.Interrupts++;
+        pthread_mutex_unlock(&Host.Lock);
+
+        CpuStart = XQspiPsHost_NowNs(CLOCK_THREAD_CPUTIME_ID);
+        XQspiPs_InterruptHandler(InstancePtr);
+
+        pthread_mutex_lock(&Host.Lock);
+        Host.Stats.IsrCpuNs += XQspiPsHost_NowNs(CLOCK_THREAD_CPUTIME_ID) - CpuStart;
+
+        // Host CPU time does not move the simulated clock, so charge the refill gap
+        if (Host.Virtual && Host.Active != NULL) {
+            XQspiPsHost_Spin(Host.FifoGapNs);
+            Host.Stats.FifoRefills++;
+            Host.Stats.FifoGapNs += Host.FifoGapNs;
+        }
+    }
+
+    return NULL;
+}
+
+/**
+ * Build the stacked linear window: the first 16MB of the lower part, then
+ * of the upper part, both mapped from the image so I/O mode writes show up
+ */
+static u8 *XQspiPsHost_MapStackedWindow(int Fd, u32 PartSize)
+{
+    u32 Span = (PartSize < XQSPIPS_HOST_LINEAR_MAX) ? PartSize : XQSPIPS_HOST_LINEAR_MAX;
+    u8 *Window;
+
+    Window = mmap(NULL, 2U * XQSPIPS_HOST_LINEAR_MAX, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+    if (Window == MAP_FAILED) {
+        return NULL;
+    }
+
+    if (mmap(Window, Span, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_FIXED, Fd, 0) == MAP_FAILED ||
+        mmap(Window + XQSPIPS_HOST_LINEAR_MAX, Span, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_FIXED,
+             Fd, (off_t)PartSize) == MAP_FAILED) {
+        munmap(Window, 2U * XQSPIPS_HOST_LINEAR_MAX);
+        return NULL;
+    }
+
+    return Window;
+}
+
+/**
+ * Wire the default flash model(s) to the controller on first use
+ */
+static s32 XQspiPsHost_AttachDefaultFlash(void)
+{
+    const FlashEmu_Part_t *PartPtr;
+    const char *Dual = getenv("XQSPIPS_HOST_DUAL");
+    FlashEmu_t *Lower = &XQspiPsHost_Flash[0];
+    FlashEmu_t *Upper = &XQspiPsHost_Flash[1];
+    u8 *Window;
+    s32 Status;
+
+    if (Host.HasDevice[0] || Lower->Image != NULL) {
+        return XST_SUCCESS;
+    }
+
+    if (Dual != NULL && Dual[0] == '\0') {
+        Dual = NULL;
+    }
+
+    PartPtr = FlashEmu_FindPart(getenv("XQSPIPS_HOST_PART"));
+    if (PartPtr == NULL) {
+        return XST_DEVICE_NOT_FOUND;
+    }
+
+    if (Dual == NULL) {
+        Status = FlashEmu_Open(Lower, getenv("XQSPIPS_HOST_IMAGE"), PartPtr);
+    } else if (strcmp(Dual, "parallel") == 0 || strcmp(Dual, "stacked") == 0) {
+        Status = FlashEmu_OpenPair(Lower, Upper, getenv("XQSPIPS_HOST_IMAGE"), PartPtr, strcmp(Dual, "parallel") == 0);
+    } else {
+        Status = XST_INVALID_PARAM;
+    }
+    if (Status != XST_SUCCESS) {
+        return Status;
+    }
+
+    // Model a large part that only has the bank register
+    if (getenv("XQSPIPS_HOST_NO_4BYTE") != NULL) {
+        FlashEmu_SetNative4Byte(Lower, 0);
+        if (Dual != NULL) {
+            FlashEmu_SetNative4Byte(Upper, 0);
+        }
+    }
+
+    XQspiPsHost_AttachDevice(&Lower->Device);
+
+    // The linear window reaches the first 16MB of each part (3 byte addresses)
+    if (Dual == NULL) {
+        XQspiPsHost_SetLinearWindow(Lower->Image, (Lower->Size < XQSPIPS_HOST_LINEAR_MAX) ? Lower->Size : XQSPIPS_HOST_LINEAR_MAX);
+    } else if (Upper->Stride == 2U) {
+        XQspiPsHost_AttachUpperDevice(&Upper->Device);
+        XQspiPsHost_SetLinearWindow(Lower->Image, (Lower->Size < XQSPIPS_HOST_LINEAR_MAX) ?
+                                    2U * Lower->Size : 2U * XQSPIPS_HOST_LINEAR_MAX);
+    } else {
+        XQspiPsHost_AttachUpperDevice(&Upper->Device);
+        Window = XQspiPsHost_MapStackedWindow(Lower->Fd, Lower->Size);
+        if (Window == NULL) {
+            return XST_FAILURE;
+        }
+        XQspiPsHost_SetLinearWindow(Window, 2U * XQSPIPS_HOST_LINEAR_MAX);
+    }
+
+    return XST_SUCCESS;
+}
+
+/**
+ * Move bytes from the send buffer into the TX FIFO, Lock held
+ */
+static void XQspiPsHost_FillTxFifo(XQspiPs *InstancePtr)
+{
+    while (InstancePtr->RemainingBytes > 0 && Host.TxCount < XQSPIPS_HOST_FIFO_BYTES) {
+        u32 Tail = (Host.TxHead + Host.TxCount) % XQSPIPS_HOST_FIFO_BYTES;
+
+        Host.TxFifo[Tail] = *InstancePtr->SendBufferPtr++;
+        Host.TxCount++;
+        InstancePtr->RemainingBytes--;
+    }
+}
+
+/**
+ * Account one FIFO register access, which costs CPU time on the board
+ */
+static void XQspiPsHost_RegisterAccess(void)
+{
+    XQspiPsHost_InitTiming();
+
+    __atomic_add_fetch(&Host.Stats.FifoAccesses, 1, __ATOMIC_RELAXED);
+    if (Host.Virtual) {
+        XQspiPsHost_AdvanceTo(XQspiPsHost_TimeNs() + Host.RegNs);
+    }
+}
+
+/**
+ * Shift a TXD write of Bytes bytes, Lock held
+ * The word starts when the bus finishes the previous one, or now if the bus
+ * ran dry waiting for it, and its received bytes are queued for RXD.
+ */
+static void XQspiPsHost_PushWord(u32 Word, u32 Bytes)
+{
+    XQspiPsHost_Word_t *Entry;
+    u64 Now = XQspiPsHost_TimeNs();
+    u64 TimePs = 0;
+    u64 Start = Host.FifoFreeNs;
+    u32 Rx = 0;
+    u32 Index;
+
+    XQspiPsHost_Select();
+
+    if (Start < Now) {
+        // The bus idled inside the frame while the CPU got to this word
+        if (Host.FrameWords > 0) {
+            Host.Stats.FifoRefills++;
+            Host.Stats.FifoGapNs += Now - Start;
+        }
+        Start = Now;
+        Host.FifoCarryPs = 0;
+    }
+    Host.FrameWords++;
+
+    for (Index = 0; Index < Bytes; Index++) {
+        Rx |= (u32)XQspiPsHost_Shift((u8)(Word >> (8U * Index)), &TimePs) << (8U * Index);
+    }
+    XQspiPsHost_AddBusTime(TimePs);
+
+    TimePs += Host.FifoCarryPs;
+    Host.FifoFreeNs = Start + TimePs / 1000ULL;
+    Host.FifoCarryPs = TimePs % 1000ULL;
+
+    if (Host.RxWordCount == XQSPIPS_FIFO_DEPTH) {
+        Host.Regs[XQSPIPS_SR_OFFSET / 4] |= XQSPIPS_IXR_RXOVR_MASK;
+        return;
+    }
+
+    // Short writes come back in the top bytes of RXD
+    Entry = &Host.RxWords[(Host.RxWordHead + Host.RxWordCount) % XQSPIPS_FIFO_DEPTH];
+    Entry->Word = Rx << (8U * (4U - Bytes));
+    Entry->StartNs = Start;
+    Entry->ReadyNs = Host.FifoFreeNs;
+    Host.RxWordCount++;
+}
+
+/**
+ * SR as the FIFO levels stand now, Lock held
+ * A status read made while the RX threshold word is still on the bus is
+ * one turn of a polling loop; with the simulated clock it skips ahead to
+ * the word instead.
+ */
+static u32 XQspiPsHost_FifoStatus(void)
+{
+    XQspiPsHost_Word_t *Entry;
+    u64 Now = XQspiPsHost_TimeNs();
+    u32 Status = Host.Regs[XQSPIPS_SR_OFFSET / 4] & XQSPIPS_IXR_RXOVR_MASK;
+    u32 Threshold = Host.Regs[XQSPIPS_RXWR_OFFSET / 4];
+    u32 Queued = 0;
+    u32 Index;
+
+    if (Threshold == 0) {
+        Threshold = 1;
+    }
+
+    if (Host.RxWordCount > 0) {
+        if (Host.RxWordCount >= Threshold) {
+            Entry = &Host.RxWords[(Host.RxWordHead + Threshold - 1U) % XQSPIPS_FIFO_DEPTH];
+            if (Host.Virtual && Entry->ReadyNs > Now) {
+                XQspiPsHost_AdvanceTo(Entry->ReadyNs);
+                Now = Entry->ReadyNs;
+            }
+            if (Entry->ReadyNs <= Now) {
+                Status |= XQSPIPS_IXR_RXNEMPTY_MASK;
+            }
+        }
+
+        for (Index = 0; Index < Host.RxWordCount; Index++) {
+            Entry = &Host.RxWords[(Host.RxWordHead + Index) % XQSPIPS_FIFO_DEPTH];
+            if (Entry->StartNs > Now) {
+                Queued++;
+            }
+        }
+        if (Host.RxWordCount == XQSPIPS_FIFO_DEPTH && Entry->ReadyNs <= Now) {
+            Status |= XQSPIPS_IXR_RXFULL_MASK;
+        }
+    }
+
+    if (Queued < Host.Regs[XQSPIPS_TXWR_OFFSET / 4]) {
+        Status |= XQSPIPS_IXR_TXOW_MASK;
+    }
+    if (Queued >= XQSPIPS_FIFO_DEPTH) {
+        Status |= XQSPIPS_IXR_TXFULL_MASK;
+    }
+
+    return Status;
+}
+
+/**
+ * Pop RXD, waiting for the word if the bus hasn't delivered it yet
+ */
+static u32 XQspiPsHost_PopWord(void)
+{
+    XQspiPsHost_Word_t Entry;
+
+    pthread_mutex_lock(&Host.Lock);
+    if (Host.RxWordCount == 0) {
+        pthread_mutex_unlock(&Host.Lock);
+        return 0;
+    }
+    Entry = Host.RxWords[Host.RxWordHead];
+    Host.RxWordHead = (Host.RxWordHead + 1U) % XQSPIPS_FIFO_DEPTH;
+    Host.RxWordCount--;
+    pthread_mutex_unlock(&Host.Lock);
+
+    XQspiPsHost_SpinUntil(Entry.ReadyNs);
+
+    // Without manual chip select the frame ends once the FIFOs run empty
+    pthread_mutex_lock(&Host.Lock);
+    if (!(Host.Regs[XQSPIPS_CR_OFFSET / 4] & XQSPIPS_CR_SSFORCE_MASK) && Host.RxWordCount == 0 && Host.Active == NULL) {
+        XQspiPsHost_Deselect();
+    }
+    pthread_mutex_unlock(&Host.Lock);
+
+    return Entry.Word;
+}
+
+/**
+ * CR write, drives chip select from SSCTRL under manual chip select
+ * Releasing CS waits for the bus to finish the words already written.
+ */
+static void XQspiPsHost_WriteControl(u32 RegisterValue)
+{
+    u64 Deadline;
+
+    pthread_mutex_lock(&Host.Lock);
+    Host.Regs[XQSPIPS_CR_OFFSET / 4] = RegisterValue & ~XQSPIPS_CR_MANSTRT_MASK;
+    if ((RegisterValue & XQSPIPS_CR_SSFORCE_MASK) && Host.Active == NULL) {
+        if (!(RegisterValue & XQSPIPS_CR_SSCTRL_MASK)) {
+            XQspiPsHost_Select();
+        } else if (Host.Selected) {
+            Deadline = Host.FifoFreeNs;
+            pthread_mutex_unlock(&Host.Lock);
+            XQspiPsHost_SpinUntil(Deadline);
+            pthread_mutex_lock(&Host.Lock);
+            XQspiPsHost_Deselect();
+        }
+    }
+    pthread_mutex_unlock(&Host.Lock);
+}
+
+/*******************************************************************************
+*   Functions
+*******************************************************************************/
+
+XQspiPs_Config *XQspiPs_LookupConfig(u16 DeviceId)
+{
+    u32 Index;
+
+    for (Index = 0; Index < XPAR_XQSPIPS_NUM_INSTANCES; Index++) {
+        if (XQspiPsHost_ConfigTable[Index].DeviceId == DeviceId) {
+            return &XQspiPsHost_ConfigTable[Index];
+        }
+    }
+
+    return NULL;
+}
+
+s32 XQspiPs_CfgInitialize(XQspiPs *InstancePtr, const XQspiPs_Config *ConfigPtr, u32 EffectiveAddr)
+{
+    s32 Status;
+
+    if (InstancePtr->IsBusy == TRUE && InstancePtr->IsReady == XIL_COMPONENT_IS_READY) {
+        return XST_DEVICE_BUSY;
+    }
+
+    Status = XQspiPsHost_AttachDefaultFlash();
+    if (Status != XST_SUCCESS) {
+        return Status;
+    }
+
+    memset(InstancePtr, 0, sizeof(*InstancePtr));
+    InstancePtr->Config = *ConfigPtr;
+    InstancePtr->Config.BaseAddress = EffectiveAddr;
+    InstancePtr->IsReady = XIL_COMPONENT_IS_READY;
+
+    XQspiPs_Reset(InstancePtr);
+
+    return XST_SUCCESS;
+}
+
+s32 XQspiPs_SelfTest(XQspiPs *InstancePtr)
+{
+    (void)InstancePtr;
+    return XST_SUCCESS;
+}
+
+void XQspiPs_Reset(XQspiPs *InstancePtr)
+{
+    (void)InstancePtr;
+
+    pthread_mutex_lock(&Host.Lock);
+    memset(Host.Regs, 0, sizeof(Host.Regs));
+    Host.Regs[XQSPIPS_TXWR_OFFSET / 4] = XQSPIPS_TXWR_RESET_VALUE;
+    Host.Regs[XQSPIPS_RXWR_OFFSET / 4] = XQSPIPS_RXWR_RESET_VALUE;
+    Host.Regs[XQSPIPS_CR_OFFSET / 4] = XQSPIPS_CR_SSCTRL_MASK;
+    Host.Options = 0;
+    Host.Prescaler = XQSPIPS_CLK_PRESCALE_8;
+    Host.TxHead = 0;
+    Host.TxCount = 0;
+    Host.RxCount = 0;
+    Host.RxWordHead = 0;
+    Host.RxWordCount = 0;
+    Host.FifoFreeNs = 0;
+    Host.FifoCarryPs = 0;
+    Host.Active = NULL;
+    XQspiPsHost_Deselect();
+    pthread_mutex_unlock(&Host.Lock);
+}
+
+s32 XQspiPs_SetOptions(XQspiPs *InstancePtr, u32 Options)
+{
+    if (InstancePtr->IsBusy) {
+        return XST_DEVICE_BUSY;
+    }
+
+    Host.Options = Options;
+
+    // Mirror the CR bits the options map to, like the real driver
+    pthread_mutex_lock(&Host.Lock);
+    Host.Regs[XQSPIPS_CR_OFFSET / 4] &= ~(XQSPIPS_CR_SSFORCE_MASK | XQSPIPS_CR_MANSTRTEN_MASK);
+    if (Options & XQSPIPS_FORCE_SSELECT_OPTION) {
+        Host.Regs[XQSPIPS_CR_OFFSET / 4] |= XQSPIPS_CR_SSFORCE_MASK;
+    }
+    if (Options & XQSPIPS_MANUAL_START_OPTION) {
+        Host.Regs[XQSPIPS_CR_OFFSET / 4] |= XQSPIPS_CR_MANSTRTEN_MASK;
+    }
+    pthread_mutex_unlock(&Host.Lock);
+
+    InstancePtr->IsManualChipselect = (Options & XQSPIPS_FORCE_SSELECT_OPTION) ? TRUE : FALSE;
+    InstancePtr->IsManualstart = (Options & XQSPIPS_MANUAL_START_OPTION) ? TRUE : FALSE;
+
+    return XST_SUCCESS;
+}
+
+u32 XQspiPs_GetOptions(XQspiPs *InstancePtr)
+{
+    (void)InstancePtr;
+    return Host.Options;
+}
+
+s32 XQspiPs_SetClkPrescaler(XQspiPs *InstancePtr, u8 Prescaler)
+{
+    if (InstancePtr->IsBusy) {
+        return XST_DEVICE_BUSY;
+    }
+
+    if (Prescaler > XQSPIPS_CLK_PRESCALE_256) {
+        return XST_INVALID_PARAM;
+    }
+
+    Host.Prescaler = Prescaler;
+    return XST_SUCCESS;
+}
+
+u8 XQspiPs_GetClkPrescaler(XQspiPs *InstancePtr)
+{
+    (void)InstancePtr;
+    return Host.Prescaler;
+}
+
+s32 XQspiPs_SetSlaveSelect(XQspiPs *InstancePtr)
+{
+    if (InstancePtr->IsBusy) {
+        return XST_DEVICE_BUSY;
+    }
+
+    // Only latches the select value (a CR read-modify-write), the frame
+    // starts with the first byte
+    XQspiPsHost_RegisterAccess();
+    XQspiPsHost_RegisterAccess();
+    return XST_SUCCESS;
+}
+
+s32 XQspiPs_PolledTransfer(XQspiPs *InstancePtr, u8 *SendBufPtr, u8 *RecvBufPtr, u32 ByteCount)
+{
+    u64 TimePs = 0;
+    u64 BusNs;
+    u64 GapNs;
+    u64 CpuNs;
+    u32 Words = (ByteCount + 3U) / 4U;
+    u32 Index;
+
+    if (SendBufPtr == NULL || ByteCount == 0) {
+        return XST_INVALID_PARAM;
+    }
+
+    if (InstancePtr->IsBusy) {
+        return XST_DEVICE_BUSY;
+    }
+
+    XQspiPsHost_InitTiming();
+
+    __atomic_add_fetch(&Host.Stats.FifoAccesses, XQSPIPS_HOST_POLLED_SETUP + (u64)Words * XQSPIPS_HOST_POLLED_WORD,
+                       __ATOMIC_RELAXED);
+    CpuNs = 0;
+    if (Host.Virtual) {
+        CpuNs = (XQSPIPS_HOST_POLLED_SETUP + ((Words - 1U) % XQSPIPS_FIFO_DEPTH + 1U) * XQSPIPS_HOST_POLLED_DRAIN) *
+                Host.RegNs;
+    }
+
+    pthread_mutex_lock(&Host.Lock);
+    XQspiPsHost_Select();
+    for (Index = 0; Index < ByteCount; Index++) {
+        u8 RxByte = XQspiPsHost_Shift(SendBufPtr[Index], &TimePs);
+
+        if (RecvBufPtr != NULL) {
+            RecvBufPtr[Index] = RxByte;
+        }
+    }
+    XQspiPsHost_Deselect();
+    BusNs = XQspiPsHost_AddBusTime(TimePs);
+
+    // The bus idles while each full FIFO is drained and the next one loaded
+    GapNs = ((ByteCount - 1U) / XQSPIPS_HOST_FIFO_BYTES) * Host.FifoGapNs;
+    Host.Stats.FifoRefills += (ByteCount - 1U) / XQSPIPS_HOST_FIFO_BYTES;
+    Host.Stats.FifoGapNs += GapNs;
+    pthread_mutex_unlock(&Host.Lock);
+
+    XQspiPsHost_Spin(BusNs + GapNs + CpuNs);
+
+    return XST_SUCCESS;
+}
+
+s32 XQspiPs_Transfer(XQspiPs *InstancePtr, u8 *SendBufPtr, u8 *RecvBufPtr, u32 ByteCount)
+{
+    if (SendBufPtr == NULL || ByteCount == 0) {
+        return XST_INVALID_PARAM;
+    }
+
+    if (InstancePtr->IsBusy) {
+        return XST_DEVICE_BUSY;
+    }
+
+    pthread_mutex_lock(&Host.Lock);
+
+    if (!Host.IrqThreadRunning) {
+        if (pthread_create(&Host.IrqThread, NULL, XQspiPsHost_IrqThread, NULL) != 0) {
+            pthread_mutex_unlock(&Host.Lock);
+            return XST_FAILURE;
+        }
+        pthread_detach(Host.IrqThread);
+        Host.IrqThreadRunning = 1;
+    }
+
+    XQspiPsHost_InitTiming();
+
+    InstancePtr->IsBusy = TRUE;
+    InstancePtr->SendBufferPtr = SendBufPtr;
+    InstancePtr->RecvBufferPtr = RecvBufPtr;
+    InstancePtr->RequestedBytes = ByteCount;
+    InstancePtr->RemainingBytes = ByteCount;
+
+    Host.Active = InstancePtr;
+    Host.ActiveBytes = ByteCount;
+    XQspiPsHost_Select();
+    XQspiPsHost_FillTxFifo(InstancePtr);
+
+    pthread_cond_signal(&Host.Wake);
+    pthread_mutex_unlock(&Host.Lock);
+
+    return XST_SUCCESS;
+}
+
+void XQspiPs_SetStatusHandler(XQspiPs *InstancePtr, void *CallBackRef, XQspiPs_StatusHandler FuncPtr)
+{
+    InstancePtr->StatusHandler = FuncPtr;
+    InstancePtr->StatusRef = CallBackRef;
+}
+
+void XQspiPs_InterruptHandler(void *InstancePtr)
+{
+    XQspiPs *QspiPtr = (XQspiPs *)InstancePtr;
+    u32 Index;
+    u32 Done;
+    u32 ByteCount = 0;
+
+    pthread_mutex_lock(&Host.Lock);
+
+    // Drain the RX FIFO
+    for (Index = 0; Index < Host.RxCount; Index++) {
+        if (QspiPtr->RecvBufferPtr != NULL) {
+            *QspiPtr->RecvBufferPtr++ = Host.RxFifo[Index];
+        }
+    }
+    QspiPtr->RequestedBytes -= Host.RxCount;
+    Host.RxCount = 0;
+
+    // Refill the TX FIFO
+    XQspiPsHost_FillTxFifo(QspiPtr);
+
+    Done = (QspiPtr->RequestedBytes == 0);
+    if (Done) {
+        u64 Latency = XQspiPsHost_TimeNs() - Host.LastByteNs;
+
+        XQspiPsHost_Deselect();
+        Host.Active = NULL;
+        QspiPtr->IsBusy = FALSE;
+
+        Host.Stats.Completions++;
+        Host.Stats.CompletionLatencyNs += Latency;
+        if (Latency > Host.Stats.CompletionLatencyMaxNs) {
+            Host.Stats.CompletionLatencyMaxNs = Latency;
+        }
+        ByteCount = Host.ActiveBytes;
+    }
+
+    pthread_mutex_unlock(&Host.Lock);
+
+    if (Done && QspiPtr->StatusHandler != NULL) {
+        QspiPtr->StatusHandler(QspiPtr->StatusRef, XST_SPI_TRANSFER_DONE, ByteCount);
+    }
+}
+
+s32 XQspiPs_SetLqspiConfigReg(XQspiPs *InstancePtr, u32 RegValue)
+{
+    if (InstancePtr->IsBusy) {
+        return XST_DEVICE_BUSY;
+    }
+
+    XQspiPs_WriteReg(InstancePtr->Config.BaseAddress, XQSPIPS_LQSPI_CR_OFFSET, RegValue);
+    return XST_SUCCESS;
+}
+
+u32 XQspiPs_GetLqspiConfigReg(XQspiPs *InstancePtr)
+{
+    return XQspiPs_ReadReg(InstancePtr->Config.BaseAddress, XQSPIPS_LQSPI_CR_OFFSET);
+}
+
+u32 XQspiPsHost_ReadReg(u32 BaseAddress, u32 RegOffset)
+{
+    u32 Value;
+
+    (void)BaseAddress;
+
+    switch (RegOffset) {
+    case XQSPIPS_SR_OFFSET:
+        XQspiPsHost_RegisterAccess();
+        pthread_mutex_lock(&Host.Lock);
+        Value = XQspiPsHost_FifoStatus();
+        pthread_mutex_unlock(&Host.Lock);
+        return Value;
+
+    case XQSPIPS_RXD_OFFSET:
+        XQspiPsHost_RegisterAccess();
+        return XQspiPsHost_PopWord();
+
+    default:
+        return Host.Regs[(RegOffset % XQSPIPS_REG_SPACE) / 4];
+    }
+}
+
+void XQspiPsHost_WriteReg(u32 BaseAddress, u32 RegOffset, u32 RegisterValue)
+{
+    (void)BaseAddress;
+
+    switch (RegOffset) {
+    case XQSPIPS_CR_OFFSET:
+        XQspiPsHost_RegisterAccess();
+        XQspiPsHost_WriteControl(RegisterValue);
+        break;
+
+    case XQSPIPS_SR_OFFSET:
+        Host.Regs[XQSPIPS_SR_OFFSET / 4] &= ~RegisterValue;
+        break;
+
+    case XQSPIPS_RXWR_OFFSET:
+        XQspiPsHost_RegisterAccess();
+        Host.Regs[XQSPIPS_RXWR_OFFSET / 4] = RegisterValue;
+        break;
+
+    case XQSPIPS_TXD_00_OFFSET:
+    case XQSPIPS_TXD_01_OFFSET:
+    case XQSPIPS_TXD_10_OFFSET:
+    case XQSPIPS_TXD_11_OFFSET:
+        XQspiPsHost_RegisterAccess();
+        pthread_mutex_lock(&Host.Lock);
+        XQspiPsHost_PushWord(RegisterValue, (RegOffset == XQSPIPS_TXD_00_OFFSET) ? 4U :
+                             (RegOffset - XQSPIPS_TXD_01_OFFSET) / 4U + 1U);
+        pthread_mutex_unlock(&Host.Lock);
+        break;
+
+    default:
+        Host.Regs[(RegOffset % XQSPIPS_REG_SPACE) / 4] = RegisterValue;
+        break;
+    }
+}
+
+/**
+ * Attach the device model clocked by the controller (NULL detaches)
+ */
+void XQspiPsHost_AttachDevice(const XQspiPsHost_Device *DevicePtr)
+{
+    pthread_mutex_lock(&Host.Lock);
+    if (DevicePtr != NULL) {
+        Host.Device[0] = *DevicePtr;
+        Host.HasDevice[0] = 1;
+    } else {
+        Host.HasDevice[0] = 0;
+    }
+    pthread_mutex_unlock(&Host.Lock);
+}
+
+/**
+ * Attach the upper memory of a dual stacked or parallel pair (NULL detaches)
+ */
+void XQspiPsHost_AttachUpperDevice(const XQspiPsHost_Device *DevicePtr)
+{
+    pthread_mutex_lock(&Host.Lock);
+    if (DevicePtr != NULL) {
+        Host.Device[1] = *DevicePtr;
+        Host.HasDevice[1] = 1;
+    } else {
+        Host.HasDevice[1] = 0;
+    }
+    pthread_mutex_unlock(&Host.Lock);
+}
+
+/**
+ * Back the linear (XIP) window with host memory, normally the flash image
+ */
+void XQspiPsHost_SetLinearWindow(u8 *WindowPtr, u32 Size)
+{
+    Host.LinearWindow = WindowPtr;
+    Host.LinearSize = Size;
+}
+
+/**
+ * Base of the linear window, stands in for XPAR_PS7_QSPI_LINEAR_0_S_AXI_BASEADDR
+ */
+UINTPTR XQspiPsHost_LinearBase(void)
+{
+    return (UINTPTR)Host.LinearWindow;
+}
+
+/**
+ * Snapshot the bus and interrupt accounting
+ */
+void XQspiPsHost_GetStats(XQspiPsHost_Stats *StatsPtr)
+{
+    pthread_mutex_lock(&Host.Lock);
+    *StatsPtr = Host.Stats;
+    pthread_mutex_unlock(&Host.Lock);
+}
+
+/**
+ * Clear the bus and interrupt accounting
+ */
+void XQspiPsHost_ResetStats(void)
+{
+    pthread_mutex_lock(&Host.Lock);
+    memset(&Host.Stats, 0, sizeof(Host.Stats));
+    Host.BusTimePs = 0;
+    pthread_mutex_unlock(&Host.Lock);
+}
+
+/**
+ * Record the bytes clocked from now on, Size of each in MosiPtr and MisoPtr
+ * (MisoPtr may be NULL). A NULL MosiPtr stops recording.
+ */
+void XQspiPsHost_SetTrace(u8 *MosiPtr, u8 *MisoPtr, u32 Size)
+{
+    pthread_mutex_lock(&Host.Lock);
+    Host.TraceMosi = MosiPtr;
+    Host.TraceMiso = MisoPtr;
+    Host.TraceSize = (MosiPtr != NULL) ? Size : 0;
+    Host.TraceLength = 0;
+    pthread_mutex_unlock(&Host.Lock);
+}
+
+/**
+ * Bytes clocked since XQspiPsHost_SetTrace, including any past its Size
+ */
+u32 XQspiPsHost_GetTraceLength(void)
+{
+    u32 Length;
+
+    pthread_mutex_lock(&Host.Lock);
+    Length = Host.TraceLength;
+    pthread_mutex_unlock(&Host.Lock);
+
+    return Length;
+}
+
+/**
+ * Controller time in nanoseconds, CLOCK_MONOTONIC or the simulated clock
+ */
+u64 XQspiPsHost_TimeNs(void)
+{
+    XQspiPsHost_InitTiming();
+
+    if (Host.Virtual) {
+        return __atomic_load_n(&Host.VirtualNs, __ATOMIC_ACQUIRE);
+    }
+
+    return XQspiPsHost_NowNs(CLOCK_MONOTONIC);
+}
+
+/**
+ * usleep() of the host build, advances the simulated clock instead of
+ * sleeping when XQSPIPS_HOST_VIRTUAL_TIME is set
+ */
+int XQspiPsHost_Usleep(u32 Us)
+{
+    XQspiPsHost_InitTiming();
+
+    if (Host.Virtual) {
+        XQspiPsHost_AdvanceTo(XQspiPsHost_TimeNs() + (u64)Us * 1000ULL);
+        return 0;
+    }
+
+    return usleep(Us);
+}
+
+/**
+ * Flash model attached by default, NULL if another device was attached
+ */
+FlashEmu_t *XQspiPsHost_GetFlash(void)
+{
+    return (XQspiPsHost_Flash[0].Image != NULL) ? &XQspiPsHost_Flash[0] : NULL;
+}
+
+/**
+ * Upper flash model of a default dual configuration, NULL with a single part
+ */
+FlashEmu_t *XQspiPsHost_GetUpperFlash(void)
+{
+    return (XQspiPsHost_Flash[1].Image != NULL) ? &XQspiPsHost_Flash[1] : NULL;
+}
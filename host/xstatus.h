@@ -0,0 +1,42 @@
+/*******************************************************************************
+*   McMaster PRESET (www.mcmasterneudose.ca)
+*
+*   Data Acquisition Module - DAM
+*   Flight Firmware
+*
+*   @file       xstatus.h
+*   @desc       Host build stand-in for the Xilinx BSP status codes
+*   @author     Sameer Suleman
+*   @date       October 16, 2026
+*
+*******************************************************************************/
+#ifndef XSTATUS_H
+#define XSTATUS_H
+
+#include "xil_types.h"
+
+typedef s32 XStatus;
+
+/* Common status codes, values match the Xilinx BSP */
+#define XST_SUCCESS                 0L
+#define XST_FAILURE                 1L
+#define XST_DEVICE_NOT_FOUND        2L
+#define XST_BUFFER_TOO_SMALL        12L
+#define XST_NO_DATA                 13L
+#define XST_INVALID_PARAM           15L
+#define XST_NO_FEATURE              19L
+#define XST_DEVICE_BUSY             21L
+#define XST_DATA_LOST               26L
+#define XST_RECV_ERROR              27L
+#define XST_SEND_ERROR              28L
+#define XST_NOT_ENABLED             29L
+#define XST_TIMEOUT                 31L
+
+/* SPI status codes */
+#define XST_SPI_MODE_FAULT          1151
+#define XST_SPI_TRANSFER_DONE       1152
+#define XST_SPI_TRANSMIT_UNDERRUN   1153
+#define XST_SPI_RECEIVE_OVERRUN     1154
+#define XST_SPI_NO_SLAVE            1155
+
+#endif /* XSTATUS_H */
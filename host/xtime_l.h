@@ -0,0 +1,31 @@
+/*******************************************************************************
+*   McMaster PRESET (www.mcmasterneudose.ca)
+*
+*   Data Acquisition Module - DAM
+*   Flight Firmware
+*
+*   @file       xtime_l.h
+*   @desc       Host build stand-in for the Xilinx global timer API
+*   @author     Sameer Suleman
+*   @date       October 16, 2026
+*
+*******************************************************************************/
+#ifndef XTIME_L_H
+#define XTIME_L_H
+
+#include "xil_types.h"
+
+typedef u64 XTime;
+
+/* The host global timer counts the controller's nanoseconds: CLOCK_MONOTONIC,
+ * or simulated time when XQSPIPS_HOST_VIRTUAL_TIME is set */
+#define COUNTS_PER_SECOND   1000000000ULL
+
+u64 XQspiPsHost_TimeNs(void);
+
+static inline void XTime_GetTime(XTime *Xtime_Global)
+{
+    *Xtime_Global = (XTime)XQspiPsHost_TimeNs();
+}
+
+#endif /* XTIME_L_H */
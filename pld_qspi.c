@@ -19,6 +19,32 @@
 *	1.0.0	sam		2025-02-24	Initial commit to dev branch
 *   1.0.1   sam     2025-03-17  Finalized changes based on Graham's feedback
 *   1.1.0   sam     2025-09-27  Cleaned up to only include functions used by helloworld.c
+*   1.2.0   sam     2026-10-16  Interrupt-driven asynchronous transfers
+*   1.3.0   sam     2026-10-16  Linear (XIP) memory-mapped read mode
+*   1.4.0   sam     2026-10-16  Streaming reads with framing stripped in place
+*   1.5.0   sam     2026-10-16  Page program write engine with adaptive WIP polling
+*   1.6.0   sam     2026-10-16  Erase planner and background erase-ahead
+*   1.7.0   sam     2026-10-16  4 byte addressing and cached bank register
+*   1.8.0   sam     2026-10-16  Dual parallel and dual stacked flash configurations
+*   1.9.0   sam     2026-10-16  Flash modification callback for read caches
+*   1.10.0  sam     2026-10-16  Optional transfer instrumentation (PLD_QSPI_STATS)
+*   1.11.0  sam     2026-10-16  Clock prescaler auto-tuning with loopback clock selection
+*   1.12.0  sam     2026-10-16  Vectored transfers, zero-copy polled reads and page programs
+*   1.13.0  sam     2026-10-16  Word-wide FIFO engine for every polled transfer, fixed layout reads
+*   1.14.0  sam     2026-10-16  CRC32C checked reads folded into the FIFO drain
+*   1.15.0  sam     2026-10-16  Blank checking and skipped erases of blank blocks
+*   1.16.0  sam     2026-10-16  Differential region updates rewriting only changed sectors
+*   1.17.0  sam     2026-10-16  Erase suspend / resume so reads preempt background erases
+*   1.18.0  sam     2026-10-16  Non-blocking page programs for the acquisition pipeline
+*   1.18.1  sam     2026-10-17  Erase suspends wait out the whole resume interval
+*   1.18.2  sam     2026-10-17  Settled background erases poll from their remaining time
+*   1.18.3  sam     2026-10-17  Chip erase weighed against the walk of the whole flash
+*   1.18.4  sam     2026-10-17  Writes report their own status, not the background erase's
+*   1.18.5  sam     2026-10-17  PLD_QSPI_NowUs exported as the time base of the modules
+*   1.18.6  sam     2026-10-17  Erase run time kept across suspends, suspends polled from tSUS
+*   1.18.7  sam     2026-10-17  Started page programs settle from the rest of their tPP estimate
+*   1.18.8  sam     2026-10-17  PLD_QSPI_EraseAheadRemainingUs for callers waiting out a background erase
+*   1.18.9  sam     2026-10-17  Erase marked suspended once the suspend is sent, suspend wait floored
 *	</pre>
 *******************************************************************************/
 
@@ -26,6 +52,7 @@
 *   Includes
 *******************************************************************************/
 #include "pld_qspi.h"
+#include "pld_qspi_crc.h"
 
 /* STD Includes */
 #include <string.h>
@@ -34,52 +61,317 @@
 #include "xparameters.h"
 #include "xqspips.h"
 #include "xil_printf.h"
+#include "xil_cache.h"
+#include "xtime_l.h"
+#include "sleep.h"
 #include <xil_types.h>
 #include <xstatus.h>
 
+/*******************************************************************************
+*   Preprocessor Macros
+*******************************************************************************/
+/* Instrumentation hooks. Without PLD_QSPI_STATS the timer is never read and
+ * the recording disappears, leaving only the start time variables. */
+#ifdef PLD_QSPI_STATS
+#define PLD_QSPI_STATS_STAMP()          PLD_QSPI_StatsStamp()
+#define PLD_QSPI_STATS_RECORD(InstancePtr, Op, Start, Bytes, Status) \
+    PLD_QSPI_StatsRecord((InstancePtr), (Op), (Start), (Bytes), (Status))
+#else
+#define PLD_QSPI_STATS_STAMP()          0U
+#define PLD_QSPI_STATS_RECORD(InstancePtr, Op, Start, Bytes, Status) ((void)(Start), (void)(Bytes))
+#endif
+
+/* PLD_QSPI_Compare results */
+#define PLD_QSPI_CHANGE_DIFFERS         0x01U           /* Some byte differs */
+#define PLD_QSPI_CHANGE_ERASE           0x02U           /* Some bit goes from 0 to 1, only an erase can do that */
+
+/*******************************************************************************
+*   Datatype Definitions
+*******************************************************************************/
+/* Position in a PLD_QSPI_TransferV segment list */
+typedef struct {
+    const PLD_QSPI_Segment_t *Segment;
+    const PLD_QSPI_Segment_t *End;
+    uint32_t Offset;                        /* Bytes of Segment already moved */
+} PLD_QSPI_Cursor_t;
+
+/* Marked (dirty, changed or erased) granules of an erase block, bit n
+ * covers Base + n * Granule */
+typedef struct {
+    uint32_t Base;
+    uint32_t Granule;
+    uint32_t Bits[PLD_QSPI_BLANK_MAP_WORDS];
+} PLD_QSPI_BlankMap_t;
+
+/*******************************************************************************
+*   Global Variables
+*******************************************************************************/
+/* TXD register for a FIFO write of 1, 2, 3 or 4 bytes */
+static const uint32_t PLD_QSPI_TxdOffset[5] = {
+    0, XQSPIPS_TXD_01_OFFSET, XQSPIPS_TXD_10_OFFSET, XQSPIPS_TXD_11_OFFSET, XQSPIPS_TXD_00_OFFSET
+};
+
+/*******************************************************************************
+*   Local Function Prototypes
+*******************************************************************************/
+static void PLD_QSPI_StatusHandler(void *CallBackRef, u32 StatusEvent, unsigned ByteCount);
+static uint32_t PLD_QSPI_BuildReadHeader(PLD_QSPI_t *InstancePtr, uint32_t Address, uint8_t *Frame);
+static XStatus PLD_QSPI_ReadDirect(PLD_QSPI_t *InstancePtr, uint32_t Address, uint8_t *Buffer, uint32_t Length,
+                                   uint32_t *CrcPtr);
+static void PLD_QSPI_CursorSkip(PLD_QSPI_Cursor_t *CursorPtr);
+static uint32_t PLD_QSPI_PackWord(PLD_QSPI_Cursor_t *CursorPtr, uint32_t Size);
+static void PLD_QSPI_UnpackWord(PLD_QSPI_Cursor_t *CursorPtr, uint32_t Word, uint32_t Size);
+static XStatus PLD_QSPI_FifoTransfer(PLD_QSPI_t *InstancePtr, const PLD_QSPI_Segment_t *Segments,
+                                     uint32_t Count, uint32_t Total);
+static uint32_t PLD_QSPI_FifoBatch(uint32_t InFlight, uint32_t Last);
+static void PLD_QSPI_FifoBegin(PLD_QSPI_t *InstancePtr);
+static void PLD_QSPI_FifoWait(PLD_QSPI_t *InstancePtr, uint32_t Words);
+static void PLD_QSPI_FifoEnd(PLD_QSPI_t *InstancePtr);
+static uint32_t PLD_QSPI_LoadWord(const uint8_t *Bytes, uint32_t Size);
+static XStatus PLD_QSPI_HeaderRead(PLD_QSPI_t *InstancePtr, const uint8_t *Header, uint32_t HeaderLength,
+                                   uint8_t *Buffer, uint32_t Length, uint32_t *CrcPtr);
+static void PLD_QSPI_CacheControl(PLD_QSPI_t *InstancePtr);
+static XStatus PLD_QSPI_ApplyClock(PLD_QSPI_t *InstancePtr, uint8_t Prescaler);
+static XStatus PLD_QSPI_ReadSignature(PLD_QSPI_t *InstancePtr, uint32_t Address, uint32_t Length,
+                                      uint32_t *SignaturePtr);
+static uint32_t PLD_QSPI_AddressLimit(PLD_QSPI_t *InstancePtr);
+static uint32_t PLD_QSPI_TargetSize(PLD_QSPI_t *InstancePtr);
+static uint32_t PLD_QSPI_DeviceAddress(PLD_QSPI_t *InstancePtr, uint32_t Address);
+static uint32_t PLD_QSPI_PutAddress(PLD_QSPI_t *InstancePtr, uint32_t Address, uint8_t *Frame);
+static XStatus PLD_QSPI_SelectDevice(PLD_QSPI_t *InstancePtr, uint32_t Device);
+static XStatus PLD_QSPI_SelectBank(PLD_QSPI_t *InstancePtr, uint32_t Address);
+static uint32_t PLD_QSPI_ReadSpan(PLD_QSPI_t *InstancePtr, uint32_t Address, uint32_t Length);
+static uint32_t PLD_QSPI_ReadChunk(PLD_QSPI_t *InstancePtr, uint32_t Address, uint32_t Length);
+static XStatus PLD_QSPI_SendAddressCmd(PLD_QSPI_t *InstancePtr, uint8_t Cmd, uint32_t Address);
+static uint32_t PLD_QSPI_BlockCostUs(PLD_QSPI_t *InstancePtr, uint32_t Level);
+static uint32_t PLD_QSPI_PickEraseLevel(PLD_QSPI_t *InstancePtr, uint32_t Address, uint32_t Length);
+static XStatus PLD_QSPI_ScanBlank(PLD_QSPI_t *InstancePtr, uint32_t Address, uint32_t Length,
+                                  uint32_t Granule, uint32_t *BlankPtr, uint32_t *DirtyMap);
+static uint32_t PLD_QSPI_Erased(const uint8_t *Data, uint32_t Length);
+static uint32_t PLD_QSPI_DirtyBlocks(const PLD_QSPI_BlankMap_t *MapPtr, uint32_t Address, uint32_t Length,
+                                     uint32_t Size);
+static void PLD_QSPI_MapInit(PLD_QSPI_BlankMap_t *MapPtr, uint32_t Base, uint32_t Length, uint32_t Granule);
+static void PLD_QSPI_MapMark(PLD_QSPI_BlankMap_t *MapPtr, uint32_t Address, uint32_t Length);
+static XStatus PLD_QSPI_EraseBlock(PLD_QSPI_t *InstancePtr, uint32_t Address, uint32_t Level,
+                                   uint32_t Execute, PLD_QSPI_BlankMap_t *MapPtr, uint32_t RewriteUs,
+                                   uint32_t *CostUsPtr);
+static XStatus PLD_QSPI_UpdateBlock(PLD_QSPI_t *InstancePtr, uint32_t Address, uint32_t Level,
+                                    const uint8_t *Data, PLD_QSPI_Update_t *UpdatePtr);
+static uint32_t PLD_QSPI_Compare(const uint8_t *Old, const uint8_t *New, uint32_t Length);
+static XStatus PLD_QSPI_ErasePlan(PLD_QSPI_t *InstancePtr, uint32_t Address, uint32_t Length,
+                                  uint32_t Execute, uint32_t ChipErase, uint32_t *CostUsPtr);
+static uint32_t PLD_QSPI_RemainingUs(uint32_t TypicalUs, uint32_t StartUs);
+static XStatus PLD_QSPI_SettleEraseAhead(PLD_QSPI_t *InstancePtr);
+static XStatus PLD_QSPI_PauseEraseAhead(PLD_QSPI_t *InstancePtr);
+static XStatus PLD_QSPI_ResumeEraseAhead(PLD_QSPI_t *InstancePtr);
+static XStatus PLD_QSPI_SelectEraseAhead(PLD_QSPI_t *InstancePtr);
+static XStatus PLD_QSPI_SelectFlashOf(PLD_QSPI_t *InstancePtr, uint32_t Address);
+static XStatus PLD_QSPI_SettleProgram(PLD_QSPI_t *InstancePtr);
+static void PLD_QSPI_NotifyModify(PLD_QSPI_t *InstancePtr, uint32_t Address, uint32_t Length);
+static uint32_t PLD_QSPI_BuildProgramHeader(PLD_QSPI_t *InstancePtr, uint32_t Address, uint8_t *Frame);
+static XStatus PLD_QSPI_StreamChunks(PLD_QSPI_t *InstancePtr, uint32_t Address, uint32_t Length,
+                                     PLD_QSPI_Sink_t Sink, void *Ctx);
+#ifdef PLD_QSPI_STATS
+static uint64_t PLD_QSPI_StatsStamp(void);
+static void PLD_QSPI_StatsRecord(PLD_QSPI_t *InstancePtr, uint32_t Op, uint64_t Start, uint32_t Bytes, XStatus Status);
+#endif
+
 /*******************************************************************************
 *   Functions
 *******************************************************************************/
 
+/**
+ * Fill a flash description with conservative defaults
+ * A 128Mbit part with 256 byte pages, 1-1-4 quad output reads and 4KB/64KB
+ * erases, which every part we fit supports.
+ */
+void PLD_QSPI_FlashDefaults(PLD_QSPI_Flash_t *FlashPtr)
+{
+    memset(FlashPtr, 0, sizeof(*FlashPtr));
+
+    FlashPtr->Name = "unknown";
+    FlashPtr->Size = PLD_QSPI_DEFAULT_FLASH_SIZE;
+    FlashPtr->PageSize = PLD_QSPI_DEFAULT_PAGE_SIZE;
+    FlashPtr->ReadCmd = PLD_QSPI_CMD_QUAD_READ;
+    FlashPtr->ReadDummyBytes = 1;
+    FlashPtr->LinearReadCmd = PLD_QSPI_CMD_QUAD_READ;
+    FlashPtr->LinearDummyBytes = 1;
+    FlashPtr->ProgramCmd = PLD_QSPI_CMD_PAGE_PROGRAM;
+    FlashPtr->ProgramTimeUs = PLD_QSPI_DEFAULT_TPP_US;
+    FlashPtr->ProgramTimeMaxUs = PLD_QSPI_DEFAULT_TPP_MAX_US;
+
+    FlashPtr->Erase[0].Size = 0x1000U;
+    FlashPtr->Erase[0].Cmd = PLD_QSPI_CMD_ERASE_4K;
+    FlashPtr->Erase[0].TimeUs = PLD_QSPI_DEFAULT_T4K_US;
+    FlashPtr->Erase[0].TimeMaxUs = PLD_QSPI_DEFAULT_T4K_MAX_US;
+    FlashPtr->Erase[1].Size = 0x10000U;
+    FlashPtr->Erase[1].Cmd = PLD_QSPI_CMD_ERASE_64K;
+    FlashPtr->Erase[1].TimeUs = PLD_QSPI_DEFAULT_T64K_US;
+    FlashPtr->Erase[1].TimeMaxUs = PLD_QSPI_DEFAULT_T64K_MAX_US;
+    FlashPtr->EraseTypes = 2;
+    FlashPtr->ChipEraseTimeUs = PLD_QSPI_DEFAULT_TCE_US;
+    FlashPtr->ChipEraseTimeMaxUs = PLD_QSPI_DEFAULT_TCE_MAX_US;
+}
+
+/**
+ * Fill an open-time configuration with the usual settings
+ * A single flash, SCLK at the reference clock divided by 8, manual chip
+ * select and HOLD driven high.
+ */
+void PLD_QSPI_ConfigDefaults(PLD_QSPI_Config_t *ConfigPtr)
+{
+    ConfigPtr->ConnectionMode = PLD_QSPI_CONNECTION_SINGLE;
+    ConfigPtr->Prescaler = XQSPIPS_CLK_PRESCALE_8;
+    ConfigPtr->Options = XQSPIPS_FORCE_SSELECT_OPTION | XQSPIPS_HOLD_B_DRIVE_OPTION;
+}
+
+/**
+ * Install the description of the attached flash
+ * FlashPtr describes one flash. With two flashes in parallel every page and
+ * erase block is split across both, so the size, page size and erase sizes
+ * are doubled. Two stacked flashes double the size only. Timings are per
+ * operation and don't change.
+ */
+void PLD_QSPI_SetFlash(PLD_QSPI_t *InstancePtr, const PLD_QSPI_Flash_t *FlashPtr)
+{
+    uint32_t Index;
+
+    InstancePtr->Flash = *FlashPtr;
+    InstancePtr->DeviceSize = FlashPtr->Size;
+
+    if (InstancePtr->ConnectionMode == PLD_QSPI_CONNECTION_PARALLEL) {
+        InstancePtr->Flash.Size *= 2U;
+        InstancePtr->Flash.PageSize *= 2U;
+        for (Index = 0; Index < InstancePtr->Flash.EraseTypes; Index++) {
+            InstancePtr->Flash.Erase[Index].Size *= 2U;
+        }
+    } else if (InstancePtr->ConnectionMode == PLD_QSPI_CONNECTION_STACKED) {
+        InstancePtr->Flash.Size *= 2U;
+    }
+
+    InstancePtr->ProgramEstUs = InstancePtr->Flash.ProgramTimeUs;
+    for (Index = 0; Index < PLD_QSPI_MAX_DEVICES; Index++) {
+        InstancePtr->Bank[Index] = PLD_QSPI_BANK_UNKNOWN;
+    }
+}
+
 /**
  * Initialize the QSPI driver
+ * ConfigPtr selects the flash wiring and the clock and I/O options (see
+ * PLD_QSPI_ConfigDefaults). NULL keeps a single flash and leaves the clock
+ * and options at the controller's reset values.
  * Note: This function uses the SDT/non-SDT initialization pattern for compatibility
  */
 #ifndef SDT
-XStatus PLD_QSPI_Open(PLD_QSPI_t *InstancePtr, uint16_t SpiDevId)
+XStatus PLD_QSPI_Open(PLD_QSPI_t *InstancePtr, uint16_t SpiDevId, const PLD_QSPI_Config_t *ConfigPtr)
 #else
-XStatus PLD_QSPI_Open(PLD_QSPI_t *InstancePtr, UINTPTR SpiBaseAddr)
+XStatus PLD_QSPI_Open(PLD_QSPI_t *InstancePtr, UINTPTR SpiBaseAddr, const PLD_QSPI_Config_t *ConfigPtr)
 #endif
 {
     XStatus Status;
-    XQspiPs_Config *ConfigPtr;
+    XQspiPs_Config *QspiConfigPtr;
+    PLD_QSPI_Flash_t Flash;
 
     // Prevent initializing the same SPI device twice
-    if (InstancePtr->IsReady == XIL_COMPONENT_IS_READY) {
+    if (InstancePtr->Qspi.IsReady == XIL_COMPONENT_IS_READY) {
         return XST_SUCCESS;
     }
 
+    if (ConfigPtr != NULL && ConfigPtr->ConnectionMode != PLD_QSPI_CONNECTION_SINGLE &&
+        ConfigPtr->ConnectionMode != PLD_QSPI_CONNECTION_STACKED &&
+        ConfigPtr->ConnectionMode != PLD_QSPI_CONNECTION_PARALLEL) {
+        return XST_INVALID_PARAM;
+    }
+
 #ifndef SDT
-    ConfigPtr = XQspiPs_LookupConfig(SpiDevId);
+    QspiConfigPtr = XQspiPs_LookupConfig(SpiDevId);
 #else
-    ConfigPtr = XQspiPs_LookupConfig(SpiBaseAddr);
+    QspiConfigPtr = XQspiPs_LookupConfig(SpiBaseAddr);
 #endif
     
-    if (ConfigPtr == NULL) {
+    if (QspiConfigPtr == NULL) {
         return XST_DEVICE_NOT_FOUND;
     }
 
-    Status = XQspiPs_CfgInitialize(InstancePtr, ConfigPtr, ConfigPtr->BaseAddress);
+    Status = XQspiPs_CfgInitialize(&InstancePtr->Qspi, QspiConfigPtr, QspiConfigPtr->BaseAddress);
+    if (Status != XST_SUCCESS) {
+        return Status;
+    }
+
+    Status = XQspiPs_SelfTest(&InstancePtr->Qspi);
     if (Status != XST_SUCCESS) {
         return Status;
     }
 
-    Status = XQspiPs_SelfTest(InstancePtr);
+    InstancePtr->ConnectionMode = PLD_QSPI_CONNECTION_SINGLE;
+    if (ConfigPtr != NULL) {
+        InstancePtr->ConnectionMode = ConfigPtr->ConnectionMode;
+
+        Status = PLD_QSPI_ApplyClock(InstancePtr, ConfigPtr->Prescaler);
+        if (Status != XST_SUCCESS) {
+            return Status;
+        }
+
+        Status = XQspiPs_SetOptions(&InstancePtr->Qspi, ConfigPtr->Options);
+        if (Status != XST_SUCCESS) {
+            return Status;
+        }
+    }
+    InstancePtr->Qspi.Config.ConnectionMode = InstancePtr->ConnectionMode;
+
+    // Parallel flashes share CS with a bus each, stacked flashes share the
+    // bus and U_PAGE picks the one I/O mode commands go to
+    if (InstancePtr->ConnectionMode == PLD_QSPI_CONNECTION_PARALLEL) {
+        InstancePtr->IoConfig = XQSPIPS_LQSPI_CR_TWO_MEM_MASK | XQSPIPS_LQSPI_CR_SEP_BUS_MASK;
+    } else if (InstancePtr->ConnectionMode == PLD_QSPI_CONNECTION_STACKED) {
+        InstancePtr->IoConfig = XQSPIPS_LQSPI_CR_TWO_MEM_MASK;
+    } else {
+        InstancePtr->IoConfig = 0;
+    }
+
+    Status = XQspiPs_SetLqspiConfigReg(&InstancePtr->Qspi, InstancePtr->IoConfig);
     if (Status != XST_SUCCESS) {
         return Status;
     }
+    InstancePtr->Device = 0;
+
+    // Conservative defaults until PLD_QSPI_Identify reads the part
+    PLD_QSPI_FlashDefaults(&Flash);
+    PLD_QSPI_SetFlash(InstancePtr, &Flash);
+    InstancePtr->ProgramLastUs = 0;
+    InstancePtr->ProgramPending = 0;
+    InstancePtr->EraseAheadNext = 0;
+    InstancePtr->EraseAheadEnd = 0;
+    InstancePtr->EraseAheadLevel = 0;
+    InstancePtr->EraseAheadSuspended = 0;
+    InstancePtr->EraseAheadResumeUs = 0;
+    InstancePtr->EraseAheadRunUs = 0;
+    InstancePtr->UseSuspend = 1;
+    InstancePtr->Suspends = 0;
+    InstancePtr->BlankCheck = 0;
+    InstancePtr->EraseSkips = 0;
+    InstancePtr->EraseSkippedUs = 0;
+    InstancePtr->LinearMode = 0;
+    InstancePtr->IoOptions = 0;
+
+    // Route interrupt mode completions back through this driver
+    InstancePtr->AsyncCallback = NULL;
+    InstancePtr->AsyncCallbackRef = NULL;
+    InstancePtr->AsyncBusy = 0;
+    InstancePtr->AsyncStatus = XST_SUCCESS;
+    InstancePtr->UseInterrupts = 0;
+    InstancePtr->ModifyCallback = NULL;
+    InstancePtr->ModifyCallbackRef = NULL;
+    InstancePtr->AsyncStart = 0;
+    InstancePtr->EraseAheadStart = 0;
+    memset(&InstancePtr->Tune, 0, sizeof(InstancePtr->Tune));
+    PLD_QSPI_ResetStats(InstancePtr);
+    XQspiPs_SetStatusHandler(&InstancePtr->Qspi, InstancePtr, PLD_QSPI_StatusHandler);
+    XQspiPs_SetTXWatermark(&InstancePtr->Qspi, PLD_QSPI_ASYNC_TX_WATERMARK);
+    InstancePtr->RxThreshold = XQSPIPS_RXWR_RESET_VALUE;
 
-    XQspiPs_Enable(InstancePtr);
+    XQspiPs_Enable(&InstancePtr->Qspi);
+    PLD_QSPI_CacheControl(InstancePtr);
     
     return XST_SUCCESS;
 }
@@ -100,10 +392,147 @@ XStatus PLD_QSPI_Open(PLD_QSPI_t *InstancePtr, UINTPTR SpiBaseAddr)
 
 /**
  * Set clock prescaler for QSPI
+ * The loopback clock is switched on with it when SCLK goes above
+ * PLD_QSPI_LOOPBACK_MIN_HZ.
  */
 XStatus PLD_QSPI_SetClockPrescalar(PLD_QSPI_t *InstancePtr, uint8_t Prescaler)
 {
-    return XQspiPs_SetClkPrescaler(InstancePtr, Prescaler);
+    return PLD_QSPI_ApplyClock(InstancePtr, Prescaler);
+}
+
+/**
+ * Find the fastest SCLK the board reads reliably
+ * The prescaler in use when called is taken as safe. The region at Address
+ * is read twice there to get its signature, then Passes times at each
+ * faster prescaler, stopping at the first step with a mismatch. The clock
+ * is left PLD_QSPI_TUNE_MARGIN steps slower than the fastest clean step
+ * (never slower than the start) and the result is kept in InstancePtr->Tune.
+ * Any region works, but one with mixed data catches more sampling errors
+ * than erased flash.
+ */
+XStatus PLD_QSPI_AutoTune(PLD_QSPI_t *InstancePtr, uint32_t Address, uint32_t Length, uint32_t Passes)
+{
+    XStatus Status;
+    uint8_t Safe;
+    uint8_t Fastest;
+    uint8_t Prescaler;
+    uint32_t Signature;
+    uint32_t Check;
+    uint32_t Pass;
+
+    if (InstancePtr->Qspi.IsReady != XIL_COMPONENT_IS_READY) {
+        return XST_DEVICE_NOT_FOUND;
+    }
+
+    if (Length == 0 || Passes == 0) {
+        return XST_INVALID_PARAM;
+    }
+
+    Safe = XQspiPs_GetClkPrescaler(&InstancePtr->Qspi);
+
+    // The starting clock must agree with itself, or there is nothing to compare against
+    Status = PLD_QSPI_ReadSignature(InstancePtr, Address, Length, &Signature);
+    if (Status != XST_SUCCESS) {
+        return Status;
+    }
+    Status = PLD_QSPI_ReadSignature(InstancePtr, Address, Length, &Check);
+    if (Status != XST_SUCCESS) {
+        return Status;
+    }
+    if (Check != Signature) {
+        return XST_FAILURE;
+    }
+
+    Fastest = Safe;
+    for (Prescaler = Safe; Prescaler > XQSPIPS_CLK_PRESCALE_2; ) {
+        Prescaler--;
+
+        Status = PLD_QSPI_ApplyClock(InstancePtr, Prescaler);
+        if (Status != XST_SUCCESS) {
+            break;
+        }
+
+        for (Pass = 0; Pass < Passes; Pass++) {
+            Status = PLD_QSPI_ReadSignature(InstancePtr, Address, Length, &Check);
+            if (Status != XST_SUCCESS || Check != Signature) {
+                break;
+            }
+        }
+        if (Pass < Passes) {
+            break;
+        }
+
+        Fastest = Prescaler;
+    }
+
+    Prescaler = ((uint32_t)(Safe - Fastest) > PLD_QSPI_TUNE_MARGIN) ? (uint8_t)(Fastest + PLD_QSPI_TUNE_MARGIN) : Safe;
+    Status = PLD_QSPI_ApplyClock(InstancePtr, Prescaler);
+    if (Status != XST_SUCCESS) {
+        return Status;
+    }
+
+    InstancePtr->Tune.Tuned = 1;
+    InstancePtr->Tune.Prescaler = Prescaler;
+    InstancePtr->Tune.FastestPrescaler = Fastest;
+    InstancePtr->Tune.Loopback = (XQspiPs_ReadReg(InstancePtr->Qspi.Config.BaseAddress, XQSPIPS_LPBK_DLY_ADJ_OFFSET) &
+                                  XQSPIPS_LPBK_DLY_ADJ_USE_LPBK_MASK) ? 1U : 0U;
+    InstancePtr->Tune.Signature = Signature;
+
+    return XST_SUCCESS;
+}
+
+/**
+ * Program the prescaler and the matching read data capture clock
+ * Above PLD_QSPI_LOOPBACK_MIN_HZ data is sampled on the loopback clock,
+ * which follows the SCLK pad delay instead of the internal clock.
+ */
+static XStatus PLD_QSPI_ApplyClock(PLD_QSPI_t *InstancePtr, uint8_t Prescaler)
+{
+    XStatus Status;
+    uint32_t SclkHz;
+
+    Status = XQspiPs_SetClkPrescaler(&InstancePtr->Qspi, Prescaler);
+    if (Status != XST_SUCCESS) {
+        return Status;
+    }
+
+    SclkHz = InstancePtr->Qspi.Config.InputClockHz / (2U << Prescaler);
+    XQspiPs_WriteReg(InstancePtr->Qspi.Config.BaseAddress, XQSPIPS_LPBK_DLY_ADJ_OFFSET,
+                     (SclkHz > PLD_QSPI_LOOPBACK_MIN_HZ) ? XQSPIPS_LPBK_DLY_ADJ_USE_LPBK_MASK : 0U);
+
+    // The prescaler lives in CR
+    PLD_QSPI_CacheControl(InstancePtr);
+
+    return XST_SUCCESS;
+}
+
+/**
+ * Refresh the controller setup the polled transfer engine keeps in the handle
+ * Saves a CR read and the option lookups on every transfer. Must follow
+ * every clock or option change the driver makes.
+ */
+static void PLD_QSPI_CacheControl(PLD_QSPI_t *InstancePtr)
+{
+    InstancePtr->BaseAddress = InstancePtr->Qspi.Config.BaseAddress;
+    InstancePtr->Control = XQspiPs_ReadReg(InstancePtr->BaseAddress, XQSPIPS_CR_OFFSET) | XQSPIPS_CR_SSCTRL_MASK;
+    InstancePtr->ManualCs = XQspiPs_IsManualChipSelect(&InstancePtr->Qspi) ? 1U : 0U;
+    InstancePtr->ManualStart = XQspiPs_IsManualStart(&InstancePtr->Qspi) ? 1U : 0U;
+}
+
+/**
+ * CRC32C of a flash range at the current clock
+ */
+static XStatus PLD_QSPI_ReadSignature(PLD_QSPI_t *InstancePtr, uint32_t Address, uint32_t Length,
+                                      uint32_t *SignaturePtr)
+{
+    XStatus Status;
+    XStatus Resume;
+
+    *SignaturePtr = 0;
+    Status = PLD_QSPI_ReadDirect(InstancePtr, Address, NULL, Length, SignaturePtr);
+    Resume = PLD_QSPI_ResumeEraseAhead(InstancePtr);
+
+    return (Status != XST_SUCCESS) ? Status : Resume;
 }
 
 /**
@@ -111,7 +540,12 @@ XStatus PLD_QSPI_SetClockPrescalar(PLD_QSPI_t *InstancePtr, uint8_t Prescaler)
  */
 XStatus PLD_QSPI_SetOptionsManually(PLD_QSPI_t *InstancePtr, uint32_t options)
 {
-    return XQspiPs_SetOptions(InstancePtr, options);
+    XStatus Status;
+
+    Status = XQspiPs_SetOptions(&InstancePtr->Qspi, options);
+    PLD_QSPI_CacheControl(InstancePtr);
+
+    return Status;
 }
 
 /**
@@ -119,37 +553,2694 @@ XStatus PLD_QSPI_SetOptionsManually(PLD_QSPI_t *InstancePtr, uint32_t options)
  */
 XStatus PLD_QSPI_Close(PLD_QSPI_t *InstancePtr)
 {
-    XQspiPs_Disable(InstancePtr);
+    if (InstancePtr->LinearMode) {
+        PLD_QSPI_DisableLinearMode(InstancePtr);
+    }
+
+    XQspiPs_Disable(&InstancePtr->Qspi);
     return XST_SUCCESS;
 }
 
 /**
  * Perform QSPI transfer (polled mode)
+ * Runs on the driver's own FIFO engine rather than XQspiPs_PolledTransfer,
+ * which re-reads the options, re-selects the slave, looks the opcode up in
+ * its instruction table and polls status around every word.
  */
 XStatus PLD_QSPI_Transfer(PLD_QSPI_t *InstancePtr, uint8_t *WriteData, uint8_t *ReadData, uint32_t DataLength)
 {
     XStatus Status;
+    PLD_QSPI_Segment_t Segment;
+    uint64_t Start;
 
     // Check if driver is ready
-    if (InstancePtr->IsReady != XIL_COMPONENT_IS_READY) {
+    if (InstancePtr->Qspi.IsReady != XIL_COMPONENT_IS_READY) {
         return XST_DEVICE_NOT_FOUND;
     }
 
-    // Check if manual chip select is enabled
-    uint32_t ShouldCS = XQspiPs_GetOptions(InstancePtr) & XQSPIPS_FORCE_SSELECT_OPTION;
+    // The controller cannot run a polled transfer under an async one or in linear mode
+    if (InstancePtr->AsyncBusy || InstancePtr->LinearMode) {
+        return XST_DEVICE_BUSY;
+    }
 
-    if (ShouldCS) {
-        Status = XQspiPs_SetSlaveSelect(InstancePtr);
-        if (Status != XST_SUCCESS) {
-            return Status;
+    // A NULL WriteData clocks out 0xFF, like a PLD_QSPI_TransferV segment
+    if (DataLength == 0) {
+        return XST_INVALID_PARAM;
+    }
+
+    Segment.Tx = WriteData;
+    Segment.Rx = ReadData;
+    Segment.Length = DataLength;
+
+    Start = PLD_QSPI_STATS_STAMP();
+    Status = PLD_QSPI_FifoTransfer(InstancePtr, &Segment, 1U, DataLength);
+    PLD_QSPI_STATS_RECORD(InstancePtr, PLD_QSPI_OP_TRANSFER, Start, DataLength, Status);
+
+    return Status;
+}
+
+/**
+ * Perform a QSPI transfer made of several buffers (polled mode)
+ * The segments are clocked back to back under one chip select, each sending
+ * from and receiving into its own buffers, so a command header, dummy cycles
+ * and a payload of any size need no staging frame. Frames longer than the
+ * FIFO need manual chip select (XQSPIPS_FORCE_SSELECT_OPTION, the default).
+ */
+XStatus PLD_QSPI_TransferV(PLD_QSPI_t *InstancePtr, const PLD_QSPI_Segment_t *Segments, uint32_t Count)
+{
+    XStatus Status;
+    uint32_t Total = 0;
+    uint32_t Index;
+    uint64_t Start;
+
+    // Check if driver is ready
+    if (InstancePtr->Qspi.IsReady != XIL_COMPONENT_IS_READY) {
+        return XST_DEVICE_NOT_FOUND;
+    }
+
+    if (InstancePtr->AsyncBusy || InstancePtr->LinearMode) {
+        return XST_DEVICE_BUSY;
+    }
+
+    if (Segments == NULL || Count == 0) {
+        return XST_INVALID_PARAM;
+    }
+
+    for (Index = 0; Index < Count; Index++) {
+        if (Segments[Index].Length > UINT32_MAX - Total) {
+            return XST_INVALID_PARAM;
         }
+        Total += Segments[Index].Length;
     }
 
-    // Use polled mode operation
-    Status = XQspiPs_PolledTransfer(InstancePtr, WriteData, ReadData, DataLength);
-    if (Status != XST_SUCCESS) {
-        return Status;
+    if (Total == 0) {
+        return XST_INVALID_PARAM;
+    }
+
+    Start = PLD_QSPI_STATS_STAMP();
+    Status = PLD_QSPI_FifoTransfer(InstancePtr, Segments, Count, Total);
+    PLD_QSPI_STATS_RECORD(InstancePtr, PLD_QSPI_OP_TRANSFER, Start, Total, Status);
+
+    return Status;
+}
+
+/**
+ * Move a cursor off exhausted (and empty) segments
+ */
+static void PLD_QSPI_CursorSkip(PLD_QSPI_Cursor_t *CursorPtr)
+{
+    while (CursorPtr->Segment < CursorPtr->End && CursorPtr->Offset == CursorPtr->Segment->Length) {
+        CursorPtr->Segment++;
+        CursorPtr->Offset = 0;
+    }
+}
+
+/**
+ * Gather the next Size bytes of a segment list into a TXD word, first byte lowest
+ */
+static uint32_t PLD_QSPI_PackWord(PLD_QSPI_Cursor_t *CursorPtr, uint32_t Size)
+{
+    const PLD_QSPI_Segment_t *Segment;
+    uint32_t Word = 0;
+    uint32_t Byte;
+
+    PLD_QSPI_CursorSkip(CursorPtr);
+    Segment = CursorPtr->Segment;
+
+    // Whole words inside one buffer are a single (unaligned) load
+    if (Size == 4U && Segment->Length - CursorPtr->Offset >= 4U) {
+        if (Segment->Tx != NULL) {
+            memcpy(&Word, &Segment->Tx[CursorPtr->Offset], 4U);
+        } else {
+            Word = 0xFFFFFFFFU;
+        }
+        CursorPtr->Offset += 4U;
+        return Word;
+    }
+
+    for (Byte = 0; Byte < Size; Byte++) {
+        PLD_QSPI_CursorSkip(CursorPtr);
+        Segment = CursorPtr->Segment;
+        Word |= (uint32_t)((Segment->Tx != NULL) ? Segment->Tx[CursorPtr->Offset] : 0xFFU) << (8U * Byte);
+        CursorPtr->Offset++;
+    }
+
+    return Word;
+}
+
+/**
+ * Scatter Size received bytes, first byte lowest, into a segment list
+ */
+static void PLD_QSPI_UnpackWord(PLD_QSPI_Cursor_t *CursorPtr, uint32_t Word, uint32_t Size)
+{
+    const PLD_QSPI_Segment_t *Segment;
+    uint32_t Byte;
+
+    PLD_QSPI_CursorSkip(CursorPtr);
+    Segment = CursorPtr->Segment;
+
+    if (Size == 4U && Segment->Length - CursorPtr->Offset >= 4U) {
+        if (Segment->Rx != NULL) {
+            memcpy(&Segment->Rx[CursorPtr->Offset], &Word, 4U);
+        }
+        CursorPtr->Offset += 4U;
+        return;
+    }
+
+    for (Byte = 0; Byte < Size; Byte++) {
+        PLD_QSPI_CursorSkip(CursorPtr);
+        Segment = CursorPtr->Segment;
+        if (Segment->Rx != NULL) {
+            Segment->Rx[CursorPtr->Offset] = (uint8_t)Word;
+        }
+        Word >>= 8;
+        CursorPtr->Offset++;
+    }
+}
+
+/**
+ * Body of PLD_QSPI_TransferV, runs the controller FIFOs directly
+ * Words are packed from and unpacked into the segments on the fly. The
+ * first write carries the odd bytes of the first segment (1 to 3 bytes
+ * through TXD_01 to TXD_11), so the segment after a command header starts
+ * word aligned, and the last write carries what is left. The TX FIFO is
+ * kept topped up, never more words in flight than the RX FIFO holds, and
+ * RX is drained a batch (PLD_QSPI_FifoBatch) per status poll.
+ */
+static XStatus PLD_QSPI_FifoTransfer(PLD_QSPI_t *InstancePtr, const PLD_QSPI_Segment_t *Segments,
+                                     uint32_t Count, uint32_t Total)
+{
+    uint32_t BaseAddress = InstancePtr->BaseAddress;
+    PLD_QSPI_Cursor_t Tx = { Segments, Segments + Count, 0 };
+    PLD_QSPI_Cursor_t Rx = { Segments, Segments + Count, 0 };
+    uint32_t TxLeft = Total;
+    uint32_t RxLeft = Total;
+    uint32_t Sent = 0;
+    uint32_t Received = 0;
+    uint32_t Words;
+    uint32_t Lead;
+    uint32_t Batch;
+    uint32_t Size;
+    uint32_t Word;
+
+    PLD_QSPI_CursorSkip(&Tx);
+    Lead = Tx.Segment->Length & 3U;
+    if (Lead == 0) {
+        Lead = 4U;
     }
+    Words = 1U + (Total - Lead) / 4U + (((Total - Lead) & 3U) != 0U);
+
+    PLD_QSPI_FifoBegin(InstancePtr);
+
+    while (Received < Words) {
+        while (Sent < Words && Sent - Received < XQSPIPS_FIFO_DEPTH) {
+            Size = (Sent == 0) ? Lead : ((TxLeft < 4U) ? TxLeft : 4U);
+            XQspiPs_WriteReg(BaseAddress, PLD_QSPI_TxdOffset[Size], PLD_QSPI_PackWord(&Tx, Size));
+            TxLeft -= Size;
+            Sent++;
+        }
+
+        if (InstancePtr->ManualStart) {
+            XQspiPs_WriteReg(BaseAddress, XQSPIPS_CR_OFFSET,
+                             (InstancePtr->Control & ~XQSPIPS_CR_SSCTRL_MASK) | XQSPIPS_CR_MANSTRT_MASK);
+        }
+
+        // Leave words on the bus while this batch is handled
+        Batch = PLD_QSPI_FifoBatch(Sent - Received, Sent == Words);
+        PLD_QSPI_FifoWait(InstancePtr, Batch);
+
+        do {
+            // Short writes come back in the top bytes of RXD
+            Size = (Received == 0) ? Lead : ((RxLeft < 4U) ? RxLeft : 4U);
+            Word = XQspiPs_ReadReg(BaseAddress, XQSPIPS_RXD_OFFSET);
+            PLD_QSPI_UnpackWord(&Rx, Word >> (8U * (4U - Size)), Size);
+            RxLeft -= Size;
+            Received++;
+        } while (--Batch > 0);
+    }
+
+    PLD_QSPI_FifoEnd(InstancePtr);
 
     return XST_SUCCESS;
 }
+
+/**
+ * RX words to wait for with InFlight words on the bus
+ * While there is more to send, PLD_QSPI_FIFO_BATCH words at a time. Once
+ * the last word is written, the rest is halved down to PLD_QSPI_FIFO_TAIL
+ * words, so the words still on the bus cover the CPU reading each batch
+ * and little is left to read once the bus stops.
+ */
+static uint32_t PLD_QSPI_FifoBatch(uint32_t InFlight, uint32_t Last)
+{
+    if (!Last) {
+        return (InFlight > PLD_QSPI_FIFO_BATCH) ? PLD_QSPI_FIFO_BATCH : InFlight;
+    }
+
+    return (InFlight > PLD_QSPI_FIFO_TAIL) ? (InFlight + 1U) / 2U : InFlight;
+}
+
+/**
+ * Open a frame, asserting chip select when the driver drives it
+ */
+static void PLD_QSPI_FifoBegin(PLD_QSPI_t *InstancePtr)
+{
+    if (InstancePtr->ManualCs) {
+        XQspiPs_WriteReg(InstancePtr->BaseAddress, XQSPIPS_CR_OFFSET, InstancePtr->Control & ~XQSPIPS_CR_SSCTRL_MASK);
+    }
+}
+
+/**
+ * Wait until the RX FIFO holds Words words
+ * RXNEMPTY is raised at the RX threshold, so moving the threshold to the
+ * batch size lets one status poll cover the whole batch. The threshold is
+ * left in place, as runs of same sized transfers reuse it.
+ */
+static void PLD_QSPI_FifoWait(PLD_QSPI_t *InstancePtr, uint32_t Words)
+{
+    if (InstancePtr->RxThreshold != Words) {
+        XQspiPs_WriteReg(InstancePtr->BaseAddress, XQSPIPS_RXWR_OFFSET, Words);
+        InstancePtr->RxThreshold = Words;
+    }
+
+    while (!(XQspiPs_ReadReg(InstancePtr->BaseAddress, XQSPIPS_SR_OFFSET) & XQSPIPS_IXR_RXNEMPTY_MASK)) {
+        // Spin, the batch is still on the bus
+    }
+}
+
+/**
+ * Close a frame, releasing chip select
+ */
+static void PLD_QSPI_FifoEnd(PLD_QSPI_t *InstancePtr)
+{
+    if (InstancePtr->ManualCs) {
+        XQspiPs_WriteReg(InstancePtr->BaseAddress, XQSPIPS_CR_OFFSET, InstancePtr->Control);
+    }
+}
+
+/**
+ * Pack Size bytes into a TXD word, first byte lowest
+ */
+static uint32_t PLD_QSPI_LoadWord(const uint8_t *Bytes, uint32_t Size)
+{
+    uint32_t Word = 0;
+    uint32_t Byte;
+
+    for (Byte = 0; Byte < Size; Byte++) {
+        Word |= (uint32_t)Bytes[Byte] << (8U * Byte);
+    }
+
+    return Word;
+}
+
+/**
+ * Polled read of Length bytes after a HeaderLength byte command header
+ * Inline so each PLD_QSPI_FIXED_READ variant compiles it for a constant
+ * header, which folds the header split and word count into constants.
+ * Frames of a single word (write enable, status reads) are one TXD write
+ * and one RXD read. Longer headers go out as their odd bytes then whole
+ * words, so every payload word lands aligned and is stored with a single
+ * (unaligned) copy, and payload TX words are plain 0xFF fill. With CrcPtr
+ * set, the payload is folded into the CRC32C there a batch at a time,
+ * while the following batch is on the bus.
+ */
+static inline XStatus PLD_QSPI_FixedRead(PLD_QSPI_t *InstancePtr, const uint8_t *Header, uint32_t HeaderLength,
+                                         uint8_t *Buffer, uint32_t Length, uint32_t *CrcPtr)
+{
+    uint32_t BaseAddress = InstancePtr->BaseAddress;
+    uint32_t Lead = HeaderLength & 3U;
+    uint32_t HeaderWords = (HeaderLength + 3U) / 4U;
+    uint32_t Tail = Length & 3U;
+    uint32_t Words = HeaderWords + Length / 4U + (Tail != 0U);
+    uint32_t Sent = 0;
+    uint32_t Received = 0;
+    uint32_t Folded = 0;
+    uint32_t Batch;
+    uint32_t Size;
+    uint32_t Word;
+    uint32_t Byte;
+
+    PLD_QSPI_FifoBegin(InstancePtr);
+
+    if (HeaderLength < 4U && Length <= 4U - HeaderLength) {
+        Size = HeaderLength + Length;
+        XQspiPs_WriteReg(BaseAddress, PLD_QSPI_TxdOffset[Size],
+                         PLD_QSPI_LoadWord(Header, HeaderLength) | (0xFFFFFFFFU << (8U * HeaderLength)));
+        if (InstancePtr->ManualStart) {
+            XQspiPs_WriteReg(BaseAddress, XQSPIPS_CR_OFFSET,
+                             (InstancePtr->Control & ~XQSPIPS_CR_SSCTRL_MASK) | XQSPIPS_CR_MANSTRT_MASK);
+        }
+        PLD_QSPI_FifoWait(InstancePtr, 1U);
+
+        // Short writes come back in the top bytes of RXD
+        Word = XQspiPs_ReadReg(BaseAddress, XQSPIPS_RXD_OFFSET);
+        for (Byte = 0; Byte < Length; Byte++) {
+            Buffer[Byte] = (uint8_t)(Word >> (8U * (4U - Size + HeaderLength + Byte)));
+        }
+
+        PLD_QSPI_FifoEnd(InstancePtr);
+        if (CrcPtr != NULL) {
+            *CrcPtr = PLD_QSPI_Crc32c(*CrcPtr, Buffer, Length);
+        }
+        return XST_SUCCESS;
+    }
+
+    while (Received < Words) {
+        while (Sent < Words && Sent - Received < XQSPIPS_FIFO_DEPTH) {
+            if (Sent < HeaderWords) {
+                if (Lead != 0U && Sent == 0) {
+                    XQspiPs_WriteReg(BaseAddress, PLD_QSPI_TxdOffset[Lead], PLD_QSPI_LoadWord(Header, Lead));
+                } else {
+                    Byte = (Lead != 0U) ? Lead + 4U * (Sent - 1U) : 4U * Sent;
+                    XQspiPs_WriteReg(BaseAddress, XQSPIPS_TXD_00_OFFSET, PLD_QSPI_LoadWord(&Header[Byte], 4U));
+                }
+            } else {
+                Size = (Sent == Words - 1U && Tail != 0U) ? Tail : 4U;
+                XQspiPs_WriteReg(BaseAddress, PLD_QSPI_TxdOffset[Size], 0xFFFFFFFFU);
+            }
+            Sent++;
+        }
+
+        if (InstancePtr->ManualStart) {
+            XQspiPs_WriteReg(BaseAddress, XQSPIPS_CR_OFFSET,
+                             (InstancePtr->Control & ~XQSPIPS_CR_SSCTRL_MASK) | XQSPIPS_CR_MANSTRT_MASK);
+        }
+
+        // Whole payload words drained so far, checked while the FIFO refills
+        if (CrcPtr != NULL && Received > HeaderWords) {
+            Byte = 4U * (Received - HeaderWords);
+            *CrcPtr = PLD_QSPI_Crc32c(*CrcPtr, &Buffer[Folded], Byte - Folded);
+            Folded = Byte;
+        }
+
+        Batch = PLD_QSPI_FifoBatch(Sent - Received, Sent == Words);
+        PLD_QSPI_FifoWait(InstancePtr, Batch);
+
+        do {
+            Word = XQspiPs_ReadReg(BaseAddress, XQSPIPS_RXD_OFFSET);
+            if (Received >= HeaderWords) {
+                Byte = 4U * (Received - HeaderWords);
+                if (Received == Words - 1U && Tail != 0U) {
+                    Word >>= 8U * (4U - Tail);
+                    for (Size = 0; Size < Tail; Size++) {
+                        Buffer[Byte + Size] = (uint8_t)(Word >> (8U * Size));
+                    }
+                } else {
+                    memcpy(&Buffer[Byte], &Word, 4U);
+                }
+            }
+            Received++;
+        } while (--Batch > 0);
+    }
+
+    PLD_QSPI_FifoEnd(InstancePtr);
+
+    if (CrcPtr != NULL) {
+        *CrcPtr = PLD_QSPI_Crc32c(*CrcPtr, &Buffer[Folded], Length - Folded);
+    }
+
+    return XST_SUCCESS;
+}
+
+/* Fixed layout reads, PLD_QSPI_FixedRead compiled once per header length */
+#define PLD_QSPI_FIXED_READ(HeaderLength) \
+    static XStatus PLD_QSPI_FixedRead##HeaderLength(PLD_QSPI_t *InstancePtr, const uint8_t *Header, \
+                                                    uint8_t *Buffer, uint32_t Length, uint32_t *CrcPtr) \
+    { \
+        return PLD_QSPI_FixedRead(InstancePtr, Header, HeaderLength##U, Buffer, Length, CrcPtr); \
+    }
+
+PLD_QSPI_FIXED_READ(1)      /* Write enable, status and ID reads */
+PLD_QSPI_FIXED_READ(4)      /* 3 byte address */
+PLD_QSPI_FIXED_READ(5)      /* 3 byte address and a dummy byte, or 4 byte address */
+PLD_QSPI_FIXED_READ(6)      /* 4 byte address and a dummy byte */
+
+/**
+ * Send a command header and read Length bytes back in the same frame
+ * Common header lengths take a fixed layout variant, anything else (more
+ * dummy bytes, parallel alignment bytes) the segment engine. CrcPtr, if
+ * not NULL, has the data folded into it.
+ */
+static XStatus PLD_QSPI_HeaderRead(PLD_QSPI_t *InstancePtr, const uint8_t *Header, uint32_t HeaderLength,
+                                   uint8_t *Buffer, uint32_t Length, uint32_t *CrcPtr)
+{
+    XStatus Status;
+    PLD_QSPI_Segment_t Segments[2];
+    uint64_t Start;
+
+    // Check if driver is ready
+    if (InstancePtr->Qspi.IsReady != XIL_COMPONENT_IS_READY) {
+        return XST_DEVICE_NOT_FOUND;
+    }
+
+    if (InstancePtr->AsyncBusy || InstancePtr->LinearMode) {
+        return XST_DEVICE_BUSY;
+    }
+
+    Start = PLD_QSPI_STATS_STAMP();
+    switch (HeaderLength) {
+    case 1U:
+        Status = PLD_QSPI_FixedRead1(InstancePtr, Header, Buffer, Length, CrcPtr);
+        break;
+    case 4U:
+        Status = PLD_QSPI_FixedRead4(InstancePtr, Header, Buffer, Length, CrcPtr);
+        break;
+    case 5U:
+        Status = PLD_QSPI_FixedRead5(InstancePtr, Header, Buffer, Length, CrcPtr);
+        break;
+    case 6U:
+        Status = PLD_QSPI_FixedRead6(InstancePtr, Header, Buffer, Length, CrcPtr);
+        break;
+    default:
+        Segments[0].Tx = Header;
+        Segments[0].Rx = NULL;
+        Segments[0].Length = HeaderLength;
+        Segments[1].Tx = NULL;
+        Segments[1].Rx = Buffer;
+        Segments[1].Length = Length;
+        Status = PLD_QSPI_FifoTransfer(InstancePtr, Segments, 2U, HeaderLength + Length);
+        if (Status == XST_SUCCESS && CrcPtr != NULL) {
+            *CrcPtr = PLD_QSPI_Crc32c(*CrcPtr, Buffer, Length);
+        }
+        break;
+    }
+    PLD_QSPI_STATS_RECORD(InstancePtr, PLD_QSPI_OP_TRANSFER, Start, HeaderLength + Length, Status);
+
+    return Status;
+}
+
+/**
+ * Start a QSPI transfer in interrupt mode and return immediately
+ * Callback is invoked from PLD_QSPI_InterruptHandler once the transfer completes or fails.
+ * The caller must have connected PLD_QSPI_InterruptHandler to the QSPI interrupt
+ * (with this instance as its reference) and enabled it on the GIC beforehand.
+ * WriteData and ReadData must stay valid until the callback fires.
+ */
+XStatus PLD_QSPI_TransferAsync(PLD_QSPI_t *InstancePtr, uint8_t *WriteData, uint8_t *ReadData,
+                               uint32_t DataLength, PLD_QSPI_Callback_t Callback, void *CallbackRef)
+{
+    XStatus Status;
+
+    // Check if driver is ready
+    if (InstancePtr->Qspi.IsReady != XIL_COMPONENT_IS_READY) {
+        return XST_DEVICE_NOT_FOUND;
+    }
+
+    if (InstancePtr->AsyncBusy || InstancePtr->LinearMode) {
+        return XST_DEVICE_BUSY;
+    }
+
+    InstancePtr->AsyncCallback = Callback;
+    InstancePtr->AsyncCallbackRef = CallbackRef;
+    InstancePtr->AsyncBusy = 1;
+
+    // The XQspiPs interrupt handler drains RX one word per RXNEMPTY
+    if (InstancePtr->RxThreshold != XQSPIPS_RXWR_RESET_VALUE) {
+        XQspiPs_SetRXWatermark(&InstancePtr->Qspi, XQSPIPS_RXWR_RESET_VALUE);
+        InstancePtr->RxThreshold = XQSPIPS_RXWR_RESET_VALUE;
+    }
+
+    // Check if manual chip select is enabled
+    if (XQspiPs_GetOptions(&InstancePtr->Qspi) & XQSPIPS_FORCE_SSELECT_OPTION) {
+        Status = XQspiPs_SetSlaveSelect(&InstancePtr->Qspi);
+        if (Status != XST_SUCCESS) {
+            InstancePtr->AsyncBusy = 0;
+            return Status;
+        }
+    }
+
+    // Prime the FIFO, the rest is moved by the TX threshold interrupt
+    InstancePtr->AsyncStart = PLD_QSPI_STATS_STAMP();
+    Status = XQspiPs_Transfer(&InstancePtr->Qspi, WriteData, ReadData, DataLength);
+    if (Status != XST_SUCCESS) {
+        PLD_QSPI_STATS_RECORD(InstancePtr, PLD_QSPI_OP_TRANSFER, InstancePtr->AsyncStart, DataLength, Status);
+        InstancePtr->AsyncBusy = 0;
+        return Status;
+    }
+
+    return XST_SUCCESS;
+}
+
+/**
+ * Block until the running async transfer (if any) completes
+ * Returns the completion status of the last async transfer.
+ */
+XStatus PLD_QSPI_WaitAsync(PLD_QSPI_t *InstancePtr)
+{
+    while (InstancePtr->AsyncBusy) {
+        // Spin, completion is signalled from interrupt context
+    }
+
+    return InstancePtr->AsyncStatus;
+}
+
+/**
+ * Check whether an async transfer is still in flight
+ */
+uint32_t PLD_QSPI_IsBusy(PLD_QSPI_t *InstancePtr)
+{
+    return InstancePtr->AsyncBusy;
+}
+
+/**
+ * QSPI interrupt service routine
+ * Connect this to the QSPI interrupt ID with the PLD_QSPI_t instance as callback reference.
+ */
+void PLD_QSPI_InterruptHandler(void *InstancePtr)
+{
+    XQspiPs_InterruptHandler(&((PLD_QSPI_t *)InstancePtr)->Qspi);
+}
+
+/**
+ * Tell the driver whether PLD_QSPI_InterruptHandler is connected
+ * When enabled, bulk operations such as PLD_QSPI_ReadStream overlap the next
+ * transfer with processing of the current one. Leave disabled until the
+ * interrupt is connected on the GIC, or async transfers will never complete.
+ */
+void PLD_QSPI_UseInterrupts(PLD_QSPI_t *InstancePtr, uint32_t Enable)
+{
+    InstancePtr->UseInterrupts = Enable ? 1 : 0;
+}
+
+/**
+ * Status handler registered with XQspiPs, runs in interrupt context
+ * Every event the XQspiPs driver reports ends the transfer, so translate it
+ * into a status code and hand it to the user callback.
+ */
+static void PLD_QSPI_StatusHandler(void *CallBackRef, u32 StatusEvent, unsigned ByteCount)
+{
+    PLD_QSPI_t *InstancePtr = (PLD_QSPI_t *)CallBackRef;
+    PLD_QSPI_Callback_t Callback = InstancePtr->AsyncCallback;
+    void *CallbackRef = InstancePtr->AsyncCallbackRef;
+    XStatus Status = (StatusEvent == XST_SPI_TRANSFER_DONE) ? XST_SUCCESS : (XStatus)StatusEvent;
+
+    PLD_QSPI_STATS_RECORD(InstancePtr, PLD_QSPI_OP_TRANSFER, InstancePtr->AsyncStart, (uint32_t)ByteCount, Status);
+
+    InstancePtr->AsyncStatus = Status;
+    InstancePtr->AsyncBusy = 0;
+
+    if (Callback != NULL) {
+        Callback(CallbackRef, Status, (uint32_t)ByteCount);
+    }
+}
+
+/**
+ * Switch the controller into linear (XIP) mode
+ * The flash becomes readable through the AXI window at PLD_QSPI_LINEAR_BASEADDR,
+ * using the linear read opcode and dummy bytes in InstancePtr->Flash. I/O mode
+ * transfers are refused until PLD_QSPI_DisableLinearMode is called.
+ */
+XStatus PLD_QSPI_EnableLinearMode(PLD_QSPI_t *InstancePtr)
+{
+    XStatus Status;
+    u32 LqspiConfig;
+
+    // Check if driver is ready
+    if (InstancePtr->Qspi.IsReady != XIL_COMPONENT_IS_READY) {
+        return XST_DEVICE_NOT_FOUND;
+    }
+
+    if (InstancePtr->AsyncBusy) {
+        return XST_DEVICE_BUSY;
+    }
+
+    if (InstancePtr->LinearMode) {
+        return XST_SUCCESS;
+    }
+
+    // The controller issues 3 byte addresses, which must land in the first 16MB of each flash
+    Status = PLD_QSPI_SelectBank(InstancePtr, 0);
+    if (Status == XST_SUCCESS && InstancePtr->ConnectionMode == PLD_QSPI_CONNECTION_STACKED) {
+        Status = PLD_QSPI_SelectBank(InstancePtr, InstancePtr->DeviceSize);
+    }
+    if (Status != XST_SUCCESS) {
+        return Status;
+    }
+
+    InstancePtr->IoOptions = XQspiPs_GetOptions(&InstancePtr->Qspi);
+
+    XQspiPs_Disable(&InstancePtr->Qspi);
+
+    // Linear mode drives CS itself, manual chip select and start must be off
+    Status = XQspiPs_SetOptions(&InstancePtr->Qspi, XQSPIPS_LQSPI_MODE_OPTION | XQSPIPS_HOLD_B_DRIVE_OPTION);
+    if (Status != XST_SUCCESS) {
+        XQspiPs_Enable(&InstancePtr->Qspi);
+        return Status;
+    }
+
+    LqspiConfig = XQSPIPS_LQSPI_CR_LINEAR_MASK | InstancePtr->IoConfig |
+                  (((u32)InstancePtr->Flash.LinearDummyBytes << XQSPIPS_LQSPI_CR_DUMMY_SHIFT) & XQSPIPS_LQSPI_CR_DUMMY_MASK) |
+                  InstancePtr->Flash.LinearReadCmd;
+
+    Status = XQspiPs_SetLqspiConfigReg(&InstancePtr->Qspi, LqspiConfig);
+    if (Status != XST_SUCCESS) {
+        XQspiPs_SetLqspiConfigReg(&InstancePtr->Qspi, InstancePtr->IoConfig | (InstancePtr->Device ? XQSPIPS_LQSPI_CR_U_PAGE_MASK : 0));
+        XQspiPs_SetOptions(&InstancePtr->Qspi, InstancePtr->IoOptions);
+        XQspiPs_Enable(&InstancePtr->Qspi);
+        return Status;
+    }
+
+    XQspiPs_Enable(&InstancePtr->Qspi);
+    PLD_QSPI_CacheControl(InstancePtr);
+    InstancePtr->LinearMode = 1;
+
+    return XST_SUCCESS;
+}
+
+/**
+ * Leave linear mode and restore the I/O mode options
+ */
+XStatus PLD_QSPI_DisableLinearMode(PLD_QSPI_t *InstancePtr)
+{
+    XStatus Status;
+
+    if (!InstancePtr->LinearMode) {
+        return XST_SUCCESS;
+    }
+
+    XQspiPs_Disable(&InstancePtr->Qspi);
+
+    // Back to I/O mode talking to the lower flash
+    Status = XQspiPs_SetLqspiConfigReg(&InstancePtr->Qspi, InstancePtr->IoConfig);
+    if (Status != XST_SUCCESS) {
+        XQspiPs_Enable(&InstancePtr->Qspi);
+        return Status;
+    }
+    InstancePtr->Device = 0;
+
+    Status = XQspiPs_SetOptions(&InstancePtr->Qspi, InstancePtr->IoOptions);
+    XQspiPs_Enable(&InstancePtr->Qspi);
+    PLD_QSPI_CacheControl(InstancePtr);
+    if (Status != XST_SUCCESS) {
+        return Status;
+    }
+
+    InstancePtr->LinearMode = 0;
+
+    return XST_SUCCESS;
+}
+
+/**
+ * Get a pointer into the linear window for a flash region (zero-copy read)
+ * The region is invalidated in the data cache so data programmed through
+ * I/O mode since the last mapping is seen. The pointer is valid until
+ * linear mode is disabled.
+ * Each flash contributes at most 16MB to the window. Parallel flashes are
+ * interleaved by the controller, so the window matches flash addresses.
+ * The upper of two stacked flashes starts 16MB into the window, so a
+ * region must not span both.
+ */
+XStatus PLD_QSPI_MapRegion(PLD_QSPI_t *InstancePtr, uint32_t Address, uint32_t Length, const uint8_t **RegionPtr)
+{
+    uint32_t Limit = InstancePtr->Flash.Size;
+    uint32_t Base = 0;
+    uint32_t Window;
+
+    if (!InstancePtr->LinearMode) {
+        return XST_NOT_ENABLED;
+    }
+
+    if (InstancePtr->ConnectionMode == PLD_QSPI_CONNECTION_PARALLEL) {
+        Window = 2U * PLD_QSPI_LINEAR_WINDOW_SIZE;
+    } else if (InstancePtr->ConnectionMode == PLD_QSPI_CONNECTION_STACKED) {
+        Window = PLD_QSPI_LINEAR_WINDOW_SIZE;
+        Limit = InstancePtr->DeviceSize;
+        if (Address >= Limit) {
+            Base = Limit;
+        }
+    } else {
+        Window = PLD_QSPI_LINEAR_WINDOW_SIZE;
+    }
+
+    if (Limit > Window) {
+        Limit = Window;
+    }
+
+    if (RegionPtr == NULL || Length == 0 || Address - Base >= Limit || Length > Limit - (Address - Base)) {
+        return XST_INVALID_PARAM;
+    }
+
+    // Window offset of the region, the upper stacked flash sits past the lower one's 16MB
+    Address = (Base != 0) ? PLD_QSPI_LINEAR_WINDOW_SIZE + (Address - Base) : Address;
+
+    Xil_DCacheInvalidateRange((INTPTR)(PLD_QSPI_LINEAR_BASEADDR + Address), Length);
+
+    *RegionPtr = (const uint8_t *)(PLD_QSPI_LINEAR_BASEADDR + Address);
+
+    return XST_SUCCESS;
+}
+
+/**
+ * Write the read command, address and dummy bytes at the start of a frame
+ * Returns the number of framing bytes, which the data follows.
+ */
+static uint32_t PLD_QSPI_BuildReadHeader(PLD_QSPI_t *InstancePtr, uint32_t Address, uint8_t *Frame)
+{
+    uint32_t Length = 0;
+    uint32_t Index;
+    uint32_t Odd = (InstancePtr->ConnectionMode == PLD_QSPI_CONNECTION_PARALLEL) ? (Address & 1U) : 0;
+
+    Frame[Length++] = InstancePtr->Flash.ReadCmd;
+    Length += PLD_QSPI_PutAddress(InstancePtr, Address - Odd, &Frame[Length]);
+
+    // Dummy (and mode) bytes are sent high so no part enters continuous read mode
+    for (Index = 0; Index < InstancePtr->Flash.ReadDummyBytes; Index++) {
+        Frame[Length++] = 0xFF;
+    }
+
+    // Parallel reads start on the lower flash, an odd address drops its byte
+    if (Odd) {
+        Frame[Length++] = 0xFF;
+    }
+
+    return Length;
+}
+
+/**
+ * Read an arbitrarily large flash range and hand it to Sink chunk by chunk
+ * Each chunk is read into one of two frame buffers in the handle and passed
+ * to Sink in place, just past the command framing, so no oversized caller
+ * buffer or payload copy is needed. With interrupts in use, the next chunk is
+ * already on the bus while Sink processes the current one.
+ */
+XStatus PLD_QSPI_ReadStream(PLD_QSPI_t *InstancePtr, uint32_t Address, uint32_t Length,
+                            PLD_QSPI_Sink_t Sink, void *Ctx)
+{
+    XStatus Status;
+    XStatus Resume;
+    uint64_t Start = PLD_QSPI_STATS_STAMP();
+
+    Status = PLD_QSPI_StreamChunks(InstancePtr, Address, Length, Sink, Ctx);
+    Resume = PLD_QSPI_ResumeEraseAhead(InstancePtr);
+    if (Status == XST_SUCCESS) {
+        Status = Resume;
+    }
+    PLD_QSPI_STATS_RECORD(InstancePtr, PLD_QSPI_OP_READ, Start, Length, Status);
+
+    return Status;
+}
+
+/**
+ * Body of PLD_QSPI_ReadStream, split out so every exit is counted once
+ */
+static XStatus PLD_QSPI_StreamChunks(PLD_QSPI_t *InstancePtr, uint32_t Address, uint32_t Length,
+                                     PLD_QSPI_Sink_t Sink, void *Ctx)
+{
+    XStatus Status;
+    uint32_t Limit = PLD_QSPI_AddressLimit(InstancePtr);
+    uint32_t Header[2];
+    uint32_t Chunk[2];
+    uint32_t ChunkAddress[2];
+    uint32_t Current = 0;
+    uint32_t Next;
+    uint32_t Pipelined = InstancePtr->UseInterrupts;
+
+    // Check if driver is ready
+    if (InstancePtr->Qspi.IsReady != XIL_COMPONENT_IS_READY) {
+        return XST_DEVICE_NOT_FOUND;
+    }
+
+    if (Sink == NULL || Address >= Limit || Length > Limit - Address) {
+        return XST_INVALID_PARAM;
+    }
+
+    if (Length == 0) {
+        return XST_SUCCESS;
+    }
+
+    // A busy flash ignores reads, suspend or finish any background erase first
+    Status = PLD_QSPI_PauseEraseAhead(InstancePtr);
+    if (Status != XST_SUCCESS) {
+        return Status;
+    }
+
+    // Issue the first chunk
+    Chunk[Current] = PLD_QSPI_ReadChunk(InstancePtr, Address, Length);
+    ChunkAddress[Current] = Address;
+    Header[Current] = PLD_QSPI_BuildReadHeader(InstancePtr, Address, InstancePtr->Frame[Current]);
+
+    Status = PLD_QSPI_SelectBank(InstancePtr, Address);
+    if (Status != XST_SUCCESS) {
+        return Status;
+    }
+
+    if (Pipelined) {
+        Status = PLD_QSPI_TransferAsync(InstancePtr, InstancePtr->Frame[Current], InstancePtr->Frame[Current],
+                                        Header[Current] + Chunk[Current], NULL, NULL);
+    } else {
+        Status = PLD_QSPI_Transfer(InstancePtr, InstancePtr->Frame[Current], InstancePtr->Frame[Current],
+                                   Header[Current] + Chunk[Current]);
+    }
+    if (Status != XST_SUCCESS) {
+        return Status;
+    }
+
+    Address += Chunk[Current];
+    Length -= Chunk[Current];
+
+    for (;;) {
+        if (Pipelined) {
+            Status = PLD_QSPI_WaitAsync(InstancePtr);
+            if (Status != XST_SUCCESS) {
+                return Status;
+            }
+        }
+
+        // Put the next chunk on the bus before consuming this one
+        Next = Current ^ 1U;
+        if (Length > 0) {
+            Chunk[Next] = PLD_QSPI_ReadChunk(InstancePtr, Address, Length);
+            ChunkAddress[Next] = Address;
+            Header[Next] = PLD_QSPI_BuildReadHeader(InstancePtr, Address, InstancePtr->Frame[Next]);
+
+            if (Pipelined) {
+                Status = PLD_QSPI_SelectBank(InstancePtr, Address);
+                if (Status != XST_SUCCESS) {
+                    return Status;
+                }
+
+                Status = PLD_QSPI_TransferAsync(InstancePtr, InstancePtr->Frame[Next], InstancePtr->Frame[Next],
+                                                Header[Next] + Chunk[Next], NULL, NULL);
+                if (Status != XST_SUCCESS) {
+                    return Status;
+                }
+            }
+        }
+
+        Status = Sink(Ctx, ChunkAddress[Current], &InstancePtr->Frame[Current][Header[Current]], Chunk[Current]);
+        if (Status != XST_SUCCESS) {
+            // Let the chunk in flight drain before handing the controller back
+            if (Pipelined && Length > 0) {
+                PLD_QSPI_WaitAsync(InstancePtr);
+            }
+            return Status;
+        }
+
+        if (Length == 0) {
+            return XST_SUCCESS;
+        }
+
+        if (!Pipelined) {
+            Status = PLD_QSPI_SelectBank(InstancePtr, Address);
+            if (Status != XST_SUCCESS) {
+                return Status;
+            }
+
+            Status = PLD_QSPI_Transfer(InstancePtr, InstancePtr->Frame[Next], InstancePtr->Frame[Next],
+                                       Header[Next] + Chunk[Next]);
+            if (Status != XST_SUCCESS) {
+                return Status;
+            }
+        }
+
+        Address += Chunk[Next];
+        Length -= Chunk[Next];
+        Current = Next;
+    }
+}
+
+/**
+ * Read a flash range into a caller buffer holding only the payload
+ * The data is received straight into Buffer, one transfer per bank (or
+ * stacked flash), with nothing copied through the frame buffers.
+ */
+XStatus PLD_QSPI_Read(PLD_QSPI_t *InstancePtr, uint32_t Address, uint8_t *Buffer, uint32_t Length)
+{
+    XStatus Status;
+    XStatus Resume;
+    uint64_t Start;
+
+    if (Buffer == NULL) {
+        return XST_INVALID_PARAM;
+    }
+
+    Start = PLD_QSPI_STATS_STAMP();
+    Status = PLD_QSPI_ReadDirect(InstancePtr, Address, Buffer, Length, NULL);
+    Resume = PLD_QSPI_ResumeEraseAhead(InstancePtr);
+    if (Status == XST_SUCCESS) {
+        Status = Resume;
+    }
+    PLD_QSPI_STATS_RECORD(InstancePtr, PLD_QSPI_OP_READ, Start, Length, Status);
+
+    return Status;
+}
+
+/**
+ * Read a flash range and check it against its CRC32C (PLD_QSPI_Crc32c)
+ * The CRC is folded over the data as it leaves the RX FIFO, a batch at a
+ * time while the next batch is still on the bus, so the check costs no
+ * pass over memory of its own. Buffer receives the data if not NULL;
+ * otherwise the range is read a chunk at a time through a frame buffer,
+ * so a whole image can be checked without room for it. Returns
+ * XST_DATA_LOST on a mismatch. CrcPtr, if not NULL, receives the CRC of
+ * what was read.
+ */
+XStatus PLD_QSPI_ReadVerify(PLD_QSPI_t *InstancePtr, uint32_t Address, uint8_t *Buffer, uint32_t Length,
+                            uint32_t Expected, uint32_t *CrcPtr)
+{
+    XStatus Status;
+    XStatus Resume;
+    uint32_t Crc = 0;
+    uint64_t Start;
+
+    Start = PLD_QSPI_STATS_STAMP();
+    Status = PLD_QSPI_ReadDirect(InstancePtr, Address, Buffer, Length, &Crc);
+    Resume = PLD_QSPI_ResumeEraseAhead(InstancePtr);
+    if (Status == XST_SUCCESS) {
+        Status = Resume;
+    }
+    if (Status == XST_SUCCESS && Crc != Expected) {
+        Status = XST_DATA_LOST;
+    }
+    PLD_QSPI_STATS_RECORD(InstancePtr, PLD_QSPI_OP_READ, Start, Length, Status);
+
+    if (CrcPtr != NULL) {
+        *CrcPtr = Crc;
+    }
+
+    return Status;
+}
+
+/**
+ * Body of PLD_QSPI_Read and PLD_QSPI_ReadVerify, split out so every exit
+ * is counted once. A NULL Buffer reads through the first frame buffer,
+ * which only makes sense with CrcPtr set.
+ */
+static XStatus PLD_QSPI_ReadDirect(PLD_QSPI_t *InstancePtr, uint32_t Address, uint8_t *Buffer, uint32_t Length,
+                                   uint32_t *CrcPtr)
+{
+    XStatus Status;
+    uint8_t Header[PLD_QSPI_MAX_READ_HEADER];
+    uint32_t HeaderLength;
+    uint32_t Limit = PLD_QSPI_AddressLimit(InstancePtr);
+    uint32_t Span;
+
+    // Check if driver is ready
+    if (InstancePtr->Qspi.IsReady != XIL_COMPONENT_IS_READY) {
+        return XST_DEVICE_NOT_FOUND;
+    }
+
+    if (Address >= Limit || Length > Limit - Address) {
+        return XST_INVALID_PARAM;
+    }
+
+    // A busy flash ignores reads, suspend or finish any background erase first
+    Status = PLD_QSPI_PauseEraseAhead(InstancePtr);
+    if (Status != XST_SUCCESS) {
+        return Status;
+    }
+
+    // Command framing from the stack, data into the caller's buffer
+    while (Length > 0) {
+        if (Buffer != NULL) {
+            Span = PLD_QSPI_ReadSpan(InstancePtr, Address, Length);
+        } else {
+            Span = PLD_QSPI_ReadChunk(InstancePtr, Address, Length);
+        }
+        HeaderLength = PLD_QSPI_BuildReadHeader(InstancePtr, Address, Header);
+
+        Status = PLD_QSPI_SelectBank(InstancePtr, Address);
+        if (Status != XST_SUCCESS) {
+            return Status;
+        }
+
+        Status = PLD_QSPI_HeaderRead(InstancePtr, Header, HeaderLength,
+                                     (Buffer != NULL) ? Buffer : InstancePtr->Frame[0], Span, CrcPtr);
+        if (Status != XST_SUCCESS) {
+            return Status;
+        }
+
+        Address += Span;
+        if (Buffer != NULL) {
+            Buffer += Span;
+        }
+        Length -= Span;
+    }
+
+    return XST_SUCCESS;
+}
+
+/**
+ * Free running microsecond clock (wraps after ~71 minutes, differences stay valid)
+ * The time base of the driver and of every module built on it.
+ */
+uint32_t PLD_QSPI_NowUs(void)
+{
+    XTime Now;
+
+    XTime_GetTime(&Now);
+    return (uint32_t)(Now / (COUNTS_PER_SECOND / 1000000U));
+}
+
+/**
+ * Read the flash status register
+ * Parallel flashes answer with a byte each. They are ORed, so the pair
+ * reads busy until both are done. Stacked flashes answer for the one
+ * selected by the last command.
+ */
+XStatus PLD_QSPI_ReadStatus(PLD_QSPI_t *InstancePtr, uint8_t *StatusPtr)
+{
+    XStatus Status;
+    uint8_t Cmd = PLD_QSPI_CMD_READ_STATUS;
+    uint8_t Data[2];
+    uint32_t Length = (InstancePtr->ConnectionMode == PLD_QSPI_CONNECTION_PARALLEL) ? 2U : 1U;
+    uint64_t Start = PLD_QSPI_STATS_STAMP();
+
+    Status = PLD_QSPI_HeaderRead(InstancePtr, &Cmd, 1U, Data, Length, NULL);
+    PLD_QSPI_STATS_RECORD(InstancePtr, PLD_QSPI_OP_STATUS, Start, Length, Status);
+    if (Status != XST_SUCCESS) {
+        return Status;
+    }
+
+    *StatusPtr = (Length == 2U) ? (uint8_t)(Data[0] | Data[1]) : Data[0];
+    return XST_SUCCESS;
+}
+
+/**
+ * Run a read style command (ID, SFDP, registers) against one flash
+ * Frame holds HeaderLength bytes of command framing followed by room for
+ * the response. Device selects the lower (0) or upper (1) flash of a dual
+ * configuration. Parallel flashes both answer and their bytes alternate on
+ * the bus, so 2 x Length bytes are clocked (Frame must hold them) and
+ * Device's bytes are gathered at Frame + HeaderLength.
+ */
+XStatus PLD_QSPI_ReadDevice(PLD_QSPI_t *InstancePtr, uint32_t Device, uint8_t *Frame,
+                            uint32_t HeaderLength, uint32_t Length)
+{
+    XStatus Status;
+    uint32_t Index;
+
+    if (Frame == NULL || Device >= PLD_QSPI_MAX_DEVICES ||
+        (Device > 0 && InstancePtr->ConnectionMode == PLD_QSPI_CONNECTION_SINGLE)) {
+        return XST_INVALID_PARAM;
+    }
+
+    if (InstancePtr->ConnectionMode != PLD_QSPI_CONNECTION_PARALLEL) {
+        Status = PLD_QSPI_SelectDevice(InstancePtr, Device);
+        if (Status != XST_SUCCESS) {
+            return Status;
+        }
+
+        return PLD_QSPI_Transfer(InstancePtr, Frame, Frame, HeaderLength + Length);
+    }
+
+    Status = PLD_QSPI_Transfer(InstancePtr, Frame, Frame, HeaderLength + 2U * Length);
+    if (Status != XST_SUCCESS) {
+        return Status;
+    }
+
+    for (Index = 0; Index < Length; Index++) {
+        Frame[HeaderLength + Index] = Frame[HeaderLength + 2U * Index + Device];
+    }
+
+    return XST_SUCCESS;
+}
+
+/**
+ * Set the flash write enable latch ahead of a program or erase
+ */
+XStatus PLD_QSPI_WriteEnable(PLD_QSPI_t *InstancePtr)
+{
+    uint8_t Cmd = PLD_QSPI_CMD_WRITE_ENABLE;
+
+    return PLD_QSPI_HeaderRead(InstancePtr, &Cmd, 1U, NULL, 0, NULL);
+}
+
+/**
+ * Wait for the flash to finish a program or erase
+ * The bus is left alone for most of ExpectedUs, then the status register is
+ * polled with an interval that starts at PLD_QSPI_POLL_MIN_US and doubles
+ * up to PLD_QSPI_POLL_MAX_US (or a quarter of ExpectedUs if smaller). This
+ * catches completion close to the typical time without flooding the bus with
+ * status reads on slow operations.
+ */
+XStatus PLD_QSPI_WaitReady(PLD_QSPI_t *InstancePtr, uint32_t ExpectedUs, uint32_t TimeoutUs, uint32_t *ElapsedUsPtr)
+{
+    XStatus Status;
+    uint8_t FlashStatus;
+    uint32_t Start = PLD_QSPI_NowUs();
+    uint32_t Elapsed;
+    uint32_t Interval = PLD_QSPI_POLL_MIN_US;
+    uint32_t MaxInterval = ExpectedUs / 4U;
+
+    if (MaxInterval > PLD_QSPI_POLL_MAX_US) {
+        MaxInterval = PLD_QSPI_POLL_MAX_US;
+    }
+    if (MaxInterval < PLD_QSPI_POLL_MIN_US) {
+        MaxInterval = PLD_QSPI_POLL_MIN_US;
+    }
+
+    if (PLD_QSPI_POLL_LEAD(ExpectedUs) > 0) {
+        usleep(PLD_QSPI_POLL_LEAD(ExpectedUs));
+    }
+
+    for (;;) {
+        Status = PLD_QSPI_ReadStatus(InstancePtr, &FlashStatus);
+        if (Status != XST_SUCCESS) {
+            return Status;
+        }
+
+        Elapsed = PLD_QSPI_NowUs() - Start;
+
+        if (!(FlashStatus & PLD_QSPI_SR_WIP)) {
+            break;
+        }
+
+        if (Elapsed > TimeoutUs) {
+            return XST_TIMEOUT;
+        }
+
+        usleep(Interval);
+        if (Interval < MaxInterval) {
+            Interval = (Interval * 2U < MaxInterval) ? Interval * 2U : MaxInterval;
+        }
+    }
+
+    if (ElapsedUsPtr != NULL) {
+        *ElapsedUsPtr = Elapsed;
+    }
+
+    return XST_SUCCESS;
+}
+
+/**
+ * Busy time left of an operation that typically takes TypicalUs and has run
+ * since StartUs, as the ExpectedUs of PLD_QSPI_WaitReady. Never less than
+ * an eighth of TypicalUs, so one running late is still polled at a
+ * sensible interval rather than flat out.
+ */
+static uint32_t PLD_QSPI_RemainingUs(uint32_t TypicalUs, uint32_t StartUs)
+{
+    uint32_t Elapsed = PLD_QSPI_NowUs() - StartUs;
+    uint32_t Floor = TypicalUs / 8U;
+
+    return (Elapsed + Floor < TypicalUs) ? TypicalUs - Elapsed : Floor;
+}
+
+/**
+ * Write the page program command and address at the start of a frame
+ * Returns the number of framing bytes, which the data follows.
+ */
+static uint32_t PLD_QSPI_BuildProgramHeader(PLD_QSPI_t *InstancePtr, uint32_t Address, uint8_t *Frame)
+{
+    uint32_t Header = 1U;
+    uint32_t Odd = (InstancePtr->ConnectionMode == PLD_QSPI_CONNECTION_PARALLEL) ? (Address & 1U) : 0;
+
+    Frame[0] = InstancePtr->Flash.ProgramCmd;
+    Header += PLD_QSPI_PutAddress(InstancePtr, Address - Odd, &Frame[Header]);
+
+    // Parallel data starts on the lower flash, pad an odd address with a byte that programs nothing
+    if (Odd) {
+        Frame[Header++] = 0xFF;
+    }
+
+    return Header;
+}
+
+/**
+ * Program a buffer into (erased) flash
+ * The buffer is split on page boundaries. Each page gets WREN + page program,
+ * with the command header from the stack and the data sent straight from
+ * the caller's buffer. Completion polling is seeded with a running estimate
+ * of tPP learned from previous pages.
+ */
+XStatus PLD_QSPI_Write(PLD_QSPI_t *InstancePtr, uint32_t Address, const uint8_t *Data, uint32_t Length)
+{
+    XStatus Status;
+    PLD_QSPI_Segment_t Segments[2];
+    uint8_t Header[PLD_QSPI_MAX_READ_HEADER];
+    uint32_t PageSize = InstancePtr->Flash.PageSize;
+    uint32_t Limit = PLD_QSPI_AddressLimit(InstancePtr);
+    uint32_t PageLength;
+    uint32_t Elapsed;
+    uint64_t Start;
+
+    // Check if driver is ready
+    if (InstancePtr->Qspi.IsReady != XIL_COMPONENT_IS_READY) {
+        return XST_DEVICE_NOT_FOUND;
+    }
+
+    if (Data == NULL || Address >= Limit || Length > Limit - Address) {
+        return XST_INVALID_PARAM;
+    }
+
+    if (Length == 0) {
+        return XST_SUCCESS;
+    }
+
+    Status = PLD_QSPI_SettleEraseAhead(InstancePtr);
+    if (Status != XST_SUCCESS) {
+        return Status;
+    }
+
+    PLD_QSPI_NotifyModify(InstancePtr, Address, Length);
+
+    Segments[0].Tx = Header;
+    Segments[0].Rx = NULL;
+    Segments[1].Rx = NULL;
+
+    for (;;) {
+        Start = PLD_QSPI_STATS_STAMP();
+
+        // Pages never straddle a bank or flash, so those only change between pages
+        PageLength = PageSize - (Address % PageSize);
+        if (PageLength > Length) {
+            PageLength = Length;
+        }
+
+        Status = PLD_QSPI_SelectBank(InstancePtr, Address);
+        if (Status != XST_SUCCESS) {
+            break;
+        }
+
+        Status = PLD_QSPI_WriteEnable(InstancePtr);
+        if (Status != XST_SUCCESS) {
+            break;
+        }
+
+        Segments[0].Length = PLD_QSPI_BuildProgramHeader(InstancePtr, Address, Header);
+        Segments[1].Tx = Data;
+        Segments[1].Length = PageLength;
+        Status = PLD_QSPI_TransferV(InstancePtr, Segments, 2U);
+        if (Status != XST_SUCCESS) {
+            break;
+        }
+
+        Status = PLD_QSPI_WaitReady(InstancePtr, InstancePtr->ProgramEstUs,
+                                    InstancePtr->Flash.ProgramTimeMaxUs * 2U, &Elapsed);
+        if (Status != XST_SUCCESS) {
+            break;
+        }
+        PLD_QSPI_STATS_RECORD(InstancePtr, PLD_QSPI_OP_PROGRAM, Start, PageLength, XST_SUCCESS);
+
+        // Track tPP with a 1/8 weight moving average
+        InstancePtr->ProgramLastUs = Elapsed;
+        InstancePtr->ProgramEstUs = InstancePtr->ProgramEstUs - (InstancePtr->ProgramEstUs / 8U) + (Elapsed / 8U);
+
+        Address += PageLength;
+        Data += PageLength;
+        Length -= PageLength;
+
+        if (Length == 0) {
+            // Use the gap after a write to move any background erase along, its errors are
+            // left for the erase ahead calls to report
+            PLD_QSPI_EraseAheadService(InstancePtr);
+            return XST_SUCCESS;
+        }
+    }
+
+    // Only a failed page leaves the loop
+    PLD_QSPI_STATS_RECORD(InstancePtr, PLD_QSPI_OP_PROGRAM, Start, PageLength, Status);
+
+    return Status;
+}
+
+/**
+ * Issue one page program and return without waiting for it
+ * Data may not cross a page boundary. PLD_QSPI_ProgramPoll reports when
+ * the page is done. Any other command first waits for it, so the caller
+ * can get on with other work while the flash programs. The flash must
+ * already be erased, as for PLD_QSPI_Write.
+ */
+XStatus PLD_QSPI_ProgramStart(PLD_QSPI_t *InstancePtr, uint32_t Address, const uint8_t *Data, uint32_t Length)
+{
+    XStatus Status;
+    PLD_QSPI_Segment_t Segments[2];
+    uint8_t Header[PLD_QSPI_MAX_READ_HEADER];
+    uint32_t Limit = PLD_QSPI_AddressLimit(InstancePtr);
+
+    // Check if driver is ready
+    if (InstancePtr->Qspi.IsReady != XIL_COMPONENT_IS_READY) {
+        return XST_DEVICE_NOT_FOUND;
+    }
+
+    if (Data == NULL || Length == 0 || Address >= Limit || Length > Limit - Address ||
+        Length > InstancePtr->Flash.PageSize - (Address % InstancePtr->Flash.PageSize)) {
+        return XST_INVALID_PARAM;
+    }
+
+    Status = PLD_QSPI_SettleEraseAhead(InstancePtr);
+    if (Status != XST_SUCCESS) {
+        return Status;
+    }
+
+    PLD_QSPI_NotifyModify(InstancePtr, Address, Length);
+
+    InstancePtr->ProgramStart = PLD_QSPI_STATS_STAMP();
+
+    Status = PLD_QSPI_SelectBank(InstancePtr, Address);
+    if (Status == XST_SUCCESS) {
+        Status = PLD_QSPI_WriteEnable(InstancePtr);
+    }
+    if (Status == XST_SUCCESS) {
+        Segments[0].Tx = Header;
+        Segments[0].Rx = NULL;
+        Segments[0].Length = PLD_QSPI_BuildProgramHeader(InstancePtr, Address, Header);
+        Segments[1].Tx = Data;
+        Segments[1].Rx = NULL;
+        Segments[1].Length = Length;
+        Status = PLD_QSPI_TransferV(InstancePtr, Segments, 2U);
+    }
+    if (Status != XST_SUCCESS) {
+        PLD_QSPI_STATS_RECORD(InstancePtr, PLD_QSPI_OP_PROGRAM, InstancePtr->ProgramStart, Length, Status);
+        return Status;
+    }
+
+    InstancePtr->ProgramPending = Length;
+    InstancePtr->ProgramAddress = Address;
+    InstancePtr->ProgramIssuedUs = PLD_QSPI_NowUs();
+
+    return XST_SUCCESS;
+}
+
+/**
+ * Check on the page PLD_QSPI_ProgramStart issued, with one status read
+ * Returns XST_DEVICE_BUSY while it programs, XST_SUCCESS once it is done
+ * (or when none is in flight), and XST_TIMEOUT past twice the worst case
+ * page program time.
+ */
+XStatus PLD_QSPI_ProgramPoll(PLD_QSPI_t *InstancePtr)
+{
+    XStatus Status;
+    uint8_t FlashStatus;
+
+    if (InstancePtr->ProgramPending == 0) {
+        return XST_SUCCESS;
+    }
+
+    Status = PLD_QSPI_SelectFlashOf(InstancePtr, InstancePtr->ProgramAddress);
+    if (Status == XST_SUCCESS) {
+        Status = PLD_QSPI_ReadStatus(InstancePtr, &FlashStatus);
+    }
+    if (Status == XST_SUCCESS && (FlashStatus & PLD_QSPI_SR_WIP)) {
+        if (PLD_QSPI_NowUs() - InstancePtr->ProgramIssuedUs <= InstancePtr->Flash.ProgramTimeMaxUs * 2U) {
+            return XST_DEVICE_BUSY;
+        }
+        Status = XST_TIMEOUT;
+    }
+
+    // The poll interval is the caller's, so unlike PLD_QSPI_Write this leaves the tPP estimate alone
+    PLD_QSPI_STATS_RECORD(InstancePtr, PLD_QSPI_OP_PROGRAM, InstancePtr->ProgramStart,
+                          InstancePtr->ProgramPending, Status);
+    InstancePtr->ProgramPending = 0;
+
+    return Status;
+}
+
+/**
+ * Highest address reachable with the current addressing mode
+ */
+static uint32_t PLD_QSPI_AddressLimit(PLD_QSPI_t *InstancePtr)
+{
+    // 3 byte addressing without a bank register reaches the first 16MB of a flash only
+    if (InstancePtr->Flash.AddressMode == PLD_QSPI_ADDR_3BYTE && InstancePtr->DeviceSize > PLD_QSPI_BANK_SIZE) {
+        return (InstancePtr->ConnectionMode == PLD_QSPI_CONNECTION_PARALLEL) ? 2U * PLD_QSPI_BANK_SIZE : PLD_QSPI_BANK_SIZE;
+    }
+
+    return InstancePtr->Flash.Size;
+}
+
+/**
+ * Bytes behind one chip select: both parallel flashes, or one stacked flash
+ */
+static uint32_t PLD_QSPI_TargetSize(PLD_QSPI_t *InstancePtr)
+{
+    return (InstancePtr->ConnectionMode == PLD_QSPI_CONNECTION_STACKED) ? InstancePtr->DeviceSize : InstancePtr->Flash.Size;
+}
+
+/**
+ * Address a command carries on the bus for a driver address
+ * Parallel flashes each hold every other byte. Stacked flashes each start at 0.
+ */
+static uint32_t PLD_QSPI_DeviceAddress(PLD_QSPI_t *InstancePtr, uint32_t Address)
+{
+    if (InstancePtr->ConnectionMode == PLD_QSPI_CONNECTION_PARALLEL) {
+        return Address / 2U;
+    }
+
+    if (InstancePtr->ConnectionMode == PLD_QSPI_CONNECTION_STACKED) {
+        return Address % InstancePtr->DeviceSize;
+    }
+
+    return Address;
+}
+
+/**
+ * Write a command address in the flash's address format
+ * Returns the number of address bytes.
+ */
+static uint32_t PLD_QSPI_PutAddress(PLD_QSPI_t *InstancePtr, uint32_t Address, uint8_t *Frame)
+{
+    uint32_t Length = 0;
+
+    Address = PLD_QSPI_DeviceAddress(InstancePtr, Address);
+
+    if (InstancePtr->Flash.AddressMode == PLD_QSPI_ADDR_4BYTE) {
+        Frame[Length++] = (uint8_t)(Address >> 24);
+    }
+    Frame[Length++] = (uint8_t)(Address >> 16);
+    Frame[Length++] = (uint8_t)(Address >> 8);
+    Frame[Length++] = (uint8_t)Address;
+
+    return Length;
+}
+
+/**
+ * Point I/O mode at the lower (0) or upper (1) stacked flash
+ * The selection is cached like the bank, other configurations ignore it.
+ */
+static XStatus PLD_QSPI_SelectDevice(PLD_QSPI_t *InstancePtr, uint32_t Device)
+{
+    XStatus Status;
+
+    if (InstancePtr->ConnectionMode != PLD_QSPI_CONNECTION_STACKED || InstancePtr->Device == Device) {
+        return XST_SUCCESS;
+    }
+
+    Status = XQspiPs_SetLqspiConfigReg(&InstancePtr->Qspi,
+                                       InstancePtr->IoConfig | (Device ? XQSPIPS_LQSPI_CR_U_PAGE_MASK : 0));
+    if (Status != XST_SUCCESS) {
+        return Status;
+    }
+
+    InstancePtr->Device = Device;
+
+    return XST_SUCCESS;
+}
+
+/**
+ * Select the flash holding Address and point its bank / extended address
+ * register at the 16MB bank holding it
+ * The selected bank is cached in the handle, so sequential operations only
+ * pay for a register write when they cross into another bank. Nothing is
+ * sent unless the flash uses bank addressing.
+ */
+static XStatus PLD_QSPI_SelectBank(PLD_QSPI_t *InstancePtr, uint32_t Address)
+{
+    XStatus Status;
+    uint32_t Device = (InstancePtr->ConnectionMode == PLD_QSPI_CONNECTION_STACKED) ? Address / InstancePtr->DeviceSize : 0;
+    uint32_t Bank = PLD_QSPI_DeviceAddress(InstancePtr, Address) / PLD_QSPI_BANK_SIZE;
+    uint8_t Frame[3];
+    uint32_t Length = 2U;
+
+    Status = PLD_QSPI_SelectDevice(InstancePtr, Device);
+    if (Status != XST_SUCCESS) {
+        return Status;
+    }
+
+    if (InstancePtr->Flash.AddressMode != PLD_QSPI_ADDR_BANK || InstancePtr->Bank[Device] == Bank) {
+        return XST_SUCCESS;
+    }
+
+    if (InstancePtr->Flash.BankNeedsWren) {
+        Status = PLD_QSPI_WriteEnable(InstancePtr);
+        if (Status != XST_SUCCESS) {
+            return Status;
+        }
+    }
+
+    Frame[0] = InstancePtr->Flash.BankWriteCmd;
+    Frame[1] = (uint8_t)Bank;
+    Frame[2] = (uint8_t)Bank;
+
+    // Parallel flashes each latch every other data byte, so both need a copy
+    if (InstancePtr->ConnectionMode == PLD_QSPI_CONNECTION_PARALLEL) {
+        Length = 3U;
+    }
+
+    Status = PLD_QSPI_Transfer(InstancePtr, Frame, NULL, Length);
+    if (Status != XST_SUCCESS) {
+        InstancePtr->Bank[Device] = PLD_QSPI_BANK_UNKNOWN;
+        return Status;
+    }
+
+    InstancePtr->Bank[Device] = Bank;
+
+    return XST_SUCCESS;
+}
+
+/**
+ * Longest read from Address, up to Length, that stays in the current bank
+ * or stacked flash
+ */
+static uint32_t PLD_QSPI_ReadSpan(PLD_QSPI_t *InstancePtr, uint32_t Address, uint32_t Length)
+{
+    uint32_t Span = PLD_QSPI_TargetSize(InstancePtr);
+    uint32_t BankSpan = PLD_QSPI_BANK_SIZE;
+    uint32_t Left;
+
+    if (InstancePtr->Flash.AddressMode == PLD_QSPI_ADDR_BANK) {
+        if (InstancePtr->ConnectionMode == PLD_QSPI_CONNECTION_PARALLEL) {
+            BankSpan *= 2U;
+        }
+        if (BankSpan < Span) {
+            Span = BankSpan;
+        }
+    }
+
+    Left = Span - (Address % Span);
+
+    return (Length < Left) ? Length : Left;
+}
+
+/**
+ * Length of the next streamed read chunk, which must not leave the current
+ * bank or stacked flash
+ */
+static uint32_t PLD_QSPI_ReadChunk(PLD_QSPI_t *InstancePtr, uint32_t Address, uint32_t Length)
+{
+    return PLD_QSPI_ReadSpan(InstancePtr, Address, (Length < PLD_QSPI_STREAM_CHUNK_SIZE) ? Length : PLD_QSPI_STREAM_CHUNK_SIZE);
+}
+
+/**
+ * Send a command followed by an address, with write enable first
+ */
+static XStatus PLD_QSPI_SendAddressCmd(PLD_QSPI_t *InstancePtr, uint8_t Cmd, uint32_t Address)
+{
+    XStatus Status;
+    uint8_t Frame[5];
+    uint32_t Length = 1U;
+
+    Status = PLD_QSPI_SelectBank(InstancePtr, Address);
+    if (Status != XST_SUCCESS) {
+        return Status;
+    }
+
+    Status = PLD_QSPI_WriteEnable(InstancePtr);
+    if (Status != XST_SUCCESS) {
+        return Status;
+    }
+
+    Frame[0] = Cmd;
+    Length += PLD_QSPI_PutAddress(InstancePtr, Address, &Frame[Length]);
+
+    return PLD_QSPI_Transfer(InstancePtr, Frame, NULL, Length);
+}
+
+/**
+ * Cheapest time to erase one whole aligned block of erase type Level
+ * Either one erase of that type or the best erase of each sub-block,
+ * whichever the part's timings make faster.
+ */
+static uint32_t PLD_QSPI_BlockCostUs(PLD_QSPI_t *InstancePtr, uint32_t Level)
+{
+    PLD_QSPI_EraseType_t *Type = &InstancePtr->Flash.Erase[Level];
+    uint32_t SplitUs;
+
+    if (Level == 0) {
+        return Type->TimeUs;
+    }
+
+    SplitUs = (Type->Size / InstancePtr->Flash.Erase[Level - 1].Size) * PLD_QSPI_BlockCostUs(InstancePtr, Level - 1);
+
+    return (SplitUs < Type->TimeUs) ? SplitUs : Type->TimeUs;
+}
+
+/**
+ * Largest erase type aligned at Address that fits in Length
+ */
+static uint32_t PLD_QSPI_PickEraseLevel(PLD_QSPI_t *InstancePtr, uint32_t Address, uint32_t Length)
+{
+    uint32_t Level = InstancePtr->Flash.EraseTypes - 1U;
+
+    while (Level > 0) {
+        uint32_t Size = InstancePtr->Flash.Erase[Level].Size;
+
+        if ((Address % Size) == 0 && Size <= Length) {
+            break;
+        }
+        Level--;
+    }
+
+    return Level;
+}
+
+/**
+ * Erase (or just cost, when Execute is 0) one aligned block the cheapest way
+ * With a dirty map, blank blocks are passed over, and a block is erased
+ * piecewise when erasing only its dirty sub-blocks is quicker. RewriteUs
+ * charges each page of a clean sub-block a whole erase would wipe, for
+ * callers that have to program it back. Every block erased is marked in
+ * the map, so afterwards it shows what was erased.
+ */
+static XStatus PLD_QSPI_EraseBlock(PLD_QSPI_t *InstancePtr, uint32_t Address, uint32_t Level, uint32_t Execute,
+                                   PLD_QSPI_BlankMap_t *MapPtr, uint32_t RewriteUs, uint32_t *CostUsPtr)
+{
+    XStatus Status;
+    PLD_QSPI_EraseType_t *Type = &InstancePtr->Flash.Erase[Level];
+    uint32_t SubSize = (Level > 0) ? InstancePtr->Flash.Erase[Level - 1].Size : Type->Size;
+    uint32_t WholeUs = Type->TimeUs;
+    uint32_t SplitUs;
+    uint32_t Offset;
+    uint64_t Start;
+
+    if (MapPtr != NULL) {
+        Offset = PLD_QSPI_DirtyBlocks(MapPtr, Address, Type->Size, SubSize);
+        if (Offset == 0) {
+            InstancePtr->EraseSkips++;
+            return XST_SUCCESS;
+        }
+        SplitUs = (Level > 0) ? Offset * PLD_QSPI_BlockCostUs(InstancePtr, Level - 1) : Type->TimeUs;
+        WholeUs += (Type->Size / SubSize - Offset) * (SubSize / InstancePtr->Flash.PageSize) * RewriteUs;
+    } else {
+        SplitUs = PLD_QSPI_BlockCostUs(InstancePtr, Level);
+    }
+
+    // Smaller erases win for this block, descend a level
+    if (Level > 0 && SplitUs < WholeUs) {
+        for (Offset = 0; Offset < Type->Size; Offset += SubSize) {
+            Status = PLD_QSPI_EraseBlock(InstancePtr, Address + Offset, Level - 1, Execute, MapPtr,
+                                         RewriteUs, CostUsPtr);
+            if (Status != XST_SUCCESS) {
+                return Status;
+            }
+        }
+        return XST_SUCCESS;
+    }
+
+    *CostUsPtr += Type->TimeUs;
+
+    if (!Execute) {
+        return XST_SUCCESS;
+    }
+
+    Start = PLD_QSPI_STATS_STAMP();
+    Status = PLD_QSPI_SendAddressCmd(InstancePtr, Type->Cmd, Address);
+    if (Status == XST_SUCCESS) {
+        Status = PLD_QSPI_WaitReady(InstancePtr, Type->TimeUs, Type->TimeMaxUs * 2U, NULL);
+    }
+    PLD_QSPI_STATS_RECORD(InstancePtr, PLD_QSPI_OP_ERASE, Start, Type->Size, Status);
+
+    if (Status == XST_SUCCESS && MapPtr != NULL) {
+        PLD_QSPI_MapMark(MapPtr, Address, Type->Size);
+    }
+
+    return Status;
+}
+
+/**
+ * Walk a range as maximal aligned erase blocks, erasing or costing each
+ * Blocks can't extend past the range, so every valid erase sequence is a
+ * refinement of this walk and picking the cheapest way per block is optimal.
+ * With ChipErase set, a whole flash (or parallel pair) in the range is
+ * chip erased instead where that is faster than its walk.
+ */
+static XStatus PLD_QSPI_ErasePlan(PLD_QSPI_t *InstancePtr, uint32_t Address, uint32_t Length,
+                                  uint32_t Execute, uint32_t ChipErase, uint32_t *CostUsPtr)
+{
+    XStatus Status;
+    uint32_t Level;
+    uint32_t WalkUs = 0;
+    uint32_t BlockUs;
+    uint32_t Blank;
+    uint32_t Target = PLD_QSPI_TargetSize(InstancePtr);
+    uint32_t TargetLeft = Target - (Address % Target);
+    uint8_t Cmd = PLD_QSPI_CMD_CHIP_ERASE;
+    uint64_t Start;
+    PLD_QSPI_BlankMap_t Map;
+    PLD_QSPI_BlankMap_t *MapPtr = NULL;
+
+    *CostUsPtr = 0;
+
+    // Plan stacked flashes one at a time, so each can be chip erased
+    if (Length > TargetLeft) {
+        Status = PLD_QSPI_ErasePlan(InstancePtr, Address, TargetLeft, Execute, ChipErase, &WalkUs);
+        if (Status != XST_SUCCESS) {
+            return Status;
+        }
+
+        Status = PLD_QSPI_ErasePlan(InstancePtr, Address + TargetLeft, Length - TargetLeft, Execute, ChipErase,
+                                    CostUsPtr);
+        *CostUsPtr += WalkUs;
+        return Status;
+    }
+
+    // Compare the block walk against a chip erase when a whole flash (or parallel pair) is covered
+    if (ChipErase && TargetLeft == Target && Length == Target) {
+        PLD_QSPI_ErasePlan(InstancePtr, Address, Length, 0, 0, &WalkUs);
+
+        if (InstancePtr->Flash.ChipEraseTimeUs < WalkUs) {
+            *CostUsPtr = InstancePtr->Flash.ChipEraseTimeUs;
+            if (!Execute) {
+                return XST_SUCCESS;
+            }
+
+            // The first dirty word ends the check, so only blank flashes are read through
+            if (InstancePtr->BlankCheck) {
+                Status = PLD_QSPI_ScanBlank(InstancePtr, Address, Length, Length, &Blank, NULL);
+                if (Status != XST_SUCCESS) {
+                    return Status;
+                }
+                if (Blank) {
+                    *CostUsPtr = 0;
+                    InstancePtr->EraseSkips++;
+                    InstancePtr->EraseSkippedUs += InstancePtr->Flash.ChipEraseTimeUs;
+                    return XST_SUCCESS;
+                }
+            }
+
+            Start = PLD_QSPI_STATS_STAMP();
+            Status = PLD_QSPI_SelectDevice(InstancePtr,
+                                           (InstancePtr->ConnectionMode == PLD_QSPI_CONNECTION_STACKED) ? Address / Target : 0);
+            if (Status == XST_SUCCESS) {
+                Status = PLD_QSPI_WriteEnable(InstancePtr);
+            }
+            if (Status == XST_SUCCESS) {
+                Status = PLD_QSPI_Transfer(InstancePtr, &Cmd, NULL, 1);
+            }
+            if (Status == XST_SUCCESS) {
+                Status = PLD_QSPI_WaitReady(InstancePtr, InstancePtr->Flash.ChipEraseTimeUs,
+                                            InstancePtr->Flash.ChipEraseTimeMaxUs * 2U, NULL);
+            }
+            PLD_QSPI_STATS_RECORD(InstancePtr, PLD_QSPI_OP_ERASE, Start, Target, Status);
+
+            return Status;
+        }
+    }
+
+    while (Length >= InstancePtr->Flash.Erase[0].Size) {
+        Level = PLD_QSPI_PickEraseLevel(InstancePtr, Address, Length);
+
+        // Map which smallest erases of the block are dirty, coarser for huge blocks
+        if (Execute && InstancePtr->BlankCheck) {
+            PLD_QSPI_MapInit(&Map, Address, InstancePtr->Flash.Erase[Level].Size, InstancePtr->Flash.Erase[0].Size);
+            Status = PLD_QSPI_ScanBlank(InstancePtr, Address, InstancePtr->Flash.Erase[Level].Size,
+                                        Map.Granule, &Blank, Map.Bits);
+            if (Status != XST_SUCCESS) {
+                return Status;
+            }
+            MapPtr = &Map;
+        }
+
+        BlockUs = 0;
+        Status = PLD_QSPI_EraseBlock(InstancePtr, Address, Level, Execute, MapPtr, 0, &BlockUs);
+        if (Status != XST_SUCCESS) {
+            return Status;
+        }
+        *CostUsPtr += BlockUs;
+        if (MapPtr != NULL) {
+            InstancePtr->EraseSkippedUs += PLD_QSPI_BlockCostUs(InstancePtr, Level) - BlockUs;
+        }
+
+        Address += InstancePtr->Flash.Erase[Level].Size;
+        Length -= InstancePtr->Flash.Erase[Level].Size;
+    }
+
+    return XST_SUCCESS;
+}
+
+/**
+ * Estimate the typical time PLD_QSPI_EraseRange would take for a range
+ */
+XStatus PLD_QSPI_EraseEstimate(PLD_QSPI_t *InstancePtr, uint32_t Address, uint32_t Length, uint32_t *EstimateUsPtr)
+{
+    uint32_t Limit = PLD_QSPI_AddressLimit(InstancePtr);
+    uint32_t Granule = InstancePtr->Flash.Erase[0].Size;
+
+    if (EstimateUsPtr == NULL || Address >= Limit || Length > Limit - Address ||
+        (Address % Granule) != 0 || (Length % Granule) != 0) {
+        return XST_INVALID_PARAM;
+    }
+
+    return PLD_QSPI_ErasePlan(InstancePtr, Address, Length, 0, 1, EstimateUsPtr);
+}
+
+/**
+ * Erase a range using the fastest mix of erase sizes for the part
+ * Address and Length must be multiples of the smallest erase size.
+ */
+XStatus PLD_QSPI_EraseRange(PLD_QSPI_t *InstancePtr, uint32_t Address, uint32_t Length)
+{
+    XStatus Status;
+    uint32_t Limit = PLD_QSPI_AddressLimit(InstancePtr);
+    uint32_t Granule = InstancePtr->Flash.Erase[0].Size;
+    uint32_t CostUs;
+
+    // Check if driver is ready
+    if (InstancePtr->Qspi.IsReady != XIL_COMPONENT_IS_READY) {
+        return XST_DEVICE_NOT_FOUND;
+    }
+
+    if (Address >= Limit || Length > Limit - Address ||
+        (Address % Granule) != 0 || (Length % Granule) != 0) {
+        return XST_INVALID_PARAM;
+    }
+
+    Status = PLD_QSPI_SettleEraseAhead(InstancePtr);
+    if (Status != XST_SUCCESS) {
+        return Status;
+    }
+
+    PLD_QSPI_NotifyModify(InstancePtr, Address, Length);
+
+    return PLD_QSPI_ErasePlan(InstancePtr, Address, Length, 1, 1, &CostUs);
+}
+
+/**
+ * Queue a range for background erasing
+ * The range is erased one block at a time from PLD_QSPI_EraseAheadService,
+ * which PLD_QSPI_Write also calls when it finishes, so a log can pre-erase
+ * its next region in the gaps between writes to the current one. Any
+ * previously queued range is dropped.
+ */
+XStatus PLD_QSPI_EraseAheadStart(PLD_QSPI_t *InstancePtr, uint32_t Address, uint32_t Length)
+{
+    XStatus Status;
+    uint32_t Limit = PLD_QSPI_AddressLimit(InstancePtr);
+    uint32_t Granule = InstancePtr->Flash.Erase[0].Size;
+
+    if (Address >= Limit || Length > Limit - Address ||
+        (Address % Granule) != 0 || (Length % Granule) != 0) {
+        return XST_INVALID_PARAM;
+    }
+
+    Status = PLD_QSPI_SettleEraseAhead(InstancePtr);
+    if (Status != XST_SUCCESS) {
+        return Status;
+    }
+
+    InstancePtr->EraseAheadNext = Address;
+    InstancePtr->EraseAheadEnd = Address + Length;
+
+    return PLD_QSPI_EraseAheadService(InstancePtr);
+}
+
+/**
+ * Advance the background erase without blocking
+ * Returns straight away while an erase is running, otherwise issues the
+ * next block erase of the queued range.
+ */
+XStatus PLD_QSPI_EraseAheadService(PLD_QSPI_t *InstancePtr)
+{
+    XStatus Status;
+    uint8_t FlashStatus;
+    uint32_t Level;
+    uint32_t Blank;
+    PLD_QSPI_EraseType_t *Type;
+
+    // Nothing can start on the flash until a started page program is done
+    if (InstancePtr->ProgramPending != 0) {
+        Status = PLD_QSPI_ProgramPoll(InstancePtr);
+        if (Status != XST_SUCCESS) {
+            return (Status == XST_DEVICE_BUSY) ? XST_SUCCESS : Status;
+        }
+    }
+
+    // A suspended part reads as ready, so get the erase running again first
+    if (InstancePtr->EraseAheadSuspended) {
+        return PLD_QSPI_ResumeEraseAhead(InstancePtr);
+    }
+
+    if (InstancePtr->EraseAheadLevel != 0) {
+        Status = PLD_QSPI_SelectEraseAhead(InstancePtr);
+        if (Status != XST_SUCCESS) {
+            return Status;
+        }
+        Status = PLD_QSPI_ReadStatus(InstancePtr, &FlashStatus);
+        if (Status != XST_SUCCESS || (FlashStatus & PLD_QSPI_SR_WIP)) {
+            return Status;
+        }
+        PLD_QSPI_STATS_RECORD(InstancePtr, PLD_QSPI_OP_ERASE, InstancePtr->EraseAheadStart,
+                              InstancePtr->Flash.Erase[InstancePtr->EraseAheadLevel - 1U].Size, XST_SUCCESS);
+        InstancePtr->EraseAheadLevel = 0;
+    }
+
+    if (InstancePtr->EraseAheadNext >= InstancePtr->EraseAheadEnd) {
+        return XST_SUCCESS;
+    }
+
+    Level = PLD_QSPI_PickEraseLevel(InstancePtr, InstancePtr->EraseAheadNext,
+                                    InstancePtr->EraseAheadEnd - InstancePtr->EraseAheadNext);
+
+    // Where smaller erases are faster for this block, issue the first of them
+    while (Level > 0 && PLD_QSPI_BlockCostUs(InstancePtr, Level) < InstancePtr->Flash.Erase[Level].TimeUs) {
+        Level--;
+    }
+    Type = &InstancePtr->Flash.Erase[Level];
+
+    // A blank block is passed over, one block checked per call
+    if (InstancePtr->BlankCheck) {
+        Status = PLD_QSPI_ScanBlank(InstancePtr, InstancePtr->EraseAheadNext, Type->Size, Type->Size, &Blank, NULL);
+        if (Status != XST_SUCCESS) {
+            return Status;
+        }
+        if (Blank) {
+            InstancePtr->EraseSkips++;
+            InstancePtr->EraseSkippedUs += Type->TimeUs;
+            InstancePtr->EraseAheadNext += Type->Size;
+            return XST_SUCCESS;
+        }
+    }
+
+    PLD_QSPI_NotifyModify(InstancePtr, InstancePtr->EraseAheadNext, Type->Size);
+
+    InstancePtr->EraseAheadStart = PLD_QSPI_STATS_STAMP();
+    Status = PLD_QSPI_SendAddressCmd(InstancePtr, Type->Cmd, InstancePtr->EraseAheadNext);
+    if (Status != XST_SUCCESS) {
+        PLD_QSPI_STATS_RECORD(InstancePtr, PLD_QSPI_OP_ERASE, InstancePtr->EraseAheadStart, Type->Size, Status);
+        return Status;
+    }
+
+    InstancePtr->EraseAheadLevel = Level + 1U;
+    InstancePtr->EraseAheadNext += Type->Size;
+    InstancePtr->EraseAheadResumeUs = PLD_QSPI_NowUs();
+    InstancePtr->EraseAheadRunUs = 0;
+
+    return XST_SUCCESS;
+}
+
+/**
+ * Bytes of the background erase range not yet erased (0 once idle)
+ */
+uint32_t PLD_QSPI_EraseAheadPending(PLD_QSPI_t *InstancePtr)
+{
+    uint32_t Pending = InstancePtr->EraseAheadEnd - InstancePtr->EraseAheadNext;
+
+    if (InstancePtr->EraseAheadLevel != 0) {
+        Pending += InstancePtr->Flash.Erase[InstancePtr->EraseAheadLevel - 1U].Size;
+    }
+
+    return Pending;
+}
+
+/**
+ * Typical time left of the background block erase in flight (0 when none is)
+ * Meant as the ExpectedUs of PLD_QSPI_WaitReady for callers waiting it out.
+ */
+uint32_t PLD_QSPI_EraseAheadRemainingUs(PLD_QSPI_t *InstancePtr)
+{
+    uint32_t Started;
+
+    if (InstancePtr->EraseAheadLevel == 0) {
+        return 0;
+    }
+
+    // A suspended erase is not running, only its time before the suspend counts
+    Started = InstancePtr->EraseAheadSuspended ? PLD_QSPI_NowUs() : InstancePtr->EraseAheadResumeUs;
+
+    return PLD_QSPI_RemainingUs(InstancePtr->Flash.Erase[InstancePtr->EraseAheadLevel - 1U].TimeUs,
+                                Started - InstancePtr->EraseAheadRunUs);
+}
+
+/**
+ * Check whether a flash range reads back erased (all 0xFF)
+ * The range is read through a frame buffer, a short probe first and then
+ * in growing chunks, and the scan stops at the first dirty chunk. With
+ * DirtyMap, bit n is set when the n-th smallest erase sector from the one
+ * holding Address is dirty. Each sector's scan stops at its first dirty
+ * chunk. The caller sizes the map, one bit per sector.
+ */
+XStatus PLD_QSPI_IsBlank(PLD_QSPI_t *InstancePtr, uint32_t Address, uint32_t Length,
+                         uint32_t *BlankPtr, uint32_t *DirtyMap)
+{
+    XStatus Status;
+    XStatus Resume;
+    uint32_t Limit = PLD_QSPI_AddressLimit(InstancePtr);
+    uint64_t Start;
+
+    if (BlankPtr == NULL || Address >= Limit || Length > Limit - Address) {
+        return XST_INVALID_PARAM;
+    }
+
+    Start = PLD_QSPI_STATS_STAMP();
+    Status = PLD_QSPI_ScanBlank(InstancePtr, Address, Length, InstancePtr->Flash.Erase[0].Size, BlankPtr, DirtyMap);
+    Resume = PLD_QSPI_ResumeEraseAhead(InstancePtr);
+    if (Status == XST_SUCCESS) {
+        Status = Resume;
+    }
+    PLD_QSPI_STATS_RECORD(InstancePtr, PLD_QSPI_OP_READ, Start, Length, Status);
+
+    return Status;
+}
+
+/**
+ * Let erases pass over blocks that already read back erased
+ * PLD_QSPI_EraseRange maps each block it is about to erase, skips it when
+ * blank and erases only the dirty sub-blocks when that is quicker. Erase-
+ * ahead checks one block per service call. An erase interrupted by a
+ * power loss can leave cells that read 0xFF but are not fully erased, so
+ * leave this off for ranges an erase may have been cut short on.
+ */
+void PLD_QSPI_UseBlankCheck(PLD_QSPI_t *InstancePtr, uint32_t Enable)
+{
+    InstancePtr->BlankCheck = Enable ? 1 : 0;
+}
+
+/**
+ * Let reads suspend a background erase rather than wait for it (the default)
+ * Only parts whose description has a suspend opcode are suspended. Off,
+ * a read waits out the rest of the block erase in flight.
+ */
+void PLD_QSPI_UseSuspend(PLD_QSPI_t *InstancePtr, uint32_t Enable)
+{
+    InstancePtr->UseSuspend = Enable ? 1 : 0;
+}
+
+/**
+ * Body of PLD_QSPI_IsBlank with the dirty map in Granule sized units
+ */
+static XStatus PLD_QSPI_ScanBlank(PLD_QSPI_t *InstancePtr, uint32_t Address, uint32_t Length,
+                                  uint32_t Granule, uint32_t *BlankPtr, uint32_t *DirtyMap)
+{
+    XStatus Status;
+    uint32_t First = Address / Granule;
+    uint32_t Probe = PLD_QSPI_BLANK_PROBE;
+    uint32_t Span;
+    uint32_t Index;
+
+    *BlankPtr = 1;
+
+    if (Length == 0) {
+        return XST_SUCCESS;
+    }
+
+    if (DirtyMap != NULL) {
+        memset(DirtyMap, 0, (((Address + Length - 1U) / Granule - First) / 32U + 1U) * sizeof(uint32_t));
+    }
+
+    while (Length > 0) {
+        Span = (Probe < Length) ? Probe : Length;
+        if (DirtyMap != NULL && Span > Granule - Address % Granule) {
+            Span = Granule - Address % Granule;
+        }
+
+        Status = PLD_QSPI_ReadDirect(InstancePtr, Address, InstancePtr->Frame[0], Span, NULL);
+        if (Status != XST_SUCCESS) {
+            return Status;
+        }
+
+        if (!PLD_QSPI_Erased(InstancePtr->Frame[0], Span)) {
+            *BlankPtr = 0;
+            if (DirtyMap == NULL) {
+                return XST_SUCCESS;
+            }
+
+            // The rest of the granule can't make it any dirtier
+            Index = Address / Granule - First;
+            DirtyMap[Index / 32U] |= 1U << (Index % 32U);
+            Span = Granule - Address % Granule;
+            if (Span > Length) {
+                Span = Length;
+            }
+            Probe = PLD_QSPI_BLANK_PROBE;
+        } else if (Probe < PLD_QSPI_STREAM_CHUNK_SIZE) {
+            Probe *= 2U;
+        }
+
+        Address += Span;
+        Length -= Span;
+    }
+
+    return XST_SUCCESS;
+}
+
+/**
+ * Whether Length bytes all read 0xFF
+ * Compared 32 bytes at a time as four 64-bit words ANDed together, which
+ * compilers targeting NEON turn into vector loads and ANDs.
+ */
+static uint32_t PLD_QSPI_Erased(const uint8_t *Data, uint32_t Length)
+{
+    uint64_t Words[4];
+
+    while (Length > 0 && ((uintptr_t)Data & 7U) != 0) {
+        if (*Data++ != 0xFFU) {
+            return 0;
+        }
+        Length--;
+    }
+
+    while (Length >= sizeof(Words)) {
+        memcpy(Words, Data, sizeof(Words));
+        if ((Words[0] & Words[1] & Words[2] & Words[3]) != UINT64_MAX) {
+            return 0;
+        }
+        Data += sizeof(Words);
+        Length -= sizeof(Words);
+    }
+
+    while (Length > 0) {
+        if (*Data++ != 0xFFU) {
+            return 0;
+        }
+        Length--;
+    }
+
+    return 1;
+}
+
+/**
+ * Size byte sub-blocks of a block with a dirty granule in the map
+ */
+static uint32_t PLD_QSPI_DirtyBlocks(const PLD_QSPI_BlankMap_t *MapPtr, uint32_t Address, uint32_t Length,
+                                     uint32_t Size)
+{
+    uint32_t Dirty = 0;
+    uint32_t Offset;
+    uint32_t Bit;
+    uint32_t End;
+
+    for (Offset = 0; Offset < Length; Offset += Size) {
+        Bit = (Address + Offset - MapPtr->Base) / MapPtr->Granule;
+        End = (Address + Offset + Size - 1U - MapPtr->Base) / MapPtr->Granule;
+        for (; Bit <= End; Bit++) {
+            if (MapPtr->Bits[Bit / 32U] & (1U << (Bit % 32U))) {
+                Dirty++;
+                break;
+            }
+        }
+    }
+
+    return Dirty;
+}
+
+/**
+ * Empty map over a Length byte block, Granule coarsened until it fits
+ */
+static void PLD_QSPI_MapInit(PLD_QSPI_BlankMap_t *MapPtr, uint32_t Base, uint32_t Length, uint32_t Granule)
+{
+    MapPtr->Base = Base;
+    MapPtr->Granule = Granule;
+    while (Length / MapPtr->Granule > 32U * PLD_QSPI_BLANK_MAP_WORDS) {
+        MapPtr->Granule *= 2U;
+    }
+    memset(MapPtr->Bits, 0, sizeof(MapPtr->Bits));
+}
+
+/**
+ * Mark every granule of a map that Length bytes from Address touch
+ */
+static void PLD_QSPI_MapMark(PLD_QSPI_BlankMap_t *MapPtr, uint32_t Address, uint32_t Length)
+{
+    uint32_t Bit = (Address - MapPtr->Base) / MapPtr->Granule;
+    uint32_t End = (Address + Length - 1U - MapPtr->Base) / MapPtr->Granule;
+
+    for (; Bit <= End; Bit++) {
+        MapPtr->Bits[Bit / 32U] |= 1U << (Bit % 32U);
+    }
+}
+
+/**
+ * Bring a sector aligned range of flash up to date with Data, touching only what differs
+ * Each erase block of the range is read back a chunk at a time and
+ * compared. Sectors (smallest erases) that already hold the data are left
+ * alone. Sectors that only need bits cleared have the pages that differ
+ * programmed over the old data. Only sectors that need a bit set back to 1
+ * are erased, through the erase planner, then rewritten, skipping pages
+ * that are all 0xFF. A larger erase is taken where it is quicker even
+ * after programming back the unchanged sectors it wipes. UpdatePtr, if not NULL, receives what was done, also on failure.
+ */
+XStatus PLD_QSPI_UpdateRegion(PLD_QSPI_t *InstancePtr, uint32_t Address, const uint8_t *Data, uint32_t Length,
+                              PLD_QSPI_Update_t *UpdatePtr)
+{
+    XStatus Status = XST_SUCCESS;
+    XStatus Resume;
+    PLD_QSPI_Update_t Update;
+    uint32_t Limit = PLD_QSPI_AddressLimit(InstancePtr);
+    uint32_t Granule = InstancePtr->Flash.Erase[0].Size;
+    uint32_t Level;
+    uint32_t Size;
+
+    // Check if driver is ready
+    if (InstancePtr->Qspi.IsReady != XIL_COMPONENT_IS_READY) {
+        return XST_DEVICE_NOT_FOUND;
+    }
+
+    if (Data == NULL || Address >= Limit || Length > Limit - Address ||
+        (Address % Granule) != 0 || (Length % Granule) != 0) {
+        return XST_INVALID_PARAM;
+    }
+
+    memset(&Update, 0, sizeof(Update));
+
+    // Same block walk as the erase planner, so a changed run of sectors can share an erase
+    while (Length > 0 && Status == XST_SUCCESS) {
+        Level = PLD_QSPI_PickEraseLevel(InstancePtr, Address, Length);
+        Size = InstancePtr->Flash.Erase[Level].Size;
+
+        Status = PLD_QSPI_UpdateBlock(InstancePtr, Address, Level, Data, &Update);
+
+        Address += Size;
+        Data += Size;
+        Length -= Size;
+    }
+
+    // Comparing an unchanged region only suspends a background erase, let it run on
+    Resume = PLD_QSPI_ResumeEraseAhead(InstancePtr);
+    if (Status == XST_SUCCESS) {
+        Status = Resume;
+    }
+
+    if (UpdatePtr != NULL) {
+        *UpdatePtr = Update;
+    }
+
+    return Status;
+}
+
+/**
+ * Body of PLD_QSPI_UpdateRegion for one aligned erase block of type Level
+ */
+static XStatus PLD_QSPI_UpdateBlock(PLD_QSPI_t *InstancePtr, uint32_t Address, uint32_t Level,
+                                    const uint8_t *Data, PLD_QSPI_Update_t *UpdatePtr)
+{
+    XStatus Status;
+    PLD_QSPI_BlankMap_t Pages;              /* Pages that differ */
+    PLD_QSPI_BlankMap_t Sectors;            /* Sectors that need an erase, then every sector erased */
+    uint32_t Size = InstancePtr->Flash.Erase[Level].Size;
+    uint32_t Sector = InstancePtr->Flash.Erase[0].Size;
+    uint32_t PageSize = InstancePtr->Flash.PageSize;
+    uint32_t Changes = 0;
+    uint32_t Offset;
+    uint32_t Span;
+    uint32_t Part;
+    uint32_t Run;
+    uint32_t Program;
+    uint32_t Skips;
+    uint32_t CostUs = 0;
+
+    PLD_QSPI_MapInit(&Pages, Address, Size, PageSize);
+    PLD_QSPI_MapInit(&Sectors, Address, Size, Sector);
+
+    // Compare a chunk at a time, a sector that needs an erase is rewritten whole so isn't read any further
+    for (Offset = 0; Offset < Size; Offset += Span) {
+        Span = Sectors.Granule - Offset % Sectors.Granule;
+        if (Span > PLD_QSPI_STREAM_CHUNK_SIZE) {
+            Span = PLD_QSPI_STREAM_CHUNK_SIZE;
+        }
+
+        Status = PLD_QSPI_ReadDirect(InstancePtr, Address + Offset, InstancePtr->Frame[0], Span, NULL);
+        if (Status != XST_SUCCESS) {
+            return Status;
+        }
+        UpdatePtr->BytesRead += Span;
+
+        for (Part = 0; Part < Span; Part += Run) {
+            Run = Pages.Granule - (Offset + Part) % Pages.Granule;
+            if (Run > Span - Part) {
+                Run = Span - Part;
+            }
+
+            Changes = PLD_QSPI_Compare(InstancePtr->Frame[0] + Part, Data + Offset + Part, Run);
+            if (Changes & PLD_QSPI_CHANGE_DIFFERS) {
+                PLD_QSPI_MapMark(&Pages, Address + Offset + Part, Run);
+            }
+            if (Changes & PLD_QSPI_CHANGE_ERASE) {
+                break;
+            }
+        }
+
+        if (Changes & PLD_QSPI_CHANGE_ERASE) {
+            PLD_QSPI_MapMark(&Sectors, Address + Offset, 1U);
+            Span = Sectors.Granule - Offset % Sectors.Granule;
+        }
+    }
+
+    if (PLD_QSPI_DirtyBlocks(&Sectors, Address, Size, Size) != 0) {
+        Status = PLD_QSPI_SettleEraseAhead(InstancePtr);
+        if (Status != XST_SUCCESS) {
+            return Status;
+        }
+
+        PLD_QSPI_NotifyModify(InstancePtr, Address, Size);
+
+        // Sectors a larger erase wipes needlessly are programmed back, so that counts against it.
+        // Unchanged sectors passed over here aren't blank skips.
+        Skips = InstancePtr->EraseSkips;
+        Status = PLD_QSPI_EraseBlock(InstancePtr, Address, Level, 1, &Sectors,
+                                     InstancePtr->ProgramEstUs, &CostUs);
+        InstancePtr->EraseSkips = Skips;
+        if (Status != XST_SUCCESS) {
+            return Status;
+        }
+    }
+
+    for (Offset = 0; Offset < Size; Offset += Sector) {
+        if (PLD_QSPI_DirtyBlocks(&Sectors, Address + Offset, Sector, Sector) != 0) {
+            UpdatePtr->SectorsErased++;
+        } else if (PLD_QSPI_DirtyBlocks(&Pages, Address + Offset, Sector, Sector) != 0) {
+            UpdatePtr->SectorsProgrammed++;
+        } else {
+            UpdatePtr->SectorsSame++;
+        }
+    }
+
+    // Program runs of pages, changed ones over old data and non-blank ones of erased sectors
+    Run = 0;
+    for (Offset = 0; Offset <= Size; Offset += PageSize) {
+        Program = 0;
+        if (Offset < Size) {
+            if (PLD_QSPI_DirtyBlocks(&Sectors, Address + Offset, PageSize, PageSize) != 0) {
+                Program = !PLD_QSPI_Erased(Data + Offset, PageSize);
+            } else {
+                Program = PLD_QSPI_DirtyBlocks(&Pages, Address + Offset, PageSize, PageSize);
+            }
+        }
+
+        if (Program) {
+            Run += PageSize;
+        } else if (Run > 0) {
+            Status = PLD_QSPI_Write(InstancePtr, Address + Offset - Run, Data + Offset - Run, Run);
+            if (Status != XST_SUCCESS) {
+                return Status;
+            }
+            UpdatePtr->PagesProgrammed += Run / PageSize;
+            UpdatePtr->BytesProgrammed += Run;
+            Run = 0;
+        }
+    }
+
+    return XST_SUCCESS;
+}
+
+/**
+ * How the Length bytes read back from flash (Old) differ from the data
+ * wanted there (New), as PLD_QSPI_CHANGE_* flags
+ * Programming can only clear bits, so any bit New has set where Old has it
+ * clear needs an erase. Compared 8 bytes at a time, stopping at the first.
+ */
+static uint32_t PLD_QSPI_Compare(const uint8_t *Old, const uint8_t *New, uint32_t Length)
+{
+    uint64_t OldWord;
+    uint64_t NewWord;
+    uint64_t Differ = 0;
+    uint64_t Sets = 0;
+
+    while (Length >= sizeof(OldWord) && Sets == 0) {
+        memcpy(&OldWord, Old, sizeof(OldWord));
+        memcpy(&NewWord, New, sizeof(NewWord));
+        Differ |= OldWord ^ NewWord;
+        Sets |= NewWord & ~OldWord;
+        Old += sizeof(OldWord);
+        New += sizeof(NewWord);
+        Length -= sizeof(OldWord);
+    }
+
+    while (Length > 0 && Sets == 0) {
+        Differ |= (uint8_t)(*Old ^ *New);
+        Sets |= (uint8_t)(*New & ~*Old);
+        Old++;
+        New++;
+        Length--;
+    }
+
+    return ((Differ != 0) ? PLD_QSPI_CHANGE_DIFFERS : 0U) | ((Sets != 0) ? PLD_QSPI_CHANGE_ERASE : 0U);
+}
+
+/**
+ * Register the callback run ahead of every program and erase (NULL removes it)
+ * Only PLD_QSPI_Write and the erase functions report; raw PLD_QSPI_Transfer
+ * commands that change the flash are not seen.
+ */
+void PLD_QSPI_SetModifyCallback(PLD_QSPI_t *InstancePtr, PLD_QSPI_Modify_t Callback, void *CallbackRef)
+{
+    InstancePtr->ModifyCallback = Callback;
+    InstancePtr->ModifyCallbackRef = CallbackRef;
+}
+
+/**
+ * Tell the registered callback a range is about to change
+ */
+static void PLD_QSPI_NotifyModify(PLD_QSPI_t *InstancePtr, uint32_t Address, uint32_t Length)
+{
+    if (InstancePtr->ModifyCallback != NULL) {
+        InstancePtr->ModifyCallback(InstancePtr->ModifyCallbackRef, Address, Length);
+    }
+}
+
+/**
+ * Wait for a background block erase or started page program in flight, so
+ * a foreground command can run
+ */
+static XStatus PLD_QSPI_SettleEraseAhead(PLD_QSPI_t *InstancePtr)
+{
+    XStatus Status;
+    PLD_QSPI_EraseType_t *Type;
+
+    Status = PLD_QSPI_SettleProgram(InstancePtr);
+    if (Status != XST_SUCCESS) {
+        return Status;
+    }
+
+    if (InstancePtr->EraseAheadLevel == 0) {
+        return XST_SUCCESS;
+    }
+
+    Type = &InstancePtr->Flash.Erase[InstancePtr->EraseAheadLevel - 1U];
+
+    Status = PLD_QSPI_ResumeEraseAhead(InstancePtr);
+    if (Status != XST_SUCCESS) {
+        return Status;
+    }
+
+    Status = PLD_QSPI_SelectEraseAhead(InstancePtr);
+    if (Status != XST_SUCCESS) {
+        return Status;
+    }
+
+    // Part of the erase has usually run already, some of it before any suspends, so only the rest is waited out
+    Status = PLD_QSPI_WaitReady(InstancePtr, PLD_QSPI_EraseAheadRemainingUs(InstancePtr), Type->TimeMaxUs * 2U, NULL);
+    PLD_QSPI_STATS_RECORD(InstancePtr, PLD_QSPI_OP_ERASE, InstancePtr->EraseAheadStart, Type->Size, Status);
+    if (Status != XST_SUCCESS) {
+        return Status;
+    }
+
+    InstancePtr->EraseAheadLevel = 0;
+
+    return XST_SUCCESS;
+}
+
+/**
+ * Make way for a read while a background block erase is in flight
+ * Where the part can suspend, the erase is suspended (PLD_QSPI_ResumeEraseAhead
+ * restarts it), so the read waits at most the resume interval plus the
+ * suspend latency instead of the rest of the erase. Otherwise the erase is
+ * waited out as before.
+ */
+static XStatus PLD_QSPI_PauseEraseAhead(PLD_QSPI_t *InstancePtr)
+{
+    XStatus Status;
+    PLD_QSPI_EraseType_t *Type;
+    uint8_t FlashStatus;
+    uint8_t Cmd = InstancePtr->Flash.SuspendCmd;
+    uint32_t Elapsed;
+    uint32_t Timeout;
+
+    // A page program is over within tPP, not worth a suspend
+    Status = PLD_QSPI_SettleProgram(InstancePtr);
+    if (Status != XST_SUCCESS) {
+        return Status;
+    }
+
+    if (InstancePtr->EraseAheadLevel == 0 || InstancePtr->EraseAheadSuspended) {
+        return XST_SUCCESS;
+    }
+
+    if (!InstancePtr->UseSuspend || Cmd == 0) {
+        return PLD_QSPI_SettleEraseAhead(InstancePtr);
+    }
+
+    Type = &InstancePtr->Flash.Erase[InstancePtr->EraseAheadLevel - 1U];
+
+    // Back to back suspends would starve the erase, parts ignore a suspend this soon.
+    // The clock truncates to whole microseconds, so wait one past the interval.
+    Elapsed = PLD_QSPI_NowUs() - InstancePtr->EraseAheadResumeUs;
+    if (Elapsed <= InstancePtr->Flash.ResumeIntervalUs) {
+        usleep(InstancePtr->Flash.ResumeIntervalUs - Elapsed + 1U);
+    }
+
+    Status = PLD_QSPI_SelectEraseAhead(InstancePtr);
+    if (Status != XST_SUCCESS) {
+        return Status;
+    }
+
+    Status = PLD_QSPI_ReadStatus(InstancePtr, &FlashStatus);
+    if (Status != XST_SUCCESS) {
+        return Status;
+    }
+
+    if (!(FlashStatus & PLD_QSPI_SR_WIP)) {
+        PLD_QSPI_STATS_RECORD(InstancePtr, PLD_QSPI_OP_ERASE, InstancePtr->EraseAheadStart, Type->Size, XST_SUCCESS);
+        InstancePtr->EraseAheadLevel = 0;
+        return XST_SUCCESS;
+    }
+
+    Elapsed = PLD_QSPI_NowUs() - InstancePtr->EraseAheadResumeUs;
+    Status = PLD_QSPI_HeaderRead(InstancePtr, &Cmd, 1U, NULL, 0, NULL);
+    if (Status != XST_SUCCESS) {
+        return Status;
+    }
+
+    // Suspended from here on, even if the wait fails, so the resume is never skipped
+    InstancePtr->EraseAheadRunUs += Elapsed;
+    InstancePtr->EraseAheadSuspended = 1;
+    InstancePtr->Suspends++;
+
+    // An erase that ends before the suspend lands just reads ready, resuming it is then harmless
+    Timeout = InstancePtr->Flash.SuspendTimeUs * 2U;
+    if (Timeout < PLD_QSPI_SUSPEND_TIMEOUT_MIN_US) {
+        Timeout = PLD_QSPI_SUSPEND_TIMEOUT_MIN_US;
+    }
+    return PLD_QSPI_WaitReady(InstancePtr, InstancePtr->Flash.SuspendTimeUs, Timeout, NULL);
+}
+
+/**
+ * Restart a background erase PLD_QSPI_PauseEraseAhead suspended
+ */
+static XStatus PLD_QSPI_ResumeEraseAhead(PLD_QSPI_t *InstancePtr)
+{
+    XStatus Status;
+    uint8_t Cmd = InstancePtr->Flash.ResumeCmd;
+
+    if (!InstancePtr->EraseAheadSuspended) {
+        return XST_SUCCESS;
+    }
+
+    Status = PLD_QSPI_SelectEraseAhead(InstancePtr);
+    if (Status != XST_SUCCESS) {
+        return Status;
+    }
+
+    Status = PLD_QSPI_HeaderRead(InstancePtr, &Cmd, 1U, NULL, 0, NULL);
+    if (Status != XST_SUCCESS) {
+        return Status;
+    }
+
+    InstancePtr->EraseAheadSuspended = 0;
+    InstancePtr->EraseAheadResumeUs = PLD_QSPI_NowUs();
+
+    return XST_SUCCESS;
+}
+
+/**
+ * Point status reads and suspend / resume at the stacked flash erasing ahead
+ * Reads may have selected the other one since the erase was issued.
+ */
+static XStatus PLD_QSPI_SelectEraseAhead(PLD_QSPI_t *InstancePtr)
+{
+    return PLD_QSPI_SelectFlashOf(InstancePtr, InstancePtr->EraseAheadNext -
+                                  InstancePtr->Flash.Erase[InstancePtr->EraseAheadLevel - 1U].Size);
+}
+
+/**
+ * Select the stacked flash holding Address without touching its bank
+ * register, which a busy flash would ignore
+ */
+static XStatus PLD_QSPI_SelectFlashOf(PLD_QSPI_t *InstancePtr, uint32_t Address)
+{
+    if (InstancePtr->ConnectionMode != PLD_QSPI_CONNECTION_STACKED) {
+        return XST_SUCCESS;
+    }
+
+    return PLD_QSPI_SelectDevice(InstancePtr, Address / InstancePtr->DeviceSize);
+}
+
+/**
+ * Wait for a page PLD_QSPI_ProgramStart issued
+ */
+static XStatus PLD_QSPI_SettleProgram(PLD_QSPI_t *InstancePtr)
+{
+    XStatus Status;
+    uint32_t Elapsed;
+
+    if (InstancePtr->ProgramPending == 0) {
+        return XST_SUCCESS;
+    }
+
+    Status = PLD_QSPI_SelectFlashOf(InstancePtr, InstancePtr->ProgramAddress);
+    if (Status == XST_SUCCESS) {
+        // Some of the program has usually elapsed already, so only the rest of the tPP estimate is waited out
+        Elapsed = PLD_QSPI_NowUs() - InstancePtr->ProgramIssuedUs;
+        Status = PLD_QSPI_WaitReady(InstancePtr, PLD_QSPI_RemainingUs(InstancePtr->ProgramEstUs,
+                                                                      InstancePtr->ProgramIssuedUs),
+                                    (Elapsed < InstancePtr->Flash.ProgramTimeMaxUs * 2U) ?
+                                    InstancePtr->Flash.ProgramTimeMaxUs * 2U - Elapsed : 0, NULL);
+    }
+
+    PLD_QSPI_STATS_RECORD(InstancePtr, PLD_QSPI_OP_PROGRAM, InstancePtr->ProgramStart,
+                          InstancePtr->ProgramPending, Status);
+    InstancePtr->ProgramPending = 0;
+
+    return Status;
+}
+
+/**
+ * Copy the statistics block
+ * Async completions update it from interrupt context, so a copy taken while
+ * a transfer is in flight may be mid-update for the transfer counters.
+ */
+XStatus PLD_QSPI_GetStats(PLD_QSPI_t *InstancePtr, PLD_QSPI_Stats_t *StatsPtr)
+{
+#ifdef PLD_QSPI_STATS
+    if (StatsPtr == NULL) {
+        return XST_INVALID_PARAM;
+    }
+
+    memcpy(StatsPtr, &InstancePtr->Stats, sizeof(*StatsPtr));
+    return XST_SUCCESS;
+#else
+    (void)InstancePtr;
+    (void)StatsPtr;
+    return XST_NO_FEATURE;
+#endif
+}
+
+/**
+ * Clear the statistics block
+ */
+void PLD_QSPI_ResetStats(PLD_QSPI_t *InstancePtr)
+{
+#ifdef PLD_QSPI_STATS
+    memset(&InstancePtr->Stats, 0, sizeof(InstancePtr->Stats));
+#else
+    (void)InstancePtr;
+#endif
+}
+
+#ifdef PLD_QSPI_STATS
+/**
+ * Timer value for latency measurement
+ * The Zynq global timer (XTime); host builds back XTime with CLOCK_MONOTONIC.
+ */
+static uint64_t PLD_QSPI_StatsStamp(void)
+{
+    XTime Now;
+
+    XTime_GetTime(&Now);
+    return (uint64_t)Now;
+}
+
+/**
+ * Account one finished operation against its class
+ */
+static void PLD_QSPI_StatsRecord(PLD_QSPI_t *InstancePtr, uint32_t Op, uint64_t Start, uint32_t Bytes, XStatus Status)
+{
+    PLD_QSPI_OpStats_t *OpPtr = &InstancePtr->Stats.Op[Op];
+    uint64_t Ticks = PLD_QSPI_StatsStamp() - Start;
+    uint64_t Ns;
+    uint32_t Bucket = 0;
+
+    OpPtr->Count++;
+
+    if (Status != XST_SUCCESS) {
+        OpPtr->Errors++;
+        OpPtr->LastError = Status;
+        return;
+    }
+
+    // Split the conversion so chip erase length intervals can't overflow
+    Ns = (Ticks / COUNTS_PER_SECOND) * 1000000000ULL + ((Ticks % COUNTS_PER_SECOND) * 1000000000ULL) / COUNTS_PER_SECOND;
+
+    OpPtr->Bytes += Bytes;
+    OpPtr->TotalNs += Ns;
+    if (Ns > OpPtr->MaxNs) {
+        OpPtr->MaxNs = Ns;
+    }
+
+    while (Ns != 0 && Bucket < PLD_QSPI_STATS_BUCKETS - 1U) {
+        Ns >>= 1;
+        Bucket++;
+    }
+    OpPtr->Histogram[Bucket]++;
+}
+#endif
@@ -19,6 +19,32 @@
 *	1.0.0	sam		2025-02-24	Initial commit to dev branch
 *   1.0.1   sam     2025-03-17  Finalized changes based on Graham's feedback
 *   1.1.0   sam     2025-09-27  QSPI works perfectly on board, updating soon
+*   1.2.0   sam     2026-10-16  Interrupt-driven asynchronous transfers
+*   1.3.0   sam     2026-10-16  Linear (XIP) memory-mapped read mode
+*   1.4.0   sam     2026-10-16  Streaming reads with framing stripped in place
+*   1.5.0   sam     2026-10-16  Page program write engine with adaptive WIP polling
+*   1.6.0   sam     2026-10-16  Erase planner and background erase-ahead
+*   1.7.0   sam     2026-10-16  4 byte addressing and cached bank register
+*   1.8.0   sam     2026-10-16  Dual parallel and dual stacked flash configurations
+*   1.9.0   sam     2026-10-16  Flash modification callback for read caches
+*   1.10.0  sam     2026-10-16  Optional transfer instrumentation (PLD_QSPI_STATS)
+*   1.11.0  sam     2026-10-16  Clock prescaler auto-tuning with loopback clock selection
+*   1.12.0  sam     2026-10-16  Vectored transfers, zero-copy polled reads and page programs
+*   1.13.0  sam     2026-10-16  Word-wide FIFO engine for every polled transfer, fixed layout reads
+*   1.14.0  sam     2026-10-16  CRC32C checked reads folded into the FIFO drain
+*   1.15.0  sam     2026-10-16  Blank checking and skipped erases of blank blocks
+*   1.16.0  sam     2026-10-16  Differential region updates rewriting only changed sectors
+*   1.17.0  sam     2026-10-16  Erase suspend / resume so reads preempt background erases
+*   1.18.0  sam     2026-10-16  Non-blocking page programs for the acquisition pipeline
+*   1.18.1  sam     2026-10-17  Erase suspends wait out the whole resume interval
+*   1.18.2  sam     2026-10-17  Settled background erases poll from their remaining time
+*   1.18.3  sam     2026-10-17  Chip erase weighed against the walk of the whole flash
+*   1.18.4  sam     2026-10-17  Writes report their own status, not the background erase's
+*   1.18.5  sam     2026-10-17  PLD_QSPI_NowUs exported as the time base of the modules
+*   1.18.6  sam     2026-10-17  Erase run time kept across suspends, suspends polled from tSUS
+*   1.18.7  sam     2026-10-17  Started page programs settle from the rest of their tPP estimate
+*   1.18.8  sam     2026-10-17  PLD_QSPI_EraseAheadRemainingUs for callers waiting out a background erase
+*   1.18.9  sam     2026-10-17  Erase marked suspended once the suspend is sent, suspend wait floored
 *	</pre>
 *
 *******************************************************************************/
@@ -39,6 +65,7 @@
 /* Xilinx Includes */
 #include "xstatus.h"
 #include "xqspips.h"
+#include "xparameters.h"
 
 /* FreeAct Includes */
 
@@ -47,15 +74,345 @@
 /*******************************************************************************
 *   Preprocessor Macros
 *******************************************************************************/
+/* TX FIFO level (in words) below which the controller raises its threshold
+ * interrupt during an async transfer. A quarter of the FIFO leaves the ISR
+ * enough headroom to refill before the bus idles, while keeping the number
+ * of interrupts per transfer low. */
+#ifndef PLD_QSPI_ASYNC_TX_WATERMARK
+#define PLD_QSPI_ASYNC_TX_WATERMARK     (XQSPIPS_FIFO_DEPTH / 4)
+#endif
+
+/* AXI window the controller maps the flash into in linear mode */
+#ifdef XPAR_PS7_QSPI_LINEAR_0_S_AXI_BASEADDR
+#define PLD_QSPI_LINEAR_BASEADDR        XPAR_PS7_QSPI_LINEAR_0_S_AXI_BASEADDR
+#else
+#define PLD_QSPI_LINEAR_BASEADDR        0xFC000000U
+#endif
+#define PLD_QSPI_LINEAR_WINDOW_SIZE     0x1000000U      /* 16MB per flash, 32MB with two */
+
+/* Payload bytes per streamed read transfer. Two frames of this size plus command framing live in every
+ * PLD_QSPI_t, so keep it modest when the handle is on a small stack. */
+#ifndef PLD_QSPI_STREAM_CHUNK_SIZE
+#define PLD_QSPI_STREAM_CHUNK_SIZE      1024U
+#endif
+
+/* First read of a blank check, in bytes. Each clean read doubles the next
+ * one up to PLD_QSPI_STREAM_CHUNK_SIZE, so dirty flash is found after a
+ * short read and erased flash is scanned in whole chunks. */
+#ifndef PLD_QSPI_BLANK_PROBE
+#define PLD_QSPI_BLANK_PROBE            256U
+#endif
+
+/* Words of the dirty map built for each block an erase considers skipping.
+ * Blocks of more than 32 x this many smallest erases are mapped coarser. */
+#define PLD_QSPI_BLANK_MAP_WORDS        8U
+
+/* RX FIFO words the polled transfer engine waits for at a time once the
+ * FIFO is full. Half the FIFO stays on the bus while the CPU drains these
+ * and writes as many more. */
+#ifndef PLD_QSPI_FIFO_BATCH
+#define PLD_QSPI_FIFO_BATCH             (XQSPIPS_FIFO_DEPTH / 2)
+#endif
+
+/* Words the engine reads back at once after the bus stops. More words
+ * than this still in flight at the end of a frame are drained in halves. */
+#ifndef PLD_QSPI_FIFO_TAIL
+#define PLD_QSPI_FIFO_TAIL              2U
+#endif
+
+/* Largest command, address, mode and dummy framing ahead of read data
+ * (opcode, 4 address bytes, up to 7 mode/dummy bytes and the alignment
+ * byte of an odd address in dual parallel mode) */
+#define PLD_QSPI_MAX_READ_HEADER        13U
+
+/* Status polling backoff while the flash is busy, in microseconds. The first
+ * poll is made after PLD_QSPI_POLL_LEAD of the expected busy time has passed,
+ * then the interval doubles from PLD_QSPI_POLL_MIN_US up to PLD_QSPI_POLL_MAX_US. */
+#ifndef PLD_QSPI_POLL_MIN_US
+#define PLD_QSPI_POLL_MIN_US            2U
+#endif
+#ifndef PLD_QSPI_POLL_MAX_US
+#define PLD_QSPI_POLL_MAX_US            1000U
+#endif
+#define PLD_QSPI_POLL_LEAD(Us)          (((Us) * 7U) / 8U)
+
+/* Least time a suspended erase is given to stop, for descriptions that
+ * leave tSUS at 0 */
+#ifndef PLD_QSPI_SUSPEND_TIMEOUT_MIN_US
+#define PLD_QSPI_SUSPEND_TIMEOUT_MIN_US 100U
+#endif
+
+/* Erase granularities tracked per part (subsector, half block, block, ...) */
+#define PLD_QSPI_MAX_ERASE_TYPES        4U
+
+/* Flashes the controller can drive (lower and upper memory) */
+#define PLD_QSPI_MAX_DEVICES            2U
+
+/* SCLK above which read data is sampled with the loopback (feedback) clock */
+#define PLD_QSPI_LOOPBACK_MIN_HZ        40000000U
+
+/* Prescaler steps PLD_QSPI_AutoTune backs off from the fastest setting that
+ * read cleanly, so temperature and voltage drift stay inside the margin */
+#ifndef PLD_QSPI_TUNE_MARGIN
+#define PLD_QSPI_TUNE_MARGIN            1U
+#endif
+
+/* Define PLD_QSPI_STATS to count operations and time them into log2
+ * latency histograms (PLD_QSPI_GetStats). Left undefined, the recording
+ * compiles away and PLD_QSPI_GetStats returns XST_NO_FEATURE. */
+#define PLD_QSPI_STATS_BUCKETS          32U             /* Bucket n holds latencies of 2^(n-1) to 2^n ns */
+
+/* Operation classes in PLD_QSPI_Stats_t */
+#define PLD_QSPI_OP_TRANSFER            0               /* Every bus transfer, polled or async */
+#define PLD_QSPI_OP_READ                1               /* PLD_QSPI_ReadStream / _Read / _ReadVerify / _IsBlank calls */
+#define PLD_QSPI_OP_PROGRAM             2               /* Page programs, WREN to ready */
+#define PLD_QSPI_OP_ERASE               3               /* Block and chip erases, command to ready */
+#define PLD_QSPI_OP_STATUS              4               /* Status register reads, including busy polls */
+#define PLD_QSPI_OP_COUNT               5
 
 /*******************************************************************************
 *   Datatype Definitions
 *******************************************************************************/
-typedef XQspiPs PLD_QSPI_t;
+/* Completion callback for PLD_QSPI_TransferAsync, called from interrupt context */
+typedef void (*PLD_QSPI_Callback_t)(void *CallbackRef, XStatus Status, uint32_t ByteCount);
+
+/* Consumer for PLD_QSPI_ReadStream. Data points into the driver's frame buffer
+ * and is only valid during the call. Returning anything but XST_SUCCESS stops
+ * the stream and is passed back to the caller. */
+typedef XStatus (*PLD_QSPI_Sink_t)(void *Ctx, uint32_t Address, const uint8_t *Data, uint32_t Length);
+
+/* Called before the driver programs or erases a range, so copies of it held
+ * elsewhere (read caches) can be dropped */
+typedef void (*PLD_QSPI_Modify_t)(void *CallbackRef, uint32_t Address, uint32_t Length);
+
+/* One piece of a PLD_QSPI_TransferV frame. Tx NULL clocks out 0xFF (dummy
+ * cycles, read data), Rx NULL drops what comes back. Command headers are
+ * Tx only, payload reads Rx only and dummy gaps have neither. */
+typedef struct {
+    const uint8_t *Tx;
+    uint8_t *Rx;
+    uint32_t Length;
+} PLD_QSPI_Segment_t;
+
+/* One erase granularity supported by the flash */
+typedef struct {
+    uint32_t Size;                          /* Bytes, power of two */
+    uint8_t Cmd;                            /* Erase opcode */
+    uint32_t TimeUs;                        /* Typical erase time */
+    uint32_t TimeMaxUs;                     /* Worst case erase time */
+} PLD_QSPI_EraseType_t;
+
+/* Open-time controller configuration, filled by PLD_QSPI_ConfigDefaults */
+typedef struct {
+    uint8_t ConnectionMode;                 /* PLD_QSPI_CONNECTION_*, how the flash(es) are wired */
+    uint8_t Prescaler;                      /* XQSPIPS_CLK_PRESCALE_* */
+    uint32_t Options;                       /* XQspiPs options for I/O mode */
+} PLD_QSPI_Config_t;
+
+/* Clock setting chosen by PLD_QSPI_AutoTune */
+typedef struct {
+    uint8_t Tuned;                          /* Non-zero once PLD_QSPI_AutoTune has succeeded */
+    uint8_t Prescaler;                      /* XQSPIPS_CLK_PRESCALE_* selected, margin applied */
+    uint8_t FastestPrescaler;               /* Fastest prescaler that passed every read */
+    uint8_t Loopback;                       /* Loopback clock in use at Prescaler */
+    uint32_t Signature;                     /* CRC32C of the signature region at the starting clock */
+} PLD_QSPI_Tune_t;
+
+/* What PLD_QSPI_UpdateRegion did, sectors being smallest erases */
+typedef struct {
+    uint32_t SectorsSame;                   /* Already held the new data, left alone */
+    uint32_t SectorsProgrammed;             /* Changed by programming alone, only 1 to 0 bits */
+    uint32_t SectorsErased;                 /* Erased and rewritten */
+    uint32_t PagesProgrammed;
+    uint32_t BytesProgrammed;
+    uint32_t BytesRead;                     /* Read back for comparison */
+} PLD_QSPI_Update_t;
+
+/* Counters and latency histogram of one operation class */
+typedef struct {
+    uint32_t Count;                         /* Operations completed or failed */
+    uint32_t Errors;                        /* Operations that failed */
+    XStatus LastError;                      /* Status of the most recent failure */
+    uint64_t Bytes;                         /* Payload bytes moved by successful operations */
+    uint64_t TotalNs;                       /* Summed latency of successful operations */
+    uint64_t MaxNs;                         /* Longest successful operation */
+    uint32_t Histogram[PLD_QSPI_STATS_BUCKETS]; /* Successful operations by latency, last bucket open ended */
+} PLD_QSPI_OpStats_t;
+
+/* Driver statistics block, indexed by PLD_QSPI_OP_* */
+typedef struct {
+    PLD_QSPI_OpStats_t Op[PLD_QSPI_OP_COUNT];
+} PLD_QSPI_Stats_t;
+
+/* Geometry and read mode of the attached flash */
+typedef struct {
+    const char *Name;                       /* Part name, "unknown" if not in the part table */
+    uint8_t JedecId[3];                     /* Manufacturer, memory type, capacity */
+    uint16_t SfdpRevision;                  /* Basic parameter table major << 8 | minor, 0 without SFDP */
+    uint32_t Size;                          /* Device size in bytes */
+    uint32_t PageSize;                      /* Program page size in bytes */
+    uint8_t ReadCmd;                        /* Read opcode used for I/O mode data reads */
+    uint8_t ReadDummyBytes;                 /* Dummy bytes between address and data for ReadCmd */
+    uint8_t LinearReadCmd;                  /* Read opcode the controller uses in linear mode */
+    uint8_t LinearDummyBytes;               /* Mode and dummy bytes for LinearReadCmd */
+    uint8_t AddressMode;                    /* PLD_QSPI_ADDR_*, how addresses above 16MB are reached */
+    uint8_t BankWriteCmd;                   /* Bank / extended address register write opcode */
+    uint8_t BankNeedsWren;                  /* BankWriteCmd must be preceded by WREN */
+    uint8_t ProgramCmd;                     /* Page program opcode */
+    uint32_t ProgramTimeUs;                 /* Typical page program time (tPP) */
+    uint32_t ProgramTimeMaxUs;              /* Worst case page program time */
+    PLD_QSPI_EraseType_t Erase[PLD_QSPI_MAX_ERASE_TYPES]; /* Supported erases, ascending size */
+    uint32_t EraseTypes;                    /* Valid entries in Erase */
+    uint32_t ChipEraseTimeUs;               /* Typical chip erase time */
+    uint32_t ChipEraseTimeMaxUs;            /* Worst case chip erase time */
+    uint8_t SuspendCmd;                     /* Program / erase suspend opcode, 0 if the part can't suspend */
+    uint8_t ResumeCmd;                      /* Program / erase resume opcode */
+    uint32_t SuspendTimeUs;                 /* Worst case suspend latency (tSUS) */
+    uint32_t ResumeIntervalUs;              /* Run time an operation needs after a resume before the next suspend */
+} PLD_QSPI_Flash_t;
+
+typedef struct {
+    XQspiPs Qspi;                           /* Xilinx driver instance, must stay first */
+    PLD_QSPI_Flash_t Flash;                 /* Attached flash description, both flashes in a dual configuration */
+
+    /* Dual flash configuration */
+    uint8_t ConnectionMode;                 /* PLD_QSPI_CONNECTION_* given to PLD_QSPI_Open */
+    uint32_t DeviceSize;                    /* Bytes in each flash */
+    uint32_t IoConfig;                      /* LQSPI_CR memory selection used in I/O mode */
+    uint32_t Device;                        /* Stacked flash currently selected (U_PAGE) */
+
+    /* Controller setup cached for the polled transfer engine, refreshed
+     * whenever the driver changes the clock or options */
+    uint32_t BaseAddress;                   /* Controller registers */
+    uint32_t Control;                       /* CR with chip select released */
+    uint8_t ManualCs;                       /* XQSPIPS_FORCE_SSELECT_OPTION is set */
+    uint8_t ManualStart;                    /* XQSPIPS_MANUAL_START_OPTION is set */
+    uint32_t RxThreshold;                   /* RXWR as last written, the engine's batch size */
+
+    /* Linear (XIP) mode state */
+    uint32_t LinearMode;                    /* Non-zero while the controller is in linear mode */
+    uint32_t IoOptions;                     /* I/O mode options restored when leaving linear mode */
+
+    /* Asynchronous transfer state */
+    PLD_QSPI_Callback_t AsyncCallback;      /* Completion callback of the running transfer */
+    void *AsyncCallbackRef;                 /* Reference handed back to AsyncCallback */
+    volatile uint32_t AsyncBusy;            /* Non-zero while an async transfer is in flight */
+    volatile XStatus AsyncStatus;           /* Status of the last completed async transfer */
+    uint32_t UseInterrupts;                 /* QSPI interrupt is connected, bulk paths may overlap */
+
+    /* Flash modification notification */
+    PLD_QSPI_Modify_t ModifyCallback;       /* Called ahead of every program and erase, NULL if unused */
+    void *ModifyCallbackRef;                /* Reference handed back to ModifyCallback */
+
+    /* Clock auto-tuning result */
+    PLD_QSPI_Tune_t Tune;
+
+    /* Page program timing */
+    uint32_t ProgramEstUs;                  /* Running estimate of tPP, seeds the status polling */
+    uint32_t ProgramLastUs;                 /* Measured busy time of the last page program */
+    uint32_t ProgramPending;                /* Bytes of the PLD_QSPI_ProgramStart page in flight, 0 when idle */
+    uint32_t ProgramAddress;                /* Where the page in flight is programming */
+    uint32_t ProgramIssuedUs;               /* When the page in flight was issued */
+
+    /* Bank / extended address register currently selected on each flash,
+     * PLD_QSPI_BANK_UNKNOWN until the driver first writes it */
+    uint32_t Bank[PLD_QSPI_MAX_DEVICES];
+
+    /* Background erase-ahead */
+    uint32_t EraseAheadNext;                /* Next address to erase */
+    uint32_t EraseAheadEnd;                 /* End of the queued range */
+    uint32_t EraseAheadLevel;               /* Erase type + 1 of the erase in flight, 0 when idle */
+    uint32_t EraseAheadSuspended;           /* The erase in flight is suspended for a read */
+    uint32_t EraseAheadResumeUs;            /* When the erase in flight was issued or last resumed */
+    uint32_t EraseAheadRunUs;               /* Time the erase in flight ran before its last resume */
+    uint32_t UseSuspend;                    /* Reads suspend the erase in flight instead of waiting it out */
+    uint32_t Suspends;                      /* Erases suspended for a read */
+
+    /* Blank checking ahead of erases (PLD_QSPI_UseBlankCheck) */
+    uint32_t BlankCheck;                    /* Erases pass over blocks that already read back erased */
+    uint32_t EraseSkips;                    /* Erase commands not issued because their block was blank */
+    uint64_t EraseSkippedUs;                /* Typical erase time saved against the plain erase plan */
+
+    /* Instrumentation, start times stay 0 without PLD_QSPI_STATS */
+    uint64_t AsyncStart;                    /* Timer value when the running async transfer started */
+    uint64_t EraseAheadStart;               /* Timer value when the erase-ahead block in flight was issued */
+    uint64_t ProgramStart;                  /* Timer value when the PLD_QSPI_ProgramStart page in flight was issued */
+#ifdef PLD_QSPI_STATS
+    PLD_QSPI_Stats_t Stats;
+#endif
+
+    /* Transfer frames, command framing followed by payload. Used by streamed
+     * reads, blank checks, region update read-backs, and PLD_QSPI_ReadVerify
+     * without a caller buffer. */
+    uint8_t Frame[2][PLD_QSPI_MAX_READ_HEADER + PLD_QSPI_STREAM_CHUNK_SIZE];
+} PLD_QSPI_t;
 
 /*******************************************************************************
 *   Constant Definitions
 *******************************************************************************/
+/* Flash commands */
+#define PLD_QSPI_CMD_READ               0x03
+#define PLD_QSPI_CMD_FAST_READ          0x0B
+#define PLD_QSPI_CMD_DUAL_READ          0x3B
+#define PLD_QSPI_CMD_QUAD_READ          0x6B
+#define PLD_QSPI_CMD_QUAD_IO_READ       0xEB
+#define PLD_QSPI_CMD_READ_ID            0x9F
+#define PLD_QSPI_CMD_READ_SFDP          0x5A
+#define PLD_QSPI_CMD_WRITE_ENABLE       0x06
+#define PLD_QSPI_CMD_READ_STATUS        0x05
+#define PLD_QSPI_CMD_PAGE_PROGRAM       0x02
+#define PLD_QSPI_CMD_QUAD_PAGE_PROGRAM  0x32
+#define PLD_QSPI_CMD_ERASE_4K           0x20
+#define PLD_QSPI_CMD_ERASE_32K          0x52
+#define PLD_QSPI_CMD_ERASE_64K          0xD8
+#define PLD_QSPI_CMD_CHIP_ERASE         0xC7
+#define PLD_QSPI_CMD_WRITE_EAR          0xC5            /* Extended address register (Micron, Winbond, Macronix) */
+#define PLD_QSPI_CMD_BANK_WRITE         0x17            /* Bank address register (Spansion) */
+#define PLD_QSPI_CMD_SUSPEND            0x75            /* Program / erase suspend (Micron, Winbond, Spansion) */
+#define PLD_QSPI_CMD_RESUME             0x7A
+#define PLD_QSPI_CMD_SUSPEND_ALT        0xB0            /* Program / erase suspend (Macronix) */
+#define PLD_QSPI_CMD_RESUME_ALT         0x30
+
+/* 4 byte address variants */
+#define PLD_QSPI_CMD_READ_4B            0x13
+#define PLD_QSPI_CMD_FAST_READ_4B       0x0C
+#define PLD_QSPI_CMD_DUAL_READ_4B       0x3C
+#define PLD_QSPI_CMD_QUAD_READ_4B       0x6C
+#define PLD_QSPI_CMD_QUAD_IO_READ_4B    0xEC
+#define PLD_QSPI_CMD_PAGE_PROGRAM_4B    0x12
+#define PLD_QSPI_CMD_QUAD_PAGE_PROGRAM_4B 0x34
+#define PLD_QSPI_CMD_ERASE_4K_4B        0x21
+#define PLD_QSPI_CMD_ERASE_32K_4B       0x5C
+#define PLD_QSPI_CMD_ERASE_64K_4B       0xDC
+
+/* Flash wiring, same values as the XQspiPs connection modes */
+#define PLD_QSPI_CONNECTION_SINGLE      XQSPIPS_CONNECTION_MODE_SINGLE
+#define PLD_QSPI_CONNECTION_STACKED     XQSPIPS_CONNECTION_MODE_STACKED     /* Two flashes on one bus, twice the capacity */
+#define PLD_QSPI_CONNECTION_PARALLEL    XQSPIPS_CONNECTION_MODE_PARALLEL    /* Two flashes on separate buses, bytes interleaved */
+
+/* Addressing modes */
+#define PLD_QSPI_ADDR_3BYTE             0               /* 3 byte addresses, first 16MB only */
+#define PLD_QSPI_ADDR_4BYTE             1               /* 4 byte addresses on every addressed command */
+#define PLD_QSPI_ADDR_BANK              2               /* 3 byte addresses within a 16MB bank register window */
+
+#define PLD_QSPI_BANK_SIZE              0x1000000U
+#define PLD_QSPI_BANK_UNKNOWN           0xFFFFFFFFU
+
+/* Status register bits */
+#define PLD_QSPI_SR_WIP                 0x01            /* Write in progress */
+#define PLD_QSPI_SR_WEL                 0x02            /* Write enable latch */
+
+/* Defaults used until the flash is identified */
+#define PLD_QSPI_DEFAULT_FLASH_SIZE     0x1000000U      /* 128Mbit */
+#define PLD_QSPI_DEFAULT_PAGE_SIZE      256U
+#define PLD_QSPI_DEFAULT_TPP_US         500U
+#define PLD_QSPI_DEFAULT_TPP_MAX_US     5000U
+#define PLD_QSPI_DEFAULT_T4K_US         50000U
+#define PLD_QSPI_DEFAULT_T4K_MAX_US     800000U
+#define PLD_QSPI_DEFAULT_T64K_US        300000U
+#define PLD_QSPI_DEFAULT_T64K_MAX_US    3000000U
+#define PLD_QSPI_DEFAULT_TCE_US         100000000U
+#define PLD_QSPI_DEFAULT_TCE_MAX_US     400000000U
 
 /*******************************************************************************
 *   Function Prototypes
@@ -64,19 +421,72 @@ typedef XQspiPs PLD_QSPI_t;
 /* Basic QSPI Functions - Only functions actually used in helloworld.c */
 
 #ifndef SDT
-XStatus PLD_QSPI_Open(PLD_QSPI_t *InstancePtr, uint16_t SpiDevId);
+XStatus PLD_QSPI_Open(PLD_QSPI_t *InstancePtr, uint16_t SpiDevId, const PLD_QSPI_Config_t *ConfigPtr);
 #else
-XStatus PLD_QSPI_Open(PLD_QSPI_t *InstancePtr, UINTPTR SpiBaseAddr);
+XStatus PLD_QSPI_Open(PLD_QSPI_t *InstancePtr, UINTPTR SpiBaseAddr, const PLD_QSPI_Config_t *ConfigPtr);
 #endif
 
 XStatus PLD_QSPI_Close(PLD_QSPI_t *InstancePtr);
+void PLD_QSPI_ConfigDefaults(PLD_QSPI_Config_t *ConfigPtr);
+void PLD_QSPI_FlashDefaults(PLD_QSPI_Flash_t *FlashPtr);
+void PLD_QSPI_SetFlash(PLD_QSPI_t *InstancePtr, const PLD_QSPI_Flash_t *FlashPtr);
+XStatus PLD_QSPI_ReadDevice(PLD_QSPI_t *InstancePtr, uint32_t Device, uint8_t *Frame,
+                            uint32_t HeaderLength, uint32_t Length);
 
 /* Configuration functions */
 XStatus PLD_QSPI_SetClockPrescalar(PLD_QSPI_t *InstancePtr, uint8_t Prescaler);
+XStatus PLD_QSPI_AutoTune(PLD_QSPI_t *InstancePtr, uint32_t Address, uint32_t Length, uint32_t Passes);
 XStatus PLD_QSPI_SetOptionsManually(PLD_QSPI_t *InstancePtr, uint32_t options);
 
-/* Transfer function */
+/* Transfer functions */
 XStatus PLD_QSPI_Transfer(PLD_QSPI_t *InstancePtr, uint8_t *WriteData, uint8_t *ReadData, uint32_t DataLength);
+XStatus PLD_QSPI_TransferV(PLD_QSPI_t *InstancePtr, const PLD_QSPI_Segment_t *Segments, uint32_t Count);
+
+/* Asynchronous (interrupt mode) transfer functions */
+XStatus PLD_QSPI_TransferAsync(PLD_QSPI_t *InstancePtr, uint8_t *WriteData, uint8_t *ReadData,
+                               uint32_t DataLength, PLD_QSPI_Callback_t Callback, void *CallbackRef);
+XStatus PLD_QSPI_WaitAsync(PLD_QSPI_t *InstancePtr);
+uint32_t PLD_QSPI_IsBusy(PLD_QSPI_t *InstancePtr);
+void PLD_QSPI_InterruptHandler(void *InstancePtr);
+void PLD_QSPI_UseInterrupts(PLD_QSPI_t *InstancePtr, uint32_t Enable);
+void PLD_QSPI_SetModifyCallback(PLD_QSPI_t *InstancePtr, PLD_QSPI_Modify_t Callback, void *CallbackRef);
+XStatus PLD_QSPI_GetStats(PLD_QSPI_t *InstancePtr, PLD_QSPI_Stats_t *StatsPtr);
+void PLD_QSPI_ResetStats(PLD_QSPI_t *InstancePtr);
+uint32_t PLD_QSPI_NowUs(void);
+
+/* Flash read functions */
+XStatus PLD_QSPI_ReadStream(PLD_QSPI_t *InstancePtr, uint32_t Address, uint32_t Length,
+                            PLD_QSPI_Sink_t Sink, void *Ctx);
+XStatus PLD_QSPI_Read(PLD_QSPI_t *InstancePtr, uint32_t Address, uint8_t *Buffer, uint32_t Length);
+XStatus PLD_QSPI_ReadVerify(PLD_QSPI_t *InstancePtr, uint32_t Address, uint8_t *Buffer, uint32_t Length,
+                            uint32_t Expected, uint32_t *CrcPtr);
+
+/* Flash program functions */
+XStatus PLD_QSPI_ReadStatus(PLD_QSPI_t *InstancePtr, uint8_t *StatusPtr);
+XStatus PLD_QSPI_WriteEnable(PLD_QSPI_t *InstancePtr);
+XStatus PLD_QSPI_WaitReady(PLD_QSPI_t *InstancePtr, uint32_t ExpectedUs, uint32_t TimeoutUs, uint32_t *ElapsedUsPtr);
+XStatus PLD_QSPI_Write(PLD_QSPI_t *InstancePtr, uint32_t Address, const uint8_t *Data, uint32_t Length);
+XStatus PLD_QSPI_ProgramStart(PLD_QSPI_t *InstancePtr, uint32_t Address, const uint8_t *Data, uint32_t Length);
+XStatus PLD_QSPI_ProgramPoll(PLD_QSPI_t *InstancePtr);
+XStatus PLD_QSPI_UpdateRegion(PLD_QSPI_t *InstancePtr, uint32_t Address, const uint8_t *Data, uint32_t Length,
+                              PLD_QSPI_Update_t *UpdatePtr);
+
+/* Flash erase functions */
+XStatus PLD_QSPI_EraseRange(PLD_QSPI_t *InstancePtr, uint32_t Address, uint32_t Length);
+XStatus PLD_QSPI_EraseEstimate(PLD_QSPI_t *InstancePtr, uint32_t Address, uint32_t Length, uint32_t *EstimateUsPtr);
+XStatus PLD_QSPI_EraseAheadStart(PLD_QSPI_t *InstancePtr, uint32_t Address, uint32_t Length);
+XStatus PLD_QSPI_EraseAheadService(PLD_QSPI_t *InstancePtr);
+uint32_t PLD_QSPI_EraseAheadPending(PLD_QSPI_t *InstancePtr);
+uint32_t PLD_QSPI_EraseAheadRemainingUs(PLD_QSPI_t *InstancePtr);
+void PLD_QSPI_UseSuspend(PLD_QSPI_t *InstancePtr, uint32_t Enable);
+XStatus PLD_QSPI_IsBlank(PLD_QSPI_t *InstancePtr, uint32_t Address, uint32_t Length,
+                         uint32_t *BlankPtr, uint32_t *DirtyMap);
+void PLD_QSPI_UseBlankCheck(PLD_QSPI_t *InstancePtr, uint32_t Enable);
+
+/* Linear (XIP) mode functions */
+XStatus PLD_QSPI_EnableLinearMode(PLD_QSPI_t *InstancePtr);
+XStatus PLD_QSPI_DisableLinearMode(PLD_QSPI_t *InstancePtr);
+XStatus PLD_QSPI_MapRegion(PLD_QSPI_t *InstancePtr, uint32_t Address, uint32_t Length, const uint8_t **RegionPtr);
 
 /*******************************************************************************
 *   Global Variables
@@ -0,0 +1,217 @@
+/*******************************************************************************
+*   McMaster PRESET (www.mcmasterneudose.ca)
+*
+*   Data Acquisition Module - DAM
+*   Flight Firmware
+*
+*   @file       pld_qspi_boot.c
+*   @desc       Boot image loader for the QSPI flash
+*   @author     Sameer Suleman
+*   @date       October 17, 2026
+*
+*	<pre>
+*
+*   An image on flash is a 32-byte header (PLD_QSPI_BootHeader_t, with its
+*   own CRC) followed by the payload. Boot code keeps two or more copies
+*   and hands their addresses to PLD_QSPI_BootLoad, which loads the first
+*   copy that checks out.
+*
+*   Loading sits on the boot critical path, so the payload is not read in
+*   small buffers and checked afterwards. Once the header is good, the
+*   clock is tuned against the start of the image if nobody has tuned it
+*   yet, and the whole payload is then read straight into the caller's
+*   buffer by PLD_QSPI_ReadVerify: one command per bank or stacked flash,
+*   at the fast read opcode PLD_QSPI_Identify chose, with the CRC folded
+*   over each FIFO batch while the next one is still on the bus. The
+*   image is ready, and checked, when the read returns.
+*
+*   A copy with a missing or corrupt header, or a payload that fails its
+*   CRC, is skipped for the next. Reading too fast corrupts every copy
+*   alike, so when all of them fail at a clock the loader tuned, they are
+*   tried once more at the clock it was called at.
+*
+*   Revision History:
+*
+*	Ver   	Who    	Date   		Changes
+*	----- 	---- 	-------- 	-------------------------------------------------------
+*   1.0.0   sam     2026-10-17  Header checked image load in one verified read, redundant copy fallback
+*   1.0.1   sam     2026-10-17  Timed with the driver's PLD_QSPI_NowUs
+*	</pre>
+*
+*******************************************************************************/
+
+/*******************************************************************************
+*   Includes
+*******************************************************************************/
+#include "pld_qspi_boot.h"
+
+/* STD Includes */
+#include <stddef.h>
+#include <string.h>
+
+/* NEUDOSE Includes */
+#include "pld_qspi_crc.h"
+
+/*******************************************************************************
+*   Function Prototypes
+*******************************************************************************/
+static uint32_t PLD_QSPI_BootHeaderCrc(const PLD_QSPI_BootHeader_t *HeaderPtr);
+
+/*******************************************************************************
+*   Function Definitions
+*******************************************************************************/
+
+/**
+ * Fill in the header for Length bytes of Image
+ * The header is programmed at the copy's address, the image right after it.
+ */
+void PLD_QSPI_BootMakeHeader(PLD_QSPI_BootHeader_t *HeaderPtr, const uint8_t *Image, uint32_t Length,
+                             uint32_t Version, uint32_t LoadAddress, uint32_t EntryAddress, uint32_t Flags)
+{
+    HeaderPtr->Magic = PLD_QSPI_BOOT_MAGIC;
+    HeaderPtr->Version = Version;
+    HeaderPtr->Length = Length;
+    HeaderPtr->LoadAddress = LoadAddress;
+    HeaderPtr->EntryAddress = EntryAddress;
+    HeaderPtr->Crc = PLD_QSPI_Crc32c(0, Image, Length);
+    HeaderPtr->Flags = Flags;
+    HeaderPtr->HeaderCrc = PLD_QSPI_BootHeaderCrc(HeaderPtr);
+}
+
+/**
+ * Read and check the header of the image copy at Address
+ * XST_NO_DATA if there is no image (erased flash), XST_DATA_LOST if the
+ * header is corrupt. The payload is not read.
+ */
+XStatus PLD_QSPI_BootCheckHeader(PLD_QSPI_t *InstancePtr, uint32_t Address, PLD_QSPI_BootHeader_t *HeaderPtr)
+{
+    XStatus Status;
+    PLD_QSPI_BootHeader_t Header;
+    uint32_t Index;
+
+    if (InstancePtr == NULL || HeaderPtr == NULL) {
+        return XST_INVALID_PARAM;
+    }
+
+    Status = PLD_QSPI_Read(InstancePtr, Address, (uint8_t *)&Header, sizeof(Header));
+    if (Status != XST_SUCCESS) {
+        return Status;
+    }
+
+    if (Header.Magic != PLD_QSPI_BOOT_MAGIC) {
+        for (Index = 0; Index < sizeof(Header); Index++) {
+            if (((const uint8_t *)&Header)[Index] != 0xFFU) {
+                return XST_DATA_LOST;
+            }
+        }
+        return XST_NO_DATA;
+    }
+
+    if (Header.HeaderCrc != PLD_QSPI_BootHeaderCrc(&Header) || Header.Length == 0) {
+        return XST_DATA_LOST;
+    }
+
+    *HeaderPtr = Header;
+
+    return XST_SUCCESS;
+}
+
+/**
+ * Load the first good image of Copies copies into Buffer
+ * Addresses are tried in order. HeaderPtr receives the header of the copy
+ * loaded, StatsPtr (if not NULL) how the load went, failed or not. Returns
+ * the status of the last copy tried when none loads: XST_NO_DATA for no
+ * image, XST_DATA_LOST for a corrupt one, XST_BUFFER_TOO_SMALL for one
+ * larger than Size.
+ */
+XStatus PLD_QSPI_BootLoad(PLD_QSPI_t *InstancePtr, const uint32_t *Addresses, uint32_t Copies, uint8_t *Buffer,
+                          uint32_t Size, PLD_QSPI_BootHeader_t *HeaderPtr, PLD_QSPI_BootStats_t *StatsPtr)
+{
+    XStatus Status = XST_NO_DATA;
+    PLD_QSPI_BootHeader_t Header;
+    PLD_QSPI_BootStats_t Stats;
+    uint32_t Start = PLD_QSPI_NowUs();
+    uint32_t Tuned = 0;
+    uint32_t Copy;
+    uint32_t Span;
+    uint32_t Now;
+    uint8_t Safe;
+
+    if (InstancePtr == NULL || Addresses == NULL || Copies == 0 || Buffer == NULL || HeaderPtr == NULL) {
+        return XST_INVALID_PARAM;
+    }
+
+    memset(&Stats, 0, sizeof(Stats));
+    Safe = XQspiPs_GetClkPrescaler(&InstancePtr->Qspi);
+
+    for (;;) {
+        for (Copy = 0; Copy < Copies; Copy++) {
+            Status = PLD_QSPI_BootCheckHeader(InstancePtr, Addresses[Copy], &Header);
+            if (Status != XST_SUCCESS) {
+                if (Status == XST_NO_DATA || Status == XST_DATA_LOST) {
+                    Stats.BadHeaders++;
+                }
+                continue;
+            }
+
+            if (Header.Length > Size) {
+                Status = XST_BUFFER_TOO_SMALL;
+                continue;
+            }
+
+            // Tune against the start of the first image found, a failed tune stays at the opening clock
+            if (!InstancePtr->Tune.Tuned && PLD_QSPI_BOOT_TUNE_PASSES != 0 && !Stats.SafeRetry) {
+                Now = PLD_QSPI_NowUs();
+                Span = PLD_QSPI_BOOT_HEADER + Header.Length;
+                if (Span > PLD_QSPI_BOOT_TUNE_SIZE) {
+                    Span = PLD_QSPI_BOOT_TUNE_SIZE;
+                }
+                if (PLD_QSPI_AutoTune(InstancePtr, Addresses[Copy], Span, PLD_QSPI_BOOT_TUNE_PASSES) == XST_SUCCESS) {
+                    Tuned = 1;
+                }
+                Stats.TuneUs = PLD_QSPI_NowUs() - Now;
+            }
+
+            // The whole payload in one verified read, the CRC keeping pace with the bus
+            Stats.Prescaler = XQspiPs_GetClkPrescaler(&InstancePtr->Qspi);
+            Now = PLD_QSPI_NowUs();
+            Status = PLD_QSPI_ReadVerify(InstancePtr, Addresses[Copy] + PLD_QSPI_BOOT_HEADER, Buffer, Header.Length,
+                                         Header.Crc, NULL);
+            Stats.LoadUs = PLD_QSPI_NowUs() - Now;
+            if (Status == XST_SUCCESS) {
+                Stats.Copy = Copy;
+                *HeaderPtr = Header;
+                break;
+            }
+            if (Status == XST_DATA_LOST) {
+                Stats.BadImages++;
+            }
+        }
+
+        if (Copy < Copies || !Tuned || Stats.SafeRetry || XQspiPs_GetClkPrescaler(&InstancePtr->Qspi) == Safe) {
+            break;
+        }
+
+        // Every copy failed at the tuned clock, which is no longer trusted
+        if (PLD_QSPI_SetClockPrescalar(InstancePtr, Safe) != XST_SUCCESS) {
+            break;
+        }
+        InstancePtr->Tune.Tuned = 0;
+        Stats.SafeRetry = 1;
+    }
+
+    Stats.ReadyUs = PLD_QSPI_NowUs() - Start;
+    if (StatsPtr != NULL) {
+        *StatsPtr = Stats;
+    }
+
+    return Status;
+}
+
+/**
+ * CRC32C of a header up to its own CRC field
+ */
+static uint32_t PLD_QSPI_BootHeaderCrc(const PLD_QSPI_BootHeader_t *HeaderPtr)
+{
+    return PLD_QSPI_Crc32c(0, (const uint8_t *)HeaderPtr, offsetof(PLD_QSPI_BootHeader_t, HeaderCrc));
+}
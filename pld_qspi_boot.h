@@ -0,0 +1,102 @@
+/*******************************************************************************
+*   McMaster PRESET (www.mcmasterneudose.ca)
+*
+*   Data Acquisition Module - DAM
+*   Flight Firmware
+*
+*   @file       pld_qspi_boot.h
+*   @desc       Boot image loader for the QSPI flash
+*   @author     Sameer Suleman
+*   @date       October 17, 2026
+*
+*	<pre>
+*
+*   Revision History:
+*
+*	Ver   	Who    	Date   		Changes
+*	----- 	---- 	-------- 	-------------------------------------------------------
+*   1.0.0   sam     2026-10-17  Header checked image load in one verified read, redundant copy fallback
+*   1.0.1   sam     2026-10-17  Timed with the driver's PLD_QSPI_NowUs
+*	</pre>
+*
+*******************************************************************************/
+
+/*******************************************************************************
+*   Prevent circular dependency
+*   DO NOT REMOVE
+*******************************************************************************/
+#ifndef PLD_QSPI_BOOT
+#define PLD_QSPI_BOOT
+
+/*******************************************************************************
+*   Includes
+*******************************************************************************/
+/* STD Includes */
+#include <stdint.h>
+
+/* Xilinx Includes */
+#include "xstatus.h"
+
+/* NEUDOSE Includes */
+#include "pld_qspi.h"
+
+/*******************************************************************************
+*   Preprocessor Macros
+*******************************************************************************/
+/* Payload bytes the loader tunes the clock against when the driver has not
+ * been tuned yet, and the passes at each step. 0 passes loads at the clock
+ * the driver was opened with. */
+#ifndef PLD_QSPI_BOOT_TUNE_SIZE
+#define PLD_QSPI_BOOT_TUNE_SIZE         0x1000U
+#endif
+
+#ifndef PLD_QSPI_BOOT_TUNE_PASSES
+#define PLD_QSPI_BOOT_TUNE_PASSES       4U
+#endif
+
+/*******************************************************************************
+*   Constant Definitions
+*******************************************************************************/
+#define PLD_QSPI_BOOT_MAGIC             0x544F4F42U     /* "BOOT" at the start of every image */
+#define PLD_QSPI_BOOT_HEADER            32U             /* Header bytes ahead of the payload */
+
+/*******************************************************************************
+*   Datatype Definitions
+*******************************************************************************/
+/* On flash, ahead of the payload of every image copy */
+typedef struct {
+    uint32_t Magic;
+    uint32_t Version;                       /* Image version, for the caller */
+    uint32_t Length;                        /* Payload bytes */
+    uint32_t LoadAddress;                   /* Where the image belongs, for the caller */
+    uint32_t EntryAddress;                  /* Where it starts, for the caller */
+    uint32_t Crc;                           /* CRC32C of the payload */
+    uint32_t Flags;                         /* Caller defined, e.g. application or bitstream */
+    uint32_t HeaderCrc;                     /* CRC32C of the header up to here */
+} PLD_QSPI_BootHeader_t;
+
+typedef struct {
+    uint32_t Copy;                          /* Index of the copy loaded */
+    uint32_t BadHeaders;                    /* Copies skipped for a missing or corrupt header */
+    uint32_t BadImages;                     /* Copies whose payload failed its CRC */
+    uint32_t SafeRetry;                     /* Non-zero if the copies were tried again at the opening clock */
+    uint8_t Prescaler;                      /* XQSPIPS_CLK_PRESCALE_* the image was read at */
+    uint32_t TuneUs;                        /* Clock tuning */
+    uint32_t LoadUs;                        /* Payload read and check of the copy loaded */
+    uint32_t ReadyUs;                       /* Whole load, every copy tried included */
+} PLD_QSPI_BootStats_t;
+
+/*******************************************************************************
+*   Function Prototypes
+*******************************************************************************/
+void PLD_QSPI_BootMakeHeader(PLD_QSPI_BootHeader_t *HeaderPtr, const uint8_t *Image, uint32_t Length,
+                             uint32_t Version, uint32_t LoadAddress, uint32_t EntryAddress, uint32_t Flags);
+XStatus PLD_QSPI_BootCheckHeader(PLD_QSPI_t *InstancePtr, uint32_t Address, PLD_QSPI_BootHeader_t *HeaderPtr);
+XStatus PLD_QSPI_BootLoad(PLD_QSPI_t *InstancePtr, const uint32_t *Addresses, uint32_t Copies, uint8_t *Buffer,
+                          uint32_t Size, PLD_QSPI_BootHeader_t *HeaderPtr, PLD_QSPI_BootStats_t *StatsPtr);
+
+/*******************************************************************************
+*   Prevent circular dependency
+*   DO NOT REMOVE
+*******************************************************************************/
+#endif /* PLD_QSPI_BOOT */
@@ -0,0 +1,214 @@
+/*******************************************************************************
+*   McMaster PRESET (www.mcmasterneudose.ca)
+*
+*   Data Acquisition Module - DAM
+*   Flight Firmware
+*
+*   @file       pld_qspi_cache.c
+*   @desc       LRU RAM read cache over the QSPI flash read path
+*   @author     Sameer Suleman
+*   @date       October 16, 2026
+*
+*	<pre>
+*
+*   The cache is fully associative over a caller supplied arena of lines.
+*   A read is split on line boundaries; lines found in RAM are copied out
+*   and the rest are filled from flash a whole line at a time, replacing
+*   the least recently used line. Lookup and victim selection share one
+*   pass over the arena, which stays cheap for the few dozen lines a
+*   calibration or config working set needs.
+*
+*   The cache registers itself as the driver's modify callback, so lines
+*   covering a range are dropped before PLD_QSPI_Write or an erase changes
+*   it. Flash changed behind the driver's back (raw PLD_QSPI_Transfer
+*   commands, another master) needs PLD_QSPI_CacheInvalidate.
+*
+*   Revision History:
+*
+*	Ver   	Who    	Date   		Changes
+*	----- 	---- 	-------- 	-------------------------------------------------------
+*   1.0.0   sam     2026-10-16  Line cache with LRU eviction and program/erase invalidation
+*	</pre>
+*
+*******************************************************************************/
+
+/*******************************************************************************
+*   Includes
+*******************************************************************************/
+#include "pld_qspi_cache.h"
+
+/* STD Includes */
+#include <string.h>
+
+/*******************************************************************************
+*   Function Prototypes
+*******************************************************************************/
+static void PLD_QSPI_CacheModified(void *CallbackRef, uint32_t Address, uint32_t Length);
+static PLD_QSPI_CacheLine_t *PLD_QSPI_CacheLookup(PLD_QSPI_Cache_t *CachePtr, uint32_t Tag, uint32_t *HitPtr);
+
+/*******************************************************************************
+*   Function Definitions
+*******************************************************************************/
+
+/**
+ * Set up a cache over an opened driver
+ * Lines is the arena, usually a static array, and is emptied here. The
+ * cache replaces any modify callback registered on the driver.
+ */
+XStatus PLD_QSPI_CacheInit(PLD_QSPI_Cache_t *CachePtr, PLD_QSPI_t *InstancePtr,
+                           PLD_QSPI_CacheLine_t *Lines, uint32_t LineCount)
+{
+    uint32_t Index;
+
+    if (CachePtr == NULL || InstancePtr == NULL || Lines == NULL || LineCount == 0) {
+        return XST_INVALID_PARAM;
+    }
+
+    for (Index = 0; Index < LineCount; Index++) {
+        Lines[Index].Tag = PLD_QSPI_CACHE_NO_TAG;
+        Lines[Index].LastUse = 0;
+    }
+
+    CachePtr->Qspi = InstancePtr;
+    CachePtr->Lines = Lines;
+    CachePtr->LineCount = LineCount;
+    CachePtr->Clock = 0;
+    PLD_QSPI_CacheResetStats(CachePtr);
+
+    PLD_QSPI_SetModifyCallback(InstancePtr, PLD_QSPI_CacheModified, CachePtr);
+
+    return XST_SUCCESS;
+}
+
+/**
+ * Read a flash range through the cache
+ * Reads larger than the whole cache bypass it rather than flush the
+ * working set.
+ */
+XStatus PLD_QSPI_CacheRead(PLD_QSPI_Cache_t *CachePtr, uint32_t Address, uint8_t *Buffer, uint32_t Length)
+{
+    XStatus Status;
+    PLD_QSPI_CacheLine_t *Line;
+    uint32_t Size = CachePtr->Qspi->Flash.Size;
+    uint32_t Tag;
+    uint32_t Offset;
+    uint32_t Span;
+    uint32_t Hit;
+    uint32_t Index;
+
+    if (Buffer == NULL || Address >= Size || Length > Size - Address) {
+        return XST_INVALID_PARAM;
+    }
+
+    if (Length > CachePtr->LineCount * PLD_QSPI_CACHE_LINE_SIZE) {
+        CachePtr->Stats.Bypasses++;
+        return PLD_QSPI_Read(CachePtr->Qspi, Address, Buffer, Length);
+    }
+
+    while (Length > 0) {
+        Tag = Address & ~(PLD_QSPI_CACHE_LINE_SIZE - 1U);
+        Offset = Address - Tag;
+        Span = PLD_QSPI_CACHE_LINE_SIZE - Offset;
+        if (Span > Length) {
+            Span = Length;
+        }
+
+        Line = PLD_QSPI_CacheLookup(CachePtr, Tag, &Hit);
+        if (Hit) {
+            CachePtr->Stats.Hits++;
+        } else {
+            CachePtr->Stats.Misses++;
+            if (Line->Tag != PLD_QSPI_CACHE_NO_TAG) {
+                CachePtr->Stats.Evictions++;
+            }
+
+            // Keep the line empty until the fill has succeeded
+            Line->Tag = PLD_QSPI_CACHE_NO_TAG;
+            Status = PLD_QSPI_Read(CachePtr->Qspi, Tag, Line->Data, PLD_QSPI_CACHE_LINE_SIZE);
+            if (Status != XST_SUCCESS) {
+                return Status;
+            }
+            Line->Tag = Tag;
+        }
+
+        // Restart the ages rather than let the clock wrap and invert the order
+        if (++CachePtr->Clock == 0) {
+            for (Index = 0; Index < CachePtr->LineCount; Index++) {
+                CachePtr->Lines[Index].LastUse = 0;
+            }
+            CachePtr->Clock = 1;
+        }
+        Line->LastUse = CachePtr->Clock;
+
+        memcpy(Buffer, &Line->Data[Offset], Span);
+
+        Address += Span;
+        Buffer += Span;
+        Length -= Span;
+    }
+
+    return XST_SUCCESS;
+}
+
+/**
+ * Drop every cached line overlapping a range
+ */
+void PLD_QSPI_CacheInvalidate(PLD_QSPI_Cache_t *CachePtr, uint32_t Address, uint32_t Length)
+{
+    PLD_QSPI_CacheLine_t *Line;
+    uint64_t End = (uint64_t)Address + Length;
+    uint32_t Index;
+
+    for (Index = 0; Index < CachePtr->LineCount; Index++) {
+        Line = &CachePtr->Lines[Index];
+        if (Line->Tag != PLD_QSPI_CACHE_NO_TAG &&
+            (uint64_t)Line->Tag + PLD_QSPI_CACHE_LINE_SIZE > Address && Line->Tag < End) {
+            Line->Tag = PLD_QSPI_CACHE_NO_TAG;
+            Line->LastUse = 0;
+            CachePtr->Stats.Invalidations++;
+        }
+    }
+}
+
+/**
+ * Clear the hit / miss counters
+ */
+void PLD_QSPI_CacheResetStats(PLD_QSPI_Cache_t *CachePtr)
+{
+    memset(&CachePtr->Stats, 0, sizeof(CachePtr->Stats));
+}
+
+/**
+ * Driver modify callback, runs ahead of every program and erase
+ */
+static void PLD_QSPI_CacheModified(void *CallbackRef, uint32_t Address, uint32_t Length)
+{
+    PLD_QSPI_CacheInvalidate((PLD_QSPI_Cache_t *)CallbackRef, Address, Length);
+}
+
+/**
+ * Find the line holding Tag, or the line to refill with it
+ * Empty lines are taken first, then the least recently used one.
+ */
+static PLD_QSPI_CacheLine_t *PLD_QSPI_CacheLookup(PLD_QSPI_Cache_t *CachePtr, uint32_t Tag, uint32_t *HitPtr)
+{
+    PLD_QSPI_CacheLine_t *Victim = &CachePtr->Lines[0];
+    PLD_QSPI_CacheLine_t *Line;
+    uint32_t Index;
+
+    for (Index = 0; Index < CachePtr->LineCount; Index++) {
+        Line = &CachePtr->Lines[Index];
+        if (Line->Tag == Tag) {
+            *HitPtr = 1;
+            return Line;
+        }
+
+        // Empty lines have LastUse 0, so they lose every comparison
+        if (Line->LastUse < Victim->LastUse) {
+            Victim = Line;
+        }
+    }
+
+    *HitPtr = 0;
+    return Victim;
+}
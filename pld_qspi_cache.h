@@ -0,0 +1,97 @@
+/*******************************************************************************
+*   McMaster PRESET (www.mcmasterneudose.ca)
+*
+*   Data Acquisition Module - DAM
+*   Flight Firmware
+*
+*   @file       pld_qspi_cache.h
+*   @desc       LRU RAM read cache over the QSPI flash read path
+*   @author     Sameer Suleman
+*   @date       October 16, 2026
+*
+*	<pre>
+*
+*   Revision History:
+*
+*	Ver   	Who    	Date   		Changes
+*	----- 	---- 	-------- 	-------------------------------------------------------
+*   1.0.0   sam     2026-10-16  Line cache with LRU eviction and program/erase invalidation
+*	</pre>
+*
+*******************************************************************************/
+
+/*******************************************************************************
+*   Prevent circular dependency
+*   DO NOT REMOVE
+*******************************************************************************/
+#ifndef PLD_QSPI_CACHE
+#define PLD_QSPI_CACHE
+
+/*******************************************************************************
+*   Includes
+*******************************************************************************/
+/* STD Includes */
+#include <stdint.h>
+
+/* Xilinx Includes */
+#include "xstatus.h"
+
+/* NEUDOSE Includes */
+#include "pld_qspi.h"
+
+/*******************************************************************************
+*   Preprocessor Macros
+*******************************************************************************/
+/* Bytes per cache line, a power of two. Every miss reads a whole line, so
+ * larger lines suit tables read front to back and smaller lines suit
+ * scattered small records. */
+#ifndef PLD_QSPI_CACHE_LINE_SIZE
+#define PLD_QSPI_CACHE_LINE_SIZE        256U
+#endif
+
+/*******************************************************************************
+*   Constant Definitions
+*******************************************************************************/
+#define PLD_QSPI_CACHE_NO_TAG           0xFFFFFFFFU     /* Tag of an empty line */
+
+/*******************************************************************************
+*   Datatype Definitions
+*******************************************************************************/
+/* One cached, line aligned flash range */
+typedef struct {
+    uint32_t Tag;                           /* Flash address of Data[0], PLD_QSPI_CACHE_NO_TAG when empty */
+    uint32_t LastUse;                       /* Cache clock at the last hit or fill, the oldest line is evicted */
+    uint8_t Data[PLD_QSPI_CACHE_LINE_SIZE];
+} PLD_QSPI_CacheLine_t;
+
+/* Counters for sizing the cache, in lines rather than reads */
+typedef struct {
+    uint32_t Hits;                          /* Lines served from RAM */
+    uint32_t Misses;                        /* Lines filled from flash */
+    uint32_t Evictions;                     /* Valid lines replaced by a fill */
+    uint32_t Invalidations;                 /* Lines dropped because their range was programmed or erased */
+    uint32_t Bypasses;                      /* Reads larger than the cache, passed straight to the flash */
+} PLD_QSPI_CacheStats_t;
+
+typedef struct {
+    PLD_QSPI_t *Qspi;                       /* Driver the cache reads through */
+    PLD_QSPI_CacheLine_t *Lines;            /* Caller's (static) line arena */
+    uint32_t LineCount;                     /* Entries in Lines */
+    uint32_t Clock;                         /* Use counter ordering LastUse */
+    PLD_QSPI_CacheStats_t Stats;
+} PLD_QSPI_Cache_t;
+
+/*******************************************************************************
+*   Function Prototypes
+*******************************************************************************/
+XStatus PLD_QSPI_CacheInit(PLD_QSPI_Cache_t *CachePtr, PLD_QSPI_t *InstancePtr,
+                           PLD_QSPI_CacheLine_t *Lines, uint32_t LineCount);
+XStatus PLD_QSPI_CacheRead(PLD_QSPI_Cache_t *CachePtr, uint32_t Address, uint8_t *Buffer, uint32_t Length);
+void PLD_QSPI_CacheInvalidate(PLD_QSPI_Cache_t *CachePtr, uint32_t Address, uint32_t Length);
+void PLD_QSPI_CacheResetStats(PLD_QSPI_Cache_t *CachePtr);
+
+/*******************************************************************************
+*   Prevent circular dependency
+*   DO NOT REMOVE
+*******************************************************************************/
+#endif /* PLD_QSPI_CACHE */
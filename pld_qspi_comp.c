@@ -0,0 +1,597 @@
+/*******************************************************************************
+*   McMaster PRESET (www.mcmasterneudose.ca)
+*
+*   Data Acquisition Module - DAM
+*   Flight Firmware
+*
+*   @file       pld_qspi_comp.c
+*   @desc       Block compression of logged data on the QSPI flash
+*   @author     Sameer Suleman
+*   @date       October 17, 2026
+*
+*	<pre>
+*
+*   Logged data is cut into fixed size blocks, each coded on its own and
+*   written through the acquisition pipeline as one frame: a header then
+*   the payload. A block depends on no other, so any block can be read
+*   back alone, and PLD_QSPI_CompSeek finds block N by hopping over N
+*   headers without decoding anything.
+*
+*   Coding is two passes. Detector samples move slowly, so each sample
+*   (Width bytes, little endian) is first replaced by its difference from
+*   the one before, and the differences are split into byte planes: all
+*   low bytes, then all next bytes and so on. Small differences leave the
+*   high planes nearly all 0x00 / 0xFF, which the second pass, a byte
+*   oriented LZ coder in the style of LZ4 (hashed 4-byte matches, no
+*   entropy stage), turns into a few long matches. Decoding is copies
+*   only. A block that does not shrink is stored raw.
+*
+*   Everything works in the caller's arena (PLD_QSPI_COMP_ARENA_SIZE), and
+*   the header's CRC32C of the raw block is checked after decoding.
+*
+*   Revision History:
+*
+*	Ver   	Who    	Date   		Changes
+*	----- 	---- 	-------- 	-------------------------------------------------------
+*   1.0.0   sam     2026-10-17  Delta, byte plane and LZ coding of fixed blocks into the pipeline
+*	</pre>
+*
+*******************************************************************************/
+
+/*******************************************************************************
+*   Includes
+*******************************************************************************/
+#include "pld_qspi_comp.h"
+
+/* STD Includes */
+#include <string.h>
+
+/* NEUDOSE Includes */
+#include "pld_qspi_crc.h"
+
+/*******************************************************************************
+*   Constant Definitions
+*******************************************************************************/
+#define PLD_QSPI_COMP_MIN_MATCH         4U
+#define PLD_QSPI_COMP_MAX_OFFSET        0xFFFFU
+#define PLD_QSPI_COMP_SKIP_SHIFT        5U              /* Misses before the match finder steps further */
+
+/*******************************************************************************
+*   Function Prototypes
+*******************************************************************************/
+static void PLD_QSPI_CompDelta(const uint8_t *Data, uint8_t *Planes, uint32_t Length, uint32_t Width);
+static void PLD_QSPI_CompUndelta(const uint8_t *Planes, uint8_t *Data, uint32_t Length, uint32_t Width);
+static uint32_t PLD_QSPI_CompLength(uint8_t *Out, uint32_t Length);
+static uint32_t PLD_QSPI_CompEncode(PLD_QSPI_Comp_t *CompPtr, const uint8_t *Src, uint32_t Length,
+                                    uint8_t *Dst, uint32_t Capacity);
+static XStatus PLD_QSPI_CompDecode(const uint8_t *Src, uint32_t Length, uint8_t *Dst, uint32_t RawLength);
+static XStatus PLD_QSPI_CompCheck(PLD_QSPI_Comp_t *CompPtr, const PLD_QSPI_CompHeader_t *HeaderPtr);
+static XStatus PLD_QSPI_CompEmit(PLD_QSPI_Comp_t *CompPtr, uint32_t Wait);
+
+/*******************************************************************************
+*   Function Definitions
+*******************************************************************************/
+
+/**
+ * Set up a compressor over a pipeline, or a reader with PipePtr NULL
+ * Arena takes PLD_QSPI_COMP_ARENA_SIZE(BlockSize) bytes, 2 byte aligned.
+ * Width is the sample size the delta pass works in (1, 2 or 4), 0 to
+ * code the bytes as they are.
+ */
+XStatus PLD_QSPI_CompInit(PLD_QSPI_Comp_t *CompPtr, PLD_QSPI_t *InstancePtr, PLD_QSPI_Pipe_t *PipePtr,
+                          uint8_t *Arena, uint32_t ArenaSize, uint32_t BlockSize, uint32_t Width)
+{
+    if (CompPtr == NULL || InstancePtr == NULL || Arena == NULL || ((uintptr_t)Arena & 1U) != 0 ||
+        BlockSize == 0 || BlockSize > PLD_QSPI_COMP_BLOCK_MAX ||
+        ArenaSize < PLD_QSPI_COMP_ARENA_SIZE(BlockSize) || (Width != 0 && Width != 1 && Width != 2 && Width != 4)) {
+        return XST_INVALID_PARAM;
+    }
+
+    memset(CompPtr, 0, sizeof(*CompPtr));
+    CompPtr->Qspi = InstancePtr;
+    CompPtr->Pipe = PipePtr;
+    CompPtr->BlockSize = BlockSize;
+    CompPtr->Width = Width;
+
+    // The table goes first, where the arena's alignment holds
+    CompPtr->Hash = (uint16_t *)Arena;
+    CompPtr->Raw = Arena + (2U << PLD_QSPI_COMP_HASH_BITS);
+    CompPtr->Work = CompPtr->Raw + BlockSize;
+    CompPtr->Frame = CompPtr->Work + BlockSize;
+
+    return XST_SUCCESS;
+}
+
+/**
+ * Add Length bytes to the stream
+ * Each block that fills is packed and handed to the pipeline, waiting for
+ * room if Wait is set. Otherwise a block the pipeline has no room for is
+ * dropped whole, counted, and XST_DATA_LOST returned once the rest of
+ * Data is taken. XST_BUFFER_TOO_SMALL at the end of the pipeline region.
+ */
+XStatus PLD_QSPI_CompWrite(PLD_QSPI_Comp_t *CompPtr, const uint8_t *Data, uint32_t Length, uint32_t Wait)
+{
+    XStatus Status;
+    XStatus Result = XST_SUCCESS;
+    uint32_t Copy;
+
+    if (CompPtr->Pipe == NULL || (Data == NULL && Length != 0)) {
+        return XST_INVALID_PARAM;
+    }
+
+    while (Length > 0) {
+        Copy = CompPtr->BlockSize - CompPtr->Fill;
+        if (Copy > Length) {
+            Copy = Length;
+        }
+        memcpy(&CompPtr->Raw[CompPtr->Fill], Data, Copy);
+        CompPtr->Fill += Copy;
+        Data += Copy;
+        Length -= Copy;
+
+        if (CompPtr->Fill == CompPtr->BlockSize) {
+            Status = PLD_QSPI_CompEmit(CompPtr, Wait);
+            if (Status == XST_DATA_LOST) {
+                Result = Status;
+            } else if (Status != XST_SUCCESS) {
+                return Status;
+            }
+        }
+    }
+
+    return Result;
+}
+
+/**
+ * Pack the partly filled block, then program everything in the pipeline
+ * The stream can carry on afterwards, the short block stays in it.
+ */
+XStatus PLD_QSPI_CompFlush(PLD_QSPI_Comp_t *CompPtr)
+{
+    XStatus Status;
+
+    if (CompPtr->Pipe == NULL) {
+        return XST_INVALID_PARAM;
+    }
+
+    if (CompPtr->Fill != 0) {
+        Status = PLD_QSPI_CompEmit(CompPtr, 1);
+        if (Status != XST_SUCCESS) {
+            return Status;
+        }
+    }
+
+    return PLD_QSPI_PipeFlush(CompPtr->Pipe);
+}
+
+/**
+ * Read and decode the block whose header is at Address
+ * LengthPtr, if not NULL, receives the block's raw length, even when Size
+ * is too small (XST_BUFFER_TOO_SMALL). NextPtr, if not NULL, receives the
+ * address of the following block. XST_NO_DATA past the end of the stream
+ * (erased flash), XST_DATA_LOST for a corrupt block.
+ */
+XStatus PLD_QSPI_CompRead(PLD_QSPI_Comp_t *CompPtr, uint32_t Address, uint8_t *Buffer, uint32_t Size,
+                          uint32_t *LengthPtr, uint32_t *NextPtr)
+{
+    XStatus Status;
+    PLD_QSPI_CompHeader_t Header;
+
+    Status = PLD_QSPI_Read(CompPtr->Qspi, Address, CompPtr->Frame, PLD_QSPI_COMP_HEADER);
+    if (Status != XST_SUCCESS) {
+        return Status;
+    }
+
+    memcpy(&Header, CompPtr->Frame, sizeof(Header));
+    Status = PLD_QSPI_CompCheck(CompPtr, &Header);
+    if (Status != XST_SUCCESS) {
+        return Status;
+    }
+
+    if (LengthPtr != NULL) {
+        *LengthPtr = Header.RawLength;
+    }
+    if (NextPtr != NULL) {
+        *NextPtr = Address + PLD_QSPI_COMP_HEADER + Header.Length;
+    }
+    if (Size < Header.RawLength) {
+        return XST_BUFFER_TOO_SMALL;
+    }
+
+    if (Header.Length != 0) {
+        Status = PLD_QSPI_Read(CompPtr->Qspi, Address + PLD_QSPI_COMP_HEADER, &CompPtr->Frame[PLD_QSPI_COMP_HEADER],
+                               Header.Length);
+        if (Status != XST_SUCCESS) {
+            return Status;
+        }
+    }
+
+    CompPtr->Stats.BlocksRead++;
+
+    return PLD_QSPI_CompUnpack(CompPtr, CompPtr->Frame, Buffer, Size, LengthPtr);
+}
+
+/**
+ * Find the block Blocks blocks on from the one at Address
+ * Reads one header per block skipped. XST_NO_DATA if the stream ends
+ * first, XST_DATA_LOST on a corrupt header.
+ */
+XStatus PLD_QSPI_CompSeek(PLD_QSPI_Comp_t *CompPtr, uint32_t Address, uint32_t Blocks, uint32_t *AddressPtr)
+{
+    XStatus Status;
+    PLD_QSPI_CompHeader_t Header;
+
+    while (Blocks > 0) {
+        Status = PLD_QSPI_Read(CompPtr->Qspi, Address, (uint8_t *)&Header, PLD_QSPI_COMP_HEADER);
+        if (Status != XST_SUCCESS) {
+            return Status;
+        }
+
+        Status = PLD_QSPI_CompCheck(CompPtr, &Header);
+        if (Status != XST_SUCCESS) {
+            return Status;
+        }
+
+        Address += PLD_QSPI_COMP_HEADER + Header.Length;
+        Blocks--;
+    }
+
+    *AddressPtr = Address;
+
+    return XST_SUCCESS;
+}
+
+/**
+ * Code Length bytes (at most a block) into a frame at CompPtr->Frame
+ * Returns the frame's length, header included. Used by PLD_QSPI_CompWrite,
+ * and on its own to code blocks held in RAM.
+ */
+uint32_t PLD_QSPI_CompPack(PLD_QSPI_Comp_t *CompPtr, const uint8_t *Data, uint32_t Length)
+{
+    PLD_QSPI_CompHeader_t Header;
+    uint8_t *Payload = &CompPtr->Frame[PLD_QSPI_COMP_HEADER];
+    const uint8_t *Src = Data;
+    uint32_t Coded;
+
+    if (Length > CompPtr->BlockSize) {
+        Length = CompPtr->BlockSize;
+    }
+
+    Header.Magic = PLD_QSPI_COMP_MAGIC;
+    Header.Width = (uint8_t)CompPtr->Width;
+    Header.RawLength = (uint16_t)Length;
+    Header.Sequence = CompPtr->Sequence++;
+    Header.Crc = PLD_QSPI_Crc32c(0, Data, Length);
+
+    if (CompPtr->Width != 0) {
+        PLD_QSPI_CompDelta(Data, CompPtr->Work, Length, CompPtr->Width);
+        Src = CompPtr->Work;
+    }
+
+    // Coding has to save something, or the block goes in raw
+    Coded = (Length > 1U) ? PLD_QSPI_CompEncode(CompPtr, Src, Length, Payload, Length - 1U) : 0;
+    if (Coded != 0) {
+        Header.Method = PLD_QSPI_COMP_LZ;
+        Header.Length = (uint16_t)Coded;
+    } else {
+        Header.Method = PLD_QSPI_COMP_STORED;
+        Header.Length = (uint16_t)Length;
+        memcpy(Payload, Data, Length);
+        CompPtr->Stats.StoredBlocks++;
+    }
+    memcpy(CompPtr->Frame, &Header, sizeof(Header));
+
+    CompPtr->Stats.Blocks++;
+    CompPtr->Stats.BytesIn += Length;
+    CompPtr->Stats.BytesOut += PLD_QSPI_COMP_HEADER + Header.Length;
+
+    return PLD_QSPI_COMP_HEADER + Header.Length;
+}
+
+/**
+ * Decode a frame held in RAM into Buffer
+ * LengthPtr, if not NULL, receives the raw length. XST_DATA_LOST if the
+ * frame is corrupt or fails its CRC check.
+ */
+XStatus PLD_QSPI_CompUnpack(PLD_QSPI_Comp_t *CompPtr, const uint8_t *Frame, uint8_t *Buffer, uint32_t Size,
+                            uint32_t *LengthPtr)
+{
+    XStatus Status;
+    PLD_QSPI_CompHeader_t Header;
+    const uint8_t *Payload = &Frame[PLD_QSPI_COMP_HEADER];
+
+    memcpy(&Header, Frame, sizeof(Header));
+    Status = PLD_QSPI_CompCheck(CompPtr, &Header);
+    if (Status != XST_SUCCESS) {
+        return Status;
+    }
+
+    if (LengthPtr != NULL) {
+        *LengthPtr = Header.RawLength;
+    }
+    if (Size < Header.RawLength) {
+        return XST_BUFFER_TOO_SMALL;
+    }
+
+    if (Header.Method == PLD_QSPI_COMP_STORED) {
+        memcpy(Buffer, Payload, Header.RawLength);
+    } else if (Header.Width == 0) {
+        Status = PLD_QSPI_CompDecode(Payload, Header.Length, Buffer, Header.RawLength);
+    } else {
+        Status = PLD_QSPI_CompDecode(Payload, Header.Length, CompPtr->Work, Header.RawLength);
+        if (Status == XST_SUCCESS) {
+            PLD_QSPI_CompUndelta(CompPtr->Work, Buffer, Header.RawLength, Header.Width);
+        }
+    }
+
+    if (Status != XST_SUCCESS || PLD_QSPI_Crc32c(0, Buffer, Header.RawLength) != Header.Crc) {
+        CompPtr->Stats.BadBlocks++;
+        return XST_DATA_LOST;
+    }
+
+    return XST_SUCCESS;
+}
+
+/**
+ * Clear the compression accounting
+ */
+void PLD_QSPI_CompResetStats(PLD_QSPI_Comp_t *CompPtr)
+{
+    memset(&CompPtr->Stats, 0, sizeof(CompPtr->Stats));
+}
+
+/**
+ * Replace each sample with its difference from the last, split into byte
+ * planes. Bytes past the last whole sample are copied as they are.
+ */
+static void PLD_QSPI_CompDelta(const uint8_t *Data, uint8_t *Planes, uint32_t Length, uint32_t Width)
+{
+    uint32_t Samples = Length / Width;
+    uint32_t Sample;
+    uint32_t Byte;
+    uint32_t Borrow;
+    uint32_t Last;
+
+    for (Sample = 0; Sample < Samples; Sample++) {
+        Borrow = 0;
+        for (Byte = 0; Byte < Width; Byte++) {
+            Last = (Sample != 0) ? Data[(Sample - 1U) * Width + Byte] : 0;
+            Last += Borrow;
+            Borrow = (Data[Sample * Width + Byte] < Last) ? 1U : 0U;
+            Planes[Byte * Samples + Sample] = (uint8_t)(Data[Sample * Width + Byte] - Last);
+        }
+    }
+
+    memcpy(&Planes[Samples * Width], &Data[Samples * Width], Length - Samples * Width);
+}
+
+/**
+ * Undo PLD_QSPI_CompDelta
+ */
+static void PLD_QSPI_CompUndelta(const uint8_t *Planes, uint8_t *Data, uint32_t Length, uint32_t Width)
+{
+    uint32_t Samples = Length / Width;
+    uint32_t Sample;
+    uint32_t Byte;
+    uint32_t Sum;
+
+    for (Sample = 0; Sample < Samples; Sample++) {
+        Sum = 0;
+        for (Byte = 0; Byte < Width; Byte++) {
+            Sum += Planes[Byte * Samples + Sample];
+            if (Sample != 0) {
+                Sum += Data[(Sample - 1U) * Width + Byte];
+            }
+            Data[Sample * Width + Byte] = (uint8_t)Sum;
+            Sum >>= 8;
+        }
+    }
+
+    memcpy(&Data[Samples * Width], &Planes[Samples * Width], Length - Samples * Width);
+}
+
+/**
+ * Write the 255-byte continuation of a length field, returns the bytes used
+ */
+static uint32_t PLD_QSPI_CompLength(uint8_t *Out, uint32_t Length)
+{
+    uint32_t Count = 0;
+
+    while (Length >= 255U) {
+        Out[Count++] = 255U;
+        Length -= 255U;
+    }
+    Out[Count++] = (uint8_t)Length;
+
+    return Count;
+}
+
+/**
+ * LZ code Length bytes into at most Capacity bytes
+ * Each sequence is a token (literal count in the high nibble, match length
+ * less 4 in the low, 15 meaning more follows in 255-byte steps), the
+ * literals, then a 2 byte match offset. The last sequence is literals
+ * only. Returns the coded length, 0 if it would not fit.
+ */
+static uint32_t PLD_QSPI_CompEncode(PLD_QSPI_Comp_t *CompPtr, const uint8_t *Src, uint32_t Length,
+                                    uint8_t *Dst, uint32_t Capacity)
+{
+    uint16_t *Hash = CompPtr->Hash;
+    uint32_t In = 0;
+    uint32_t Out = 0;
+    uint32_t Anchor = 0;
+    uint32_t Misses = 0;
+    uint32_t Literals;
+    uint32_t Match;
+    uint32_t Ref;
+    uint32_t Slot;
+    uint32_t Word;
+
+    memset(Hash, 0, 2U << PLD_QSPI_COMP_HASH_BITS);
+
+    while (In + PLD_QSPI_COMP_MIN_MATCH <= Length) {
+        memcpy(&Word, &Src[In], sizeof(Word));
+        Slot = (Word * 2654435761U) >> (32U - PLD_QSPI_COMP_HASH_BITS);
+        Ref = Hash[Slot];
+        Hash[Slot] = (uint16_t)(In + 1U);
+
+        // Table entries are position + 1, so 0 is an empty slot
+        if (Ref == 0 || In - (Ref - 1U) > PLD_QSPI_COMP_MAX_OFFSET ||
+            memcmp(&Src[Ref - 1U], &Src[In], PLD_QSPI_COMP_MIN_MATCH) != 0) {
+            // Step further through data that keeps missing
+            In += 1U + (Misses++ >> PLD_QSPI_COMP_SKIP_SHIFT);
+            continue;
+        }
+        Ref--;
+        Misses = 0;
+
+        Match = PLD_QSPI_COMP_MIN_MATCH;
+        while (In + Match < Length && Src[Ref + Match] == Src[In + Match]) {
+            Match++;
+        }
+
+        // Token, literal count, literals, offset and match length at their largest
+        Literals = In - Anchor;
+        if (Out + 1U + Literals / 255U + 1U + Literals + 2U + (Match - PLD_QSPI_COMP_MIN_MATCH) / 255U + 1U >
+            Capacity) {
+            return 0;
+        }
+
+        Dst[Out++] = (uint8_t)(((Literals < 15U) ? Literals : 15U) << 4) |
+                     (uint8_t)((Match - PLD_QSPI_COMP_MIN_MATCH < 15U) ? Match - PLD_QSPI_COMP_MIN_MATCH : 15U);
+        if (Literals >= 15U) {
+            Out += PLD_QSPI_CompLength(&Dst[Out], Literals - 15U);
+        }
+        memcpy(&Dst[Out], &Src[Anchor], Literals);
+        Out += Literals;
+        Dst[Out++] = (uint8_t)(In - Ref);
+        Dst[Out++] = (uint8_t)((In - Ref) >> 8);
+        if (Match - PLD_QSPI_COMP_MIN_MATCH >= 15U) {
+            Out += PLD_QSPI_CompLength(&Dst[Out], Match - PLD_QSPI_COMP_MIN_MATCH - 15U);
+        }
+
+        In += Match;
+        Anchor = In;
+    }
+
+    Literals = Length - Anchor;
+    if (Out + 1U + Literals / 255U + 1U + Literals > Capacity) {
+        return 0;
+    }
+
+    Dst[Out++] = (uint8_t)(((Literals < 15U) ? Literals : 15U) << 4);
+    if (Literals >= 15U) {
+        Out += PLD_QSPI_CompLength(&Dst[Out], Literals - 15U);
+    }
+    memcpy(&Dst[Out], &Src[Anchor], Literals);
+
+    return Out + Literals;
+}
+
+/**
+ * Undo PLD_QSPI_CompEncode, checking every length against both buffers
+ */
+static XStatus PLD_QSPI_CompDecode(const uint8_t *Src, uint32_t Length, uint8_t *Dst, uint32_t RawLength)
+{
+    uint32_t In = 0;
+    uint32_t Out = 0;
+    uint32_t Token;
+    uint32_t Count;
+    uint32_t Offset;
+    uint8_t Byte;
+
+    while (In < Length) {
+        Token = Src[In++];
+
+        Count = Token >> 4;
+        if (Count == 15U) {
+            do {
+                if (In >= Length) {
+                    return XST_DATA_LOST;
+                }
+                Byte = Src[In++];
+                Count += Byte;
+            } while (Byte == 255U);
+        }
+        if (Count > Length - In || Count > RawLength - Out) {
+            return XST_DATA_LOST;
+        }
+        memcpy(&Dst[Out], &Src[In], Count);
+        In += Count;
+        Out += Count;
+
+        if (In == Length) {
+            break;
+        }
+
+        if (Length - In < 2U) {
+            return XST_DATA_LOST;
+        }
+        Offset = Src[In] | ((uint32_t)Src[In + 1U] << 8);
+        In += 2U;
+
+        Count = (Token & 0x0FU) + PLD_QSPI_COMP_MIN_MATCH;
+        if ((Token & 0x0FU) == 15U) {
+            do {
+                if (In >= Length) {
+                    return XST_DATA_LOST;
+                }
+                Byte = Src[In++];
+                Count += Byte;
+            } while (Byte == 255U);
+        }
+        if (Offset == 0 || Offset > Out || Count > RawLength - Out) {
+            return XST_DATA_LOST;
+        }
+
+        // Byte by byte, a match may overlap the bytes it is copying
+        while (Count > 0) {
+            Dst[Out] = Dst[Out - Offset];
+            Out++;
+            Count--;
+        }
+    }
+
+    return (Out == RawLength) ? XST_SUCCESS : XST_DATA_LOST;
+}
+
+/**
+ * Validate a block header, XST_NO_DATA for erased flash
+ */
+static XStatus PLD_QSPI_CompCheck(PLD_QSPI_Comp_t *CompPtr, const PLD_QSPI_CompHeader_t *HeaderPtr)
+{
+    if (HeaderPtr->Magic == 0xFFFFU && HeaderPtr->Length == 0xFFFFU) {
+        return XST_NO_DATA;
+    }
+
+    if (HeaderPtr->Magic != PLD_QSPI_COMP_MAGIC || HeaderPtr->RawLength > CompPtr->BlockSize ||
+        HeaderPtr->Length > CompPtr->BlockSize ||
+        (HeaderPtr->Method == PLD_QSPI_COMP_STORED && HeaderPtr->Length != HeaderPtr->RawLength) ||
+        HeaderPtr->Method > PLD_QSPI_COMP_LZ || (HeaderPtr->Width != 0 && HeaderPtr->Width != 1 &&
+                                                 HeaderPtr->Width != 2 && HeaderPtr->Width != 4)) {
+        CompPtr->Stats.BadBlocks++;
+        return XST_DATA_LOST;
+    }
+
+    return XST_SUCCESS;
+}
+
+/**
+ * Pack the filled part of the block and hand the frame to the pipeline
+ */
+static XStatus PLD_QSPI_CompEmit(PLD_QSPI_Comp_t *CompPtr, uint32_t Wait)
+{
+    XStatus Status;
+    uint32_t Length;
+
+    Length = PLD_QSPI_CompPack(CompPtr, CompPtr->Raw, CompPtr->Fill);
+    CompPtr->Fill = 0;
+
+    // The frame goes in whole or not at all, so the stream never tears
+    Status = PLD_QSPI_PipeWrite(CompPtr->Pipe, CompPtr->Frame, Length, Wait);
+    if (Status == XST_DATA_LOST) {
+        CompPtr->Stats.DroppedBlocks++;
+    }
+
+    return Status;
+}
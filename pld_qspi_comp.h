@@ -0,0 +1,125 @@
+/*******************************************************************************
+*   McMaster PRESET (www.mcmasterneudose.ca)
+*
+*   Data Acquisition Module - DAM
+*   Flight Firmware
+*
+*   @file       pld_qspi_comp.h
+*   @desc       Block compression of logged data on the QSPI flash
+*   @author     Sameer Suleman
+*   @date       October 17, 2026
+*
+*	<pre>
+*
+*   Revision History:
+*
+*	Ver   	Who    	Date   		Changes
+*	----- 	---- 	-------- 	-------------------------------------------------------
+*   1.0.0   sam     2026-10-17  Delta, byte plane and LZ coding of fixed blocks into the pipeline
+*	</pre>
+*
+*******************************************************************************/
+
+/*******************************************************************************
+*   Prevent circular dependency
+*   DO NOT REMOVE
+*******************************************************************************/
+#ifndef PLD_QSPI_COMP
+#define PLD_QSPI_COMP
+
+/*******************************************************************************
+*   Includes
+*******************************************************************************/
+/* STD Includes */
+#include <stdint.h>
+
+/* Xilinx Includes */
+#include "xstatus.h"
+
+/* NEUDOSE Includes */
+#include "pld_qspi.h"
+#include "pld_qspi_pipe.h"
+
+/*******************************************************************************
+*   Preprocessor Macros
+*******************************************************************************/
+/* Match finder hash table entries, as a power of two. Each takes 2 bytes
+ * of the arena, and more entries find more matches in larger blocks. */
+#ifndef PLD_QSPI_COMP_HASH_BITS
+#define PLD_QSPI_COMP_HASH_BITS         12U
+#endif
+
+/* Arena a block size needs: the block being filled, a work block, the
+ * packed frame and the hash table */
+#define PLD_QSPI_COMP_ARENA_SIZE(BlockSize) \
+    (3U * (BlockSize) + PLD_QSPI_COMP_HEADER + (2U << PLD_QSPI_COMP_HASH_BITS))
+
+/*******************************************************************************
+*   Constant Definitions
+*******************************************************************************/
+#define PLD_QSPI_COMP_MAGIC             0x5A51U         /* "QZ" at the start of every block */
+#define PLD_QSPI_COMP_HEADER            16U
+#define PLD_QSPI_COMP_BLOCK_MAX         0x8000U
+
+/* Block coding */
+#define PLD_QSPI_COMP_STORED            0U              /* Raw bytes, the block did not compress */
+#define PLD_QSPI_COMP_LZ                1U              /* LZ coded, after the delta and byte plane pass */
+
+/*******************************************************************************
+*   Datatype Definitions
+*******************************************************************************/
+/* On flash, in front of every block's payload */
+typedef struct {
+    uint16_t Magic;
+    uint8_t Method;                         /* PLD_QSPI_COMP_STORED / _LZ */
+    uint8_t Width;                          /* Sample bytes the delta pass worked in, 0 for none */
+    uint16_t RawLength;                     /* Block bytes before coding */
+    uint16_t Length;                        /* Payload bytes after the header */
+    uint32_t Sequence;                      /* Block number in the stream, gaps are dropped blocks */
+    uint32_t Crc;                           /* CRC32C of the raw block */
+} PLD_QSPI_CompHeader_t;
+
+typedef struct {
+    uint32_t Blocks;                        /* Blocks packed */
+    uint32_t StoredBlocks;                  /* Of those, kept raw because coding did not shrink them */
+    uint64_t BytesIn;                       /* Raw bytes packed */
+    uint64_t BytesOut;                      /* Frame bytes packed, headers included */
+    uint32_t DroppedBlocks;                 /* Frames the pipeline had no room for */
+    uint32_t BlocksRead;
+    uint32_t BadBlocks;                     /* Blocks read back corrupt */
+} PLD_QSPI_CompStats_t;
+
+typedef struct {
+    PLD_QSPI_t *Qspi;                       /* Driver blocks are read back through */
+    PLD_QSPI_Pipe_t *Pipe;                  /* Pipeline frames are written to, NULL to only read */
+    uint8_t *Raw;                           /* Block being filled, BlockSize bytes */
+    uint8_t *Work;                          /* Delta coded block, BlockSize bytes */
+    uint8_t *Frame;                         /* Header and payload, PLD_QSPI_COMP_HEADER + BlockSize bytes */
+    uint16_t *Hash;                         /* Match finder table */
+    uint32_t BlockSize;
+    uint32_t Width;                         /* Sample bytes, 0 to skip the delta pass */
+    uint32_t Fill;                          /* Bytes in Raw */
+    uint32_t Sequence;                      /* Number of the next block */
+    PLD_QSPI_CompStats_t Stats;
+} PLD_QSPI_Comp_t;
+
+/*******************************************************************************
+*   Function Prototypes
+*******************************************************************************/
+XStatus PLD_QSPI_CompInit(PLD_QSPI_Comp_t *CompPtr, PLD_QSPI_t *InstancePtr, PLD_QSPI_Pipe_t *PipePtr,
+                          uint8_t *Arena, uint32_t ArenaSize, uint32_t BlockSize, uint32_t Width);
+XStatus PLD_QSPI_CompWrite(PLD_QSPI_Comp_t *CompPtr, const uint8_t *Data, uint32_t Length, uint32_t Wait);
+XStatus PLD_QSPI_CompFlush(PLD_QSPI_Comp_t *CompPtr);
+XStatus PLD_QSPI_CompRead(PLD_QSPI_Comp_t *CompPtr, uint32_t Address, uint8_t *Buffer, uint32_t Size,
+                          uint32_t *LengthPtr, uint32_t *NextPtr);
+XStatus PLD_QSPI_CompSeek(PLD_QSPI_Comp_t *CompPtr, uint32_t Address, uint32_t Blocks, uint32_t *AddressPtr);
+uint32_t PLD_QSPI_CompPack(PLD_QSPI_Comp_t *CompPtr, const uint8_t *Data, uint32_t Length);
+XStatus PLD_QSPI_CompUnpack(PLD_QSPI_Comp_t *CompPtr, const uint8_t *Frame, uint8_t *Buffer, uint32_t Size,
+                            uint32_t *LengthPtr);
+void PLD_QSPI_CompResetStats(PLD_QSPI_Comp_t *CompPtr);
+
+/*******************************************************************************
+*   Prevent circular dependency
+*   DO NOT REMOVE
+*******************************************************************************/
+#endif /* PLD_QSPI_COMP */
@@ -0,0 +1,158 @@
+/*******************************************************************************
+*   McMaster PRESET (www.mcmasterneudose.ca)
+*
+*   Data Acquisition Module - DAM
+*   Flight Firmware
+*
+*   @file       pld_qspi_crc.c
+*   @desc       CRC32C (Castagnoli) used to check images and blocks read from flash
+*   @author     Sameer Suleman
+*   @date       October 16, 2026
+*
+*	<pre>
+*
+*   Slice-by-8: eight 256 entry tables let the loop fold eight bytes per
+*   step with eight independent lookups, instead of one dependent lookup
+*   per byte. Table n holds the CRC of a byte followed by n zero bytes.
+*   The tables (8KB) are built on the first call. Words are loaded little
+*   endian, which is what the Zynq runs.
+*
+*   The CRC is incremental: pass 0 to start, then each call's result to
+*   the next call. The pre and post inversion happen inside, so results
+*   match the usual CRC32C of the whole range (iSCSI, ext4, SSE4.2).
+*
+*   Revision History:
+*
+*	Ver   	Who    	Date   		Changes
+*	----- 	---- 	-------- 	-------------------------------------------------------
+*   1.0.0   sam     2026-10-16  Slice-by-8 CRC32C, ARMv8 CRC instructions where available
+*	</pre>
+*
+*******************************************************************************/
+
+/*******************************************************************************
+*   Includes
+*******************************************************************************/
+#include "pld_qspi_crc.h"
+
+/* STD Includes */
+#include <string.h>
+#ifdef PLD_QSPI_CRC_HARDWARE
+#include <arm_acle.h>
+#endif
+
+/*******************************************************************************
+*   Global Variables
+*******************************************************************************/
+#ifndef PLD_QSPI_CRC_HARDWARE
+static uint32_t PLD_QSPI_CrcTable[8][256];
+static volatile uint32_t PLD_QSPI_CrcReady;
+#endif
+
+/*******************************************************************************
+*   Function Prototypes
+*******************************************************************************/
+#ifndef PLD_QSPI_CRC_HARDWARE
+static void PLD_QSPI_CrcBuildTables(void);
+#endif
+
+/*******************************************************************************
+*   Function Definitions
+*******************************************************************************/
+
+#ifdef PLD_QSPI_CRC_HARDWARE
+/**
+ * Fold Length bytes of Data into a running CRC32C, 0 to start
+ */
+uint32_t PLD_QSPI_Crc32c(uint32_t Crc, const uint8_t *Data, uint32_t Length)
+{
+    uint64_t Double;
+
+    Crc = ~Crc;
+
+    while (Length >= 8U) {
+        memcpy(&Double, Data, 8U);
+        Crc = __crc32cd(Crc, Double);
+        Data += 8;
+        Length -= 8U;
+    }
+
+    while (Length > 0) {
+        Crc = __crc32cb(Crc, *Data++);
+        Length--;
+    }
+
+    return ~Crc;
+}
+#else
+/**
+ * Fold Length bytes of Data into a running CRC32C, 0 to start
+ */
+uint32_t PLD_QSPI_Crc32c(uint32_t Crc, const uint8_t *Data, uint32_t Length)
+{
+    const uint32_t (*Table)[256] = PLD_QSPI_CrcTable;
+    uint32_t Low;
+    uint32_t High;
+
+    if (!PLD_QSPI_CrcReady) {
+        PLD_QSPI_CrcBuildTables();
+    }
+
+    Crc = ~Crc;
+
+    // Bytes up to an 8 byte boundary, so the main loop's loads are aligned
+    while (Length > 0 && ((uintptr_t)Data & 7U) != 0) {
+        Crc = Table[0][(Crc ^ *Data++) & 0xFFU] ^ (Crc >> 8);
+        Length--;
+    }
+
+    while (Length >= 8U) {
+        memcpy(&Low, Data, 4U);
+        memcpy(&High, Data + 4, 4U);
+        Low ^= Crc;
+        Crc = Table[7][Low & 0xFFU] ^ Table[6][(Low >> 8) & 0xFFU] ^
+              Table[5][(Low >> 16) & 0xFFU] ^ Table[4][Low >> 24] ^
+              Table[3][High & 0xFFU] ^ Table[2][(High >> 8) & 0xFFU] ^
+              Table[1][(High >> 16) & 0xFFU] ^ Table[0][High >> 24];
+        Data += 8;
+        Length -= 8U;
+    }
+
+    while (Length > 0) {
+        Crc = Table[0][(Crc ^ *Data++) & 0xFFU] ^ (Crc >> 8);
+        Length--;
+    }
+
+    return ~Crc;
+}
+
+/**
+ * Build the slice-by-8 tables from the polynomial
+ */
+static void PLD_QSPI_CrcBuildTables(void)
+{
+    uint32_t Index;
+    uint32_t Slice;
+    uint32_t Bit;
+    uint32_t Crc;
+
+    for (Index = 0; Index < 256U; Index++) {
+        Crc = Index;
+        for (Bit = 0; Bit < 8U; Bit++) {
+            Crc = (Crc >> 1) ^ ((Crc & 1U) ? PLD_QSPI_CRC32C_POLY : 0U);
+        }
+        PLD_QSPI_CrcTable[0][Index] = Crc;
+    }
+
+    // Each slice pushes the previous one through another zero byte
+    for (Index = 0; Index < 256U; Index++) {
+        Crc = PLD_QSPI_CrcTable[0][Index];
+        for (Slice = 1; Slice < 8U; Slice++) {
+            Crc = PLD_QSPI_CrcTable[0][Crc & 0xFFU] ^ (Crc >> 8);
+            PLD_QSPI_CrcTable[Slice][Index] = Crc;
+        }
+    }
+
+    PLD_QSPI_CrcReady = 1;
+}
+#endif
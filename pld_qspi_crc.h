@@ -0,0 +1,61 @@
+/*******************************************************************************
+*   McMaster PRESET (www.mcmasterneudose.ca)
+*
+*   Data Acquisition Module - DAM
+*   Flight Firmware
+*
+*   @file       pld_qspi_crc.h
+*   @desc       CRC32C (Castagnoli) used to check images and blocks read from flash
+*   @author     Sameer Suleman
+*   @date       October 16, 2026
+*
+*	<pre>
+*
+*   Revision History:
+*
+*	Ver   	Who    	Date   		Changes
+*	----- 	---- 	-------- 	-------------------------------------------------------
+*   1.0.0   sam     2026-10-16  Slice-by-8 CRC32C, ARMv8 CRC instructions where available
+*	</pre>
+*
+*******************************************************************************/
+
+/*******************************************************************************
+*   Prevent circular dependency
+*   DO NOT REMOVE
+*******************************************************************************/
+#ifndef PLD_QSPI_CRC
+#define PLD_QSPI_CRC
+
+/*******************************************************************************
+*   Includes
+*******************************************************************************/
+/* STD Includes */
+#include <stdint.h>
+
+/*******************************************************************************
+*   Preprocessor Macros
+*******************************************************************************/
+/* Targets with the ARMv8 CRC32 extension (Cortex-A53 and later) use its
+ * CRC32C instructions instead of the tables. Define PLD_QSPI_CRC_SOFTWARE
+ * to keep the tables anyway. The Zynq-7000's Cortex-A9 always uses them. */
+#if defined(__ARM_FEATURE_CRC32) && !defined(PLD_QSPI_CRC_SOFTWARE)
+#define PLD_QSPI_CRC_HARDWARE
+#endif
+
+/*******************************************************************************
+*   Constant Definitions
+*******************************************************************************/
+#define PLD_QSPI_CRC32C_POLY            0x82F63B78U     /* Reflected Castagnoli polynomial */
+#define PLD_QSPI_CRC32C_CHECK           0xE3069283U     /* CRC32C of "123456789" */
+
+/*******************************************************************************
+*   Function Prototypes
+*******************************************************************************/
+uint32_t PLD_QSPI_Crc32c(uint32_t Crc, const uint8_t *Data, uint32_t Length);
+
+/*******************************************************************************
+*   Prevent circular dependency
+*   DO NOT REMOVE
+*******************************************************************************/
+#endif /* PLD_QSPI_CRC */
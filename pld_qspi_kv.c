@@ -0,0 +1,355 @@
+/*******************************************************************************
+*   McMaster PRESET (www.mcmasterneudose.ca)
+*
+*   Data Acquisition Module - DAM
+*   Flight Firmware
+*
+*   @file       pld_qspi_kv.c
+*   @desc       Key-value parameter store on the QSPI record store
+*   @author     Sameer Suleman
+*   @date       October 17, 2026
+*
+*	<pre>
+*
+*   Keys are 32-bit, normally the CRC32C of a parameter name from
+*   PLD_QSPI_KvKey. An open-addressed hash table in RAM (linear probing)
+*   maps each key to a slot, and the slot's index doubles as the record
+*   Id in the record store underneath, whose payload is the key followed
+*   by the value. Setting a key appends a new version of its record, so
+*   the journal is the record store itself and nothing is erased in the
+*   foreground; stale versions are reclaimed by PLD_QSPI_LogService.
+*
+*   Because slots are record Ids, opening needs no rehashing: the record
+*   store's mount already knows which Ids exist, and one read of each
+*   record gives back its key. A deleted key leaves a zero-length record
+*   behind (a tombstone) while other keys may have probed past its slot,
+*   so the probe chains come back intact too.
+*
+*   Gets of absent keys and of values up to PLD_QSPI_KV_INLINE_SIZE bytes
+*   are answered from RAM. Anything larger is a single read of its record
+*   with the CRC check folded in. Sets of the value already stored write
+*   nothing, so parameters can be saved unconditionally.
+*
+*   Revision History:
+*
+*	Ver   	Who    	Date   		Changes
+*	----- 	---- 	-------- 	-------------------------------------------------------
+*   1.0.0   sam     2026-10-17  Hashed 32-bit keys, RAM hash index, small values held in RAM
+*   1.0.1   sam     2026-10-17  Timed with the driver's PLD_QSPI_NowUs
+*	</pre>
+*
+*******************************************************************************/
+
+/*******************************************************************************
+*   Includes
+*******************************************************************************/
+#include "pld_qspi_kv.h"
+
+/* STD Includes */
+#include <string.h>
+
+/* NEUDOSE Includes */
+#include "pld_qspi_crc.h"
+
+/*******************************************************************************
+*   Constant Definitions
+*******************************************************************************/
+#define PLD_QSPI_KV_NONE                0xFFFFFFFFU     /* Slot of a key that is not stored */
+
+/*******************************************************************************
+*   Function Prototypes
+*******************************************************************************/
+static uint32_t PLD_QSPI_KvFind(PLD_QSPI_Kv_t *KvPtr, uint32_t Key, uint32_t *FreePtr);
+static XStatus PLD_QSPI_KvLoad(PLD_QSPI_Kv_t *KvPtr, uint32_t Slot, uint32_t *LengthPtr);
+
+/*******************************************************************************
+*   Function Definitions
+*******************************************************************************/
+
+/**
+ * Key for a parameter name, the CRC32C of the string
+ */
+uint32_t PLD_QSPI_KvKey(const char *Name)
+{
+    return PLD_QSPI_Crc32c(0, (const uint8_t *)Name, (uint32_t)strlen(Name));
+}
+
+/**
+ * Open the key-value store kept in a mounted record store
+ * Slots holds one entry per record Id (the store's MaxRecords), and the
+ * store should hold nothing but key-value records. Reads every record
+ * once to rebuild the hash table. Records failing their CRC are dropped
+ * and counted in Stats.Lost, so their keys read as absent.
+ */
+XStatus PLD_QSPI_KvOpen(PLD_QSPI_Kv_t *KvPtr, PLD_QSPI_Log_t *LogPtr, PLD_QSPI_KvSlot_t *Slots)
+{
+    XStatus Status;
+    PLD_QSPI_KvSlot_t *SlotPtr;
+    uint32_t Start = PLD_QSPI_NowUs();
+    uint32_t Slot;
+    uint32_t Length;
+
+    if (KvPtr == NULL || LogPtr == NULL || Slots == NULL) {
+        return XST_INVALID_PARAM;
+    }
+
+    memset(KvPtr, 0, sizeof(*KvPtr));
+    KvPtr->Log = LogPtr;
+    KvPtr->Slots = Slots;
+    KvPtr->SlotCount = LogPtr->MaxRecords;
+
+    for (Slot = 0; Slot < KvPtr->SlotCount; Slot++) {
+        SlotPtr = &Slots[Slot];
+        memset(SlotPtr, 0, sizeof(*SlotPtr));
+
+        if (LogPtr->Index[Slot].Address == PLD_QSPI_LOG_NONE) {
+            SlotPtr->State = PLD_QSPI_KV_EMPTY;
+            continue;
+        }
+        if (LogPtr->Index[Slot].Length == 0) {
+            SlotPtr->State = PLD_QSPI_KV_DELETED;
+            continue;
+        }
+
+        Status = PLD_QSPI_KvLoad(KvPtr, Slot, &Length);
+        if (Status != XST_SUCCESS && Status != XST_DATA_LOST && Status != XST_BUFFER_TOO_SMALL) {
+            return Status;
+        }
+        if (Status != XST_SUCCESS || Length < PLD_QSPI_KV_KEY_SIZE) {
+            // Keep the slot taken so probe chains through it still hold
+            SlotPtr->State = PLD_QSPI_KV_DELETED;
+            KvPtr->Stats.Lost++;
+            continue;
+        }
+
+        memcpy(&SlotPtr->Key, KvPtr->Buffer, PLD_QSPI_KV_KEY_SIZE);
+        SlotPtr->Length = (uint16_t)(Length - PLD_QSPI_KV_KEY_SIZE);
+        SlotPtr->State = PLD_QSPI_KV_USED;
+        if (SlotPtr->Length <= PLD_QSPI_KV_INLINE_SIZE) {
+            SlotPtr->Inline = 1;
+            memcpy(SlotPtr->Value, &KvPtr->Buffer[PLD_QSPI_KV_KEY_SIZE], SlotPtr->Length);
+        }
+        KvPtr->Count++;
+    }
+
+    KvPtr->Stats.OpenUs = PLD_QSPI_NowUs() - Start;
+
+    return XST_SUCCESS;
+}
+
+/**
+ * Read the value of Key into Value
+ * LengthPtr, if not NULL, receives its length, even when Size is too
+ * small (XST_BUFFER_TOO_SMALL). XST_NO_DATA if the key is not stored,
+ * XST_DATA_LOST if its record fails the CRC check.
+ */
+XStatus PLD_QSPI_KvGet(PLD_QSPI_Kv_t *KvPtr, uint32_t Key, void *Value, uint32_t Size, uint32_t *LengthPtr)
+{
+    XStatus Status;
+    PLD_QSPI_KvSlot_t *SlotPtr;
+    uint32_t Slot;
+    uint32_t Free;
+    uint32_t Length;
+
+    KvPtr->Stats.Gets++;
+
+    Slot = PLD_QSPI_KvFind(KvPtr, Key, &Free);
+    if (Slot == PLD_QSPI_KV_NONE) {
+        KvPtr->Stats.Misses++;
+        return XST_NO_DATA;
+    }
+    SlotPtr = &KvPtr->Slots[Slot];
+
+    if (LengthPtr != NULL) {
+        *LengthPtr = SlotPtr->Length;
+    }
+    if (Size < SlotPtr->Length) {
+        return XST_BUFFER_TOO_SMALL;
+    }
+    if (SlotPtr->Length != 0 && Value == NULL) {
+        return XST_INVALID_PARAM;
+    }
+
+    if (SlotPtr->Inline) {
+        KvPtr->Stats.RamHits++;
+        if (SlotPtr->Length != 0) {
+            memcpy(Value, SlotPtr->Value, SlotPtr->Length);
+        }
+        return XST_SUCCESS;
+    }
+
+    KvPtr->Stats.FlashReads++;
+    Status = PLD_QSPI_KvLoad(KvPtr, Slot, &Length);
+    if (Status != XST_SUCCESS) {
+        return Status;
+    }
+
+    memcpy(Value, &KvPtr->Buffer[PLD_QSPI_KV_KEY_SIZE], SlotPtr->Length);
+
+    return XST_SUCCESS;
+}
+
+/**
+ * Store Length bytes of Value under Key, replacing any older value
+ * Appends to the record store, which stages the record until its page
+ * fills or PLD_QSPI_LogSync. A value matching the stored one is not
+ * written again. XST_BUFFER_TOO_SMALL when every slot is taken or the
+ * record store is full.
+ */
+XStatus PLD_QSPI_KvSet(PLD_QSPI_Kv_t *KvPtr, uint32_t Key, const void *Value, uint32_t Length)
+{
+    XStatus Status;
+    PLD_QSPI_KvSlot_t *SlotPtr;
+    uint32_t Slot;
+    uint32_t Free;
+    uint32_t Crc;
+    uint32_t Stored;
+
+    if (Length > PLD_QSPI_KV_VALUE_MAX || (Value == NULL && Length != 0)) {
+        return XST_INVALID_PARAM;
+    }
+
+    KvPtr->Stats.Sets++;
+
+    Slot = PLD_QSPI_KvFind(KvPtr, Key, &Free);
+    if (Slot != PLD_QSPI_KV_NONE) {
+        SlotPtr = &KvPtr->Slots[Slot];
+
+        // Small values compare in RAM, larger ones by CRC and then a read to be sure
+        if (SlotPtr->Length == Length) {
+            if (SlotPtr->Inline) {
+                if (Length == 0 || memcmp(SlotPtr->Value, Value, Length) == 0) {
+                    KvPtr->Stats.Unchanged++;
+                    return XST_SUCCESS;
+                }
+            } else {
+                Crc = PLD_QSPI_Crc32c(0, (const uint8_t *)&Key, PLD_QSPI_KV_KEY_SIZE);
+                Crc = PLD_QSPI_Crc32c(Crc, (const uint8_t *)Value, Length);
+                if (Crc == KvPtr->Log->Index[Slot].Crc && PLD_QSPI_KvLoad(KvPtr, Slot, &Stored) == XST_SUCCESS &&
+                    memcmp(&KvPtr->Buffer[PLD_QSPI_KV_KEY_SIZE], Value, Length) == 0) {
+                    KvPtr->Stats.Unchanged++;
+                    return XST_SUCCESS;
+                }
+            }
+        }
+    } else {
+        if (Free == PLD_QSPI_KV_NONE) {
+            return XST_BUFFER_TOO_SMALL;
+        }
+        Slot = Free;
+        SlotPtr = &KvPtr->Slots[Slot];
+    }
+
+    memcpy(KvPtr->Buffer, &Key, PLD_QSPI_KV_KEY_SIZE);
+    if (Length != 0) {
+        memcpy(&KvPtr->Buffer[PLD_QSPI_KV_KEY_SIZE], Value, Length);
+    }
+
+    Status = PLD_QSPI_LogAppend(KvPtr->Log, Slot, KvPtr->Buffer, PLD_QSPI_KV_KEY_SIZE + Length);
+    if (Status != XST_SUCCESS) {
+        return Status;
+    }
+
+    if (SlotPtr->State != PLD_QSPI_KV_USED) {
+        KvPtr->Count++;
+    }
+    SlotPtr->Key = Key;
+    SlotPtr->Length = (uint16_t)Length;
+    SlotPtr->State = PLD_QSPI_KV_USED;
+    SlotPtr->Inline = (Length <= PLD_QSPI_KV_INLINE_SIZE) ? 1U : 0U;
+    if (SlotPtr->Inline && Length != 0) {
+        memcpy(SlotPtr->Value, Value, Length);
+    }
+
+    return XST_SUCCESS;
+}
+
+/**
+ * Remove Key, XST_NO_DATA if it is not stored
+ * The slot's record is deleted outright when no probe can have passed
+ * it (the next slot is empty), otherwise it becomes a tombstone.
+ */
+XStatus PLD_QSPI_KvDelete(PLD_QSPI_Kv_t *KvPtr, uint32_t Key)
+{
+    XStatus Status;
+    uint32_t Slot;
+    uint32_t Free;
+    uint32_t Empty;
+
+    Slot = PLD_QSPI_KvFind(KvPtr, Key, &Free);
+    if (Slot == PLD_QSPI_KV_NONE) {
+        return XST_NO_DATA;
+    }
+
+    Empty = (KvPtr->Slots[(Slot + 1U) % KvPtr->SlotCount].State == PLD_QSPI_KV_EMPTY);
+    if (Empty) {
+        Status = PLD_QSPI_LogDelete(KvPtr->Log, Slot);
+    } else {
+        Status = PLD_QSPI_LogAppend(KvPtr->Log, Slot, NULL, 0);
+    }
+    if (Status != XST_SUCCESS) {
+        return Status;
+    }
+
+    KvPtr->Slots[Slot].State = Empty ? PLD_QSPI_KV_EMPTY : PLD_QSPI_KV_DELETED;
+    KvPtr->Count--;
+    KvPtr->Stats.Deletes++;
+
+    return XST_SUCCESS;
+}
+
+/**
+ * Clear the store accounting, the open time included
+ */
+void PLD_QSPI_KvResetStats(PLD_QSPI_Kv_t *KvPtr)
+{
+    memset(&KvPtr->Stats, 0, sizeof(KvPtr->Stats));
+}
+
+/**
+ * Slot holding Key, or PLD_QSPI_KV_NONE
+ * FreePtr receives the first empty or deleted slot on the probe, where
+ * the key would be added, PLD_QSPI_KV_NONE if every slot is taken.
+ */
+static uint32_t PLD_QSPI_KvFind(PLD_QSPI_Kv_t *KvPtr, uint32_t Key, uint32_t *FreePtr)
+{
+    PLD_QSPI_KvSlot_t *SlotPtr;
+    uint32_t Slot;
+    uint32_t Count;
+
+    *FreePtr = PLD_QSPI_KV_NONE;
+
+    // Fibonacci hashing spreads small integer keys as well as name CRCs
+    Slot = (uint32_t)(((uint64_t)(Key * 0x9E3779B1U) * KvPtr->SlotCount) >> 32);
+
+    for (Count = 0; Count < KvPtr->SlotCount; Count++) {
+        SlotPtr = &KvPtr->Slots[Slot];
+
+        if (SlotPtr->State == PLD_QSPI_KV_EMPTY) {
+            if (*FreePtr == PLD_QSPI_KV_NONE) {
+                *FreePtr = Slot;
+            }
+            break;
+        }
+        if (SlotPtr->State == PLD_QSPI_KV_DELETED) {
+            if (*FreePtr == PLD_QSPI_KV_NONE) {
+                *FreePtr = Slot;
+            }
+        } else if (SlotPtr->Key == Key) {
+            return Slot;
+        }
+
+        KvPtr->Stats.Probes++;
+        Slot = (Slot + 1U == KvPtr->SlotCount) ? 0 : Slot + 1U;
+    }
+
+    return PLD_QSPI_KV_NONE;
+}
+
+/**
+ * Read a slot's whole record, key included, into the store's buffer
+ */
+static XStatus PLD_QSPI_KvLoad(PLD_QSPI_Kv_t *KvPtr, uint32_t Slot, uint32_t *LengthPtr)
+{
+    return PLD_QSPI_LogRead(KvPtr->Log, Slot, KvPtr->Buffer, sizeof(KvPtr->Buffer), LengthPtr);
+}
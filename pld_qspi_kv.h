@@ -0,0 +1,116 @@
+/*******************************************************************************
+*   McMaster PRESET (www.mcmasterneudose.ca)
+*
+*   Data Acquisition Module - DAM
+*   Flight Firmware
+*
+*   @file       pld_qspi_kv.h
+*   @desc       Key-value parameter store on the QSPI record store
+*   @author     Sameer Suleman
+*   @date       October 17, 2026
+*
+*	<pre>
+*
+*   Revision History:
+*
+*	Ver   	Who    	Date   		Changes
+*	----- 	---- 	-------- 	-------------------------------------------------------
+*   1.0.0   sam     2026-10-17  Hashed 32-bit keys, RAM hash index, small values held in RAM
+*   1.0.1   sam     2026-10-17  Timed with the driver's PLD_QSPI_NowUs
+*	</pre>
+*
+*******************************************************************************/
+
+/*******************************************************************************
+*   Prevent circular dependency
+*   DO NOT REMOVE
+*******************************************************************************/
+#ifndef PLD_QSPI_KV
+#define PLD_QSPI_KV
+
+/*******************************************************************************
+*   Includes
+*******************************************************************************/
+/* STD Includes */
+#include <stdint.h>
+
+/* Xilinx Includes */
+#include "xstatus.h"
+
+/* NEUDOSE Includes */
+#include "pld_qspi_log.h"
+
+/*******************************************************************************
+*   Preprocessor Macros
+*******************************************************************************/
+/* Values up to this size are kept in the hash table too, so reading them
+ * never touches the flash. Covers the usual integer, float and double. */
+#ifndef PLD_QSPI_KV_INLINE_SIZE
+#define PLD_QSPI_KV_INLINE_SIZE         8U
+#endif
+
+/* Largest value, sizes the store's read buffer */
+#ifndef PLD_QSPI_KV_VALUE_MAX
+#define PLD_QSPI_KV_VALUE_MAX           256U
+#endif
+
+/*******************************************************************************
+*   Constant Definitions
+*******************************************************************************/
+#define PLD_QSPI_KV_KEY_SIZE            4U              /* Key at the front of every record payload */
+
+/* Hash table slot states */
+#define PLD_QSPI_KV_EMPTY               0U              /* Never used, ends a probe */
+#define PLD_QSPI_KV_USED                1U
+#define PLD_QSPI_KV_DELETED             2U              /* Deleted key, probes carry on past it */
+
+/*******************************************************************************
+*   Datatype Definitions
+*******************************************************************************/
+/* One hash table slot. A slot's index is also the Id of its record in the
+ * record store, so the table comes back exactly as it was at open. */
+typedef struct {
+    uint32_t Key;
+    uint16_t Length;                        /* Value bytes */
+    uint8_t State;                          /* PLD_QSPI_KV_EMPTY / _USED / _DELETED */
+    uint8_t Inline;                         /* Non-zero when Value holds the whole value */
+    uint8_t Value[PLD_QSPI_KV_INLINE_SIZE];
+} PLD_QSPI_KvSlot_t;
+
+typedef struct {
+    uint32_t Gets;
+    uint32_t RamHits;                       /* Gets answered from the table */
+    uint32_t FlashReads;                    /* Gets that read the record */
+    uint32_t Misses;                        /* Gets of absent keys, answered from the table */
+    uint32_t Sets;
+    uint32_t Unchanged;                     /* Sets that matched the stored value, so wrote nothing */
+    uint32_t Deletes;
+    uint32_t Probes;                        /* Slots looked at past the first, over all lookups */
+    uint32_t Lost;                          /* Records that failed their CRC at open, dropped */
+    uint32_t OpenUs;                        /* How long the last open took */
+} PLD_QSPI_KvStats_t;
+
+typedef struct {
+    PLD_QSPI_Log_t *Log;                    /* Mounted record store holding the values */
+    PLD_QSPI_KvSlot_t *Slots;               /* Caller's arena, one slot per store record Id */
+    uint32_t SlotCount;
+    uint32_t Count;                         /* Keys stored */
+    uint8_t Buffer[PLD_QSPI_KV_KEY_SIZE + PLD_QSPI_KV_VALUE_MAX];
+    PLD_QSPI_KvStats_t Stats;
+} PLD_QSPI_Kv_t;
+
+/*******************************************************************************
+*   Function Prototypes
+*******************************************************************************/
+uint32_t PLD_QSPI_KvKey(const char *Name);
+XStatus PLD_QSPI_KvOpen(PLD_QSPI_Kv_t *KvPtr, PLD_QSPI_Log_t *LogPtr, PLD_QSPI_KvSlot_t *Slots);
+XStatus PLD_QSPI_KvGet(PLD_QSPI_Kv_t *KvPtr, uint32_t Key, void *Value, uint32_t Size, uint32_t *LengthPtr);
+XStatus PLD_QSPI_KvSet(PLD_QSPI_Kv_t *KvPtr, uint32_t Key, const void *Value, uint32_t Length);
+XStatus PLD_QSPI_KvDelete(PLD_QSPI_Kv_t *KvPtr, uint32_t Key);
+void PLD_QSPI_KvResetStats(PLD_QSPI_Kv_t *KvPtr);
+
+/*******************************************************************************
+*   Prevent circular dependency
+*   DO NOT REMOVE
+*******************************************************************************/
+#endif /* PLD_QSPI_KV */
@@ -0,0 +1,904 @@
+/*******************************************************************************
+*   McMaster PRESET (www.mcmasterneudose.ca)
+*
+*   Data Acquisition Module - DAM
+*   Flight Firmware
+*
+*   @file       pld_qspi_log.c
+*   @desc       Log-structured record store on the QSPI flash
+*   @author     Sameer Suleman
+*   @date       October 16, 2026
+*
+*	<pre>
+*
+*   The region is split into segments used as a ring. Records (an Id, a
+*   payload and a CRC) are only ever appended, at the head segment, and a
+*   new version of a record simply makes the old one stale. A RAM index
+*   maps each Id to its newest copy, so a read is one flash read with the
+*   CRC check folded in. Appends are staged a page at a time, so small
+*   records are programmed in whole pages at the flash's page rate.
+*   PLD_QSPI_LogSync programs a partly filled page; until then the last
+*   appends only live in RAM.
+*
+*   Space comes back by reclaiming the tail (oldest) segment: its live
+*   records are copied to the head, then it is erased in the background.
+*   The copies are programmed, partly filled page included, before the
+*   segment is given up, so a power cut never finds both gone. Because segments are opened and reclaimed strictly in ring order, each
+*   one is erased once per trip around the ring, whatever the data does:
+*   rarely changed records are carried along by compaction rather than
+*   pinning their segment, so wear is level across the whole region.
+*   One segment is always held back so compaction has room to copy into.
+*
+*   Mount rebuilds the index by scanning record headers only, through a
+*   window that picks up several headers per read. Only the newest record
+*   can be torn by a power cut, so its payload is the only one checked.
+*   PLD_QSPI_LogService does background work: erasing reclaimed segments
+*   (with erase-ahead, which the store owns while mounted) and compacting
+*   a record per call when free segments run low.
+*
+*   Revision History:
+*
+*	Ver   	Who    	Date   		Changes
+*	----- 	---- 	-------- 	-------------------------------------------------------
+*   1.0.0   sam     2026-10-16  Append-only segments, RAM index, background compaction
+*   1.0.1   sam     2026-10-17  Timed with the driver's PLD_QSPI_NowUs
+*   1.0.2   sam     2026-10-17  Segment erases waited out from their remaining time
+*   1.0.3   sam     2026-10-17  Compaction copies programmed before their segment is reclaimed
+*	</pre>
+*
+*******************************************************************************/
+
+/*******************************************************************************
+*   Includes
+*******************************************************************************/
+#include "pld_qspi_log.h"
+
+/* STD Includes */
+#include <stddef.h>
+#include <string.h>
+
+/* NEUDOSE Includes */
+#include "pld_qspi_crc.h"
+
+/*******************************************************************************
+*   Function Prototypes
+*******************************************************************************/
+static uint32_t PLD_QSPI_LogSegmentAddress(PLD_QSPI_Log_t *LogPtr, uint32_t Segment);
+static uint32_t PLD_QSPI_LogSegmentOf(PLD_QSPI_Log_t *LogPtr, uint32_t Address);
+static uint32_t PLD_QSPI_LogIsErased(const uint8_t *Data, uint32_t Length);
+static uint32_t PLD_QSPI_LogHeaderCrc(const PLD_QSPI_LogRecord_t *RecordPtr);
+static void PLD_QSPI_LogIndex(PLD_QSPI_Log_t *LogPtr, uint32_t Id, const PLD_QSPI_LogEntry_t *EntryPtr);
+static XStatus PLD_QSPI_LogScan(PLD_QSPI_Log_t *LogPtr, uint32_t Segment, uint32_t *EndPtr);
+static XStatus PLD_QSPI_LogProgram(PLD_QSPI_Log_t *LogPtr);
+static XStatus PLD_QSPI_LogPut(PLD_QSPI_Log_t *LogPtr, const uint8_t *Data, uint32_t Source, uint32_t Length);
+static XStatus PLD_QSPI_LogPrepare(PLD_QSPI_Log_t *LogPtr, uint32_t Segment);
+static XStatus PLD_QSPI_LogOpen(PLD_QSPI_Log_t *LogPtr, uint32_t Reserve);
+static XStatus PLD_QSPI_LogCompactStep(PLD_QSPI_Log_t *LogPtr);
+static XStatus PLD_QSPI_LogMakeRoom(PLD_QSPI_Log_t *LogPtr, uint32_t Size);
+static XStatus PLD_QSPI_LogAdd(PLD_QSPI_Log_t *LogPtr, uint32_t Id, uint8_t Type, const uint8_t *Data, uint32_t Length);
+
+/*******************************************************************************
+*   Function Definitions
+*******************************************************************************/
+
+/**
+ * Mount the store in Address to Address + Length, rebuilding the index
+ * Segments holds Length / SegmentSize entries and Index MaxRecords. A
+ * region that was never formatted mounts empty, its segments are erased
+ * as they are needed (or all at once by PLD_QSPI_LogFormat).
+ */
+XStatus PLD_QSPI_LogMount(PLD_QSPI_Log_t *LogPtr, PLD_QSPI_t *InstancePtr, uint32_t Address, uint32_t Length,
+                          uint32_t SegmentSize, PLD_QSPI_LogSegment_t *Segments,
+                          PLD_QSPI_LogEntry_t *Index, uint32_t MaxRecords)
+{
+    XStatus Status;
+    PLD_QSPI_LogSegmentHeader_t Header;
+    PLD_QSPI_LogSegment_t *SegPtr;
+    uint32_t Granule;
+    uint32_t Start = PLD_QSPI_NowUs();
+    uint32_t Segment;
+    uint32_t Newest = PLD_QSPI_LOG_NONE;
+    uint32_t Count;
+    uint32_t End;
+
+    if (LogPtr == NULL || InstancePtr == NULL || Segments == NULL || Index == NULL ||
+        MaxRecords == 0 || MaxRecords > 0xFFFFU || InstancePtr->Flash.PageSize > PLD_QSPI_LOG_BUFFER_SIZE ||
+        InstancePtr->Flash.EraseTypes == 0 || SegmentSize <= PLD_QSPI_LOG_SEGMENT_HEADER + PLD_QSPI_LOG_RECORD_HEADER) {
+        return XST_INVALID_PARAM;
+    }
+
+    // Segments are erased whole, so they and the region must sit on erase blocks
+    Granule = InstancePtr->Flash.Erase[0].Size;
+    if (Address % Granule != 0 || SegmentSize % Granule != 0 || Length / SegmentSize < 3U ||
+        Address > UINT32_MAX - Length) {
+        return XST_INVALID_PARAM;
+    }
+
+    memset(LogPtr, 0, sizeof(*LogPtr));
+    LogPtr->Qspi = InstancePtr;
+    LogPtr->Address = Address;
+    LogPtr->SegmentSize = SegmentSize;
+    LogPtr->SegmentCount = Length / SegmentSize;
+    LogPtr->Segments = Segments;
+    LogPtr->Index = Index;
+    LogPtr->MaxRecords = MaxRecords;
+    LogPtr->Erasing = PLD_QSPI_LOG_NONE;
+
+    for (Segment = 0; Segment < MaxRecords; Segment++) {
+        Index[Segment].Address = PLD_QSPI_LOG_NONE;
+    }
+
+    // Segment headers say which segments hold records, and in what order
+    for (Segment = 0; Segment < LogPtr->SegmentCount; Segment++) {
+        SegPtr = &Segments[Segment];
+        Status = PLD_QSPI_Read(InstancePtr, PLD_QSPI_LogSegmentAddress(LogPtr, Segment), (uint8_t *)&Header,
+                               sizeof(Header));
+        if (Status != XST_SUCCESS) {
+            return Status;
+        }
+
+        SegPtr->Sequence = PLD_QSPI_LOG_NONE;
+        SegPtr->Live = 0;
+        if (Header.Magic != PLD_QSPI_LOG_MAGIC) {
+            SegPtr->EraseCount = 0;
+            SegPtr->State = PLD_QSPI_LOG_DIRTY;
+            continue;
+        }
+
+        SegPtr->EraseCount = Header.EraseCount;
+        if (Header.Sequence == PLD_QSPI_LOG_NONE && Header.SequenceCheck == PLD_QSPI_LOG_NONE) {
+            SegPtr->State = PLD_QSPI_LOG_FREE;
+        } else if (Header.Sequence == ~Header.SequenceCheck) {
+            SegPtr->State = PLD_QSPI_LOG_USED;
+            SegPtr->Sequence = Header.Sequence;
+            if (Newest == PLD_QSPI_LOG_NONE || Header.Sequence > Segments[Newest].Sequence) {
+                Newest = Segment;
+            }
+        } else {
+            // Opened, but the sequence write never finished
+            SegPtr->State = PLD_QSPI_LOG_DIRTY;
+        }
+    }
+
+    if (Newest == PLD_QSPI_LOG_NONE) {
+        LogPtr->Stats.MountUs = PLD_QSPI_NowUs() - Start;
+        return XST_SUCCESS;
+    }
+
+    // The segments in use run back from the newest around the ring
+    LogPtr->Head = Newest;
+    LogPtr->Tail = Newest;
+    LogPtr->Used = 1;
+    LogPtr->NextSequence = Segments[Newest].Sequence + 1U;
+    for (Count = 1; Count < LogPtr->SegmentCount; Count++) {
+        Segment = (Newest + LogPtr->SegmentCount - Count) % LogPtr->SegmentCount;
+        if (Segments[Segment].State != PLD_QSPI_LOG_USED ||
+            Segments[Segment].Sequence >= Segments[LogPtr->Tail].Sequence) {
+            break;
+        }
+        LogPtr->Tail = Segment;
+        LogPtr->Used++;
+    }
+
+    // Anything else in use was reclaimed before its erase, or is left from an older layout
+    for (Segment = 0; Segment < LogPtr->SegmentCount; Segment++) {
+        if (Segments[Segment].State == PLD_QSPI_LOG_USED &&
+            (Segment + LogPtr->SegmentCount - LogPtr->Tail) % LogPtr->SegmentCount >= LogPtr->Used) {
+            Segments[Segment].State = PLD_QSPI_LOG_DIRTY;
+        }
+    }
+
+    // Oldest first, so newer copies of a record replace older ones in the index
+    for (Count = 0; Count < LogPtr->Used; Count++) {
+        Segment = (LogPtr->Tail + Count) % LogPtr->SegmentCount;
+        Status = PLD_QSPI_LogScan(LogPtr, Segment, &End);
+        if (Status != XST_SUCCESS) {
+            return Status;
+        }
+    }
+    LogPtr->WriteAddress = End;
+
+    LogPtr->Stats.MountUs = PLD_QSPI_NowUs() - Start;
+
+    return XST_SUCCESS;
+}
+
+/**
+ * Erase the whole region and start an empty store, keeping erase counts
+ */
+XStatus PLD_QSPI_LogFormat(PLD_QSPI_Log_t *LogPtr)
+{
+    XStatus Status;
+    PLD_QSPI_LogSegmentHeader_t Header;
+    uint32_t Segment;
+
+    // The store's own background erase would be cut short by the one below
+    while (PLD_QSPI_EraseAheadPending(LogPtr->Qspi) != 0) {
+        Status = PLD_QSPI_EraseAheadService(LogPtr->Qspi);
+        if (Status != XST_SUCCESS) {
+            return Status;
+        }
+    }
+
+    Status = PLD_QSPI_EraseRange(LogPtr->Qspi, LogPtr->Address, LogPtr->SegmentCount * LogPtr->SegmentSize);
+    if (Status != XST_SUCCESS) {
+        return Status;
+    }
+
+    Header.Magic = PLD_QSPI_LOG_MAGIC;
+    for (Segment = 0; Segment < LogPtr->SegmentCount; Segment++) {
+        LogPtr->Segments[Segment].EraseCount++;
+        LogPtr->Segments[Segment].Sequence = PLD_QSPI_LOG_NONE;
+        LogPtr->Segments[Segment].Live = 0;
+        LogPtr->Segments[Segment].State = PLD_QSPI_LOG_FREE;
+
+        Header.EraseCount = LogPtr->Segments[Segment].EraseCount;
+        Status = PLD_QSPI_Write(LogPtr->Qspi, PLD_QSPI_LogSegmentAddress(LogPtr, Segment), (uint8_t *)&Header, 8U);
+        if (Status != XST_SUCCESS) {
+            return Status;
+        }
+    }
+    LogPtr->Stats.Erases += LogPtr->SegmentCount;
+
+    for (Segment = 0; Segment < LogPtr->MaxRecords; Segment++) {
+        LogPtr->Index[Segment].Address = PLD_QSPI_LOG_NONE;
+    }
+
+    LogPtr->Head = 0;
+    LogPtr->Tail = 0;
+    LogPtr->Used = 0;
+    LogPtr->Pending = 0;
+    LogPtr->LiveBytes = 0;
+    LogPtr->CompactAddress = 0;
+    LogPtr->Erasing = PLD_QSPI_LOG_NONE;
+
+    return XST_SUCCESS;
+}
+
+/**
+ * Append a new version of record Id, which replaces any older one
+ * The record is staged in RAM until its page fills or PLD_QSPI_LogSync.
+ * Returns XST_BUFFER_TOO_SMALL when live records would no longer leave
+ * compaction room to work in.
+ */
+XStatus PLD_QSPI_LogAppend(PLD_QSPI_Log_t *LogPtr, uint32_t Id, const uint8_t *Data, uint32_t Length)
+{
+    XStatus Status;
+
+    if (Data == NULL && Length != 0) {
+        return XST_INVALID_PARAM;
+    }
+
+    Status = PLD_QSPI_LogAdd(LogPtr, Id, PLD_QSPI_LOG_DATA, Data, Length);
+    if (Status == XST_SUCCESS) {
+        LogPtr->Stats.Appends++;
+        LogPtr->Stats.BytesAppended += Length;
+    }
+
+    return Status;
+}
+
+/**
+ * Remove record Id, XST_NO_DATA if it does not exist
+ */
+XStatus PLD_QSPI_LogDelete(PLD_QSPI_Log_t *LogPtr, uint32_t Id)
+{
+    XStatus Status;
+
+    if (Id >= LogPtr->MaxRecords) {
+        return XST_INVALID_PARAM;
+    }
+
+    if (LogPtr->Index[Id].Address == PLD_QSPI_LOG_NONE) {
+        return XST_NO_DATA;
+    }
+
+    Status = PLD_QSPI_LogAdd(LogPtr, Id, PLD_QSPI_LOG_DELETE, NULL, 0);
+    if (Status == XST_SUCCESS) {
+        LogPtr->Stats.Deletes++;
+    }
+
+    return Status;
+}
+
+/**
+ * Read the newest version of record Id into Buffer
+ * LengthPtr, if not NULL, receives its length, even when Buffer is too
+ * small (XST_BUFFER_TOO_SMALL). XST_NO_DATA if the record does not exist,
+ * XST_DATA_LOST if its payload fails the CRC check.
+ */
+XStatus PLD_QSPI_LogRead(PLD_QSPI_Log_t *LogPtr, uint32_t Id, uint8_t *Buffer, uint32_t Size, uint32_t *LengthPtr)
+{
+    XStatus Status;
+    PLD_QSPI_LogEntry_t *EntryPtr;
+    uint32_t Address;
+    uint32_t Staged;
+    uint32_t Split;
+
+    if (Id >= LogPtr->MaxRecords) {
+        return XST_INVALID_PARAM;
+    }
+
+    EntryPtr = &LogPtr->Index[Id];
+    if (EntryPtr->Address == PLD_QSPI_LOG_NONE) {
+        return XST_NO_DATA;
+    }
+
+    if (LengthPtr != NULL) {
+        *LengthPtr = EntryPtr->Length;
+    }
+    if (Size < EntryPtr->Length) {
+        return XST_BUFFER_TOO_SMALL;
+    }
+    if (EntryPtr->Length == 0) {
+        return XST_SUCCESS;
+    }
+    if (Buffer == NULL) {
+        return XST_INVALID_PARAM;
+    }
+
+    LogPtr->Stats.Reads++;
+    Address = EntryPtr->Address + PLD_QSPI_LOG_RECORD_HEADER;
+    Staged = LogPtr->WriteAddress - LogPtr->Pending;
+
+    // Records still (partly) in the staging buffer come from RAM
+    if (PLD_QSPI_LogSegmentOf(LogPtr, EntryPtr->Address) == LogPtr->Head &&
+        Address + EntryPtr->Length > Staged) {
+        Split = (Address < Staged) ? Staged - Address : 0;
+        if (Split != 0) {
+            Status = PLD_QSPI_Read(LogPtr->Qspi, Address, Buffer, Split);
+            if (Status != XST_SUCCESS) {
+                return Status;
+            }
+        }
+        memcpy(&Buffer[Split], &LogPtr->Buffer[Address + Split - Staged], EntryPtr->Length - Split);
+
+        return (PLD_QSPI_Crc32c(0, Buffer, EntryPtr->Length) == EntryPtr->Crc) ? XST_SUCCESS : XST_DATA_LOST;
+    }
+
+    return PLD_QSPI_ReadVerify(LogPtr->Qspi, Address, Buffer, EntryPtr->Length, EntryPtr->Crc, NULL);
+}
+
+/**
+ * Program the records staged in RAM, so they survive a power cut
+ */
+XStatus PLD_QSPI_LogSync(PLD_QSPI_Log_t *LogPtr)
+{
+    return PLD_QSPI_LogProgram(LogPtr);
+}
+
+/**
+ * Do one step of background work, a short flash operation at most
+ * Finishes or starts the erase of a reclaimed segment, otherwise copies
+ * one record out of the tail segment when free segments are low (or
+ * reclaims the tail outright when nothing in it is live).
+ */
+XStatus PLD_QSPI_LogService(PLD_QSPI_Log_t *LogPtr)
+{
+    XStatus Status;
+    uint32_t First = (LogPtr->Used == 0) ? LogPtr->Head : LogPtr->Head + 1U;
+    uint32_t Segment;
+    uint32_t Count;
+
+    if (LogPtr->Erasing != PLD_QSPI_LOG_NONE) {
+        if (PLD_QSPI_EraseAheadPending(LogPtr->Qspi) != 0) {
+            return PLD_QSPI_EraseAheadService(LogPtr->Qspi);
+        }
+        return PLD_QSPI_LogPrepare(LogPtr, LogPtr->Erasing);
+    }
+
+    // Erase reclaimed segments in the order they will be opened
+    for (Count = 0; Count < LogPtr->SegmentCount - LogPtr->Used; Count++) {
+        Segment = (First + Count) % LogPtr->SegmentCount;
+        if (LogPtr->Segments[Segment].State != PLD_QSPI_LOG_DIRTY) {
+            continue;
+        }
+
+        Status = PLD_QSPI_EraseAheadStart(LogPtr->Qspi, PLD_QSPI_LogSegmentAddress(LogPtr, Segment),
+                                          LogPtr->SegmentSize);
+        if (Status == XST_SUCCESS) {
+            LogPtr->Segments[Segment].State = PLD_QSPI_LOG_ERASING;
+            LogPtr->Erasing = Segment;
+        }
+        return Status;
+    }
+
+    if (LogPtr->Used >= 2U && (LogPtr->CompactAddress != 0 || LogPtr->Segments[LogPtr->Tail].Live == 0 ||
+                               LogPtr->SegmentCount - LogPtr->Used <= PLD_QSPI_LOG_FREE_TARGET)) {
+        return PLD_QSPI_LogCompactStep(LogPtr);
+    }
+
+    return XST_SUCCESS;
+}
+
+/**
+ * Clear the store accounting, the mount figures included
+ */
+void PLD_QSPI_LogResetStats(PLD_QSPI_Log_t *LogPtr)
+{
+    memset(&LogPtr->Stats, 0, sizeof(LogPtr->Stats));
+}
+
+/**
+ * Flash address of a segment's header
+ */
+static uint32_t PLD_QSPI_LogSegmentAddress(PLD_QSPI_Log_t *LogPtr, uint32_t Segment)
+{
+    return LogPtr->Address + Segment * LogPtr->SegmentSize;
+}
+
+/**
+ * Segment holding a flash address
+ */
+static uint32_t PLD_QSPI_LogSegmentOf(PLD_QSPI_Log_t *LogPtr, uint32_t Address)
+{
+    return (Address - LogPtr->Address) / LogPtr->SegmentSize;
+}
+
+/**
+ * Non-zero if every byte reads erased
+ */
+static uint32_t PLD_QSPI_LogIsErased(const uint8_t *Data, uint32_t Length)
+{
+    while (Length > 0) {
+        if (*Data++ != 0xFFU) {
+            return 0;
+        }
+        Length--;
+    }
+
+    return 1;
+}
+
+/**
+ * CRC32C of a record header, which the discard mark is left out of
+ */
+static uint32_t PLD_QSPI_LogHeaderCrc(const PLD_QSPI_LogRecord_t *RecordPtr)
+{
+    PLD_QSPI_LogRecord_t Record = *RecordPtr;
+
+    Record.Discarded = 0xFFU;
+    return PLD_QSPI_Crc32c(0, (const uint8_t *)&Record, offsetof(PLD_QSPI_LogRecord_t, HeaderCrc));
+}
+
+/**
+ * Point record Id at a new copy, or at nothing when EntryPtr's address is
+ * PLD_QSPI_LOG_NONE, moving its bytes between the segments' live counts
+ */
+static void PLD_QSPI_LogIndex(PLD_QSPI_Log_t *LogPtr, uint32_t Id, const PLD_QSPI_LogEntry_t *EntryPtr)
+{
+    PLD_QSPI_LogEntry_t *OldPtr = &LogPtr->Index[Id];
+    uint32_t Size;
+
+    if (OldPtr->Address != PLD_QSPI_LOG_NONE) {
+        Size = PLD_QSPI_LOG_RECORD_HEADER + OldPtr->Length;
+        LogPtr->Segments[PLD_QSPI_LogSegmentOf(LogPtr, OldPtr->Address)].Live -= Size;
+        LogPtr->LiveBytes -= Size;
+    }
+
+    *OldPtr = *EntryPtr;
+
+    if (EntryPtr->Address != PLD_QSPI_LOG_NONE) {
+        Size = PLD_QSPI_LOG_RECORD_HEADER + EntryPtr->Length;
+        LogPtr->Segments[PLD_QSPI_LogSegmentOf(LogPtr, EntryPtr->Address)].Live += Size;
+        LogPtr->LiveBytes += Size;
+    }
+}
+
+/**
+ * Index the records of one segment in use, returning where they end
+ * Headers are parsed out of a window of PLD_QSPI_LOG_BUFFER_SIZE bytes,
+ * so small records cost one read per window rather than one each. The
+ * head's last record is the only one a power cut can leave half written,
+ * so it alone has its payload checked.
+ */
+static XStatus PLD_QSPI_LogScan(PLD_QSPI_Log_t *LogPtr, uint32_t Segment, uint32_t *EndPtr)
+{
+    XStatus Status;
+    PLD_QSPI_LogRecord_t Record;
+    PLD_QSPI_LogEntry_t Entry;
+    PLD_QSPI_LogEntry_t Previous = { PLD_QSPI_LOG_NONE, 0, 0 };
+    uint32_t Address = PLD_QSPI_LogSegmentAddress(LogPtr, Segment) + PLD_QSPI_LOG_SEGMENT_HEADER;
+    uint32_t End = PLD_QSPI_LogSegmentAddress(LogPtr, Segment) + LogPtr->SegmentSize;
+    uint32_t Window = 0;
+    uint32_t WindowLength = 0;
+    uint32_t Last = PLD_QSPI_LOG_NONE;
+    uint32_t LastId = 0;
+
+    while (Address + PLD_QSPI_LOG_RECORD_HEADER <= End) {
+        if (Address < Window || Address + PLD_QSPI_LOG_RECORD_HEADER > Window + WindowLength) {
+            Window = Address;
+            WindowLength = (End - Address < PLD_QSPI_LOG_BUFFER_SIZE) ? End - Address : PLD_QSPI_LOG_BUFFER_SIZE;
+            Status = PLD_QSPI_Read(LogPtr->Qspi, Window, LogPtr->Buffer, WindowLength);
+            if (Status != XST_SUCCESS) {
+                return Status;
+            }
+        }
+        memcpy(&Record, &LogPtr->Buffer[Address - Window], sizeof(Record));
+
+        if (PLD_QSPI_LogIsErased((const uint8_t *)&Record, sizeof(Record))) {
+            break;
+        }
+
+        LogPtr->Stats.MountRecords++;
+
+        // A bad header hides where the next record starts, so nothing after it can be appended to
+        if (PLD_QSPI_LogHeaderCrc(&Record) != Record.HeaderCrc ||
+            (Record.Type != PLD_QSPI_LOG_DATA && Record.Type != PLD_QSPI_LOG_DELETE) ||
+            Record.Length > End - Address - PLD_QSPI_LOG_RECORD_HEADER) {
+            LogPtr->Stats.TornRecords++;
+            Address = End;
+            Last = PLD_QSPI_LOG_NONE;
+            break;
+        }
+
+        // Records from a layout with more Ids are skipped, as are torn ones
+        if (Record.Id < LogPtr->MaxRecords && Record.Discarded == 0xFFU) {
+            Previous = LogPtr->Index[Record.Id];
+            Entry.Address = (Record.Type == PLD_QSPI_LOG_DATA) ? Address : PLD_QSPI_LOG_NONE;
+            Entry.Crc = Record.DataCrc;
+            Entry.Length = Record.Length;
+            PLD_QSPI_LogIndex(LogPtr, Record.Id, &Entry);
+            Last = Address;
+            LastId = Record.Id;
+        }
+
+        Address += PLD_QSPI_LOG_RECORD_HEADER + Record.Length;
+    }
+
+    if (Segment == LogPtr->Head && Last != PLD_QSPI_LOG_NONE && LogPtr->Index[LastId].Address == Last &&
+        LogPtr->Index[LastId].Length != 0) {
+        Status = PLD_QSPI_ReadVerify(LogPtr->Qspi, Last + PLD_QSPI_LOG_RECORD_HEADER, NULL,
+                                     LogPtr->Index[LastId].Length, LogPtr->Index[LastId].Crc, NULL);
+        if (Status == XST_DATA_LOST) {
+            // Back to the copy before it for good, and nothing more goes after the torn bytes
+            PLD_QSPI_LogIndex(LogPtr, LastId, &Previous);
+            LogPtr->Stats.TornRecords++;
+            Address = End;
+            Record.Discarded = 0;
+            Status = PLD_QSPI_Write(LogPtr->Qspi, Last + offsetof(PLD_QSPI_LogRecord_t, Discarded),
+                                    &Record.Discarded, 1U);
+        }
+        if (Status != XST_SUCCESS) {
+            return Status;
+        }
+    }
+
+    *EndPtr = Address;
+
+    return XST_SUCCESS;
+}
+
+/**
+ * Program the bytes staged in the buffer, never more than a page
+ */
+static XStatus PLD_QSPI_LogProgram(PLD_QSPI_Log_t *LogPtr)
+{
+    XStatus Status;
+
+    if (LogPtr->Pending == 0) {
+        return XST_SUCCESS;
+    }
+
+    Status = PLD_QSPI_Write(LogPtr->Qspi, LogPtr->WriteAddress - LogPtr->Pending, LogPtr->Buffer, LogPtr->Pending);
+    if (Status == XST_SUCCESS) {
+        LogPtr->Stats.BytesProgrammed += LogPtr->Pending;
+        LogPtr->Pending = 0;
+    }
+
+    return Status;
+}
+
+/**
+ * Stage Length bytes at the write address, from Data or, when Data is
+ * NULL, from flash at Source, programming each page as it fills
+ */
+static XStatus PLD_QSPI_LogPut(PLD_QSPI_Log_t *LogPtr, const uint8_t *Data, uint32_t Source, uint32_t Length)
+{
+    XStatus Status;
+    uint32_t PageSize = LogPtr->Qspi->Flash.PageSize;
+    uint32_t Copy;
+
+    while (Length > 0) {
+        Copy = PageSize - (LogPtr->WriteAddress % PageSize);
+        if (Copy > Length) {
+            Copy = Length;
+        }
+
+        if (Data != NULL) {
+            memcpy(&LogPtr->Buffer[LogPtr->Pending], Data, Copy);
+            Data += Copy;
+        } else {
+            Status = PLD_QSPI_Read(LogPtr->Qspi, Source, &LogPtr->Buffer[LogPtr->Pending], Copy);
+            if (Status != XST_SUCCESS) {
+                return Status;
+            }
+            Source += Copy;
+        }
+
+        LogPtr->Pending += Copy;
+        LogPtr->WriteAddress += Copy;
+        Length -= Copy;
+
+        if (LogPtr->WriteAddress % PageSize == 0) {
+            Status = PLD_QSPI_LogProgram(LogPtr);
+            if (Status != XST_SUCCESS) {
+                return Status;
+            }
+        }
+    }
+
+    return XST_SUCCESS;
+}
+
+/**
+ * Make a segment that is not in use ready to open: erased, with its
+ * magic and erase count programmed
+ */
+static XStatus PLD_QSPI_LogPrepare(PLD_QSPI_Log_t *LogPtr, uint32_t Segment)
+{
+    XStatus Status = XST_SUCCESS;
+    PLD_QSPI_LogSegmentHeader_t Header;
+    PLD_QSPI_LogSegment_t *SegPtr = &LogPtr->Segments[Segment];
+    uint32_t Address = PLD_QSPI_LogSegmentAddress(LogPtr, Segment);
+
+    if (SegPtr->State == PLD_QSPI_LOG_FREE) {
+        return XST_SUCCESS;
+    }
+
+    if (SegPtr->State == PLD_QSPI_LOG_ERASING) {
+        // Service starts each block of the erase, the waits in between expect the rest of the block in flight
+        for (;;) {
+            Status = PLD_QSPI_EraseAheadService(LogPtr->Qspi);
+            if (Status != XST_SUCCESS || PLD_QSPI_EraseAheadPending(LogPtr->Qspi) == 0) {
+                break;
+            }
+            Status = PLD_QSPI_WaitReady(LogPtr->Qspi, PLD_QSPI_EraseAheadRemainingUs(LogPtr->Qspi),
+                                        LogPtr->Qspi->Flash.Erase[LogPtr->Qspi->Flash.EraseTypes - 1U].TimeMaxUs * 2U,
+                                        NULL);
+            if (Status != XST_SUCCESS) {
+                break;
+            }
+        }
+        LogPtr->Erasing = PLD_QSPI_LOG_NONE;
+    } else {
+        Status = PLD_QSPI_EraseRange(LogPtr->Qspi, Address, LogPtr->SegmentSize);
+    }
+    if (Status != XST_SUCCESS) {
+        SegPtr->State = PLD_QSPI_LOG_DIRTY;
+        return Status;
+    }
+
+    SegPtr->EraseCount++;
+    LogPtr->Stats.Erases++;
+
+    Header.Magic = PLD_QSPI_LOG_MAGIC;
+    Header.EraseCount = SegPtr->EraseCount;
+    Status = PLD_QSPI_Write(LogPtr->Qspi, Address, (uint8_t *)&Header, 8U);
+    SegPtr->State = (Status == XST_SUCCESS) ? PLD_QSPI_LOG_FREE : PLD_QSPI_LOG_DIRTY;
+
+    return Status;
+}
+
+/**
+ * Move the head on to the next segment around the ring
+ * Fails with XST_BUFFER_TOO_SMALL unless more than Reserve segments are
+ * free, so appends can leave one for compaction to copy into.
+ */
+static XStatus PLD_QSPI_LogOpen(PLD_QSPI_Log_t *LogPtr, uint32_t Reserve)
+{
+    XStatus Status;
+    PLD_QSPI_LogSegment_t *SegPtr;
+    uint32_t Sequence[2];
+    uint32_t Next;
+
+    if (LogPtr->SegmentCount - LogPtr->Used <= Reserve) {
+        return XST_BUFFER_TOO_SMALL;
+    }
+
+    Status = PLD_QSPI_LogProgram(LogPtr);
+    if (Status != XST_SUCCESS) {
+        return Status;
+    }
+
+    Next = (LogPtr->Used == 0) ? LogPtr->Head : (LogPtr->Head + 1U) % LogPtr->SegmentCount;
+    SegPtr = &LogPtr->Segments[Next];
+
+    Status = PLD_QSPI_LogPrepare(LogPtr, Next);
+    if (Status != XST_SUCCESS) {
+        return Status;
+    }
+
+    Sequence[0] = LogPtr->NextSequence;
+    Sequence[1] = ~LogPtr->NextSequence;
+    Status = PLD_QSPI_Write(LogPtr->Qspi, PLD_QSPI_LogSegmentAddress(LogPtr, Next) + 8U, (uint8_t *)Sequence,
+                            sizeof(Sequence));
+    if (Status != XST_SUCCESS) {
+        SegPtr->State = PLD_QSPI_LOG_DIRTY;
+        return Status;
+    }
+
+    SegPtr->State = PLD_QSPI_LOG_USED;
+    SegPtr->Sequence = LogPtr->NextSequence++;
+    SegPtr->Live = 0;
+
+    if (LogPtr->Used == 0) {
+        LogPtr->Tail = Next;
+    }
+    LogPtr->Head = Next;
+    LogPtr->Used++;
+    LogPtr->WriteAddress = PLD_QSPI_LogSegmentAddress(LogPtr, Next) + PLD_QSPI_LOG_SEGMENT_HEADER;
+
+    return XST_SUCCESS;
+}
+
+/**
+ * Look at one record of the tail segment, copying it to the head if it is
+ * live, or reclaim the tail once every record has been looked at
+ * Tombstones are dropped: every older copy they hide was in an older
+ * segment, and those have already been reclaimed.
+ */
+static XStatus PLD_QSPI_LogCompactStep(PLD_QSPI_Log_t *LogPtr)
+{
+    XStatus Status;
+    PLD_QSPI_LogRecord_t Record;
+    PLD_QSPI_LogEntry_t Entry;
+    uint32_t End = PLD_QSPI_LogSegmentAddress(LogPtr, LogPtr->Tail) + LogPtr->SegmentSize;
+    uint32_t Size = 0;
+
+    if (LogPtr->Used < 2U) {
+        return XST_NO_DATA;
+    }
+
+    if (LogPtr->CompactAddress == 0) {
+        LogPtr->CompactAddress = PLD_QSPI_LogSegmentAddress(LogPtr, LogPtr->Tail) + PLD_QSPI_LOG_SEGMENT_HEADER;
+    }
+
+    // Nothing live is left to look for once the tail's live count is down to zero
+    if (LogPtr->Segments[LogPtr->Tail].Live != 0 && LogPtr->CompactAddress + PLD_QSPI_LOG_RECORD_HEADER <= End) {
+        Status = PLD_QSPI_Read(LogPtr->Qspi, LogPtr->CompactAddress, (uint8_t *)&Record, sizeof(Record));
+        if (Status != XST_SUCCESS) {
+            return Status;
+        }
+        if (!PLD_QSPI_LogIsErased((const uint8_t *)&Record, sizeof(Record)) &&
+            PLD_QSPI_LogHeaderCrc(&Record) == Record.HeaderCrc &&
+            Record.Length <= End - LogPtr->CompactAddress - PLD_QSPI_LOG_RECORD_HEADER) {
+            Size = PLD_QSPI_LOG_RECORD_HEADER + Record.Length;
+        }
+    }
+
+    if (Size == 0) {
+        // Copies still staged in RAM must be on flash before the originals can be erased
+        Status = PLD_QSPI_LogProgram(LogPtr);
+        if (Status != XST_SUCCESS) {
+            return Status;
+        }
+
+        LogPtr->Segments[LogPtr->Tail].State = PLD_QSPI_LOG_DIRTY;
+        LogPtr->Segments[LogPtr->Tail].Live = 0;
+        LogPtr->Tail = (LogPtr->Tail + 1U) % LogPtr->SegmentCount;
+        LogPtr->Used--;
+        LogPtr->CompactAddress = 0;
+        LogPtr->Stats.SegmentsReclaimed++;
+        return XST_SUCCESS;
+    }
+
+    if (Record.Type == PLD_QSPI_LOG_DATA && Record.Id < LogPtr->MaxRecords &&
+        LogPtr->Index[Record.Id].Address == LogPtr->CompactAddress) {
+        if (LogPtr->WriteAddress + Size > PLD_QSPI_LogSegmentAddress(LogPtr, LogPtr->Head) + LogPtr->SegmentSize) {
+            // Compaction may take the segment appends leave it
+            Status = PLD_QSPI_LogOpen(LogPtr, 0);
+            if (Status != XST_SUCCESS) {
+                return Status;
+            }
+        }
+
+        Entry = LogPtr->Index[Record.Id];
+        Entry.Address = LogPtr->WriteAddress;
+        Status = PLD_QSPI_LogPut(LogPtr, (const uint8_t *)&Record, 0, sizeof(Record));
+        if (Status == XST_SUCCESS) {
+            Status = PLD_QSPI_LogPut(LogPtr, NULL, LogPtr->CompactAddress + PLD_QSPI_LOG_RECORD_HEADER, Record.Length);
+        }
+        if (Status != XST_SUCCESS) {
+            return Status;
+        }
+
+        PLD_QSPI_LogIndex(LogPtr, Record.Id, &Entry);
+        LogPtr->Stats.RecordsCopied++;
+    }
+
+    LogPtr->CompactAddress += Size;
+
+    return XST_SUCCESS;
+}
+
+/**
+ * Get the head able to take Size more bytes, opening a new segment and, if
+ * none can be spared, reclaiming the tail in the foreground
+ */
+static XStatus PLD_QSPI_LogMakeRoom(PLD_QSPI_Log_t *LogPtr, uint32_t Size)
+{
+    XStatus Status;
+    uint32_t Reclaims = 0;
+    uint32_t Tail;
+
+    while (LogPtr->Used == 0 ||
+           LogPtr->WriteAddress + Size > PLD_QSPI_LogSegmentAddress(LogPtr, LogPtr->Head) + LogPtr->SegmentSize) {
+        Status = PLD_QSPI_LogOpen(LogPtr, 1U);
+        if (Status != XST_BUFFER_TOO_SMALL) {
+            if (Status != XST_SUCCESS) {
+                return Status;
+            }
+            continue;
+        }
+
+        // Every reclaim frees the tail's stale bytes, a lap of the ring with none means the store is full
+        if (Reclaims++ == LogPtr->SegmentCount) {
+            return XST_BUFFER_TOO_SMALL;
+        }
+
+        Tail = LogPtr->Tail;
+        do {
+            Status = PLD_QSPI_LogCompactStep(LogPtr);
+        } while (Status == XST_SUCCESS && LogPtr->Tail == Tail);
+        if (Status != XST_SUCCESS) {
+            return (Status == XST_NO_DATA) ? XST_BUFFER_TOO_SMALL : Status;
+        }
+    }
+
+    return XST_SUCCESS;
+}
+
+/**
+ * Append a record of either type and index it
+ */
+static XStatus PLD_QSPI_LogAdd(PLD_QSPI_Log_t *LogPtr, uint32_t Id, uint8_t Type, const uint8_t *Data, uint32_t Length)
+{
+    XStatus Status;
+    PLD_QSPI_LogRecord_t Record;
+    PLD_QSPI_LogEntry_t Entry;
+    uint32_t Size = PLD_QSPI_LOG_RECORD_HEADER + Length;
+    uint32_t Usable = LogPtr->SegmentSize - PLD_QSPI_LOG_SEGMENT_HEADER;
+    uint32_t Live = LogPtr->LiveBytes;
+
+    if (Id >= LogPtr->MaxRecords || Length > 0xFFFFU || Size > Usable) {
+        return XST_INVALID_PARAM;
+    }
+
+    // Two segments' worth of slack keeps compaction able to free space
+    if (LogPtr->Index[Id].Address != PLD_QSPI_LOG_NONE) {
+        Live -= PLD_QSPI_LOG_RECORD_HEADER + LogPtr->Index[Id].Length;
+    }
+    if (Type == PLD_QSPI_LOG_DATA && Live + Size > (LogPtr->SegmentCount - 2U) * Usable) {
+        return XST_BUFFER_TOO_SMALL;
+    }
+
+    Status = PLD_QSPI_LogMakeRoom(LogPtr, Size);
+    if (Status != XST_SUCCESS) {
+        return Status;
+    }
+
+    Record.Id = (uint16_t)Id;
+    Record.Length = (uint16_t)Length;
+    Record.Type = Type;
+    Record.Discarded = 0xFFU;
+    memset(Record.Reserved, 0xFF, sizeof(Record.Reserved));
+    Record.DataCrc = PLD_QSPI_Crc32c(0, Data, Length);
+    Record.HeaderCrc = PLD_QSPI_LogHeaderCrc(&Record);
+
+    Entry.Address = (Type == PLD_QSPI_LOG_DATA) ? LogPtr->WriteAddress : PLD_QSPI_LOG_NONE;
+    Entry.Crc = Record.DataCrc;
+    Entry.Length = Length;
+
+    Status = PLD_QSPI_LogPut(LogPtr, (const uint8_t *)&Record, 0, sizeof(Record));
+    if (Status == XST_SUCCESS && Length != 0) {
+        Status = PLD_QSPI_LogPut(LogPtr, Data, 0, Length);
+    }
+    if (Status != XST_SUCCESS) {
+        return Status;
+    }
+
+    PLD_QSPI_LogIndex(LogPtr, Id, &Entry);
+
+    return XST_SUCCESS;
+}
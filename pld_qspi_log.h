@@ -0,0 +1,170 @@
+/*******************************************************************************
+*   McMaster PRESET (www.mcmasterneudose.ca)
+*
+*   Data Acquisition Module - DAM
+*   Flight Firmware
+*
+*   @file       pld_qspi_log.h
+*   @desc       Log-structured record store on the QSPI flash
+*   @author     Sameer Suleman
+*   @date       October 16, 2026
+*
+*	<pre>
+*
+*   Revision History:
+*
+*	Ver   	Who    	Date   		Changes
+*	----- 	---- 	-------- 	-------------------------------------------------------
+*   1.0.0   sam     2026-10-16  Append-only segments, RAM index, background compaction
+*   1.0.1   sam     2026-10-17  Timed with the driver's PLD_QSPI_NowUs
+*   1.0.2   sam     2026-10-17  Segment erases waited out from their remaining time
+*   1.0.3   sam     2026-10-17  Compaction copies programmed before their segment is reclaimed
+*	</pre>
+*
+*******************************************************************************/
+
+/*******************************************************************************
+*   Prevent circular dependency
+*   DO NOT REMOVE
+*******************************************************************************/
+#ifndef PLD_QSPI_LOG
+#define PLD_QSPI_LOG
+
+/*******************************************************************************
+*   Includes
+*******************************************************************************/
+/* STD Includes */
+#include <stdint.h>
+
+/* Xilinx Includes */
+#include "xstatus.h"
+
+/* NEUDOSE Includes */
+#include "pld_qspi.h"
+
+/*******************************************************************************
+*   Preprocessor Macros
+*******************************************************************************/
+/* Staging buffer: holds the page being appended to (so at least a page,
+ * 512 bytes for two parallel flashes), and the window the mount scan
+ * reads headers through. Headers inside one window cost no extra read. */
+#ifndef PLD_QSPI_LOG_BUFFER_SIZE
+#define PLD_QSPI_LOG_BUFFER_SIZE        1024U
+#endif
+
+/* PLD_QSPI_LogService compacts while no more than this many segments are
+ * free (erased or waiting for an erase) */
+#ifndef PLD_QSPI_LOG_FREE_TARGET
+#define PLD_QSPI_LOG_FREE_TARGET        2U
+#endif
+
+/*******************************************************************************
+*   Constant Definitions
+*******************************************************************************/
+#define PLD_QSPI_LOG_MAGIC              0x474C5150U     /* "PQLG" at the start of every formatted segment */
+#define PLD_QSPI_LOG_NONE               0xFFFFFFFFU     /* Index address of a missing record, sequence of an unopened segment */
+#define PLD_QSPI_LOG_SEGMENT_HEADER     16U
+#define PLD_QSPI_LOG_RECORD_HEADER      16U
+
+/* Record types */
+#define PLD_QSPI_LOG_DATA               0x01U
+#define PLD_QSPI_LOG_DELETE             0x02U           /* Tombstone, hides older copies of the record */
+
+/* Segment states */
+#define PLD_QSPI_LOG_FREE               0U              /* Erased and formatted, ready to open */
+#define PLD_QSPI_LOG_DIRTY              1U              /* Reclaimed or unformatted, needs an erase */
+#define PLD_QSPI_LOG_ERASING            2U              /* Erasing in the background */
+#define PLD_QSPI_LOG_USED               3U              /* Holds records */
+
+/*******************************************************************************
+*   Datatype Definitions
+*******************************************************************************/
+/* On flash, at the start of each segment. Magic and EraseCount are
+ * programmed after the erase, Sequence when the segment is opened. */
+typedef struct {
+    uint32_t Magic;
+    uint32_t EraseCount;
+    uint32_t Sequence;                      /* Order segments were opened in, PLD_QSPI_LOG_NONE while free */
+    uint32_t SequenceCheck;                 /* ~Sequence, so a torn sequence write reads as invalid */
+} PLD_QSPI_LogSegmentHeader_t;
+
+/* On flash, in front of every record's payload */
+typedef struct {
+    uint16_t Id;
+    uint16_t Length;                        /* Payload bytes */
+    uint8_t Type;                           /* PLD_QSPI_LOG_DATA / _DELETE */
+    uint8_t Discarded;                      /* Programmed to 0 when mount finds the payload torn */
+    uint8_t Reserved[2];                    /* Left erased */
+    uint32_t DataCrc;                       /* CRC32C of the payload */
+    uint32_t HeaderCrc;                     /* CRC32C of the fields above, taking Discarded as erased */
+} PLD_QSPI_LogRecord_t;
+
+/* RAM index entry, one per record Id */
+typedef struct {
+    uint32_t Address;                       /* Flash address of the record header, PLD_QSPI_LOG_NONE if absent */
+    uint32_t Crc;                           /* Payload CRC32C, so a read checks it without the header */
+    uint32_t Length;
+} PLD_QSPI_LogEntry_t;
+
+/* RAM state of one segment */
+typedef struct {
+    uint32_t Sequence;
+    uint32_t EraseCount;
+    uint32_t Live;                          /* Bytes of current records, headers included */
+    uint32_t State;                         /* PLD_QSPI_LOG_FREE / _DIRTY / _ERASING / _USED */
+} PLD_QSPI_LogSegment_t;
+
+typedef struct {
+    uint32_t Appends;
+    uint32_t Deletes;
+    uint32_t Reads;
+    uint64_t BytesAppended;                 /* Payload handed to PLD_QSPI_LogAppend */
+    uint64_t BytesProgrammed;               /* Records and copies programmed, over BytesAppended is the write amplification */
+    uint32_t RecordsCopied;                 /* Live records moved out of a segment being reclaimed */
+    uint32_t SegmentsReclaimed;
+    uint32_t Erases;                        /* Segments erased */
+    uint32_t TornRecords;                   /* Records dropped at mount for a bad header or payload */
+    uint32_t MountRecords;                  /* Headers the last mount scanned */
+    uint32_t MountUs;                       /* How long the last mount took */
+} PLD_QSPI_LogStats_t;
+
+typedef struct {
+    PLD_QSPI_t *Qspi;                       /* Driver the store reads and programs through */
+    uint32_t Address;                       /* Region start, erase block aligned */
+    uint32_t SegmentSize;                   /* A multiple of the smallest erase size */
+    uint32_t SegmentCount;
+    PLD_QSPI_LogSegment_t *Segments;        /* Caller's arena, SegmentCount entries */
+    PLD_QSPI_LogEntry_t *Index;             /* Caller's arena, MaxRecords entries */
+    uint32_t MaxRecords;                    /* Record Ids run 0 to MaxRecords - 1 */
+    uint32_t Head;                          /* Segment being appended to */
+    uint32_t Tail;                          /* Oldest segment in use, the next one reclaimed */
+    uint32_t Used;                          /* Segments in use, Tail to Head around the ring */
+    uint32_t WriteAddress;                  /* Where the next record byte goes */
+    uint32_t Pending;                       /* Bytes staged in Buffer, programmed at WriteAddress - Pending */
+    uint32_t NextSequence;
+    uint32_t LiveBytes;                     /* Live summed over the segments */
+    uint32_t CompactAddress;                /* Next tail record compaction looks at, 0 when idle */
+    uint32_t Erasing;                       /* Segment erasing in the background, PLD_QSPI_LOG_NONE if none */
+    uint8_t Buffer[PLD_QSPI_LOG_BUFFER_SIZE];
+    PLD_QSPI_LogStats_t Stats;
+} PLD_QSPI_Log_t;
+
+/*******************************************************************************
+*   Function Prototypes
+*******************************************************************************/
+XStatus PLD_QSPI_LogMount(PLD_QSPI_Log_t *LogPtr, PLD_QSPI_t *InstancePtr, uint32_t Address, uint32_t Length,
+                          uint32_t SegmentSize, PLD_QSPI_LogSegment_t *Segments,
+                          PLD_QSPI_LogEntry_t *Index, uint32_t MaxRecords);
+XStatus PLD_QSPI_LogFormat(PLD_QSPI_Log_t *LogPtr);
+XStatus PLD_QSPI_LogAppend(PLD_QSPI_Log_t *LogPtr, uint32_t Id, const uint8_t *Data, uint32_t Length);
+XStatus PLD_QSPI_LogDelete(PLD_QSPI_Log_t *LogPtr, uint32_t Id);
+XStatus PLD_QSPI_LogRead(PLD_QSPI_Log_t *LogPtr, uint32_t Id, uint8_t *Buffer, uint32_t Size, uint32_t *LengthPtr);
+XStatus PLD_QSPI_LogSync(PLD_QSPI_Log_t *LogPtr);
+XStatus PLD_QSPI_LogService(PLD_QSPI_Log_t *LogPtr);
+void PLD_QSPI_LogResetStats(PLD_QSPI_Log_t *LogPtr);
+
+/*******************************************************************************
+*   Prevent circular dependency
+*   DO NOT REMOVE
+*******************************************************************************/
+#endif /* PLD_QSPI_LOG */
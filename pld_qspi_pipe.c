@@ -0,0 +1,362 @@
+/*******************************************************************************
+*   McMaster PRESET (www.mcmasterneudose.ca)
+*
+*   Data Acquisition Module - DAM
+*   Flight Firmware
+*
+*   @file       pld_qspi_pipe.c
+*   @desc       N-buffer acquisition to flash logging pipeline
+*   @author     Sameer Suleman
+*   @date       October 16, 2026
+*
+*	<pre>
+*
+*   Producers fill one buffer while the flash programs the ones before it.
+*   With two buffers this is a ping-pong: the acquisition side never waits
+*   on a page program, only on the flash falling a whole buffer behind.
+*   More buffers ride out longer hiccups (a slow page, a read between
+*   pages) at the same sustained rate, which is the flash's program
+*   bandwidth.
+*
+*   PLD_QSPI_PipeService never blocks. It checks the page in flight with
+*   one status read and starts the next one, so calling it from the
+*   acquisition loop (or a timer tick) at least once per page time keeps
+*   the flash programming back to back. Producers and service must run in
+*   the same context or be serialized by the caller.
+*
+*   When every buffer is full a producer either waits, servicing the
+*   flash until one frees up (backpressure, counted in StallUs), or has
+*   its data dropped and counted as an overrun. The region is only
+*   programmed, never erased, so erase it before PLD_QSPI_PipeInit.
+*
+*   Revision History:
+*
+*	Ver   	Who    	Date   		Changes
+*	----- 	---- 	-------- 	-------------------------------------------------------
+*   1.0.0   sam     2026-10-16  Ping-pong buffers programmed in the background, overrun accounting
+*   1.0.1   sam     2026-10-17  Timed with the driver's PLD_QSPI_NowUs
+*	</pre>
+*
+*******************************************************************************/
+
+/*******************************************************************************
+*   Includes
+*******************************************************************************/
+#include "pld_qspi_pipe.h"
+
+/* STD Includes */
+#include <string.h>
+
+/*******************************************************************************
+*   Function Prototypes
+*******************************************************************************/
+static uint32_t PLD_QSPI_PipeRoom(PLD_QSPI_Pipe_t *PipePtr);
+static void PLD_QSPI_PipeRotate(PLD_QSPI_Pipe_t *PipePtr);
+static XStatus PLD_QSPI_PipeStall(PLD_QSPI_Pipe_t *PipePtr);
+
+/*******************************************************************************
+*   Function Definitions
+*******************************************************************************/
+
+/**
+ * Set up an empty pipeline logging to the erased region Address to
+ * Address + Length, through Buffers buffers of BufferSize bytes in Arena
+ */
+XStatus PLD_QSPI_PipeInit(PLD_QSPI_Pipe_t *PipePtr, PLD_QSPI_t *InstancePtr, uint8_t *Arena,
+                          uint32_t BufferSize, uint32_t Buffers, uint32_t Address, uint32_t Length)
+{
+    if (PipePtr == NULL || InstancePtr == NULL || Arena == NULL || BufferSize == 0 || Buffers < 2U ||
+        Length == 0 || Address > UINT32_MAX - Length) {
+        return XST_INVALID_PARAM;
+    }
+
+    PipePtr->Qspi = InstancePtr;
+    PipePtr->Arena = Arena;
+    PipePtr->BufferSize = BufferSize;
+    PipePtr->Buffers = Buffers;
+    PipePtr->End = Address + Length;
+    PipePtr->Next = Address;
+    PipePtr->InputNext = Address;
+    PipePtr->Head = 0;
+    PipePtr->Tail = 0;
+    PipePtr->Full = 0;
+    PipePtr->FillLength = 0;
+    PipePtr->DrainOffset = 0;
+    PipePtr->InFlight = 0;
+    PipePtr->Flushing = 0;
+    PLD_QSPI_PipeResetStats(PipePtr);
+
+    return XST_SUCCESS;
+}
+
+/**
+ * Copy Length bytes into the pipeline
+ * With Wait set the flash is serviced until there is room, otherwise a
+ * write that does not fit is dropped whole and XST_DATA_LOST returned.
+ * Data past the end of the region is dropped with XST_BUFFER_TOO_SMALL.
+ */
+XStatus PLD_QSPI_PipeWrite(PLD_QSPI_Pipe_t *PipePtr, const uint8_t *Data, uint32_t Length, uint32_t Wait)
+{
+    XStatus Status;
+    uint32_t Copy;
+
+    if (Data == NULL || PipePtr->Flushing) {
+        return XST_INVALID_PARAM;
+    }
+
+    if (Length > PipePtr->End - PipePtr->InputNext) {
+        PipePtr->Stats.BytesDropped += Length;
+        return XST_BUFFER_TOO_SMALL;
+    }
+
+    // Samples are never torn, a write that can't wait goes in whole or not at all
+    if (!Wait && Length > PLD_QSPI_PipeRoom(PipePtr)) {
+        PipePtr->Stats.Overruns++;
+        PipePtr->Stats.BytesDropped += Length;
+        return XST_DATA_LOST;
+    }
+
+    while (Length > 0) {
+        if (PipePtr->FillLength == PipePtr->BufferSize) {
+            Status = PLD_QSPI_PipeStall(PipePtr);
+            if (Status != XST_SUCCESS) {
+                return Status;
+            }
+        }
+
+        Copy = PipePtr->BufferSize - PipePtr->FillLength;
+        if (Copy > Length) {
+            Copy = Length;
+        }
+        memcpy(&PipePtr->Arena[PipePtr->Tail * PipePtr->BufferSize + PipePtr->FillLength], Data, Copy);
+
+        PipePtr->FillLength += Copy;
+        PipePtr->InputNext += Copy;
+        PipePtr->Stats.BytesIn += Copy;
+        Data += Copy;
+        Length -= Copy;
+
+        PLD_QSPI_PipeRotate(PipePtr);
+    }
+
+    // Start on a buffer that just filled without waiting for the next service
+    return PLD_QSPI_PipeService(PipePtr);
+}
+
+/**
+ * Get the free part of the buffer being filled, for producers that write
+ * samples in place (a DMA target, say), then PLD_QSPI_PipeCommit them
+ * With no room, Wait services the flash until some frees up, otherwise
+ * the call counts an overrun and returns XST_DATA_LOST.
+ */
+XStatus PLD_QSPI_PipeAcquire(PLD_QSPI_Pipe_t *PipePtr, uint8_t **BufferPtr, uint32_t *SpacePtr, uint32_t Wait)
+{
+    XStatus Status;
+    uint32_t Space;
+
+    if (BufferPtr == NULL || SpacePtr == NULL || PipePtr->Flushing) {
+        return XST_INVALID_PARAM;
+    }
+
+    *SpacePtr = 0;
+
+    if (PipePtr->InputNext == PipePtr->End) {
+        return XST_BUFFER_TOO_SMALL;
+    }
+
+    if (PipePtr->FillLength == PipePtr->BufferSize) {
+        if (!Wait) {
+            PipePtr->Stats.Overruns++;
+            return XST_DATA_LOST;
+        }
+        Status = PLD_QSPI_PipeStall(PipePtr);
+        if (Status != XST_SUCCESS) {
+            return Status;
+        }
+    }
+
+    Space = PipePtr->BufferSize - PipePtr->FillLength;
+    if (Space > PipePtr->End - PipePtr->InputNext) {
+        Space = PipePtr->End - PipePtr->InputNext;
+    }
+
+    *BufferPtr = &PipePtr->Arena[PipePtr->Tail * PipePtr->BufferSize + PipePtr->FillLength];
+    *SpacePtr = Space;
+
+    return XST_SUCCESS;
+}
+
+/**
+ * Hand Length bytes written at the PLD_QSPI_PipeAcquire pointer to the flash
+ */
+XStatus PLD_QSPI_PipeCommit(PLD_QSPI_Pipe_t *PipePtr, uint32_t Length)
+{
+    if (PipePtr->Flushing || Length > PipePtr->BufferSize - PipePtr->FillLength ||
+        Length > PipePtr->End - PipePtr->InputNext) {
+        return XST_INVALID_PARAM;
+    }
+
+    PipePtr->FillLength += Length;
+    PipePtr->InputNext += Length;
+    PipePtr->Stats.BytesIn += Length;
+    PLD_QSPI_PipeRotate(PipePtr);
+
+    return PLD_QSPI_PipeService(PipePtr);
+}
+
+/**
+ * Move the flash along without blocking
+ * Checks the page in flight and, once it is done, starts the next page of
+ * the oldest full buffer. Returns the failed program's status, which is
+ * retried on the next call, otherwise XST_SUCCESS.
+ */
+XStatus PLD_QSPI_PipeService(PLD_QSPI_Pipe_t *PipePtr)
+{
+    XStatus Status;
+    uint32_t PageSize = PipePtr->Qspi->Flash.PageSize;
+    uint32_t Length;
+    uint32_t Chunk;
+
+    if (PipePtr->InFlight != 0) {
+        Status = PLD_QSPI_ProgramPoll(PipePtr->Qspi);
+        if (Status == XST_DEVICE_BUSY) {
+            return XST_SUCCESS;
+        }
+        if (Status != XST_SUCCESS) {
+            PipePtr->InFlight = 0;
+            PipePtr->Stats.Errors++;
+            return Status;
+        }
+
+        PipePtr->DrainOffset += PipePtr->InFlight;
+        PipePtr->Next += PipePtr->InFlight;
+        PipePtr->InFlight = 0;
+        PipePtr->Stats.PagesProgrammed++;
+    }
+
+    // The head is a full buffer, or the partial fill buffer during a flush
+    Length = (PipePtr->Full > 0) ? PipePtr->BufferSize : (PipePtr->Flushing ? PipePtr->FillLength : 0);
+
+    if (Length != 0 && PipePtr->DrainOffset == Length) {
+        if (PipePtr->Full > 0) {
+            PipePtr->Head = (PipePtr->Head + 1U) % PipePtr->Buffers;
+            PipePtr->Full--;
+        } else {
+            PipePtr->FillLength = 0;
+            PipePtr->Flushing = 0;
+        }
+        PipePtr->DrainOffset = 0;
+        PipePtr->Stats.BuffersWritten++;
+
+        // A producer may be sitting on a full fill buffer waiting for this one
+        PLD_QSPI_PipeRotate(PipePtr);
+        Length = (PipePtr->Full > 0) ? PipePtr->BufferSize : 0;
+    }
+
+    if (Length == 0) {
+        return XST_SUCCESS;
+    }
+
+    // Pages may start mid-page after a flush, so stop each at the page boundary
+    Chunk = PageSize - (PipePtr->Next % PageSize);
+    if (Chunk > Length - PipePtr->DrainOffset) {
+        Chunk = Length - PipePtr->DrainOffset;
+    }
+
+    Status = PLD_QSPI_ProgramStart(PipePtr->Qspi, PipePtr->Next,
+                                   &PipePtr->Arena[PipePtr->Head * PipePtr->BufferSize + PipePtr->DrainOffset], Chunk);
+    if (Status != XST_SUCCESS) {
+        PipePtr->Stats.Errors++;
+        return Status;
+    }
+    PipePtr->InFlight = Chunk;
+
+    return XST_SUCCESS;
+}
+
+/**
+ * Program everything accepted so far, the partial fill buffer included,
+ * and wait for the flash to finish
+ * Logging can carry on afterwards, from the byte after the flushed data.
+ */
+XStatus PLD_QSPI_PipeFlush(PLD_QSPI_Pipe_t *PipePtr)
+{
+    XStatus Status;
+
+    // The full buffers go first, the fill buffer becomes the head once they are done
+    while (PipePtr->Full > 0 || PipePtr->InFlight != 0) {
+        Status = PLD_QSPI_PipeService(PipePtr);
+        if (Status != XST_SUCCESS) {
+            return Status;
+        }
+    }
+
+    if (PipePtr->FillLength == 0) {
+        return XST_SUCCESS;
+    }
+
+    PipePtr->Flushing = 1;
+    while (PipePtr->Flushing) {
+        Status = PLD_QSPI_PipeService(PipePtr);
+        if (Status != XST_SUCCESS) {
+            PipePtr->Flushing = 0;
+            return Status;
+        }
+    }
+
+    return XST_SUCCESS;
+}
+
+/**
+ * Clear the pipeline accounting, MaxFull restarts from the current level
+ */
+void PLD_QSPI_PipeResetStats(PLD_QSPI_Pipe_t *PipePtr)
+{
+    memset(&PipePtr->Stats, 0, sizeof(PipePtr->Stats));
+    PipePtr->Stats.MaxFull = PipePtr->Full;
+}
+
+/**
+ * Bytes a producer can add before the flash has to catch up
+ */
+static uint32_t PLD_QSPI_PipeRoom(PLD_QSPI_Pipe_t *PipePtr)
+{
+    return (PipePtr->BufferSize - PipePtr->FillLength) +
+           (PipePtr->Buffers - 1U - PipePtr->Full) * PipePtr->BufferSize;
+}
+
+/**
+ * Queue the fill buffer for the flash once it is full and a free buffer
+ * can take its place
+ */
+static void PLD_QSPI_PipeRotate(PLD_QSPI_Pipe_t *PipePtr)
+{
+    if (PipePtr->FillLength != PipePtr->BufferSize || PipePtr->Full == PipePtr->Buffers - 1U) {
+        return;
+    }
+
+    PipePtr->Full++;
+    PipePtr->Tail = (PipePtr->Tail + 1U) % PipePtr->Buffers;
+    PipePtr->FillLength = 0;
+
+    if (PipePtr->Full > PipePtr->Stats.MaxFull) {
+        PipePtr->Stats.MaxFull = PipePtr->Full;
+    }
+}
+
+/**
+ * Service the flash until the full fill buffer can be queued (backpressure)
+ */
+static XStatus PLD_QSPI_PipeStall(PLD_QSPI_Pipe_t *PipePtr)
+{
+    XStatus Status = XST_SUCCESS;
+    uint32_t Start = PLD_QSPI_NowUs();
+
+    while (PipePtr->FillLength == PipePtr->BufferSize && Status == XST_SUCCESS) {
+        Status = PLD_QSPI_PipeService(PipePtr);
+    }
+
+    PipePtr->Stats.StallUs += PLD_QSPI_NowUs() - Start;
+
+    return Status;
+}
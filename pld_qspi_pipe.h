@@ -0,0 +1,92 @@
+/*******************************************************************************
+*   McMaster PRESET (www.mcmasterneudose.ca)
+*
+*   Data Acquisition Module - DAM
+*   Flight Firmware
+*
+*   @file       pld_qspi_pipe.h
+*   @desc       N-buffer acquisition to flash logging pipeline
+*   @author     Sameer Suleman
+*   @date       October 16, 2026
+*
+*	<pre>
+*
+*   Revision History:
+*
+*	Ver   	Who    	Date   		Changes
+*	----- 	---- 	-------- 	-------------------------------------------------------
+*   1.0.0   sam     2026-10-16  Ping-pong buffers programmed in the background, overrun accounting
+*   1.0.1   sam     2026-10-17  Timed with the driver's PLD_QSPI_NowUs
+*	</pre>
+*
+*******************************************************************************/
+
+/*******************************************************************************
+*   Prevent circular dependency
+*   DO NOT REMOVE
+*******************************************************************************/
+#ifndef PLD_QSPI_PIPE
+#define PLD_QSPI_PIPE
+
+/*******************************************************************************
+*   Includes
+*******************************************************************************/
+/* STD Includes */
+#include <stdint.h>
+
+/* Xilinx Includes */
+#include "xstatus.h"
+
+/* NEUDOSE Includes */
+#include "pld_qspi.h"
+
+/*******************************************************************************
+*   Datatype Definitions
+*******************************************************************************/
+/* Pipeline accounting */
+typedef struct {
+    uint64_t BytesIn;                       /* Accepted from producers */
+    uint64_t BytesDropped;                  /* Refused for lack of buffer space or region */
+    uint32_t Overruns;                      /* Writes dropped because flash fell behind */
+    uint32_t BuffersWritten;                /* Buffers fully programmed, a flushed partial one included */
+    uint32_t PagesProgrammed;
+    uint32_t Errors;                        /* Failed page programs, retried on the next service */
+    uint32_t MaxFull;                       /* Most buffers waiting for flash at once */
+    uint64_t StallUs;                       /* Producer time spent waiting for a free buffer */
+} PLD_QSPI_PipeStats_t;
+
+typedef struct {
+    PLD_QSPI_t *Qspi;                       /* Driver the pages are programmed through */
+    uint8_t *Arena;                         /* Buffers * BufferSize bytes */
+    uint32_t BufferSize;
+    uint32_t Buffers;
+    uint32_t End;                           /* First flash address past the region */
+    uint32_t Next;                          /* Flash address the next page programs at */
+    uint32_t InputNext;                     /* Flash address the next accepted byte will land at */
+    uint32_t Head;                          /* Buffer being programmed */
+    uint32_t Tail;                          /* Buffer being filled */
+    uint32_t Full;                          /* Filled buffers waiting for or being programmed */
+    uint32_t FillLength;                    /* Bytes in the buffer being filled */
+    uint32_t DrainOffset;                   /* Bytes of the head buffer already programmed */
+    uint32_t InFlight;                      /* Bytes of the page programming now, 0 when idle */
+    uint32_t Flushing;                      /* Non-zero while the partial fill buffer is going out */
+    PLD_QSPI_PipeStats_t Stats;
+} PLD_QSPI_Pipe_t;
+
+/*******************************************************************************
+*   Function Prototypes
+*******************************************************************************/
+XStatus PLD_QSPI_PipeInit(PLD_QSPI_Pipe_t *PipePtr, PLD_QSPI_t *InstancePtr, uint8_t *Arena,
+                          uint32_t BufferSize, uint32_t Buffers, uint32_t Address, uint32_t Length);
+XStatus PLD_QSPI_PipeWrite(PLD_QSPI_Pipe_t *PipePtr, const uint8_t *Data, uint32_t Length, uint32_t Wait);
+XStatus PLD_QSPI_PipeAcquire(PLD_QSPI_Pipe_t *PipePtr, uint8_t **BufferPtr, uint32_t *SpacePtr, uint32_t Wait);
+XStatus PLD_QSPI_PipeCommit(PLD_QSPI_Pipe_t *PipePtr, uint32_t Length);
+XStatus PLD_QSPI_PipeService(PLD_QSPI_Pipe_t *PipePtr);
+XStatus PLD_QSPI_PipeFlush(PLD_QSPI_Pipe_t *PipePtr);
+void PLD_QSPI_PipeResetStats(PLD_QSPI_Pipe_t *PipePtr);
+
+/*******************************************************************************
+*   Prevent circular dependency
+*   DO NOT REMOVE
+*******************************************************************************/
+#endif /* PLD_QSPI_PIPE */
@@ -0,0 +1,455 @@
+/*******************************************************************************
+*   McMaster PRESET (www.mcmasterneudose.ca)
+*
+*   Data Acquisition Module - DAM
+*   Flight Firmware
+*
+*   @file       pld_qspi_queue.c
+*   @desc       Prioritized request queue in front of the QSPI flash driver
+*   @author     Sameer Suleman
+*   @date       October 16, 2026
+*
+*	<pre>
+*
+*   Tasks sharing the flash submit requests instead of calling the driver
+*   directly, and the task owning the flash calls PLD_QSPI_QueueService,
+*   which issues one command per call. Submission and service must run in
+*   the same context or be serialized by the caller (the flash active
+*   object, or a mutex around both).
+*
+*   Each command goes to the most urgent request that is ready: lowest
+*   priority level, then least time left to its deadline, then oldest. A
+*   request is ready when no older request still pending overlaps it,
+*   unless both are reads, so reordering never lets a read overtake a
+*   program or erase of the same bytes (or the other way around).
+*
+*   Reads touching or overlapping the chosen read are merged into a single
+*   command as long as the span fits in PLD_QSPI_QUEUE_SLICE_SIZE. Longer
+*   reads are served a slice per command, programs a page per command and
+*   erases a largest erase block per command, so an urgent request waits
+*   for at most one slice of bulk work.
+*
+*   Revision History:
+*
+*	Ver   	Who    	Date   		Changes
+*	----- 	---- 	-------- 	-------------------------------------------------------
+*   1.0.0   sam     2026-10-16  Priority / deadline scheduling, read coalescing and sliced programs
+*   1.0.1   sam     2026-10-17  Timed with the driver's PLD_QSPI_NowUs
+*	</pre>
+*
+*******************************************************************************/
+
+/*******************************************************************************
+*   Includes
+*******************************************************************************/
+#include "pld_qspi_queue.h"
+
+/* STD Includes */
+#include <string.h>
+
+/*******************************************************************************
+*   Datatype Definitions
+*******************************************************************************/
+/* Requests served by one merged read */
+typedef struct {
+    PLD_QSPI_QueueReq_t *Members[PLD_QSPI_QUEUE_MERGE_MAX];
+    uint32_t Count;
+} PLD_QSPI_QueueMerge_t;
+
+/*******************************************************************************
+*   Function Prototypes
+*******************************************************************************/
+static uint32_t PLD_QSPI_QueueOverlaps(const PLD_QSPI_QueueReq_t *A, const PLD_QSPI_QueueReq_t *B);
+static uint32_t PLD_QSPI_QueueReady(PLD_QSPI_Queue_t *QueuePtr, const PLD_QSPI_QueueReq_t *ReqPtr);
+static int32_t PLD_QSPI_QueueSlack(const PLD_QSPI_QueueReq_t *ReqPtr, uint32_t Now);
+static PLD_QSPI_QueueReq_t *PLD_QSPI_QueuePick(PLD_QSPI_Queue_t *QueuePtr, uint32_t Now);
+static void PLD_QSPI_QueueStart(PLD_QSPI_Queue_t *QueuePtr, PLD_QSPI_QueueReq_t *ReqPtr, uint32_t Now);
+static void PLD_QSPI_QueueComplete(PLD_QSPI_Queue_t *QueuePtr, PLD_QSPI_QueueReq_t *ReqPtr, XStatus Status);
+static XStatus PLD_QSPI_QueueRead(PLD_QSPI_Queue_t *QueuePtr, PLD_QSPI_QueueReq_t *ReqPtr, uint32_t Now);
+static XStatus PLD_QSPI_QueueSink(void *Ctx, uint32_t Address, const uint8_t *Data, uint32_t Length);
+
+/*******************************************************************************
+*   Function Definitions
+*******************************************************************************/
+
+/**
+ * Set up an empty queue over an opened driver
+ */
+XStatus PLD_QSPI_QueueInit(PLD_QSPI_Queue_t *QueuePtr, PLD_QSPI_t *InstancePtr)
+{
+    if (QueuePtr == NULL || InstancePtr == NULL) {
+        return XST_INVALID_PARAM;
+    }
+
+    QueuePtr->Qspi = InstancePtr;
+    QueuePtr->Head = NULL;
+    QueuePtr->Tail = NULL;
+    QueuePtr->Last = NULL;
+    QueuePtr->Depth = 0;
+    PLD_QSPI_QueueResetStats(QueuePtr);
+
+    return XST_SUCCESS;
+}
+
+/**
+ * Queue a request
+ * The request (and its data) must stay valid until its Status leaves
+ * XST_DEVICE_BUSY or its callback runs. Nothing touches the flash here.
+ */
+XStatus PLD_QSPI_QueueSubmit(PLD_QSPI_Queue_t *QueuePtr, PLD_QSPI_QueueReq_t *ReqPtr)
+{
+    uint32_t Size = QueuePtr->Qspi->Flash.Size;
+
+    if (ReqPtr == NULL || ReqPtr->Op > PLD_QSPI_QUEUE_ERASE || ReqPtr->Priority >= PLD_QSPI_QUEUE_PRIORITIES ||
+        ReqPtr->Length == 0 || ReqPtr->Address >= Size || ReqPtr->Length > Size - ReqPtr->Address ||
+        (ReqPtr->Op != PLD_QSPI_QUEUE_ERASE && ReqPtr->Data == NULL)) {
+        return XST_INVALID_PARAM;
+    }
+
+    ReqPtr->Status = XST_DEVICE_BUSY;
+    ReqPtr->Next = NULL;
+    ReqPtr->Offset = 0;
+    ReqPtr->Started = 0;
+    ReqPtr->SubmitUs = PLD_QSPI_NowUs();
+
+    if (QueuePtr->Tail != NULL) {
+        QueuePtr->Tail->Next = ReqPtr;
+    } else {
+        QueuePtr->Head = ReqPtr;
+    }
+    QueuePtr->Tail = ReqPtr;
+
+    QueuePtr->Depth++;
+    QueuePtr->Stats.Submitted++;
+    if (QueuePtr->Depth > QueuePtr->Stats.MaxDepth) {
+        QueuePtr->Stats.MaxDepth = QueuePtr->Depth;
+    }
+
+    return XST_SUCCESS;
+}
+
+/**
+ * Issue one command for the most urgent ready request
+ * Returns the command's status (the requests it served carry it too), or
+ * XST_NO_DATA when nothing is queued.
+ */
+XStatus PLD_QSPI_QueueService(PLD_QSPI_Queue_t *QueuePtr)
+{
+    XStatus Status;
+    PLD_QSPI_t *InstancePtr = QueuePtr->Qspi;
+    PLD_QSPI_QueueReq_t *ReqPtr;
+    uint32_t Now = PLD_QSPI_NowUs();
+    uint32_t Address;
+    uint32_t Remaining;
+    uint32_t Unit;
+    uint32_t Slice;
+
+    if (QueuePtr->Head == NULL) {
+        return XST_NO_DATA;
+    }
+
+    ReqPtr = PLD_QSPI_QueuePick(QueuePtr, Now);
+
+    // The request the last command left unfinished was passed over
+    if (QueuePtr->Last != NULL && QueuePtr->Last != ReqPtr) {
+        QueuePtr->Stats.Preemptions++;
+    }
+    QueuePtr->Last = ReqPtr;
+
+    QueuePtr->Stats.Commands++;
+    QueuePtr->Stats.DepthSum += QueuePtr->Depth;
+    PLD_QSPI_QueueStart(QueuePtr, ReqPtr, Now);
+
+    if (ReqPtr->Op == PLD_QSPI_QUEUE_READ) {
+        return PLD_QSPI_QueueRead(QueuePtr, ReqPtr, Now);
+    }
+
+    // Programs stop at the next page, erases at the next largest block
+    Address = ReqPtr->Address + ReqPtr->Offset;
+    Remaining = ReqPtr->Length - ReqPtr->Offset;
+    if (ReqPtr->Op == PLD_QSPI_QUEUE_WRITE) {
+        Unit = InstancePtr->Flash.PageSize;
+    } else {
+        Unit = (InstancePtr->Flash.EraseTypes > 0) ? InstancePtr->Flash.Erase[InstancePtr->Flash.EraseTypes - 1].Size : 0;
+    }
+    Slice = (Unit != 0) ? Unit - (Address % Unit) : Remaining;
+    if (Slice > Remaining) {
+        Slice = Remaining;
+    }
+
+    if (ReqPtr->Op == PLD_QSPI_QUEUE_WRITE) {
+        Status = PLD_QSPI_Write(InstancePtr, Address, &ReqPtr->Data[ReqPtr->Offset], Slice);
+    } else {
+        Status = PLD_QSPI_EraseRange(InstancePtr, Address, Slice);
+    }
+
+    if (Status == XST_SUCCESS) {
+        ReqPtr->Offset += Slice;
+    }
+    if (Status != XST_SUCCESS || ReqPtr->Offset == ReqPtr->Length) {
+        PLD_QSPI_QueueComplete(QueuePtr, ReqPtr, Status);
+    }
+
+    return Status;
+}
+
+/**
+ * Service the queue until it is empty
+ * Returns the first failed command's status, or XST_SUCCESS.
+ */
+XStatus PLD_QSPI_QueueDrain(PLD_QSPI_Queue_t *QueuePtr)
+{
+    XStatus Status;
+    XStatus Result = XST_SUCCESS;
+
+    while ((Status = PLD_QSPI_QueueService(QueuePtr)) != XST_NO_DATA) {
+        if (Status != XST_SUCCESS && Result == XST_SUCCESS) {
+            Result = Status;
+        }
+    }
+
+    return Result;
+}
+
+/**
+ * Clear the queue accounting, MaxDepth restarts from the current depth
+ */
+void PLD_QSPI_QueueResetStats(PLD_QSPI_Queue_t *QueuePtr)
+{
+    memset(&QueuePtr->Stats, 0, sizeof(QueuePtr->Stats));
+    QueuePtr->Stats.MaxDepth = QueuePtr->Depth;
+}
+
+/**
+ * Check whether the parts of two requests still to be done overlap
+ */
+static uint32_t PLD_QSPI_QueueOverlaps(const PLD_QSPI_QueueReq_t *A, const PLD_QSPI_QueueReq_t *B)
+{
+    return (A->Address + A->Offset < B->Address + B->Length) && (B->Address + B->Offset < A->Address + A->Length);
+}
+
+/**
+ * Check that no older pending request conflicts with ReqPtr
+ */
+static uint32_t PLD_QSPI_QueueReady(PLD_QSPI_Queue_t *QueuePtr, const PLD_QSPI_QueueReq_t *ReqPtr)
+{
+    const PLD_QSPI_QueueReq_t *Older;
+
+    for (Older = QueuePtr->Head; Older != ReqPtr; Older = Older->Next) {
+        if ((Older->Op != PLD_QSPI_QUEUE_READ || ReqPtr->Op != PLD_QSPI_QUEUE_READ) &&
+            PLD_QSPI_QueueOverlaps(Older, ReqPtr)) {
+            return 0;
+        }
+    }
+
+    return 1;
+}
+
+/**
+ * Microseconds left to a request's deadline, negative once it has passed
+ */
+static int32_t PLD_QSPI_QueueSlack(const PLD_QSPI_QueueReq_t *ReqPtr, uint32_t Now)
+{
+    if (ReqPtr->DeadlineUs == 0) {
+        return INT32_MAX;
+    }
+
+    return (int32_t)(ReqPtr->SubmitUs + ReqPtr->DeadlineUs - Now);
+}
+
+/**
+ * Most urgent ready request, the oldest one wins ties
+ * The oldest pending request is always ready, so this never fails on a
+ * non-empty queue.
+ */
+static PLD_QSPI_QueueReq_t *PLD_QSPI_QueuePick(PLD_QSPI_Queue_t *QueuePtr, uint32_t Now)
+{
+    PLD_QSPI_QueueReq_t *Best = NULL;
+    PLD_QSPI_QueueReq_t *ReqPtr;
+
+    for (ReqPtr = QueuePtr->Head; ReqPtr != NULL; ReqPtr = ReqPtr->Next) {
+        if (Best != NULL && ReqPtr->Priority > Best->Priority) {
+            continue;
+        }
+
+        if (!PLD_QSPI_QueueReady(QueuePtr, ReqPtr)) {
+            continue;
+        }
+
+        if (Best == NULL || ReqPtr->Priority < Best->Priority ||
+            PLD_QSPI_QueueSlack(ReqPtr, Now) < PLD_QSPI_QueueSlack(Best, Now)) {
+            Best = ReqPtr;
+        }
+    }
+
+    return Best;
+}
+
+/**
+ * Record the queueing delay of a request's first command
+ */
+static void PLD_QSPI_QueueStart(PLD_QSPI_Queue_t *QueuePtr, PLD_QSPI_QueueReq_t *ReqPtr, uint32_t Now)
+{
+    uint32_t WaitUs;
+
+    if (ReqPtr->Started) {
+        return;
+    }
+
+    ReqPtr->Started = 1;
+    WaitUs = Now - ReqPtr->SubmitUs;
+    QueuePtr->Stats.WaitTotalUs += WaitUs;
+    if (WaitUs > QueuePtr->Stats.WaitMaxUs) {
+        QueuePtr->Stats.WaitMaxUs = WaitUs;
+    }
+}
+
+/**
+ * Take a finished request off the queue, account it and call it back
+ */
+static void PLD_QSPI_QueueComplete(PLD_QSPI_Queue_t *QueuePtr, PLD_QSPI_QueueReq_t *ReqPtr, XStatus Status)
+{
+    PLD_QSPI_QueueReq_t *Prev = NULL;
+    PLD_QSPI_QueueReq_t *Walk;
+    uint32_t LatencyUs = PLD_QSPI_NowUs() - ReqPtr->SubmitUs;
+    uint32_t Scaled = LatencyUs;
+    uint32_t Bucket = 0;
+
+    for (Walk = QueuePtr->Head; Walk != ReqPtr; Walk = Walk->Next) {
+        Prev = Walk;
+    }
+    if (Prev != NULL) {
+        Prev->Next = ReqPtr->Next;
+    } else {
+        QueuePtr->Head = ReqPtr->Next;
+    }
+    if (QueuePtr->Tail == ReqPtr) {
+        QueuePtr->Tail = Prev;
+    }
+    if (QueuePtr->Last == ReqPtr) {
+        QueuePtr->Last = NULL;
+    }
+    ReqPtr->Next = NULL;
+    QueuePtr->Depth--;
+
+    QueuePtr->Stats.Completed++;
+    if (Status != XST_SUCCESS) {
+        QueuePtr->Stats.Errors++;
+    }
+    if (ReqPtr->DeadlineUs != 0 && LatencyUs > ReqPtr->DeadlineUs) {
+        QueuePtr->Stats.DeadlinesMissed++;
+    }
+
+    while (Scaled != 0 && Bucket < PLD_QSPI_QUEUE_BUCKETS - 1U) {
+        Scaled >>= 1;
+        Bucket++;
+    }
+    QueuePtr->Stats.Latency[ReqPtr->Priority][Bucket]++;
+    if (LatencyUs > QueuePtr->Stats.LatencyMaxUs[ReqPtr->Priority]) {
+        QueuePtr->Stats.LatencyMaxUs[ReqPtr->Priority] = LatencyUs;
+    }
+
+    ReqPtr->Status = Status;
+    if (ReqPtr->Callback != NULL) {
+        ReqPtr->Callback(ReqPtr->CallbackRef, Status, (Status == XST_SUCCESS) ? ReqPtr->Length : ReqPtr->Offset);
+    }
+}
+
+/**
+ * Serve a read, merged with every ready read it touches that fits the slice
+ */
+static XStatus PLD_QSPI_QueueRead(PLD_QSPI_Queue_t *QueuePtr, PLD_QSPI_QueueReq_t *ReqPtr, uint32_t Now)
+{
+    XStatus Status;
+    PLD_QSPI_QueueMerge_t Merge;
+    PLD_QSPI_QueueReq_t *Other;
+    uint32_t Start = ReqPtr->Address + ReqPtr->Offset;
+    uint32_t End = ReqPtr->Address + ReqPtr->Length;
+    uint32_t OtherStart;
+    uint32_t OtherEnd;
+    uint32_t Added;
+    uint32_t Index;
+
+    Merge.Members[0] = ReqPtr;
+    Merge.Count = 1;
+
+    if (End - Start > PLD_QSPI_QUEUE_SLICE_SIZE) {
+        End = Start + PLD_QSPI_QUEUE_SLICE_SIZE;
+    } else {
+        // Merging one read can bring another within reach, so repeat until nothing joins
+        do {
+            Added = 0;
+            for (Other = QueuePtr->Head; Other != NULL && Merge.Count < PLD_QSPI_QUEUE_MERGE_MAX; Other = Other->Next) {
+                if (Other->Op != PLD_QSPI_QUEUE_READ) {
+                    continue;
+                }
+
+                for (Index = 0; Index < Merge.Count && Merge.Members[Index] != Other; Index++) {
+                    // Skip requests already merged
+                }
+                if (Index < Merge.Count) {
+                    continue;
+                }
+
+                OtherStart = Other->Address + Other->Offset;
+                OtherEnd = Other->Address + Other->Length;
+                if (OtherStart > End || OtherEnd < Start ||
+                    ((OtherEnd > End) ? OtherEnd : End) - ((OtherStart < Start) ? OtherStart : Start) > PLD_QSPI_QUEUE_SLICE_SIZE ||
+                    !PLD_QSPI_QueueReady(QueuePtr, Other)) {
+                    continue;
+                }
+
+                Start = (OtherStart < Start) ? OtherStart : Start;
+                End = (OtherEnd > End) ? OtherEnd : End;
+                Merge.Members[Merge.Count++] = Other;
+                PLD_QSPI_QueueStart(QueuePtr, Other, Now);
+                Added = 1;
+            }
+        } while (Added && Merge.Count < PLD_QSPI_QUEUE_MERGE_MAX);
+    }
+
+    Status = PLD_QSPI_ReadStream(QueuePtr->Qspi, Start, End - Start, PLD_QSPI_QueueSink, &Merge);
+
+    // Only an unmerged read can be left partly done
+    if (Status == XST_SUCCESS && End < ReqPtr->Address + ReqPtr->Length) {
+        ReqPtr->Offset = End - ReqPtr->Address;
+        return Status;
+    }
+
+    QueuePtr->Stats.Merged += Merge.Count - 1U;
+    for (Index = 0; Index < Merge.Count; Index++) {
+        PLD_QSPI_QueueComplete(QueuePtr, Merge.Members[Index], Status);
+    }
+
+    return Status;
+}
+
+/**
+ * Stream sink handing each chunk of a merged read to the requests it covers
+ */
+static XStatus PLD_QSPI_QueueSink(void *Ctx, uint32_t Address, const uint8_t *Data, uint32_t Length)
+{
+    PLD_QSPI_QueueMerge_t *MergePtr = (PLD_QSPI_QueueMerge_t *)Ctx;
+    PLD_QSPI_QueueReq_t *ReqPtr;
+    uint32_t Start;
+    uint32_t End;
+    uint32_t Index;
+
+    for (Index = 0; Index < MergePtr->Count; Index++) {
+        ReqPtr = MergePtr->Members[Index];
+        Start = ReqPtr->Address + ReqPtr->Offset;
+        End = ReqPtr->Address + ReqPtr->Length;
+        if (Start < Address) {
+            Start = Address;
+        }
+        if (End > Address + Length) {
+            End = Address + Length;
+        }
+
+        if (Start < End) {
+            memcpy(&ReqPtr->Data[Start - ReqPtr->Address], &Data[Start - Address], End - Start);
+        }
+    }
+
+    return XST_SUCCESS;
+}
@@ -0,0 +1,137 @@
+/*******************************************************************************
+*   McMaster PRESET (www.mcmasterneudose.ca)
+*
+*   Data Acquisition Module - DAM
+*   Flight Firmware
+*
+*   @file       pld_qspi_queue.h
+*   @desc       Prioritized request queue in front of the QSPI flash driver
+*   @author     Sameer Suleman
+*   @date       October 16, 2026
+*
+*	<pre>
+*
+*   Revision History:
+*
+*	Ver   	Who    	Date   		Changes
+*	----- 	---- 	-------- 	-------------------------------------------------------
+*   1.0.0   sam     2026-10-16  Priority / deadline scheduling, read coalescing and sliced programs
+*   1.0.1   sam     2026-10-17  Timed with the driver's PLD_QSPI_NowUs
+*	</pre>
+*
+*******************************************************************************/
+
+/*******************************************************************************
+*   Prevent circular dependency
+*   DO NOT REMOVE
+*******************************************************************************/
+#ifndef PLD_QSPI_QUEUE
+#define PLD_QSPI_QUEUE
+
+/*******************************************************************************
+*   Includes
+*******************************************************************************/
+/* STD Includes */
+#include <stdint.h>
+
+/* Xilinx Includes */
+#include "xstatus.h"
+
+/* NEUDOSE Includes */
+#include "pld_qspi.h"
+
+/*******************************************************************************
+*   Preprocessor Macros
+*******************************************************************************/
+/* Priority levels, 0 is the most urgent */
+#ifndef PLD_QSPI_QUEUE_PRIORITIES
+#define PLD_QSPI_QUEUE_PRIORITIES       4U
+#endif
+
+/* Most bytes one queued command moves. Longer reads are served a slice at
+ * a time and merged reads must fit in one, so this bounds how long an
+ * urgent request can wait behind a command already on the bus. */
+#ifndef PLD_QSPI_QUEUE_SLICE_SIZE
+#define PLD_QSPI_QUEUE_SLICE_SIZE       4096U
+#endif
+
+/* Most requests folded into one merged read */
+#ifndef PLD_QSPI_QUEUE_MERGE_MAX
+#define PLD_QSPI_QUEUE_MERGE_MAX        8U
+#endif
+
+/* Completion latency histogram, bucket n holds 2^(n-1) to 2^n us */
+#define PLD_QSPI_QUEUE_BUCKETS          24U
+
+/*******************************************************************************
+*   Constant Definitions
+*******************************************************************************/
+/* Request operations */
+#define PLD_QSPI_QUEUE_READ             0U
+#define PLD_QSPI_QUEUE_WRITE            1U              /* Programmed a page per command */
+#define PLD_QSPI_QUEUE_ERASE            2U              /* Erased a largest block per command */
+
+/*******************************************************************************
+*   Datatype Definitions
+*******************************************************************************/
+/* One queued flash operation, owned by the submitter until it completes */
+typedef struct PLD_QSPI_QueueReq {
+    /* Filled in by the caller */
+    uint8_t Op;                             /* PLD_QSPI_QUEUE_READ / _WRITE / _ERASE */
+    uint8_t Priority;                       /* 0 (most urgent) to PLD_QSPI_QUEUE_PRIORITIES - 1 */
+    uint32_t Address;
+    uint32_t Length;
+    uint8_t *Data;                          /* Read destination or program source, unused by erases */
+    uint32_t DeadlineUs;                    /* Wanted within this long of submission, 0 for none */
+    PLD_QSPI_Callback_t Callback;           /* Called on completion or failure, may be NULL */
+    void *CallbackRef;
+
+    /* Owned by the queue */
+    volatile XStatus Status;                /* XST_DEVICE_BUSY while queued */
+    struct PLD_QSPI_QueueReq *Next;         /* Submission order */
+    uint32_t Offset;                        /* Bytes already done */
+    uint32_t SubmitUs;
+    uint32_t Started;                       /* Non-zero once a command has served part of it */
+} PLD_QSPI_QueueReq_t;
+
+/* Queue accounting, wait is submission to the first command, latency is
+ * submission to completion */
+typedef struct {
+    uint32_t Submitted;
+    uint32_t Completed;                     /* Including failed requests */
+    uint32_t Errors;
+    uint32_t DeadlinesMissed;               /* Requests completed after their deadline */
+    uint32_t Commands;                      /* Reads, program pages and erases issued */
+    uint32_t Merged;                        /* Reads served by another request's command */
+    uint32_t Preemptions;                   /* Sliced requests passed over for a more urgent one */
+    uint32_t MaxDepth;
+    uint64_t DepthSum;                      /* Depth summed at every command, over Commands gives the mean */
+    uint64_t WaitTotalUs;
+    uint32_t WaitMaxUs;
+    uint32_t LatencyMaxUs[PLD_QSPI_QUEUE_PRIORITIES];
+    uint32_t Latency[PLD_QSPI_QUEUE_PRIORITIES][PLD_QSPI_QUEUE_BUCKETS];
+} PLD_QSPI_QueueStats_t;
+
+typedef struct {
+    PLD_QSPI_t *Qspi;                       /* Driver the queue issues commands through */
+    PLD_QSPI_QueueReq_t *Head;              /* Pending requests, oldest first */
+    PLD_QSPI_QueueReq_t *Tail;
+    PLD_QSPI_QueueReq_t *Last;              /* Request the previous command served */
+    uint32_t Depth;                         /* Pending requests */
+    PLD_QSPI_QueueStats_t Stats;
+} PLD_QSPI_Queue_t;
+
+/*******************************************************************************
+*   Function Prototypes
+*******************************************************************************/
+XStatus PLD_QSPI_QueueInit(PLD_QSPI_Queue_t *QueuePtr, PLD_QSPI_t *InstancePtr);
+XStatus PLD_QSPI_QueueSubmit(PLD_QSPI_Queue_t *QueuePtr, PLD_QSPI_QueueReq_t *ReqPtr);
+XStatus PLD_QSPI_QueueService(PLD_QSPI_Queue_t *QueuePtr);
+XStatus PLD_QSPI_QueueDrain(PLD_QSPI_Queue_t *QueuePtr);
+void PLD_QSPI_QueueResetStats(PLD_QSPI_Queue_t *QueuePtr);
+
+/*******************************************************************************
+*   Prevent circular dependency
+*   DO NOT REMOVE
+*******************************************************************************/
+#endif /* PLD_QSPI_QUEUE */
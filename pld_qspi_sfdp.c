@@ -0,0 +1,623 @@
+/*******************************************************************************
+*   McMaster PRESET (www.mcmasterneudose.ca)
+*
+*   Data Acquisition Module - DAM
+*   Flight Firmware
+*
+*   @file       pld_qspi_sfdp.c
+*   @desc       Flash identification for the QSPI driver (JEDEC ID, SFDP, part table)
+*   @author     Sameer Suleman
+*   @date       October 16, 2026
+*
+*	<pre>
+*
+*   Identification builds the flash description in three layers: driver
+*   defaults, then the part table entry matching the JEDEC ID (known good
+*   timings), then whatever the part's SFDP basic flash parameter table
+*   (JESD216) reports. SFDP decides geometry, read modes and erase types;
+*   timings come from SFDP only when the table is revision B or later.
+*   SFDP derives every worst case time from one multiplier, so a max time
+*   only replaces the earlier layers' when it is longer.
+*
+*   Read modes are limited to what the Zynq controller can clock: single
+*   lane address in I/O mode (1-1-1, 1-1-2, 1-1-4), any of those plus quad
+*   I/O (1-4-4) in linear mode, and mode plus dummy clocks that add up to
+*   whole bytes. The controller has no DTR support.
+*
+*   Parts over 16MB use native 4 byte address opcodes when SFDP's 4 byte
+*   address instruction table covers every command the driver issues, and
+*   otherwise keep 3 byte opcodes with a bank / extended address register.
+*   Linear mode always uses 3 byte addresses within the first 16MB.
+*
+*   Revision History:
+*
+*	Ver   	Who    	Date   		Changes
+*	----- 	---- 	-------- 	-------------------------------------------------------
+*   1.0.0   sam     2026-10-16  SFDP parser and part table replacing the ID switch
+*   1.1.0   sam     2026-10-16  4 byte address instruction table and bank register fallback
+*   1.2.0   sam     2026-10-16  Identify both flashes of a dual configuration
+*   1.3.0   sam     2026-10-16  Suspend / resume opcodes and timings (DWORDs 12 and 13)
+*   1.3.1   sam     2026-10-17  SFDP max times only raise the part table's
+*   1.3.2   sam     2026-10-17  SFDP max times worked out in 64 bits, capped for the poll timeouts
+*	</pre>
+*
+*******************************************************************************/
+
+/*******************************************************************************
+*   Includes
+*******************************************************************************/
+#include "pld_qspi_sfdp.h"
+
+/* STD Includes */
+#include <string.h>
+
+/* Xilinx Includes */
+#include "xil_types.h"
+
+/*******************************************************************************
+*   Constant Definitions
+*******************************************************************************/
+#define PLD_QSPI_SFDP_HEADER_SIZE       8U
+#define PLD_QSPI_SFDP_BFPT_MIN_DWORDS   9U      /* JESD216 */
+#define PLD_QSPI_SFDP_BFPT_TIMING_DWORDS 11U    /* JESD216B adds page size and timings */
+#define PLD_QSPI_SFDP_BFPT_SUSPEND_DWORDS 13U   /* JESD216B suspend / resume */
+#define PLD_QSPI_SFDP_MAX_TIME_US       (UINT32_MAX / 2U)       /* Max times are doubled into poll timeouts */
+
+/* Basic flash parameter table, DWORD 1 */
+#define PLD_QSPI_BFPT_ADDR_MASK         (3U << 17)
+#define PLD_QSPI_BFPT_ADDR_4_ONLY       (2U << 17)
+#define PLD_QSPI_BFPT_FAST_READ_112     (1U << 16)
+#define PLD_QSPI_BFPT_FAST_READ_144     (1U << 21)
+#define PLD_QSPI_BFPT_FAST_READ_114     (1U << 22)
+
+/* Basic flash parameter table, DWORD 12 */
+#define PLD_QSPI_BFPT_NO_SUSPEND        (1U << 31)
+
+/*******************************************************************************
+*   Global Variables
+*******************************************************************************/
+/* Parts we fit, with datasheet timings. Reads stay at the defaults here and
+ * are upgraded from SFDP. */
+static const PLD_QSPI_Flash_t PLD_QSPI_Parts[] = {
+    {
+        .Name = "n25q128", .JedecId = { PLD_QSPI_MFR_MICRON, 0xBA, 0x18 },
+        .Size = 0x1000000U, .PageSize = 256U,
+        .ReadCmd = PLD_QSPI_CMD_QUAD_READ, .ReadDummyBytes = 1,
+        .LinearReadCmd = PLD_QSPI_CMD_QUAD_READ, .LinearDummyBytes = 1,
+        .ProgramCmd = PLD_QSPI_CMD_PAGE_PROGRAM, .ProgramTimeUs = 500U, .ProgramTimeMaxUs = 5000U,
+        .Erase = { { 0x1000U, PLD_QSPI_CMD_ERASE_4K, 250000U, 800000U },
+                   { 0x10000U, PLD_QSPI_CMD_ERASE_64K, 700000U, 3000000U } },
+        .EraseTypes = 2, .ChipEraseTimeUs = 170000000U, .ChipEraseTimeMaxUs = 250000000U,
+        .SuspendCmd = PLD_QSPI_CMD_SUSPEND, .ResumeCmd = PLD_QSPI_CMD_RESUME,
+        .SuspendTimeUs = 30U, .ResumeIntervalUs = 64U,
+    },
+    {
+        .Name = "mt25ql02g", .JedecId = { PLD_QSPI_MFR_MICRON, 0xBA, 0x22 },
+        .Size = 0x10000000U, .PageSize = 256U,
+        .ReadCmd = PLD_QSPI_CMD_QUAD_READ, .ReadDummyBytes = 1,
+        .LinearReadCmd = PLD_QSPI_CMD_QUAD_READ, .LinearDummyBytes = 1,
+        .AddressMode = PLD_QSPI_ADDR_BANK, .BankWriteCmd = PLD_QSPI_CMD_WRITE_EAR, .BankNeedsWren = 1,
+        .ProgramCmd = PLD_QSPI_CMD_PAGE_PROGRAM, .ProgramTimeUs = 120U, .ProgramTimeMaxUs = 1800U,
+        .Erase = { { 0x1000U, PLD_QSPI_CMD_ERASE_4K, 50000U, 400000U },
+                   { 0x8000U, PLD_QSPI_CMD_ERASE_32K, 100000U, 1000000U },
+                   { 0x10000U, PLD_QSPI_CMD_ERASE_64K, 150000U, 1000000U } },
+        .EraseTypes = 3, .ChipEraseTimeUs = 600000000U, .ChipEraseTimeMaxUs = 2000000000U,
+        .SuspendCmd = PLD_QSPI_CMD_SUSPEND, .ResumeCmd = PLD_QSPI_CMD_RESUME,
+        .SuspendTimeUs = 30U, .ResumeIntervalUs = 64U,
+    },
+    {
+        .Name = "s25fl164k", .JedecId = { PLD_QSPI_MFR_SPANSION, 0x40, 0x17 },
+        .Size = 0x800000U, .PageSize = 256U,
+        .ReadCmd = PLD_QSPI_CMD_QUAD_READ, .ReadDummyBytes = 1,
+        .LinearReadCmd = PLD_QSPI_CMD_QUAD_READ, .LinearDummyBytes = 1,
+        .ProgramCmd = PLD_QSPI_CMD_PAGE_PROGRAM, .ProgramTimeUs = 700U, .ProgramTimeMaxUs = 3000U,
+        .Erase = { { 0x1000U, PLD_QSPI_CMD_ERASE_4K, 50000U, 450000U },
+                   { 0x8000U, PLD_QSPI_CMD_ERASE_32K, 300000U, 1300000U },
+                   { 0x10000U, PLD_QSPI_CMD_ERASE_64K, 500000U, 2000000U } },
+        .EraseTypes = 3, .ChipEraseTimeUs = 30000000U, .ChipEraseTimeMaxUs = 100000000U,
+        .SuspendCmd = PLD_QSPI_CMD_SUSPEND, .ResumeCmd = PLD_QSPI_CMD_RESUME,
+        .SuspendTimeUs = 40U, .ResumeIntervalUs = 128U,
+    },
+    {
+        .Name = "w25q128jv", .JedecId = { PLD_QSPI_MFR_WINBOND, 0x40, 0x18 },
+        .Size = 0x1000000U, .PageSize = 256U,
+        .ReadCmd = PLD_QSPI_CMD_QUAD_READ, .ReadDummyBytes = 1,
+        .LinearReadCmd = PLD_QSPI_CMD_QUAD_READ, .LinearDummyBytes = 1,
+        .ProgramCmd = PLD_QSPI_CMD_PAGE_PROGRAM, .ProgramTimeUs = 400U, .ProgramTimeMaxUs = 3000U,
+        .Erase = { { 0x1000U, PLD_QSPI_CMD_ERASE_4K, 45000U, 400000U },
+                   { 0x8000U, PLD_QSPI_CMD_ERASE_32K, 120000U, 1600000U },
+                   { 0x10000U, PLD_QSPI_CMD_ERASE_64K, 150000U, 2000000U } },
+        .EraseTypes = 3, .ChipEraseTimeUs = 40000000U, .ChipEraseTimeMaxUs = 200000000U,
+        .SuspendCmd = PLD_QSPI_CMD_SUSPEND, .ResumeCmd = PLD_QSPI_CMD_RESUME,
+        .SuspendTimeUs = 20U, .ResumeIntervalUs = 64U,
+    },
+    {
+        .Name = "mx25l12835f", .JedecId = { PLD_QSPI_MFR_MACRONIX, 0x20, 0x18 },
+        .Size = 0x1000000U, .PageSize = 256U,
+        .ReadCmd = PLD_QSPI_CMD_QUAD_READ, .ReadDummyBytes = 1,
+        .LinearReadCmd = PLD_QSPI_CMD_QUAD_READ, .LinearDummyBytes = 1,
+        .ProgramCmd = PLD_QSPI_CMD_PAGE_PROGRAM, .ProgramTimeUs = 330U, .ProgramTimeMaxUs = 1200U,
+        .Erase = { { 0x1000U, PLD_QSPI_CMD_ERASE_4K, 30000U, 120000U },
+                   { 0x8000U, PLD_QSPI_CMD_ERASE_32K, 150000U, 650000U },
+                   { 0x10000U, PLD_QSPI_CMD_ERASE_64K, 280000U, 2000000U } },
+        .EraseTypes = 3, .ChipEraseTimeUs = 50000000U, .ChipEraseTimeMaxUs = 150000000U,
+        .SuspendCmd = PLD_QSPI_CMD_SUSPEND_ALT, .ResumeCmd = PLD_QSPI_CMD_RESUME_ALT,
+        .SuspendTimeUs = 20U, .ResumeIntervalUs = 320U,
+    },
+    {
+        .Name = "is25lp128", .JedecId = { PLD_QSPI_MFR_ISSI, 0x60, 0x18 },
+        .Size = 0x1000000U, .PageSize = 256U,
+        .ReadCmd = PLD_QSPI_CMD_QUAD_READ, .ReadDummyBytes = 1,
+        .LinearReadCmd = PLD_QSPI_CMD_QUAD_READ, .LinearDummyBytes = 1,
+        .ProgramCmd = PLD_QSPI_CMD_PAGE_PROGRAM, .ProgramTimeUs = 200U, .ProgramTimeMaxUs = 700U,
+        .Erase = { { 0x1000U, PLD_QSPI_CMD_ERASE_4K, 70000U, 300000U },
+                   { 0x8000U, PLD_QSPI_CMD_ERASE_32K, 100000U, 500000U },
+                   { 0x10000U, PLD_QSPI_CMD_ERASE_64K, 150000U, 1000000U } },
+        .EraseTypes = 3, .ChipEraseTimeUs = 45000000U, .ChipEraseTimeMaxUs = 180000000U,
+        .SuspendCmd = PLD_QSPI_CMD_SUSPEND, .ResumeCmd = PLD_QSPI_CMD_RESUME,
+        .SuspendTimeUs = 100U, .ResumeIntervalUs = 128U,
+    },
+};
+
+/* 3 byte opcodes and their 4 byte address variants with the 4 byte address
+ * instruction table (DWORD 1) bit that advertises the variant */
+static const uint8_t PLD_QSPI_Opcode4B[][3] = {
+    { PLD_QSPI_CMD_READ,                PLD_QSPI_CMD_READ_4B,               0 },
+    { PLD_QSPI_CMD_FAST_READ,           PLD_QSPI_CMD_FAST_READ_4B,          1 },
+    { PLD_QSPI_CMD_DUAL_READ,           PLD_QSPI_CMD_DUAL_READ_4B,          2 },
+    { PLD_QSPI_CMD_QUAD_READ,           PLD_QSPI_CMD_QUAD_READ_4B,          4 },
+    { PLD_QSPI_CMD_QUAD_IO_READ,        PLD_QSPI_CMD_QUAD_IO_READ_4B,       5 },
+    { PLD_QSPI_CMD_PAGE_PROGRAM,        PLD_QSPI_CMD_PAGE_PROGRAM_4B,       6 },
+    { PLD_QSPI_CMD_QUAD_PAGE_PROGRAM,   PLD_QSPI_CMD_QUAD_PAGE_PROGRAM_4B,  7 },
+};
+
+/* SFDP time units in microseconds */
+static const uint32_t PLD_QSPI_SfdpEraseUnitUs[4] = { 1000U, 16000U, 128000U, 1000000U };
+static const uint32_t PLD_QSPI_SfdpChipUnitUs[4] = { 16000U, 256000U, 4000000U, 64000000U };
+static const uint32_t PLD_QSPI_SfdpSuspendUnitNs[4] = { 128U, 1000U, 8000U, 64000U };
+
+/*******************************************************************************
+*   Local Functions
+*******************************************************************************/
+
+/**
+ * Little endian 32 bit word from SFDP space
+ */
+static uint32_t PLD_QSPI_SfdpWord(const uint8_t *Data)
+{
+    return (uint32_t)Data[0] | ((uint32_t)Data[1] << 8) | ((uint32_t)Data[2] << 16) | ((uint32_t)Data[3] << 24);
+}
+
+/**
+ * Worst case time from SFDP, unless the time already known is longer
+ * SFDP scales every typical time by one multiplier, which can fall short
+ * of a datasheet's worst case for a particular operation. A chip erase
+ * times the largest multiplier overflows 32 bits, so the product is taken
+ * in 64 and capped where the driver's doubled poll timeout still fits.
+ */
+static uint32_t PLD_QSPI_SfdpMaxUs(uint32_t TypicalUs, uint32_t Multiplier, uint32_t KnownUs)
+{
+    uint64_t MaxUs = (uint64_t)TypicalUs * Multiplier;
+
+    if (MaxUs < KnownUs) {
+        MaxUs = KnownUs;
+    }
+
+    return (MaxUs > PLD_QSPI_SFDP_MAX_TIME_US) ? PLD_QSPI_SFDP_MAX_TIME_US : (uint32_t)MaxUs;
+}
+
+/**
+ * Convert a fast read's mode and dummy clocks to whole bytes on the address lanes
+ * Returns 0 when the clocks don't fill whole bytes or exceed the controller's
+ * 3 bit linear mode dummy field, so the read can't be used.
+ */
+static uint32_t PLD_QSPI_SfdpDummyBytes(uint32_t Field, uint32_t AddrLanes, uint8_t *DummyBytesPtr)
+{
+    uint32_t Bits = ((Field & 0x1FU) + ((Field >> 5) & 0x7U)) * AddrLanes;
+
+    if (((Field >> 8) & 0xFFU) == 0 || (Bits % 8U) != 0 || Bits / 8U > 7U) {
+        return 0;
+    }
+
+    *DummyBytesPtr = (uint8_t)(Bits / 8U);
+    return 1;
+}
+
+/**
+ * Size of the device from the JEDEC capacity byte when SFDP is missing
+ */
+static uint32_t PLD_QSPI_SizeFromId(const uint8_t *JedecId)
+{
+    uint8_t Capacity = JedecId[2];
+
+    // Micron numbers its 512Mbit and larger parts on from 0x20
+    if (JedecId[0] == PLD_QSPI_MFR_MICRON && Capacity >= 0x20 && Capacity <= 0x22) {
+        return 0x4000000U << (Capacity - 0x20);
+    }
+
+    if (Capacity >= 0x10 && Capacity <= 0x1F) {
+        return 1U << Capacity;
+    }
+
+    return PLD_QSPI_DEFAULT_FLASH_SIZE;
+}
+
+/**
+ * 4 byte address variant of Cmd if the 4BAIT support bits advertise it, 0 if not
+ */
+static uint8_t PLD_QSPI_To4ByteOpcode(uint8_t Cmd, uint32_t Support)
+{
+    uint32_t Index;
+
+    for (Index = 0; Index < sizeof(PLD_QSPI_Opcode4B) / sizeof(PLD_QSPI_Opcode4B[0]); Index++) {
+        if (PLD_QSPI_Opcode4B[Index][0] == Cmd) {
+            return (Support & (1U << PLD_QSPI_Opcode4B[Index][2])) ? PLD_QSPI_Opcode4B[Index][1] : 0;
+        }
+    }
+
+    return 0;
+}
+
+/**
+ * Use the bank register to reach past 16MB, with the vendor's usual opcode
+ * unless the part table already named one
+ */
+static void PLD_QSPI_UseBankAddressing(PLD_QSPI_Flash_t *FlashPtr)
+{
+    FlashPtr->AddressMode = PLD_QSPI_ADDR_BANK;
+
+    if (FlashPtr->BankWriteCmd != 0) {
+        return;
+    }
+
+    // Spansion's bank register write needs no write enable
+    if (FlashPtr->JedecId[0] == PLD_QSPI_MFR_SPANSION) {
+        FlashPtr->BankWriteCmd = PLD_QSPI_CMD_BANK_WRITE;
+        FlashPtr->BankNeedsWren = 0;
+    } else {
+        FlashPtr->BankWriteCmd = PLD_QSPI_CMD_WRITE_EAR;
+        FlashPtr->BankNeedsWren = 1;
+    }
+}
+
+/**
+ * Switch every addressed opcode to its 4 byte variant
+ * Support and EraseCmds are DWORDs 1 and 2 of the 4 byte address
+ * instruction table. Returns 0, leaving Flash alone, when any command the
+ * driver issues has no 4 byte variant.
+ */
+static uint32_t PLD_QSPI_Use4ByteOpcodes(PLD_QSPI_Flash_t *FlashPtr, uint32_t Support, uint32_t EraseCmds,
+                                         const uint8_t *EraseSlot)
+{
+    uint8_t ReadCmd = PLD_QSPI_To4ByteOpcode(FlashPtr->ReadCmd, Support);
+    uint8_t ProgramCmd = PLD_QSPI_To4ByteOpcode(FlashPtr->ProgramCmd, Support);
+    uint32_t Index;
+
+    if (ReadCmd == 0 || ProgramCmd == 0) {
+        return 0;
+    }
+
+    for (Index = 0; Index < FlashPtr->EraseTypes; Index++) {
+        if (!(Support & (1U << (9U + EraseSlot[Index])))) {
+            return 0;
+        }
+    }
+
+    FlashPtr->ReadCmd = ReadCmd;
+    FlashPtr->ProgramCmd = ProgramCmd;
+    for (Index = 0; Index < FlashPtr->EraseTypes; Index++) {
+        FlashPtr->Erase[Index].Cmd = (uint8_t)(EraseCmds >> (8U * EraseSlot[Index]));
+    }
+    FlashPtr->AddressMode = PLD_QSPI_ADDR_4BYTE;
+
+    return 1;
+}
+
+/**
+ * Pick the timing of an erase size from the entries already in Flash
+ */
+static void PLD_QSPI_KnownEraseTime(const PLD_QSPI_Flash_t *FlashPtr, PLD_QSPI_EraseType_t *TypePtr)
+{
+    uint32_t Index;
+
+    for (Index = 0; Index < FlashPtr->EraseTypes; Index++) {
+        if (FlashPtr->Erase[Index].Size == TypePtr->Size) {
+            TypePtr->TimeUs = FlashPtr->Erase[Index].TimeUs;
+            TypePtr->TimeMaxUs = FlashPtr->Erase[Index].TimeMaxUs;
+            return;
+        }
+    }
+
+    if (TypePtr->Size <= 0x1000U) {
+        TypePtr->TimeUs = PLD_QSPI_DEFAULT_T4K_US;
+        TypePtr->TimeMaxUs = PLD_QSPI_DEFAULT_T4K_MAX_US;
+    } else {
+        TypePtr->TimeUs = PLD_QSPI_DEFAULT_T64K_US;
+        TypePtr->TimeMaxUs = PLD_QSPI_DEFAULT_T64K_MAX_US;
+    }
+}
+
+/*******************************************************************************
+*   Functions
+*******************************************************************************/
+
+/**
+ * Look up a part by its 3 byte JEDEC ID, NULL if it isn't in the table
+ */
+const PLD_QSPI_Flash_t *PLD_QSPI_FindPart(const uint8_t *JedecId)
+{
+    uint32_t Index;
+
+    for (Index = 0; Index < sizeof(PLD_QSPI_Parts) / sizeof(PLD_QSPI_Parts[0]); Index++) {
+        if (memcmp(PLD_QSPI_Parts[Index].JedecId, JedecId, 3) == 0) {
+            return &PLD_QSPI_Parts[Index];
+        }
+    }
+
+    return NULL;
+}
+
+/**
+ * Apply an SFDP dump (starting at SFDP address 0) to a flash description
+ * Only fields the basic flash parameter table describes are changed. Needs
+ * no hardware, so recorded dumps can be checked on the host.
+ */
+XStatus PLD_QSPI_ParseSfdp(const uint8_t *Sfdp, uint32_t Length, PLD_QSPI_Flash_t *FlashPtr)
+{
+    const uint8_t *Header = NULL;
+    const uint8_t *Header4B = NULL;
+    const uint8_t *Table;
+    uint32_t Headers;
+    uint32_t Index;
+    uint32_t Dwords;
+    uint32_t Offset;
+    uint32_t Word;
+    uint32_t Count;
+    uint32_t Multiplier;
+    uint32_t EraseNs;
+    uint32_t ProgramNs;
+    PLD_QSPI_EraseType_t Erase[PLD_QSPI_MAX_ERASE_TYPES];
+    PLD_QSPI_EraseType_t Type;
+    uint8_t EraseSlot[PLD_QSPI_MAX_ERASE_TYPES];
+    uint8_t DummyBytes;
+    uint32_t AddressModes;
+
+    if (Sfdp == NULL || FlashPtr == NULL || Length < PLD_QSPI_SFDP_HEADER_SIZE * 2U ||
+        PLD_QSPI_SfdpWord(Sfdp) != PLD_QSPI_SFDP_SIGNATURE) {
+        return XST_FAILURE;
+    }
+
+    // Find the newest basic flash parameter table within the dump
+    Headers = (uint32_t)Sfdp[6] + 1U;
+    for (Index = 1; Index <= Headers && (Index + 1U) * PLD_QSPI_SFDP_HEADER_SIZE <= Length; Index++) {
+        const uint8_t *Candidate = &Sfdp[Index * PLD_QSPI_SFDP_HEADER_SIZE];
+
+        if ((((uint32_t)Candidate[7] << 8) | Candidate[0]) == PLD_QSPI_SFDP_BFPT_ID &&
+            (Header == NULL || ((uint32_t)Candidate[2] << 8 | Candidate[1]) > ((uint32_t)Header[2] << 8 | Header[1]))) {
+            Header = Candidate;
+        }
+
+        if ((((uint32_t)Candidate[7] << 8) | Candidate[0]) == PLD_QSPI_SFDP_4BAIT_ID) {
+            Header4B = Candidate;
+        }
+    }
+
+    if (Header == NULL) {
+        return XST_FAILURE;
+    }
+
+    Dwords = Header[3];
+    Offset = (uint32_t)Header[4] | ((uint32_t)Header[5] << 8) | ((uint32_t)Header[6] << 16);
+    if (Dwords < PLD_QSPI_SFDP_BFPT_MIN_DWORDS || Offset > Length || Dwords * 4U > Length - Offset) {
+        return XST_FAILURE;
+    }
+    Table = &Sfdp[Offset];
+
+    FlashPtr->SfdpRevision = (uint16_t)(((uint32_t)Header[2] << 8) | Header[1]);
+
+    // DWORD 2, density in bits
+    Word = PLD_QSPI_SfdpWord(&Table[4]);
+    if (Word & 0x80000000U) {
+        if ((Word & 0x7FFFFFFFU) >= 3U && (Word & 0x7FFFFFFFU) <= 34U) {
+            FlashPtr->Size = 1U << ((Word & 0x7FFFFFFFU) - 3U);
+        }
+    } else {
+        FlashPtr->Size = (Word >> 3) + 1U;
+    }
+
+    // I/O mode reads: fastest single lane address mode, fast read as fallback
+    Word = PLD_QSPI_SfdpWord(&Table[0]);
+    AddressModes = Word & PLD_QSPI_BFPT_ADDR_MASK;
+    FlashPtr->ReadCmd = PLD_QSPI_CMD_FAST_READ;
+    FlashPtr->ReadDummyBytes = 1;
+    if ((Word & PLD_QSPI_BFPT_FAST_READ_114) &&
+        PLD_QSPI_SfdpDummyBytes(PLD_QSPI_SfdpWord(&Table[8]) >> 16, 1, &DummyBytes)) {
+        FlashPtr->ReadCmd = Table[11];
+        FlashPtr->ReadDummyBytes = DummyBytes;
+    } else if ((Word & PLD_QSPI_BFPT_FAST_READ_112) &&
+               PLD_QSPI_SfdpDummyBytes(PLD_QSPI_SfdpWord(&Table[12]), 1, &DummyBytes)) {
+        FlashPtr->ReadCmd = Table[13];
+        FlashPtr->ReadDummyBytes = DummyBytes;
+    }
+
+    // Linear mode can also clock the address on four lanes
+    FlashPtr->LinearReadCmd = FlashPtr->ReadCmd;
+    FlashPtr->LinearDummyBytes = FlashPtr->ReadDummyBytes;
+    if ((Word & PLD_QSPI_BFPT_FAST_READ_144) &&
+        PLD_QSPI_SfdpDummyBytes(PLD_QSPI_SfdpWord(&Table[8]), 4, &DummyBytes)) {
+        FlashPtr->LinearReadCmd = Table[9];
+        FlashPtr->LinearDummyBytes = DummyBytes;
+    }
+
+    // DWORDs 8 and 9, up to four erase types as size exponent and opcode
+    Count = 0;
+    for (Index = 0; Index < PLD_QSPI_MAX_ERASE_TYPES; Index++) {
+        uint8_t Exponent = Table[28 + Index * 2U];
+        uint32_t Slot;
+
+        if (Exponent == 0 || Exponent > 31U) {
+            continue;
+        }
+
+        Type.Size = 1U << Exponent;
+        Type.Cmd = Table[29 + Index * 2U];
+        PLD_QSPI_KnownEraseTime(FlashPtr, &Type);
+
+        // DWORD 10, typical erase times and the max time multiplier
+        if (Dwords >= PLD_QSPI_SFDP_BFPT_TIMING_DWORDS - 1U) {
+            Word = PLD_QSPI_SfdpWord(&Table[36]);
+            Multiplier = 2U * ((Word & 0xFU) + 1U);
+            Word >>= 4U + 7U * Index;
+            Type.TimeUs = ((Word & 0x1FU) + 1U) * PLD_QSPI_SfdpEraseUnitUs[(Word >> 5) & 0x3U];
+            Type.TimeMaxUs = PLD_QSPI_SfdpMaxUs(Type.TimeUs, Multiplier, Type.TimeMaxUs);
+        }
+
+        // Keep the list sorted by size, remembering each entry's SFDP erase type
+        for (Slot = Count; Slot > 0 && Erase[Slot - 1U].Size > Type.Size; Slot--) {
+            Erase[Slot] = Erase[Slot - 1U];
+            EraseSlot[Slot] = EraseSlot[Slot - 1U];
+        }
+        Erase[Slot] = Type;
+        EraseSlot[Slot] = (uint8_t)Index;
+        Count++;
+    }
+
+    if (Count > 0) {
+        memcpy(FlashPtr->Erase, Erase, Count * sizeof(Erase[0]));
+        memset(&FlashPtr->Erase[Count], 0, (PLD_QSPI_MAX_ERASE_TYPES - Count) * sizeof(Erase[0]));
+        FlashPtr->EraseTypes = Count;
+    }
+
+    // DWORD 11 (JESD216B), page size, program and chip erase times
+    if (Dwords >= PLD_QSPI_SFDP_BFPT_TIMING_DWORDS) {
+        Word = PLD_QSPI_SfdpWord(&Table[40]);
+        Multiplier = 2U * ((Word & 0xFU) + 1U);
+
+        FlashPtr->PageSize = 1U << ((Word >> 4) & 0xFU);
+        FlashPtr->ProgramTimeUs = (((Word >> 8) & 0x1FU) + 1U) * ((Word & (1U << 13)) ? 64U : 8U);
+        FlashPtr->ProgramTimeMaxUs = PLD_QSPI_SfdpMaxUs(FlashPtr->ProgramTimeUs, Multiplier,
+                                                       FlashPtr->ProgramTimeMaxUs);
+
+        // Chip erase shares the erase multiplier from DWORD 10
+        Multiplier = 2U * ((PLD_QSPI_SfdpWord(&Table[36]) & 0xFU) + 1U);
+        FlashPtr->ChipEraseTimeUs = (((Word >> 24) & 0x1FU) + 1U) * PLD_QSPI_SfdpChipUnitUs[(Word >> 29) & 0x3U];
+        FlashPtr->ChipEraseTimeMaxUs = PLD_QSPI_SfdpMaxUs(FlashPtr->ChipEraseTimeUs, Multiplier,
+                                                         FlashPtr->ChipEraseTimeMaxUs);
+    }
+
+    // DWORDs 12 and 13, suspend / resume. Erases and programs may differ, keep the slower of each.
+    if (Dwords >= PLD_QSPI_SFDP_BFPT_SUSPEND_DWORDS) {
+        Word = PLD_QSPI_SfdpWord(&Table[44]);
+        if (Word & PLD_QSPI_BFPT_NO_SUSPEND) {
+            FlashPtr->SuspendCmd = 0;
+            FlashPtr->ResumeCmd = 0;
+        } else {
+            EraseNs = (((Word >> 24) & 0x1FU) + 1U) * PLD_QSPI_SfdpSuspendUnitNs[(Word >> 29) & 0x3U];
+            ProgramNs = (((Word >> 13) & 0x1FU) + 1U) * PLD_QSPI_SfdpSuspendUnitNs[(Word >> 18) & 0x3U];
+            FlashPtr->SuspendTimeUs = (((EraseNs > ProgramNs) ? EraseNs : ProgramNs) + 999U) / 1000U;
+
+            // Resume to suspend intervals, in 64us units
+            EraseNs = (((Word >> 20) & 0xFU) + 1U) * 64000U;
+            ProgramNs = (((Word >> 9) & 0xFU) + 1U) * 64000U;
+            FlashPtr->ResumeIntervalUs = ((EraseNs > ProgramNs) ? EraseNs : ProgramNs) / 1000U;
+
+            Word = PLD_QSPI_SfdpWord(&Table[48]);
+            FlashPtr->SuspendCmd = (uint8_t)(Word >> 24);
+            FlashPtr->ResumeCmd = (uint8_t)(Word >> 16);
+        }
+    }
+
+    // Addressing past 16MB: 4 byte opcodes where every command has one, else a bank register
+    FlashPtr->AddressMode = PLD_QSPI_ADDR_3BYTE;
+    if (AddressModes == PLD_QSPI_BFPT_ADDR_4_ONLY) {
+        FlashPtr->AddressMode = PLD_QSPI_ADDR_4BYTE;
+    } else if (FlashPtr->Size > PLD_QSPI_BANK_SIZE) {
+        Offset = (Header4B != NULL) ?
+                 ((uint32_t)Header4B[4] | ((uint32_t)Header4B[5] << 8) | ((uint32_t)Header4B[6] << 16)) : Length;
+
+        if (Count == 0 || Header4B == NULL || Header4B[3] < 2U || Offset > Length - 8U || Length < 8U ||
+            !PLD_QSPI_Use4ByteOpcodes(FlashPtr, PLD_QSPI_SfdpWord(&Sfdp[Offset]),
+                                      PLD_QSPI_SfdpWord(&Sfdp[Offset + 4U]), EraseSlot)) {
+            PLD_QSPI_UseBankAddressing(FlashPtr);
+        }
+    }
+
+    return XST_SUCCESS;
+}
+
+/**
+ * Identify the attached flash and fill in InstancePtr->Flash
+ * Reads the JEDEC ID and SFDP tables with the current clock settings, so
+ * call it after PLD_QSPI_SetClockPrescalar and PLD_QSPI_SetOptionsManually.
+ * Parts without SFDP fall back to the part table, and then to a size
+ * decoded from the ID with default timings. In a dual configuration both
+ * flashes must report the same ID (XST_FAILURE otherwise).
+ */
+XStatus PLD_QSPI_Identify(PLD_QSPI_t *InstancePtr)
+{
+    XStatus Status;
+    const PLD_QSPI_Flash_t *PartPtr;
+    PLD_QSPI_Flash_t Flash;
+    uint8_t IdFrame[1 + 2 * 3];
+    uint8_t Id[3];
+    uint8_t *Frame = InstancePtr->Frame[0];
+    uint32_t Header = 5;
+    uint32_t Devices = (InstancePtr->ConnectionMode == PLD_QSPI_CONNECTION_SINGLE) ? 1U : 2U;
+    uint32_t Device;
+
+    // Check if driver is ready
+    if (InstancePtr->Qspi.IsReady != XIL_COMPONENT_IS_READY) {
+        return XST_DEVICE_NOT_FOUND;
+    }
+
+    for (Device = 0; Device < Devices; Device++) {
+        memset(IdFrame, 0, sizeof(IdFrame));
+        IdFrame[0] = PLD_QSPI_CMD_READ_ID;
+
+        Status = PLD_QSPI_ReadDevice(InstancePtr, Device, IdFrame, 1, 3);
+        if (Status != XST_SUCCESS) {
+            return Status;
+        }
+
+        // A floating or shorted bus reads back all ones or all zeros
+        if ((IdFrame[1] == 0xFF && IdFrame[2] == 0xFF && IdFrame[3] == 0xFF) ||
+            (IdFrame[1] == 0x00 && IdFrame[2] == 0x00 && IdFrame[3] == 0x00)) {
+            return XST_DEVICE_NOT_FOUND;
+        }
+
+        // Dual configurations are driven as one part and need a matched pair
+        if (Device == 0) {
+            memcpy(Id, &IdFrame[1], 3);
+        } else if (memcmp(Id, &IdFrame[1], 3) != 0) {
+            return XST_FAILURE;
+        }
+    }
+
+    PartPtr = PLD_QSPI_FindPart(Id);
+    if (PartPtr != NULL) {
+        Flash = *PartPtr;
+    } else {
+        PLD_QSPI_FlashDefaults(&Flash);
+        memcpy(Flash.JedecId, Id, 3);
+        Flash.Size = PLD_QSPI_SizeFromId(Flash.JedecId);
+        if (Flash.Size > PLD_QSPI_BANK_SIZE) {
+            PLD_QSPI_UseBankAddressing(&Flash);
+        }
+    }
+
+    // SFDP read from the lower flash: opcode, 3 address bytes and 8 dummy
+    // clocks, in place (twice the data in parallel mode still fits a frame)
+    memset(Frame, 0, Header + 2U * PLD_QSPI_SFDP_READ_SIZE);
+    Frame[0] = PLD_QSPI_CMD_READ_SFDP;
+
+    Status = PLD_QSPI_ReadDevice(InstancePtr, 0, Frame, Header, PLD_QSPI_SFDP_READ_SIZE);
+    if (Status == XST_SUCCESS) {
+        // Parts without SFDP keep the table or ID derived description
+        (void)PLD_QSPI_ParseSfdp(&Frame[Header], PLD_QSPI_SFDP_READ_SIZE, &Flash);
+    }
+
+    // Scales the geometry to the connection mode and forgets cached banks
+    PLD_QSPI_SetFlash(InstancePtr, &Flash);
+
+    return XST_SUCCESS;
+}
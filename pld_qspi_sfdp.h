@@ -0,0 +1,79 @@
+/*******************************************************************************
+*   McMaster PRESET (www.mcmasterneudose.ca)
+*
+*   Data Acquisition Module - DAM
+*   Flight Firmware
+*
+*   @file       pld_qspi_sfdp.h
+*   @desc       Flash identification for the QSPI driver (JEDEC ID, SFDP, part table)
+*   @author     Sameer Suleman
+*   @date       October 16, 2026
+*
+*	<pre>
+*
+*   Revision History:
+*
+*	Ver   	Who    	Date   		Changes
+*	----- 	---- 	-------- 	-------------------------------------------------------
+*   1.0.0   sam     2026-10-16  SFDP parser and part table replacing the ID switch
+*   1.1.0   sam     2026-10-16  4 byte address instruction table and bank register fallback
+*   1.2.0   sam     2026-10-16  Identify both flashes of a dual configuration
+*   1.3.0   sam     2026-10-16  Suspend / resume opcodes and timings (DWORDs 12 and 13)
+*   1.3.1   sam     2026-10-17  SFDP max times only raise the part table's
+*   1.3.2   sam     2026-10-17  SFDP max times worked out in 64 bits, capped for the poll timeouts
+*	</pre>
+*
+*******************************************************************************/
+
+/*******************************************************************************
+*   Prevent circular dependency
+*   DO NOT REMOVE
+*******************************************************************************/
+#ifndef PLD_QSPI_SFDP
+#define PLD_QSPI_SFDP
+
+/*******************************************************************************
+*   Includes
+*******************************************************************************/
+/* STD Includes */
+#include <stdint.h>
+
+/* Xilinx Includes */
+#include "xstatus.h"
+
+/* NEUDOSE Includes */
+#include "pld_qspi.h"
+
+/*******************************************************************************
+*   Preprocessor Macros
+*******************************************************************************/
+/* Bytes of SFDP space read during identification, enough for the header,
+ * the parameter headers and a JESD216B basic flash parameter table */
+#define PLD_QSPI_SFDP_READ_SIZE         256U
+
+/*******************************************************************************
+*   Constant Definitions
+*******************************************************************************/
+#define PLD_QSPI_SFDP_SIGNATURE         0x50444653U     /* "SFDP" little endian */
+#define PLD_QSPI_SFDP_BFPT_ID           0xFF00U         /* Basic flash parameter table */
+#define PLD_QSPI_SFDP_4BAIT_ID          0xFF84U         /* 4 byte address instruction table */
+
+/* JEDEC manufacturer IDs */
+#define PLD_QSPI_MFR_MICRON             0x20
+#define PLD_QSPI_MFR_SPANSION           0x01
+#define PLD_QSPI_MFR_WINBOND            0xEF
+#define PLD_QSPI_MFR_MACRONIX           0xC2
+#define PLD_QSPI_MFR_ISSI               0x9D
+
+/*******************************************************************************
+*   Function Prototypes
+*******************************************************************************/
+XStatus PLD_QSPI_Identify(PLD_QSPI_t *InstancePtr);
+const PLD_QSPI_Flash_t *PLD_QSPI_FindPart(const uint8_t *JedecId);
+XStatus PLD_QSPI_ParseSfdp(const uint8_t *Sfdp, uint32_t Length, PLD_QSPI_Flash_t *FlashPtr);
+
+/*******************************************************************************
+*   Prevent circular dependency
+*   DO NOT REMOVE
+*******************************************************************************/
+#endif /* PLD_QSPI_SFDP */
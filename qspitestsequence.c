@@ -4,494 +4,2237 @@
 *******************************************************************************/
 
 
- // qspitestsequence.c: QSPI test application with proper initialization
- 
+ // qspitestsequence.c: QSPI throughput / latency benchmark
+ //
+ // Identifies the flash, checks the SFDP parser against recorded dumps, then
+ // sweeps clock prescaler, transfer size, read opcode and access pattern,
+ // timing every operation. Results are printed as
+ // CSV, one row per sweep point; all other output lines start with '#'.
+ // Reads are swept at every prescaler. Programs, erases, the small command
+ // and staged versus vectored read comparisons, the CRC32C checks, the blank
+ // checks, the region updates, reads during erases, the logging pipeline, the read cache trace and the request queue load test run at the
+ // auto-tuned prescaler only, and they overwrite BENCH_REGION_ADDRESS .. + BENCH_REGION_SIZE. The boot
+ // image test also overwrites the two image copies at TEST_BOOT_PRIMARY and TEST_BOOT_SECONDARY.
+ //
+ // Columns:
+ //   op,prescaler,opcode,pattern,size,ops,errors,bytes,mb_per_s,ops_per_s,p50_ns,p99_ns
+ // prescaler is the SCLK divider, opcode the flash command used, and
+ // mb_per_s / ops_per_s cover successful operations over the wall time of
+ // the whole point.
+
 
 #include <stdio.h>
+#include <stdlib.h>
 #include "platform.h"
 #include "xil_printf.h"
 #include "pld_qspi.h"
+#include "pld_qspi_sfdp.h"
+#include "pld_qspi_cache.h"
+#include "pld_qspi_queue.h"
+#include "pld_qspi_crc.h"
+#include "pld_qspi_pipe.h"
+#include "pld_qspi_log.h"
+#include "pld_qspi_kv.h"
+#include "pld_qspi_comp.h"
+#include "pld_qspi_boot.h"
 #include "xparameters.h"
 #include "xqspips.h"
+#include "xtime_l.h"
+#include "sleep.h"
 #include <string.h>
 
-// Define buffer sizes and test parameters
-#define BUFFER_SIZE 256
-#define TEST_ADDRESS 0x100000 // Starting address for test
-// #define TEST_ADDRESS 0x000000  // CHECK test at 0x000000 instead of 0x100000 to see if data is maybe at the beginning
-#define TEST_PATTERN_START 0xAA // Starting value for test pattern
-
-// QSPI Flash commands
-#define QUAD_READ_CMD		0x6B
-#define READ_ID_CMD			0x9F
-#define WRITE_ENABLE_CMD	0x06
-
-// Buffer offsets
-#define COMMAND_OFFSET		0
-#define ADDRESS_1_OFFSET	1
-#define ADDRESS_2_OFFSET	2
-#define ADDRESS_3_OFFSET	3
-#define DATA_OFFSET			4
-#define DUMMY_OFFSET		4
-#define DUMMY_SIZE			1
-#define OVERHEAD_SIZE		4
-#define RD_ID_SIZE			4
-
-// Flash identification (global variables)
-u32 QspiFlashSize = 0;
-u32 QspiFlashMake = 0;
-
-// Flash manufacturer IDs
-#define MICRON_ID           0x20
-#define SPANSION_ID         0x01
-#define WINBOND_ID          0xEF
-#define MACRONIX_ID         0xC2
-#define ISSI_ID             0x9D
-
-// Flash size definitions
-#define FLASH_SIZE_ID_8M    0x13
-#define FLASH_SIZE_ID_16M   0x14
-#define FLASH_SIZE_ID_32M   0x15
-#define FLASH_SIZE_ID_64M   0x16
-#define FLASH_SIZE_ID_128M  0x17
-#define FLASH_SIZE_ID_256M  0x18
-#define FLASH_SIZE_ID_512M  0x19
-#define FLASH_SIZE_ID_1G    0x20
-#define FLASH_SIZE_ID_2G    0x21
-
-#define FLASH_SIZE_8M       0x100000      // 8Mbit = 1MB
-#define FLASH_SIZE_16M      0x200000      // 16Mbit = 2MB
-#define FLASH_SIZE_32M      0x400000      // 32Mbit = 4MB
-#define FLASH_SIZE_64M      0x800000      // 64Mbit = 8MB
-#define FLASH_SIZE_128M     0x1000000     // 128Mbit = 16MB
-#define FLASH_SIZE_256M     0x2000000     // 256Mbit = 32MB
-#define FLASH_SIZE_512M     0x4000000     // 512Mbit = 64MB
-#define FLASH_SIZE_1G       0x8000000     // 1Gbit = 128MB
-#define FLASH_SIZE_2G       0x10000000    // 2Gbit = 256MB
+// Flash wiring: PLD_QSPI_CONNECTION_SINGLE, _STACKED or _PARALLEL
+#ifndef TEST_CONNECTION_MODE
+#define TEST_CONNECTION_MODE PLD_QSPI_CONNECTION_SINGLE
+#endif
+
+// Flash range the benchmark reads, programs and erases
+#ifndef BENCH_REGION_ADDRESS
+#define BENCH_REGION_ADDRESS 0x100000
+#endif
+#ifndef BENCH_REGION_SIZE
+#define BENCH_REGION_SIZE 0x100000
+#endif
+
+// Clock the driver opens at, then auto-tunes from against the signature region
+#ifndef TEST_SAFE_PRESCALER
+#define TEST_SAFE_PRESCALER XQSPIPS_CLK_PRESCALE_16
+#endif
+#ifndef TEST_TUNE_ADDRESS
+#define TEST_TUNE_ADDRESS 0x0
+#endif
+#define TEST_TUNE_SIZE 0x1000
+#define TEST_TUNE_PASSES 4
+
+// Sweep axes
+#ifndef BENCH_PRESCALERS
+#define BENCH_PRESCALERS XQSPIPS_CLK_PRESCALE_4, XQSPIPS_CLK_PRESCALE_8, XQSPIPS_CLK_PRESCALE_16
+#endif
+#ifndef BENCH_READ_SIZES
+#define BENCH_READ_SIZES 16, 256, 4096, 65536
+#endif
+#ifndef BENCH_PROGRAM_SIZES
+#define BENCH_PROGRAM_SIZES 16, 256, 4096
+#endif
+
+// Operations per point: enough for BENCH_BYTES_PER_POINT, within the limits
+#define BENCH_BYTES_PER_POINT 0x40000
+#define BENCH_MIN_OPS 8
+#define BENCH_MAX_OPS 256
+#define BENCH_ERASE_OPS 4
+#define BENCH_PROGRAM_SPAN 0x10000 // Erased ahead of each program point
+#define BENCH_STRIDE 0x10000 // Strided reads take one transfer per stride
+#define BENCH_MAX_SIZE 65536
+#define BENCH_MAX_HEADER 6 // Opcode, 4 address bytes and a dummy byte
+#define BENCH_COMMAND_READ 16 // Payload of the small read in the command comparison
+#define BENCH_CRC_OPS 16 // Passes over the buffer per in-memory CRC point
+#define BENCH_IMAGE_SPAN 0x40000 // Partially used image the blank checks scan and erase
+#define BENCH_IMAGE_BLOCK 0x10000
+#define BENCH_UPDATE_EDITS 3 // Bytes changed, in different 4KB sectors, per region update
+#define BENCH_ERASE_READ_SIZE 256 // Reads issued while a background erase runs
+#define BENCH_ERASE_READ_LEAD_US 1000 // Erase run time before the read
+
+// Read cache trace replay: lines in the cache arena, reads in the trace and
+// the share of them that go to the hot tables (the rest are scattered reads)
+#ifndef TEST_CACHE_LINES
+#define TEST_CACHE_LINES 32
+#endif
+#define TEST_TRACE_READS 2048
+#define TEST_TRACE_HOT_PERCENT 80
+#define TEST_TRACE_HOT_TABLES 6
+
+// Request queue load test: one step submits on this schedule, then issues
+// one queued command. Urgent config reads, bursts of adjacent bulk reads and
+// a background log writer, which together keep the flash about 95% busy.
+#define TEST_QUEUE_STEPS 512
+#define TEST_QUEUE_URGENT_EVERY 3
+#define TEST_QUEUE_URGENT_SIZE 64
+#define TEST_QUEUE_URGENT_DEADLINE_US 2000
+#define TEST_QUEUE_BURST_EVERY 8
+#define TEST_QUEUE_BURST_READS 4
+#define TEST_QUEUE_BULK_SIZE 256
+#define TEST_QUEUE_LOG_EVERY 32
+#define TEST_QUEUE_LOG_SIZE 4096
+#define TEST_QUEUE_SLOTS 16 // Requests in flight per class
+
+// Acquisition pipeline: a sample generator logs through the ping-pong
+// buffers at each rate in turn, to find the highest rate with no overruns
+#define TEST_PIPE_RATES 64, 128, 256, 384, 448, 512, 640 // KB/s
+#define TEST_PIPE_CHUNK 512 // Bytes per generated sample block
+#define TEST_PIPE_BYTES 0x20000 // Logged per rate, erased beforehand
+#define TEST_PIPE_BUFFER 4096
+#define TEST_PIPE_BUFFERS 2
+#define TEST_PIPE_POLL_US 20 // Generator idle step between pipeline services
+
+// Record store: formatted over the benchmark region in segments of
+// TEST_LOG_SEGMENT. Appends of each size go to a freshly formatted store,
+// the churn then rewrites a small set of records with background compaction.
+// Power cuts follow on a store of TEST_LOG_CUT_SEGMENTS segments holding the
+// churn's records: an update is synced, the store serviced from none up to
+// TEST_LOG_CUT_SERVICES times, then remounted as after a reboot with every
+// record checked.
+#define TEST_LOG_SEGMENT 0x10000
+#define TEST_LOG_SIZES 32, 256, 1024
+#define TEST_LOG_RECORDS 256 // Record Ids in the index
+#define TEST_LOG_MOUNTS 8
+#define TEST_LOG_CHURN 2048 // Updates in the churn run, about two laps of the region
+#define TEST_LOG_CHURN_IDS 64
+#define TEST_LOG_CHURN_SIZE 1024
+#define TEST_LOG_CUT_SEGMENTS 4 // Small enough for every lap to copy the records not updated
+#define TEST_LOG_CUTS 256
+#define TEST_LOG_CUT_SERVICES 160 // Past the compaction of a whole segment, parallel flashes included
+
+// Parameter store: TEST_KV_KEYS named parameters in a record store over the
+// benchmark region, the last TEST_KV_TABLES of them 64-byte tables and the
+// rest 4-byte values, updated round robin TEST_KV_UPDATES times
+#define TEST_KV_KEYS 64
+#define TEST_KV_TABLES 16
+#define TEST_KV_TABLE_SIZE 64
+#define TEST_KV_SLOTS 128 // Hash table slots, twice the keys
+#define TEST_KV_UPDATES 10000
+
+// Compression: a synthetic detector stream of 16-bit samples, a noisy
+// baseline with decaying pulses, coded in blocks and logged through the
+// pipeline against the same stream logged uncompressed
+#define TEST_COMP_BYTES 0x40000
+#define TEST_COMP_BLOCK 4096
+#define TEST_COMP_CHUNK 512 // Bytes handed to the stage at a time
+#define TEST_COMP_BASELINE 1000
+#define TEST_COMP_NOISE 5 // Baseline noise, peak to peak counts
+#define TEST_COMP_PULSE_EVERY 400 // Samples between pulses, on average
+
+// Boot image: a TEST_BOOT_SIZE image and its redundant copy, each in
+// TEST_BOOT_SPAN bytes of flash outside the benchmark region, loaded from a
+// cold start (opening clock, not tuned) against a chain of small reads
+#define TEST_BOOT_SIZE 0x400000
+#define TEST_BOOT_SPAN 0x410000 // Header and image, rounded up to erase blocks
+#define TEST_BOOT_PRIMARY 0x400000
+#define TEST_BOOT_SECONDARY 0x900000
+#define TEST_BOOT_CHAIN 256 // Read size of the chained loader
+
+#define BENCH_QUEUE_URGENT 0
+#define BENCH_QUEUE_BULK 1
+#define BENCH_QUEUE_LOG 2
+#define BENCH_QUEUE_CLASSES 3
+
+#define BENCH_MAX_COUNT(A, B) (((A) > (B)) ? (A) : (B))
+#define BENCH_MAX_SAMPLES BENCH_MAX_COUNT(BENCH_MAX_COUNT(TEST_KV_UPDATES, TEST_BOOT_SIZE / TEST_BOOT_CHAIN), \
+                                          BENCH_MAX_COUNT(TEST_TRACE_READS, BENCH_MAX_OPS))
+
+// Access patterns
+#define BENCH_SEQUENTIAL 0
+#define BENCH_RANDOM 1
+#define BENCH_STRIDED 2
+#define BENCH_PATTERNS 3
+
+typedef struct {
+    u8 Cmd;                 // 3 byte address opcode
+    u8 Cmd4;                // 4 byte address opcode
+    u8 DummyBytes;
+} BenchOpcode_t;
+
+static const char *BenchPatternNames[BENCH_PATTERNS] = { "sequential", "random", "strided" };
+
+// Single lane address reads the controller can clock in I/O mode
+static const BenchOpcode_t BenchOpcodes[] = {
+    { PLD_QSPI_CMD_READ, PLD_QSPI_CMD_READ_4B, 0 },
+    { PLD_QSPI_CMD_FAST_READ, PLD_QSPI_CMD_FAST_READ_4B, 1 },
+    { PLD_QSPI_CMD_DUAL_READ, PLD_QSPI_CMD_DUAL_READ_4B, 1 },
+    { PLD_QSPI_CMD_QUAD_READ, PLD_QSPI_CMD_QUAD_READ_4B, 1 },
+};
+
+// SFDP space read back from real parts, 0xFF between the tables as on the flash.
+// The Spansion, Macronix and ISSI dumps are as their datasheets list them.
+// Each must parse, on top of its part table entry, to the description after it.
+static const u8 TestSfdpW25q128jv[] = { // JESD216A, 16 DWORD basic table
+    0x53, 0x46, 0x44, 0x50, 0x05, 0x01, 0x00, 0xFF, 0x00, 0x05, 0x01, 0x10, 0x80, 0x00, 0x00, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xE5, 0x20, 0xF9, 0xFF, 0xFF, 0xFF, 0xFF, 0x07, 0x44, 0xEB, 0x08, 0x6B, 0x08, 0x3B, 0x42, 0xBB,
+    0xFE, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0x00, 0x00, 0xFF, 0xFF, 0x40, 0xEB, 0x0C, 0x20, 0x0F, 0x52,
+    0x10, 0xD8, 0x00, 0x00, 0x36, 0x02, 0xA6, 0x00, 0x82, 0xEA, 0x14, 0xC9, 0xE9, 0x63, 0x76, 0x33,
+    0x7A, 0x75, 0x7A, 0x75, 0xF7, 0xA2, 0xD5, 0x5C, 0x19, 0xF7, 0x4D, 0xFF, 0xE9, 0x30, 0xF8, 0x80,
+};
+
+static const u8 TestSfdpN25q128[] = {   // JESD216, 9 DWORD basic table without timings
+    0x53, 0x46, 0x44, 0x50, 0x00, 0x01, 0x00, 0xFF, 0x00, 0x00, 0x01, 0x09, 0x30, 0x00, 0x00, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xE5, 0x20, 0xFB, 0xFF, 0xFF, 0xFF, 0xFF, 0x07, 0x29, 0xEB, 0x27, 0x6B, 0x27, 0x3B, 0x27, 0xBB,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0x27, 0xBB, 0xFF, 0xFF, 0x29, 0xEB, 0x0C, 0x20, 0x10, 0xD8,
+    0x00, 0x00, 0x00, 0x00,
+};
+
+static const u8 TestSfdpS25fl164k[] = {  // JESD216, 9 DWORD basic table at 0x80
+    0x53, 0x46, 0x44, 0x50, 0x00, 0x01, 0x00, 0xFF, 0x00, 0x00, 0x01, 0x09, 0x80, 0x00, 0x00, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xE5, 0x20, 0xF1, 0xFF, 0xFF, 0xFF, 0xFF, 0x03, 0x44, 0xEB, 0x08, 0x6B, 0x08, 0x3B, 0x80, 0xBB,
+    0xFE, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0x44, 0xEB, 0x0C, 0x20, 0x0F, 0x52,
+    0x10, 0xD8, 0x00, 0xFF,
+};
+
+static const u8 TestSfdpMx25l12835f[] = { // JESD216, 9 DWORD basic table and the Macronix table
+    0x53, 0x46, 0x44, 0x50, 0x00, 0x01, 0x01, 0xFF, 0x00, 0x00, 0x01, 0x09, 0x30, 0x00, 0x00, 0xFF,
+    0xC2, 0x00, 0x01, 0x04, 0x60, 0x00, 0x00, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xE5, 0x20, 0xF1, 0xFF, 0xFF, 0xFF, 0xFF, 0x07, 0x44, 0xEB, 0x08, 0x6B, 0x08, 0x3B, 0x04, 0xBB,
+    0xFE, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0x00, 0xFF, 0xFF, 0xFF, 0x44, 0xEB, 0x0C, 0x20, 0x0F, 0x52,
+    0x10, 0xD8, 0x00, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0x00, 0x36, 0x00, 0x27, 0xF4, 0x4F, 0xFF, 0xFF, 0xD9, 0xC8, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+};
+
+static const u8 TestSfdpIs25lp128[] = {  // JESD216, 9 DWORD basic table
+    0x53, 0x46, 0x44, 0x50, 0x00, 0x01, 0x00, 0xFF, 0x00, 0x00, 0x01, 0x09, 0x30, 0x00, 0x00, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xE5, 0x20, 0xF9, 0xFF, 0xFF, 0xFF, 0xFF, 0x07, 0x44, 0xEB, 0x08, 0x6B, 0x08, 0x3B, 0x80, 0xBB,
+    0xFE, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0x44, 0xEB, 0x0C, 0x20, 0x0F, 0x52,
+    0x10, 0xD8, 0x00, 0xFF,
+};
+
+typedef struct {
+    const u8 *Sfdp;
+    u32 Length;
+    PLD_QSPI_Flash_t Flash;             // Expected description, JedecId picks the part table entry
+} TestSfdpDump_t;
+
+static const TestSfdpDump_t TestSfdpDumps[] = {
+    { TestSfdpW25q128jv, sizeof(TestSfdpW25q128jv), {
+        .Name = "w25q128jv", .JedecId = { PLD_QSPI_MFR_WINBOND, 0x40, 0x18 }, .SfdpRevision = 0x0105,
+        .Size = 0x1000000, .PageSize = 256,
+        .ReadCmd = PLD_QSPI_CMD_QUAD_READ, .ReadDummyBytes = 1,
+        .LinearReadCmd = PLD_QSPI_CMD_QUAD_IO_READ, .LinearDummyBytes = 3,
+        .AddressMode = PLD_QSPI_ADDR_3BYTE,
+        .ProgramCmd = PLD_QSPI_CMD_PAGE_PROGRAM, .ProgramTimeUs = 704, .ProgramTimeMaxUs = 4224,
+        .Erase = { { 0x1000, PLD_QSPI_CMD_ERASE_4K, 64000, 896000 },
+                   { 0x8000, PLD_QSPI_CMD_ERASE_32K, 128000, 1792000 },
+                   { 0x10000, PLD_QSPI_CMD_ERASE_64K, 160000, 2240000 } },
+        .EraseTypes = 3, .ChipEraseTimeUs = 40000000, .ChipEraseTimeMaxUs = 560000000,
+        .SuspendCmd = PLD_QSPI_CMD_SUSPEND, .ResumeCmd = PLD_QSPI_CMD_RESUME,
+        .SuspendTimeUs = 20, .ResumeIntervalUs = 512,
+    } },
+    { TestSfdpN25q128, sizeof(TestSfdpN25q128), {
+        .Name = "n25q128", .JedecId = { PLD_QSPI_MFR_MICRON, 0xBA, 0x18 }, .SfdpRevision = 0x0100,
+        .Size = 0x1000000, .PageSize = 256,
+        .ReadCmd = PLD_QSPI_CMD_QUAD_READ, .ReadDummyBytes = 1,
+        .LinearReadCmd = PLD_QSPI_CMD_QUAD_IO_READ, .LinearDummyBytes = 5,
+        .AddressMode = PLD_QSPI_ADDR_3BYTE,
+        .ProgramCmd = PLD_QSPI_CMD_PAGE_PROGRAM, .ProgramTimeUs = 500, .ProgramTimeMaxUs = 5000,
+        .Erase = { { 0x1000, PLD_QSPI_CMD_ERASE_4K, 250000, 800000 },
+                   { 0x10000, PLD_QSPI_CMD_ERASE_64K, 700000, 3000000 } },
+        .EraseTypes = 2, .ChipEraseTimeUs = 170000000, .ChipEraseTimeMaxUs = 250000000,
+        .SuspendCmd = PLD_QSPI_CMD_SUSPEND, .ResumeCmd = PLD_QSPI_CMD_RESUME,
+        .SuspendTimeUs = 30, .ResumeIntervalUs = 64,
+    } },
+    { TestSfdpS25fl164k, sizeof(TestSfdpS25fl164k), {
+        .Name = "s25fl164k", .JedecId = { PLD_QSPI_MFR_SPANSION, 0x40, 0x17 }, .SfdpRevision = 0x0100,
+        .Size = 0x800000, .PageSize = 256,
+        .ReadCmd = PLD_QSPI_CMD_QUAD_READ, .ReadDummyBytes = 1,
+        .LinearReadCmd = PLD_QSPI_CMD_QUAD_IO_READ, .LinearDummyBytes = 3,
+        .AddressMode = PLD_QSPI_ADDR_3BYTE,
+        .ProgramCmd = PLD_QSPI_CMD_PAGE_PROGRAM, .ProgramTimeUs = 700, .ProgramTimeMaxUs = 3000,
+        .Erase = { { 0x1000, PLD_QSPI_CMD_ERASE_4K, 50000, 450000 },
+                   { 0x8000, PLD_QSPI_CMD_ERASE_32K, 300000, 1300000 },
+                   { 0x10000, PLD_QSPI_CMD_ERASE_64K, 500000, 2000000 } },
+        .EraseTypes = 3, .ChipEraseTimeUs = 30000000, .ChipEraseTimeMaxUs = 100000000,
+        .SuspendCmd = PLD_QSPI_CMD_SUSPEND, .ResumeCmd = PLD_QSPI_CMD_RESUME,
+        .SuspendTimeUs = 40, .ResumeIntervalUs = 128,
+    } },
+    { TestSfdpMx25l12835f, sizeof(TestSfdpMx25l12835f), {
+        .Name = "mx25l12835f", .JedecId = { PLD_QSPI_MFR_MACRONIX, 0x20, 0x18 }, .SfdpRevision = 0x0100,
+        .Size = 0x1000000, .PageSize = 256,
+        .ReadCmd = PLD_QSPI_CMD_QUAD_READ, .ReadDummyBytes = 1,
+        .LinearReadCmd = PLD_QSPI_CMD_QUAD_IO_READ, .LinearDummyBytes = 3,
+        .AddressMode = PLD_QSPI_ADDR_3BYTE,
+        .ProgramCmd = PLD_QSPI_CMD_PAGE_PROGRAM, .ProgramTimeUs = 330, .ProgramTimeMaxUs = 1200,
+        .Erase = { { 0x1000, PLD_QSPI_CMD_ERASE_4K, 30000, 120000 },
+                   { 0x8000, PLD_QSPI_CMD_ERASE_32K, 150000, 650000 },
+                   { 0x10000, PLD_QSPI_CMD_ERASE_64K, 280000, 2000000 } },
+        .EraseTypes = 3, .ChipEraseTimeUs = 50000000, .ChipEraseTimeMaxUs = 150000000,
+        .SuspendCmd = PLD_QSPI_CMD_SUSPEND_ALT, .ResumeCmd = PLD_QSPI_CMD_RESUME_ALT,
+        .SuspendTimeUs = 20, .ResumeIntervalUs = 320,
+    } },
+    { TestSfdpIs25lp128, sizeof(TestSfdpIs25lp128), {
+        .Name = "is25lp128", .JedecId = { PLD_QSPI_MFR_ISSI, 0x60, 0x18 }, .SfdpRevision = 0x0100,
+        .Size = 0x1000000, .PageSize = 256,
+        .ReadCmd = PLD_QSPI_CMD_QUAD_READ, .ReadDummyBytes = 1,
+        .LinearReadCmd = PLD_QSPI_CMD_QUAD_IO_READ, .LinearDummyBytes = 3,
+        .AddressMode = PLD_QSPI_ADDR_3BYTE,
+        .ProgramCmd = PLD_QSPI_CMD_PAGE_PROGRAM, .ProgramTimeUs = 200, .ProgramTimeMaxUs = 700,
+        .Erase = { { 0x1000, PLD_QSPI_CMD_ERASE_4K, 70000, 300000 },
+                   { 0x8000, PLD_QSPI_CMD_ERASE_32K, 100000, 500000 },
+                   { 0x10000, PLD_QSPI_CMD_ERASE_64K, 150000, 1000000 } },
+        .EraseTypes = 3, .ChipEraseTimeUs = 45000000, .ChipEraseTimeMaxUs = 180000000,
+        .SuspendCmd = PLD_QSPI_CMD_SUSPEND, .ResumeCmd = PLD_QSPI_CMD_RESUME,
+        .SuspendTimeUs = 100, .ResumeIntervalUs = 128,
+    } },
+};
+
+typedef struct {
+    PLD_QSPI_QueueReq_t Req;
+    u32 Class;
+    u64 SubmitNs;
+    u8 Data[TEST_QUEUE_BULK_SIZE];
+} BenchQueueSlot_t;
+
+static u8 BenchBuffer[BENCH_MAX_SIZE];
+static u8 BenchFrame[BENCH_MAX_HEADER + BENCH_MAX_SIZE];
+static u32 BenchSamples[BENCH_MAX_SAMPLES];
+
+static BenchQueueSlot_t BenchQueueSlots[BENCH_QUEUE_CLASSES][TEST_QUEUE_SLOTS];
+static u32 BenchQueueSamples[BENCH_QUEUE_CLASSES][TEST_QUEUE_STEPS];
+static u32 BenchQueueGood[BENCH_QUEUE_CLASSES];
+static u32 BenchQueueErrors[BENCH_QUEUE_CLASSES];
+
+/**
+ * Nanoseconds on the global timer
+ */
+static u64 BenchNowNs(void)
+{
+    XTime Now;
+
+    XTime_GetTime(&Now);
+    return (Now / COUNTS_PER_SECOND) * 1000000000ULL + ((Now % COUNTS_PER_SECOND) * 1000000000ULL) / COUNTS_PER_SECOND;
+}
+
+/**
+ * qsort comparison for latency samples
+ */
+static int BenchCompare(const void *A, const void *B)
+{
+    u32 Left = *(const u32 *)A;
+    u32 Right = *(const u32 *)B;
+
+    return (Left > Right) - (Left < Right);
+}
+
+/**
+ * Time one operation into the sample buffer, saturating at ~4.3 s
+ */
+static void BenchSample(u32 Index, u64 StartNs)
+{
+    u64 Ns = BenchNowNs() - StartNs;
+
+    BenchSamples[Index] = (Ns > 0xFFFFFFFFULL) ? 0xFFFFFFFFU : (u32)Ns;
+}
+
+/**
+ * Print one CSV row from the samples of a sweep point
+ */
+static void BenchRow(const char *Op, u32 Prescaler, u32 Opcode, const char *Pattern, u32 Size,
+                     u32 Ops, u32 Errors, u64 ElapsedNs)
+{
+    u32 Good = Ops - Errors;
+    u64 Bytes = (u64)Good * Size;
+    u32 MilliMBps = 0;
+    u32 OpsPerSec = 0;
+    u32 P50 = 0;
+    u32 P99 = 0;
+
+    if (ElapsedNs != 0) {
+        MilliMBps = (u32)((Bytes * 1000000ULL) / ElapsedNs);
+        OpsPerSec = (u32)(((u64)Good * 1000000000ULL) / ElapsedNs);
+    }
+
+    if (Good != 0) {
+        qsort(BenchSamples, Good, sizeof(BenchSamples[0]), BenchCompare);
+        P50 = BenchSamples[((Good - 1) * 50) / 100];
+        P99 = BenchSamples[((Good - 1) * 99) / 100];
+    }
+
+    xil_printf("%s,%d,0x%02x,%s,%d,%d,%d,%d,%d.%03d,%d,%d,%d\r\n", Op, 2 << Prescaler, Opcode, Pattern,
+               Size, Ops, Errors, (u32)Bytes, MilliMBps / 1000, MilliMBps % 1000, OpsPerSec, P50, P99);
+}
+
+/**
+ * Address of operation Index of a pattern over the benchmark region
+ * Size and the region are powers of two, so every access stays inside it.
+ */
+static u32 BenchAddress(u32 Pattern, u32 Index, u32 Size, u32 *SeedPtr)
+{
+    u32 Stride = (Size < BENCH_STRIDE) ? BENCH_STRIDE : 2 * Size;
+
+    if (Pattern == BENCH_RANDOM) {
+        *SeedPtr = *SeedPtr * 1103515245U + 12345U;
+        return BENCH_REGION_ADDRESS + ((*SeedPtr >> 8) % (BENCH_REGION_SIZE / Size)) * Size;
+    }
+
+    if (Pattern == BENCH_STRIDED) {
+        return BENCH_REGION_ADDRESS + (Index * Stride) % BENCH_REGION_SIZE;
+    }
+
+    return BENCH_REGION_ADDRESS + (Index * Size) % BENCH_REGION_SIZE;
+}
+
+/**
+ * Operations for a point moving Size bytes each
+ */
+static u32 BenchOps(u32 Size)
+{
+    u32 Ops = BENCH_BYTES_PER_POINT / Size;
+
+    if (Ops < BENCH_MIN_OPS) {
+        return BENCH_MIN_OPS;
+    }
+
+    return (Ops > BENCH_MAX_OPS) ? BENCH_MAX_OPS : Ops;
+}
+
+/**
+ * Sweep read opcode, size and pattern at the current prescaler
+ */
+void BenchReads(PLD_QSPI_t *QspiInstancePtr, u32 Prescaler)
+{
+    static const u32 Sizes[] = { BENCH_READ_SIZES };
+    PLD_QSPI_Flash_t *Flash = &QspiInstancePtr->Flash;
+    u8 ReadCmd = Flash->ReadCmd;
+    u8 ReadDummyBytes = Flash->ReadDummyBytes;
+    u32 Opcode;
+    u32 SizeIndex;
+    u32 Pattern;
+    u32 Ops;
+    u32 Errors;
+    u32 Seed;
+    u32 i;
+    u64 Start;
+    u64 OpStart;
+
+    for (Opcode = 0; Opcode < sizeof(BenchOpcodes) / sizeof(BenchOpcodes[0]); Opcode++) {
+        Flash->ReadCmd = (Flash->AddressMode == PLD_QSPI_ADDR_4BYTE) ? BenchOpcodes[Opcode].Cmd4 : BenchOpcodes[Opcode].Cmd;
+        Flash->ReadDummyBytes = BenchOpcodes[Opcode].DummyBytes;
+
+        for (SizeIndex = 0; SizeIndex < sizeof(Sizes) / sizeof(Sizes[0]); SizeIndex++) {
+            for (Pattern = 0; Pattern < BENCH_PATTERNS; Pattern++) {
+                Ops = BenchOps(Sizes[SizeIndex]);
+                Errors = 0;
+                Seed = 12345;
+
+                Start = BenchNowNs();
+                for (i = 0; i < Ops; i++) {
+                    OpStart = BenchNowNs();
+                    if (PLD_QSPI_Read(QspiInstancePtr, BenchAddress(Pattern, i, Sizes[SizeIndex], &Seed),
+                                      BenchBuffer, Sizes[SizeIndex]) != XST_SUCCESS) {
+                        Errors++;
+                        continue;
+                    }
+                    BenchSample(i - Errors, OpStart);
+                }
+
+                BenchRow("read", Prescaler, Flash->ReadCmd, BenchPatternNames[Pattern], Sizes[SizeIndex],
+                         Ops, Errors, BenchNowNs() - Start);
+            }
+        }
+    }
+
+    // Back to the read mode identification picked
+    Flash->ReadCmd = ReadCmd;
+    Flash->ReadDummyBytes = ReadDummyBytes;
+}
+
+/**
+ * Program sequentially through a freshly erased span, per program size
+ */
+void BenchPrograms(PLD_QSPI_t *QspiInstancePtr, u32 Prescaler)
+{
+    static const u32 Sizes[] = { BENCH_PROGRAM_SIZES };
+    u32 SizeIndex;
+    u32 Size;
+    u32 Ops;
+    u32 Errors;
+    u32 i;
+    u64 Start;
+    u64 OpStart;
+
+    for (i = 0; i < BENCH_MAX_SIZE; i++) {
+        BenchBuffer[i] = (u8)(i * 7 + 3);
+    }
+
+    for (SizeIndex = 0; SizeIndex < sizeof(Sizes) / sizeof(Sizes[0]); SizeIndex++) {
+        Size = Sizes[SizeIndex];
+        Ops = BENCH_PROGRAM_SPAN / Size;
+        if (Ops > BENCH_MAX_OPS) {
+            Ops = BENCH_MAX_OPS;
+        }
+        Errors = 0;
+
+        if (PLD_QSPI_EraseRange(QspiInstancePtr, BENCH_REGION_ADDRESS, BENCH_PROGRAM_SPAN) != XST_SUCCESS) {
+            xil_printf("# program %d: erase failed\r\n", Size);
+            continue;
+        }
+
+        Start = BenchNowNs();
+        for (i = 0; i < Ops; i++) {
+            OpStart = BenchNowNs();
+            if (PLD_QSPI_Write(QspiInstancePtr, BENCH_REGION_ADDRESS + i * Size, BenchBuffer, Size) != XST_SUCCESS) {
+                Errors++;
+                continue;
+            }
+            BenchSample(i - Errors, OpStart);
+        }
+
+        BenchRow("program", Prescaler, QspiInstancePtr->Flash.ProgramCmd, BenchPatternNames[BENCH_SEQUENTIAL],
+                 Size, Ops, Errors, BenchNowNs() - Start);
+    }
+}
+
+/**
+ * Checksum of a read, to compare the two staging modes without a second buffer
+ */
+static u32 BenchChecksum(const u8 *Data, u32 Length)
+{
+    u32 Hash = 2166136261U;
+    u32 i;
+
+    for (i = 0; i < Length; i++) {
+        Hash = (Hash ^ Data[i]) * 16777619U;
+    }
+
+    return Hash;
+}
+
+/**
+ * Build the read header the driver would send for Address on a single flash
+ */
+static u32 BenchReadHeader(PLD_QSPI_Flash_t *Flash, u32 Address, u8 *Header)
+{
+    u32 HeaderLength = 0;
+
+    Header[HeaderLength++] = Flash->ReadCmd;
+    if (Flash->AddressMode == PLD_QSPI_ADDR_4BYTE) {
+        Header[HeaderLength++] = (u8)(Address >> 24);
+    }
+    Header[HeaderLength++] = (u8)(Address >> 16);
+    Header[HeaderLength++] = (u8)(Address >> 8);
+    Header[HeaderLength++] = (u8)Address;
+    if (Flash->ReadDummyBytes > 0) {
+        Header[HeaderLength++] = 0xFF;
+    }
+
+    return HeaderLength;
+}
+
+/**
+ * Time the small commands issued thousands of times a second (write enable,
+ * status, ID and a short read) three ways: through XQspiPs_PolledTransfer
+ * the way PLD_QSPI_Transfer used to, through PLD_QSPI_Transfer (the
+ * driver's FIFO engine), and through the driver call built on a fixed
+ * layout variant where one exists
+ */
+void BenchCommands(PLD_QSPI_t *QspiInstancePtr, u32 Prescaler)
+{
+    static const char *ModeNames[3] = { "cmd_xqspips", "cmd_engine", "cmd_fixed" };
+    static const char *CommandNames[4] = { "wren", "status", "id", "read16" };
+    PLD_QSPI_Flash_t *Flash = &QspiInstancePtr->Flash;
+    u8 Frame[BENCH_MAX_HEADER + BENCH_COMMAND_READ];
+    u8 Opcodes[4] = { PLD_QSPI_CMD_WRITE_ENABLE, PLD_QSPI_CMD_READ_STATUS, PLD_QSPI_CMD_READ_ID, Flash->ReadCmd };
+    u32 Lengths[4] = { 1, 2, 4, 0 };
+    u32 HeaderLength;
+    u32 Command;
+    u32 Mode;
+    u32 Errors;
+    u32 i;
+    u64 Start;
+    u64 OpStart;
+    XStatus Status;
+
+    if (QspiInstancePtr->ConnectionMode != PLD_QSPI_CONNECTION_SINGLE) {
+        xil_printf("# commands: single flash only\r\n");
+        return;
+    }
+
+    HeaderLength = BenchReadHeader(Flash, BENCH_REGION_ADDRESS, Frame);
+    Lengths[3] = HeaderLength + BENCH_COMMAND_READ;
+
+    for (Command = 0; Command < 4; Command++) {
+        for (Mode = 0; Mode < 3; Mode++) {
+            // ID reads have no driver call of their own
+            if (Mode == 2 && Opcodes[Command] == PLD_QSPI_CMD_READ_ID) {
+                continue;
+            }
+            Errors = 0;
+
+            Start = BenchNowNs();
+            for (i = 0; i < BENCH_MAX_OPS; i++) {
+                // The frame is received in place, rebuild it every time
+                if (Command == 3) {
+                    BenchReadHeader(Flash, BENCH_REGION_ADDRESS, Frame);
+                    memset(&Frame[HeaderLength], 0xFF, BENCH_COMMAND_READ);
+                } else {
+                    Frame[0] = Opcodes[Command];
+                    memset(&Frame[1], 0x00, Lengths[Command] - 1);
+                }
+
+                OpStart = BenchNowNs();
+                if (Mode == 0) {
+                    Status = XQspiPs_SetSlaveSelect(&QspiInstancePtr->Qspi);
+                    if (Status == XST_SUCCESS) {
+                        Status = XQspiPs_PolledTransfer(&QspiInstancePtr->Qspi, Frame, Frame, Lengths[Command]);
+                    }
+                } else if (Mode == 1) {
+                    Status = PLD_QSPI_Transfer(QspiInstancePtr, Frame, Frame, Lengths[Command]);
+                } else if (Command == 0) {
+                    Status = PLD_QSPI_WriteEnable(QspiInstancePtr);
+                } else if (Command == 1) {
+                    Status = PLD_QSPI_ReadStatus(QspiInstancePtr, &Frame[1]);
+                } else {
+                    Status = PLD_QSPI_Read(QspiInstancePtr, BENCH_REGION_ADDRESS, &Frame[HeaderLength], BENCH_COMMAND_READ);
+                }
+                if (Status != XST_SUCCESS) {
+                    Errors++;
+                    continue;
+                }
+                BenchSample(i - Errors, OpStart);
+            }
+
+            BenchRow(ModeNames[Mode], Prescaler, Opcodes[Command], CommandNames[Command], Lengths[Command],
+                     BENCH_MAX_OPS, Errors, BenchNowNs() - Start);
+        }
+    }
+}
+
+/**
+ * Read each size the way callers did before PLD_QSPI_TransferV, through
+ * one frame holding command, address and payload with the payload copied
+ * out, then as a header segment plus a payload segment received in place.
+ * Both put the same bytes on the bus; the second copies none.
+ */
+void BenchStaging(PLD_QSPI_t *QspiInstancePtr, u32 Prescaler)
+{
+    static const u32 Sizes[] = { BENCH_READ_SIZES };
+    PLD_QSPI_Flash_t *Flash = &QspiInstancePtr->Flash;
+    PLD_QSPI_Segment_t Segments[2];
+    u8 Header[BENCH_MAX_HEADER];
+    u32 HeaderLength;
+    u32 Address;
+    u32 Checksum[BENCH_MAX_OPS];
+    u64 Copied = 0;
+    u32 Mismatches = 0;
+    u32 SizeIndex;
+    u32 Size;
+    u32 Mode;
+    u32 Ops;
+    u32 Errors;
+    u32 i;
+    u64 Start;
+    u64 OpStart;
+    XStatus Status;
+
+    // Parallel and stacked pairs need the driver's address mapping
+    if (QspiInstancePtr->ConnectionMode != PLD_QSPI_CONNECTION_SINGLE) {
+        xil_printf("# staging: single flash only\r\n");
+        return;
+    }
+
+    for (SizeIndex = 0; SizeIndex < sizeof(Sizes) / sizeof(Sizes[0]); SizeIndex++) {
+        Size = Sizes[SizeIndex];
+        Ops = BenchOps(Size);
+
+        for (Mode = 0; Mode < 2; Mode++) {
+            Errors = 0;
+
+            Start = BenchNowNs();
+            for (i = 0; i < Ops; i++) {
+                Address = BenchAddress(BENCH_SEQUENTIAL, i, Size, &Errors);
+                HeaderLength = BenchReadHeader(Flash, Address, Header);
+
+                OpStart = BenchNowNs();
+                if (Mode == 0) {
+                    memcpy(BenchFrame, Header, HeaderLength);
+                    memset(&BenchFrame[HeaderLength], 0xFF, Size);
+                    Status = PLD_QSPI_Transfer(QspiInstancePtr, BenchFrame, BenchFrame, HeaderLength + Size);
+                    memcpy(BenchBuffer, &BenchFrame[HeaderLength], Size);
+                    Copied += HeaderLength + 2ULL * Size;
+                } else {
+                    Segments[0].Tx = Header;
+                    Segments[0].Rx = NULL;
+                    Segments[0].Length = HeaderLength;
+                    Segments[1].Tx = NULL;
+                    Segments[1].Rx = BenchBuffer;
+                    Segments[1].Length = Size;
+                    Status = PLD_QSPI_TransferV(QspiInstancePtr, Segments, 2);
+                }
+                if (Status != XST_SUCCESS) {
+                    Errors++;
+                    continue;
+                }
+                BenchSample(i - Errors, OpStart);
+
+                if (Mode == 0) {
+                    Checksum[i] = BenchChecksum(BenchBuffer, Size);
+                } else if (Checksum[i] != BenchChecksum(BenchBuffer, Size)) {
+                    Mismatches++;
+                }
+            }
+
+            BenchRow((Mode == 0) ? "staged_read" : "vector_read", Prescaler, Flash->ReadCmd,
+                     BenchPatternNames[BENCH_SEQUENTIAL], Size, Ops, Errors, BenchNowNs() - Start);
+        }
+    }
+
+    xil_printf("# staging: %d KB copied by staged reads, none by vectored, %d mismatches\r\n",
+               (u32)(Copied / 1024), Mismatches);
+}
+
+/**
+ * CRC32C a bit at a time, the loop the tables replace
+ */
+static u32 BenchCrcBitwise(u32 Crc, const u8 *Data, u32 Length)
+{
+    u32 Bit;
+
+    Crc = ~Crc;
+    while (Length-- > 0) {
+        Crc ^= *Data++;
+        for (Bit = 0; Bit < 8; Bit++) {
+            Crc = (Crc >> 1) ^ ((Crc & 1) ? PLD_QSPI_CRC32C_POLY : 0);
+        }
+    }
+
+    return ~Crc;
+}
+
+/**
+ * Time CRC32C in memory, bit at a time against PLD_QSPI_Crc32c, then
+ * checked reads of each size: a read followed by a CRC pass over the
+ * buffer, against PLD_QSPI_ReadVerify folding the CRC into the read
+ */
+void BenchCrc(PLD_QSPI_t *QspiInstancePtr, u32 Prescaler)
+{
+    static const u32 Sizes[] = { BENCH_READ_SIZES };
+    u32 Expected[BENCH_MAX_OPS];
+    u32 Crc[2] = { 0, 0 };
+    u32 Mismatches = 0;
+    u32 SizeIndex;
+    u32 Size;
+    u32 Mode;
+    u32 Ops;
+    u32 Errors;
+    u32 Address;
+    u32 i;
+    u64 Start;
+    u64 OpStart;
+    XStatus Status;
+
+    for (i = 0; i < BENCH_MAX_SIZE; i++) {
+        BenchBuffer[i] = (u8)(i * 31 + 7);
+    }
+
+    for (Mode = 0; Mode < 2; Mode++) {
+        Start = BenchNowNs();
+        for (i = 0; i < BENCH_CRC_OPS; i++) {
+            OpStart = BenchNowNs();
+            if (Mode == 0) {
+                Crc[0] = BenchCrcBitwise(0, BenchBuffer, BENCH_MAX_SIZE);
+            } else {
+                Crc[1] = PLD_QSPI_Crc32c(0, BenchBuffer, BENCH_MAX_SIZE);
+            }
+            BenchSample(i, OpStart);
+        }
+
+        BenchRow((Mode == 0) ? "crc_bitwise" : "crc_slice8", Prescaler, 0, "memory", BENCH_MAX_SIZE,
+                 BENCH_CRC_OPS, 0, BenchNowNs() - Start);
+    }
+
+    if (Crc[0] != Crc[1] || PLD_QSPI_Crc32c(0, (const u8 *)"123456789", 9) != PLD_QSPI_CRC32C_CHECK) {
+        xil_printf("# crc: table and bitwise results differ\r\n");
+        return;
+    }
+
+    for (SizeIndex = 0; SizeIndex < sizeof(Sizes) / sizeof(Sizes[0]); SizeIndex++) {
+        Size = Sizes[SizeIndex];
+        Ops = BenchOps(Size);
+
+        for (Mode = 0; Mode < 2; Mode++) {
+            Errors = 0;
+
+            Start = BenchNowNs();
+            for (i = 0; i < Ops; i++) {
+                Address = BenchAddress(BENCH_SEQUENTIAL, i, Size, &Errors);
+
+                OpStart = BenchNowNs();
+                if (Mode == 0) {
+                    Status = PLD_QSPI_Read(QspiInstancePtr, Address, BenchBuffer, Size);
+                    Expected[i] = PLD_QSPI_Crc32c(0, BenchBuffer, Size);
+                } else {
+                    Status = PLD_QSPI_ReadVerify(QspiInstancePtr, Address, BenchBuffer, Size, Expected[i], NULL);
+                    if (Status == XST_DATA_LOST) {
+                        Mismatches++;
+                    }
+                }
+                if (Status != XST_SUCCESS) {
+                    Errors++;
+                    continue;
+                }
+                BenchSample(i - Errors, OpStart);
+            }
+
+            BenchRow((Mode == 0) ? "verify_two_pass" : "verify_fused", Prescaler, QspiInstancePtr->Flash.ReadCmd,
+                     BenchPatternNames[BENCH_SEQUENTIAL], Size, Ops, Errors, BenchNowNs() - Start);
+        }
+    }
+
+    xil_printf("# crc: %d mismatches between the two checked reads\r\n", Mismatches);
+}
+
+/**
+ * Program a partially used image over BENCH_IMAGE_SPAN: the first block
+ * dirty in every 4KB, the second with one page, the third left erased and
+ * the fourth with a byte in two 4KB sectors
+ */
+static XStatus BenchDirtyImage(PLD_QSPI_t *QspiInstancePtr)
+{
+    u32 Base = BENCH_REGION_ADDRESS;
+    XStatus Status = XST_SUCCESS;
+    u32 i;
+
+    for (i = 0; i < BENCH_IMAGE_BLOCK && Status == XST_SUCCESS; i += 0x1000) {
+        Status = PLD_QSPI_Write(QspiInstancePtr, Base + i + 0x800, BenchBuffer, 256);
+    }
+    if (Status == XST_SUCCESS) {
+        Status = PLD_QSPI_Write(QspiInstancePtr, Base + BENCH_IMAGE_BLOCK + 0x7F00, BenchBuffer, 256);
+    }
+    if (Status == XST_SUCCESS) {
+        Status = PLD_QSPI_Write(QspiInstancePtr, Base + 3 * BENCH_IMAGE_BLOCK, BenchBuffer, 1);
+    }
+    if (Status == XST_SUCCESS) {
+        Status = PLD_QSPI_Write(QspiInstancePtr, Base + 3 * BENCH_IMAGE_BLOCK + 0xAFFF, BenchBuffer, 1);
+    }
+
+    return Status;
+}
+
+/**
+ * Time blank checks of an erased and a partially used image, then erase
+ * the partially used image plainly and with blank checking, where blocks
+ * that read back erased are skipped
+ */
+void BenchBlank(PLD_QSPI_t *QspiInstancePtr, u32 Prescaler)
+{
+    static const char *ScanNames[3] = { "erased", "dirty", "dirty_map" };
+    u32 DirtyMap[BENCH_IMAGE_SPAN / 0x1000 / 32 + 1];
+    u32 Skips = 0;
+    u32 SkippedUs = 0;
+    u32 Blank;
+    u32 Scan;
+    u32 Mode;
+    u32 Errors;
+    u32 i;
+    u64 Start;
+    u64 OpStart;
+    XStatus Status;
+
+    for (i = 0; i < 256; i++) {
+        BenchBuffer[i] = (u8)i;
+    }
+
+    if (PLD_QSPI_EraseRange(QspiInstancePtr, BENCH_REGION_ADDRESS, BENCH_IMAGE_SPAN) != XST_SUCCESS) {
+        xil_printf("# blank: erase failed\r\n");
+        return;
+    }
+
+    // Erased image scanned end to end, then dirty ones stopping early or mapping every sector
+    for (Scan = 0; Scan < 3; Scan++) {
+        if (Scan == 1 && BenchDirtyImage(QspiInstancePtr) != XST_SUCCESS) {
+            xil_printf("# blank: image program failed\r\n");
+            return;
+        }
+        Errors = 0;
+
+        Start = BenchNowNs();
+        for (i = 0; i < BENCH_MIN_OPS; i++) {
+            OpStart = BenchNowNs();
+            Status = PLD_QSPI_IsBlank(QspiInstancePtr, BENCH_REGION_ADDRESS, BENCH_IMAGE_SPAN, &Blank,
+                                      (Scan == 2) ? DirtyMap : NULL);
+            if (Status != XST_SUCCESS || Blank != (Scan == 0)) {
+                Errors++;
+                continue;
+            }
+            BenchSample(i - Errors, OpStart);
+        }
+
+        BenchRow("blank_scan", Prescaler, QspiInstancePtr->Flash.ReadCmd, ScanNames[Scan], BENCH_IMAGE_SPAN,
+                 BENCH_MIN_OPS, Errors, BenchNowNs() - Start);
+    }
+
+    for (Mode = 0; Mode < 2; Mode++) {
+        if (Mode == 1 && BenchDirtyImage(QspiInstancePtr) != XST_SUCCESS) {
+            xil_printf("# blank: image program failed\r\n");
+            return;
+        }
+
+        PLD_QSPI_UseBlankCheck(QspiInstancePtr, Mode);
+        QspiInstancePtr->EraseSkips = 0;
+        QspiInstancePtr->EraseSkippedUs = 0;
+        Errors = 0;
+
+        // A block per operation keeps each sample within the latency range
+        Start = BenchNowNs();
+        for (i = 0; i < BENCH_IMAGE_SPAN / BENCH_IMAGE_BLOCK; i++) {
+            OpStart = BenchNowNs();
+            if (PLD_QSPI_EraseRange(QspiInstancePtr, BENCH_REGION_ADDRESS + i * BENCH_IMAGE_BLOCK,
+                                    BENCH_IMAGE_BLOCK) != XST_SUCCESS) {
+                Errors++;
+                continue;
+            }
+            BenchSample(i - Errors, OpStart);
+        }
+
+        BenchRow("erase_image", Prescaler, QspiInstancePtr->Flash.Erase[QspiInstancePtr->Flash.EraseTypes - 1].Cmd, (Mode == 0) ? "plain" : "blank_check",
+                 BENCH_IMAGE_BLOCK, BENCH_IMAGE_SPAN / BENCH_IMAGE_BLOCK, Errors, BenchNowNs() - Start);
+
+        Skips = QspiInstancePtr->EraseSkips;
+        SkippedUs = (u32)QspiInstancePtr->EraseSkippedUs;
+    }
+    PLD_QSPI_UseBlankCheck(QspiInstancePtr, 0);
+
+    xil_printf("# blank: %d erases skipped, %d ms of typical erase time saved\r\n", Skips, SkippedUs / 1000);
+}
+
+/**
+ * Update a BENCH_IMAGE_BLOCK image: erased and reprogrammed whole, then
+ * through PLD_QSPI_UpdateRegion unchanged, with a few bits cleared and
+ * with a few bits set. The image is put back, untimed, before each update.
+ */
+void BenchUpdate(PLD_QSPI_t *QspiInstancePtr, u32 Prescaler)
+{
+    static const char *Names[4] = { "rewrite", "same", "clear_bits", "set_bits" };
+    static const u32 Edits[BENCH_UPDATE_EDITS] = { 0x0100, 0x5120, 0xC3F0 };
+    PLD_QSPI_Update_t Update;
+    u8 Saved[BENCH_UPDATE_EDITS];
+    u32 Mode;
+    u32 Errors;
+    u32 i;
+    u32 j;
+    u64 Start;
+    u64 OpStart;
+    XStatus Status;
+
+    for (i = 0; i < BENCH_IMAGE_BLOCK; i++) {
+        BenchBuffer[i] = (u8)(i * 7 + 3);
+    }
+    for (j = 0; j < BENCH_UPDATE_EDITS; j++) {
+        Saved[j] = BenchBuffer[Edits[j]];
+    }
+    memset(&Update, 0, sizeof(Update));
+
+    for (Mode = 0; Mode < 4; Mode++) {
+        Errors = 0;
+
+        Start = BenchNowNs();
+        for (i = 0; i < BENCH_ERASE_OPS; i++) {
+            if (PLD_QSPI_UpdateRegion(QspiInstancePtr, BENCH_REGION_ADDRESS, BenchBuffer, BENCH_IMAGE_BLOCK,
+                                      NULL) != XST_SUCCESS) {
+                Errors++;
+                continue;
+            }
+
+            // Clearing a byte's lowest set bit only needs a program, setting its lowest clear bit an erase
+            for (j = 0; j < BENCH_UPDATE_EDITS; j++) {
+                if (Mode == 2) {
+                    BenchBuffer[Edits[j]] &= (u8)(Saved[j] - 1U);
+                } else if (Mode == 3) {
+                    BenchBuffer[Edits[j]] |= (u8)(Saved[j] + 1U);
+                }
+            }
+
+            OpStart = BenchNowNs();
+            if (Mode == 0) {
+                Status = PLD_QSPI_EraseRange(QspiInstancePtr, BENCH_REGION_ADDRESS, BENCH_IMAGE_BLOCK);
+                if (Status == XST_SUCCESS) {
+                    Status = PLD_QSPI_Write(QspiInstancePtr, BENCH_REGION_ADDRESS, BenchBuffer, BENCH_IMAGE_BLOCK);
+                }
+            } else {
+                Status = PLD_QSPI_UpdateRegion(QspiInstancePtr, BENCH_REGION_ADDRESS, BenchBuffer, BENCH_IMAGE_BLOCK,
+                                               &Update);
+            }
+
+            for (j = 0; j < BENCH_UPDATE_EDITS; j++) {
+                BenchBuffer[Edits[j]] = Saved[j];
+            }
+
+            if (Status != XST_SUCCESS) {
+                Errors++;
+                continue;
+            }
+            BenchSample(i - Errors, OpStart);
+        }
+
+        BenchRow("update", Prescaler, QspiInstancePtr->Flash.ProgramCmd, Names[Mode], BENCH_IMAGE_BLOCK,
+                 BENCH_ERASE_OPS, Errors, BenchNowNs() - Start);
+
+        if (Mode != 0) {
+            xil_printf("# update %s: %d sectors same, %d programmed, %d erased, %d bytes programmed\r\n",
+                       Names[Mode], Update.SectorsSame, Update.SectorsProgrammed, Update.SectorsErased,
+                       Update.BytesProgrammed);
+        }
+    }
+}
+
+/**
+ * Time small reads issued while a background (erase-ahead) block erase
+ * runs: waiting the erase out, suspending it, and a burst of reads all
+ * suspending the same erase. Only the reads are timed, so the throughput
+ * columns cover read time alone.
+ */
+void BenchEraseReads(PLD_QSPI_t *QspiInstancePtr, u32 Prescaler)
+{
+    static const char *Names[3] = { "wait", "suspend", "suspend_burst" };
+    u32 Block = QspiInstancePtr->Flash.Erase[0].Size;
+    u32 ReadAddress = BENCH_REGION_ADDRESS + BENCH_IMAGE_SPAN;
+    u32 Mode;
+    u32 Ops;
+    u32 Errors;
+    u32 Suspends;
+    u32 i;
+    u64 ReadNs;
+    u64 OpStart;
+
+    for (Mode = 0; Mode < 3; Mode++) {
+        Ops = (Mode == 2) ? BENCH_MAX_OPS : BENCH_ERASE_OPS;
+        Errors = 0;
+        ReadNs = 0;
+        Suspends = QspiInstancePtr->Suspends;
+        PLD_QSPI_UseSuspend(QspiInstancePtr, Mode != 0);
+
+        for (i = 0; i < Ops; i++) {
+            // A fresh erase for each read, or one erase under the whole burst
+            if (Mode != 2 || i == 0) {
+                if (PLD_QSPI_EraseAheadStart(QspiInstancePtr, BENCH_REGION_ADDRESS + (i % BENCH_ERASE_OPS) * Block,
+                                             Block) != XST_SUCCESS) {
+                    Errors++;
+                    continue;
+                }
+                usleep(BENCH_ERASE_READ_LEAD_US);
+            }
+
+            OpStart = BenchNowNs();
+            if (PLD_QSPI_Read(QspiInstancePtr, ReadAddress + (i * BENCH_ERASE_READ_SIZE) % BENCH_IMAGE_SPAN,
+                              BenchBuffer, BENCH_ERASE_READ_SIZE) != XST_SUCCESS) {
+                Errors++;
+                continue;
+            }
+            BenchSample(i - Errors, OpStart);
+            ReadNs += BenchNowNs() - OpStart;
+        }
+
+        BenchRow("erase_read", Prescaler, QspiInstancePtr->Flash.ReadCmd, Names[Mode], BENCH_ERASE_READ_SIZE,
+                 Ops, Errors, ReadNs);
+        xil_printf("# erase_read %s: %d suspends\r\n", Names[Mode], QspiInstancePtr->Suspends - Suspends);
+
+        while (PLD_QSPI_EraseAheadPending(QspiInstancePtr) != 0) {
+            if (PLD_QSPI_EraseAheadService(QspiInstancePtr) != XST_SUCCESS) {
+                break;
+            }
+            usleep(BENCH_ERASE_READ_LEAD_US);
+        }
+    }
+
+    PLD_QSPI_UseSuspend(QspiInstancePtr, 1);
+}
+
+/**
+ * Log synthetic sample blocks through the acquisition pipeline at rising
+ * rates. Blocks the pipeline has no room for are dropped and counted as
+ * errors, and the rows time the logging from the first block to the end
+ * of the flush. The p50 / p99 columns are the time to hand over a block.
+ */
+void BenchPipeline(PLD_QSPI_t *QspiInstancePtr, u32 Prescaler)
+{
+    static const u32 Rates[] = { TEST_PIPE_RATES };
+    static u8 Arena[TEST_PIPE_BUFFER * TEST_PIPE_BUFFERS];
+    PLD_QSPI_Pipe_t Pipe;
+    XStatus Status;
+    char Name[16];
+    u32 Ops = TEST_PIPE_BYTES / TEST_PIPE_CHUNK;
+    u32 Sustained = 0;
+    u32 Errors;
+    u32 Rate;
+    u32 i;
+    u32 j;
+    u64 Start;
+    u64 Due;
+    u64 OpStart;
+
+    for (i = 0; i < TEST_PIPE_CHUNK; i++) {
+        BenchBuffer[i] = (u8)(i * 7U);
+    }
+
+    for (Rate = 0; Rate < sizeof(Rates) / sizeof(Rates[0]); Rate++) {
+        if (PLD_QSPI_EraseRange(QspiInstancePtr, BENCH_REGION_ADDRESS, TEST_PIPE_BYTES) != XST_SUCCESS ||
+            PLD_QSPI_PipeInit(&Pipe, QspiInstancePtr, Arena, TEST_PIPE_BUFFER, TEST_PIPE_BUFFERS,
+                              BENCH_REGION_ADDRESS, TEST_PIPE_BYTES) != XST_SUCCESS) {
+            xil_printf("# pipeline %d KB/s setup failed\r\n", Rates[Rate]);
+            continue;
+        }
+        Errors = 0;
+
+        Start = BenchNowNs();
+        Due = Start;
+        for (j = 0; j < Ops; j++) {
+            // The generator idles until its next block is due, servicing the flash meanwhile
+            while (BenchNowNs() < Due) {
+                PLD_QSPI_PipeService(&Pipe);
+                usleep(TEST_PIPE_POLL_US);
+            }
+            Due += ((u64)TEST_PIPE_CHUNK * 1000000000ULL) / ((u64)Rates[Rate] * 1024U);
+
+            BenchBuffer[0] = (u8)j;
+            OpStart = BenchNowNs();
+            Status = PLD_QSPI_PipeWrite(&Pipe, BenchBuffer, TEST_PIPE_CHUNK, 0);
+            if (Status != XST_SUCCESS) {
+                Errors++;
+                continue;
+            }
+            BenchSample(j - Errors, OpStart);
+        }
+        if (PLD_QSPI_PipeFlush(&Pipe) != XST_SUCCESS) {
+            xil_printf("# pipeline %d KB/s flush failed\r\n", Rates[Rate]);
+        }
+
+        snprintf(Name, sizeof(Name), "%luKBps", (unsigned long)Rates[Rate]);
+        BenchRow("pipeline", Prescaler, QspiInstancePtr->Flash.ProgramCmd, Name, TEST_PIPE_CHUNK,
+                 Ops, Errors, BenchNowNs() - Start);
+        xil_printf("# pipeline %d KB/s: %d overruns, at most %d of %d buffers queued for flash, %d pages\r\n", Rates[Rate],
+                   Pipe.Stats.Overruns, Pipe.Stats.MaxFull, TEST_PIPE_BUFFERS, Pipe.Stats.PagesProgrammed);
+
+        if (Errors == 0 && Rates[Rate] > Sustained) {
+            Sustained = Rates[Rate];
+        }
+    }
+
+    xil_printf("# pipeline: sustained %d KB/s without overruns, page program bandwidth %d KB/s\r\n", Sustained,
+               (QspiInstancePtr->ProgramEstUs != 0) ?
+               (u32)(((u64)QspiInstancePtr->Flash.PageSize * 1000000ULL) / QspiInstancePtr->ProgramEstUs / 1024U) : 0);
+}
+
+/**
+ * Time the record store: appends of each size until synced, reads by Id,
+ * remounts (the index rebuild scan) and a rewrite churn serviced in the
+ * background. The churn reports the write amplification and how evenly
+ * the erases spread over the segments, the power cuts after it any synced
+ * record a remount could not read back.
+ */
+void BenchLog(PLD_QSPI_t *QspiInstancePtr, u32 Prescaler)
+{
+    static const u32 Sizes[] = { TEST_LOG_SIZES };
+    static PLD_QSPI_Log_t Log;
+    static PLD_QSPI_LogSegment_t Segments[BENCH_REGION_SIZE / TEST_LOG_SEGMENT];
+    static PLD_QSPI_LogEntry_t Index[TEST_LOG_RECORDS];
+    static u8 Versions[TEST_LOG_CHURN_IDS];
+    u32 SegmentSize = TEST_LOG_SEGMENT;
+    u32 Size;
+    u32 Id;
+    u32 Cut;
+    u32 Copied;
+    u32 Lost;
+    u32 Length;
+    u32 Errors;
+    u32 MinErases;
+    u32 MaxErases;
+    u32 Seed = 1;
+    u32 i;
+    u64 Start;
+    u64 OpStart;
+
+    // A segment takes one block erase, which doubles with two parallel flashes
+    while (SegmentSize < QspiInstancePtr->Flash.Erase[QspiInstancePtr->Flash.EraseTypes - 1U].Size) {
+        SegmentSize *= 2U;
+    }
+
+    for (i = 0; i < BENCH_MAX_SIZE; i++) {
+        BenchBuffer[i] = (u8)(i * 13U);
+    }
+
+    for (Size = 0; Size < sizeof(Sizes) / sizeof(Sizes[0]); Size++) {
+        if (PLD_QSPI_LogMount(&Log, QspiInstancePtr, BENCH_REGION_ADDRESS, BENCH_REGION_SIZE, SegmentSize,
+                              Segments, Index, TEST_LOG_RECORDS) != XST_SUCCESS ||
+            PLD_QSPI_LogFormat(&Log) != XST_SUCCESS) {
+            xil_printf("# log setup failed\r\n");
+            return;
+        }
+        Errors = 0;
+
+        Start = BenchNowNs();
+        for (i = 0; i < BENCH_MAX_OPS; i++) {
+            BenchBuffer[0] = (u8)i;
+            OpStart = BenchNowNs();
+            if (PLD_QSPI_LogAppend(&Log, i % TEST_LOG_RECORDS, BenchBuffer, Sizes[Size]) != XST_SUCCESS) {
+                Errors++;
+                continue;
+            }
+            BenchSample(i - Errors, OpStart);
+        }
+        if (PLD_QSPI_LogSync(&Log) != XST_SUCCESS) {
+            xil_printf("# log_append %d sync failed\r\n", Sizes[Size]);
+        }
+        BenchRow("log_append", Prescaler, QspiInstancePtr->Flash.ProgramCmd, "sequential", Sizes[Size],
+                 BENCH_MAX_OPS, Errors, BenchNowNs() - Start);
+    }
+
+    // Lookups by Id straight from the index, of the largest records
+    Errors = 0;
+    Start = BenchNowNs();
+    for (i = 0; i < BENCH_MAX_OPS; i++) {
+        Seed = Seed * 1103515245U + 12345U;
+        OpStart = BenchNowNs();
+        if (PLD_QSPI_LogRead(&Log, (Seed >> 8) % TEST_LOG_RECORDS, BenchBuffer, BENCH_MAX_SIZE,
+                             &Length) != XST_SUCCESS) {
+            Errors++;
+            continue;
+        }
+        BenchSample(i - Errors, OpStart);
+    }
+    BenchRow("log_read", Prescaler, QspiInstancePtr->Flash.ReadCmd, "random", Sizes[Size - 1U],
+             BENCH_MAX_OPS, Errors, BenchNowNs() - Start);
+
+    // Remounts rebuild the index from the record headers
+    Errors = 0;
+    Start = BenchNowNs();
+    for (i = 0; i < TEST_LOG_MOUNTS; i++) {
+        OpStart = BenchNowNs();
+        if (PLD_QSPI_LogMount(&Log, QspiInstancePtr, BENCH_REGION_ADDRESS, BENCH_REGION_SIZE, SegmentSize,
+                              Segments, Index, TEST_LOG_RECORDS) != XST_SUCCESS) {
+            Errors++;
+            continue;
+        }
+        BenchSample(i - Errors, OpStart);
+    }
+    BenchRow("log_mount", Prescaler, QspiInstancePtr->Flash.ReadCmd, "scan", Log.Used * SegmentSize,
+             TEST_LOG_MOUNTS, Errors, BenchNowNs() - Start);
+    xil_printf("# log_mount: %d records scanned in %d segments, %d.%03d ms\r\n", Log.Stats.MountRecords,
+               Log.Used, Log.Stats.MountUs / 1000, Log.Stats.MountUs % 1000);
+
+    // Rewrites of a few records, compacted and erased between appends
+    if (PLD_QSPI_LogFormat(&Log) != XST_SUCCESS) {
+        xil_printf("# log_churn format failed\r\n");
+        return;
+    }
+    PLD_QSPI_LogResetStats(&Log);
+    Errors = 0;
+
+    Start = BenchNowNs();
+    for (i = 0; i < TEST_LOG_CHURN; i++) {
+        BenchBuffer[0] = (u8)i;
+        OpStart = BenchNowNs();
+        if (PLD_QSPI_LogAppend(&Log, i % TEST_LOG_CHURN_IDS, BenchBuffer, TEST_LOG_CHURN_SIZE) != XST_SUCCESS) {
+            Errors++;
+        } else {
+            BenchSample(i - Errors, OpStart);
+            Versions[i % TEST_LOG_CHURN_IDS] = (u8)i;
+        }
+        PLD_QSPI_LogService(&Log);
+    }
+    if (PLD_QSPI_LogSync(&Log) != XST_SUCCESS) {
+        xil_printf("# log_churn sync failed\r\n");
+    }
+    BenchRow("log_churn", Prescaler, QspiInstancePtr->Flash.ProgramCmd, "rewrite", TEST_LOG_CHURN_SIZE,
+             TEST_LOG_CHURN, Errors, BenchNowNs() - Start);
+
+    MinErases = 0xFFFFFFFFU;
+    MaxErases = 0;
+    for (i = 0; i < Log.SegmentCount; i++) {
+        MinErases = (Log.Segments[i].EraseCount < MinErases) ? Log.Segments[i].EraseCount : MinErases;
+        MaxErases = (Log.Segments[i].EraseCount > MaxErases) ? Log.Segments[i].EraseCount : MaxErases;
+    }
+    xil_printf("# log_churn: write amplification %d.%02d, %d records copied, %d erases, %d to %d per segment\r\n",
+               (u32)(Log.Stats.BytesProgrammed / Log.Stats.BytesAppended),
+               (u32)(((Log.Stats.BytesProgrammed % Log.Stats.BytesAppended) * 100U) / Log.Stats.BytesAppended),
+               Log.Stats.RecordsCopied, Log.Stats.Erases, MinErases, MaxErases);
+
+    // Cut the power while compaction runs, updating a quarter of the records so the rest are copied. Any erase in
+    // flight is let finish, the worst case for the records it held.
+    if (PLD_QSPI_LogMount(&Log, QspiInstancePtr, BENCH_REGION_ADDRESS, TEST_LOG_CUT_SEGMENTS * SegmentSize,
+                          SegmentSize, Segments, Index, TEST_LOG_RECORDS) != XST_SUCCESS ||
+        PLD_QSPI_LogFormat(&Log) != XST_SUCCESS) {
+        xil_printf("# log_cut format failed\r\n");
+        return;
+    }
+    for (Id = 0; Id < TEST_LOG_CHURN_IDS; Id++) {
+        BenchBuffer[0] = Versions[Id];
+        if (PLD_QSPI_LogAppend(&Log, Id, BenchBuffer, TEST_LOG_CHURN_SIZE) != XST_SUCCESS) {
+            xil_printf("# log_cut setup failed\r\n");
+            return;
+        }
+    }
+    PLD_QSPI_LogSync(&Log);
+
+    Copied = 0;
+    Lost = 0;
+    for (Cut = 0; Cut < TEST_LOG_CUTS; Cut++) {
+        Id = Cut % (TEST_LOG_CHURN_IDS / 4U);
+        BenchBuffer[0] = (u8)(Cut + 1U);
+        if (PLD_QSPI_LogAppend(&Log, Id, BenchBuffer, TEST_LOG_CHURN_SIZE) == XST_SUCCESS &&
+            PLD_QSPI_LogSync(&Log) == XST_SUCCESS) {
+            Versions[Id] = (u8)(Cut + 1U);
+        }
+        for (i = 0; i < Cut % TEST_LOG_CUT_SERVICES; i++) {
+            // Spaced as an idle loop would be, so no step finds the last erase still running
+            usleep(PLD_QSPI_EraseAheadRemainingUs(QspiInstancePtr));
+            PLD_QSPI_LogService(&Log);
+        }
+        while (PLD_QSPI_EraseAheadPending(QspiInstancePtr) != 0) {
+            if (PLD_QSPI_EraseAheadService(QspiInstancePtr) != XST_SUCCESS) {
+                break;
+            }
+        }
+        Copied += Log.Stats.RecordsCopied;
+
+        if (PLD_QSPI_LogMount(&Log, QspiInstancePtr, BENCH_REGION_ADDRESS, TEST_LOG_CUT_SEGMENTS * SegmentSize,
+                              SegmentSize, Segments, Index, TEST_LOG_RECORDS) != XST_SUCCESS) {
+            xil_printf("# log_cut remount failed\r\n");
+            return;
+        }
+        // Read back behind the payload pattern, with the version each record was last synced at
+        for (Id = 0; Id < TEST_LOG_CHURN_IDS; Id++) {
+            BenchBuffer[0] = Versions[Id];
+            if (PLD_QSPI_LogRead(&Log, Id, &BenchBuffer[TEST_LOG_CHURN_SIZE], BENCH_MAX_SIZE - TEST_LOG_CHURN_SIZE,
+                                 &Length) != XST_SUCCESS ||
+                Length != TEST_LOG_CHURN_SIZE || memcmp(BenchBuffer, &BenchBuffer[TEST_LOG_CHURN_SIZE], Length) != 0) {
+                Lost++;
+            }
+        }
+    }
+    xil_printf("# log_cut: %d power cuts with %d records copied, %d of %d synced records lost\r\n", TEST_LOG_CUTS,
+               Copied, Lost, TEST_LOG_CUTS * TEST_LOG_CHURN_IDS);
+}
 
 /**
- * Function to read flash ID and determine flash characteristics
- * Based on the reference implementation
+ * Time the parameter store: gets answered from RAM and from flash against
+ * a plain 4-byte flash read, unchanged sets, and a run of updates serviced
+ * in the background. A closing # line gives the erases the updates cost
+ * and how long mounting and opening the store takes.
  */
-u32 FlashReadID_TEMP(PLD_QSPI_t *QspiInstancePtr)
+void BenchKv(PLD_QSPI_t *QspiInstancePtr, u32 Prescaler)
 {
-    u32 Status;
-    u8 WriteBuffer[RD_ID_SIZE];
-    u8 ReadBuffer[RD_ID_SIZE];
+    static const char *Names[3] = { "ram", "flash", "direct" };
+    static PLD_QSPI_Log_t Log;
+    static PLD_QSPI_Kv_t Kv;
+    static PLD_QSPI_LogSegment_t Segments[BENCH_REGION_SIZE / TEST_LOG_SEGMENT];
+    static PLD_QSPI_LogEntry_t Index[TEST_KV_SLOTS];
+    static PLD_QSPI_KvSlot_t Slots[TEST_KV_SLOTS];
+    static u32 Keys[TEST_KV_KEYS];
+    char Name[16];
+    u32 SegmentSize = TEST_LOG_SEGMENT;
+    u32 Value;
+    u32 Size;
+    u32 Errors;
+    u32 Erases;
+    u32 Seed = 1;
+    u32 Mode;
+    u32 Key;
+    u32 i;
+    u64 Start;
+    u64 OpStart;
+    u64 OpenNs;
 
-    // Prepare READ ID command
-    WriteBuffer[COMMAND_OFFSET]   = READ_ID_CMD;
-    WriteBuffer[ADDRESS_1_OFFSET] = 0x00;  // 3 dummy bytes
-    WriteBuffer[ADDRESS_2_OFFSET] = 0x00;
-    WriteBuffer[ADDRESS_3_OFFSET] = 0x00;
+    while (SegmentSize < QspiInstancePtr->Flash.Erase[QspiInstancePtr->Flash.EraseTypes - 1U].Size) {
+        SegmentSize *= 2U;
+    }
 
-    // Execute polled transfer to read ID
-    Status = XQspiPs_PolledTransfer(QspiInstancePtr, WriteBuffer, ReadBuffer, RD_ID_SIZE);
+    if (PLD_QSPI_LogMount(&Log, QspiInstancePtr, BENCH_REGION_ADDRESS, BENCH_REGION_SIZE, SegmentSize,
+                          Segments, Index, TEST_KV_SLOTS) != XST_SUCCESS ||
+        PLD_QSPI_LogFormat(&Log) != XST_SUCCESS || PLD_QSPI_KvOpen(&Kv, &Log, Slots) != XST_SUCCESS) {
+        xil_printf("# kv setup failed\r\n");
+        return;
+    }
 
-    // CHECK TO SEE IF WE'RE ACTUALLY TALKING TO THE FLASH CHIP -> WE SHOULD SEE READID CMD SENT (0x9F), if we see 0xFF after, no device responding, 0x00 means bus pulled floating/low
-    xil_printf("Raw ID buffer dump: ");
-    for (int j = 0; j < RD_ID_SIZE; j++) {
-        xil_printf("0x%02x ", ReadBuffer[j]);
+    for (i = 0; i < TEST_KV_KEYS; i++) {
+        snprintf(Name, sizeof(Name), "param.%lu", (unsigned long)i);
+        Keys[i] = PLD_QSPI_KvKey(Name);
+    }
+    for (i = 0; i < TEST_KV_TABLE_SIZE; i++) {
+        BenchBuffer[i] = (u8)(i * 3U);
     }
-    xil_printf("\r\n");
 
-    if (Status != XST_SUCCESS) {
-        xil_printf("Failed to read flash ID\r\n");
-        return XST_FAILURE;
+    // Updates round robin, background work between them as an idle loop would
+    Errors = 0;
+    Start = BenchNowNs();
+    for (i = 0; i < TEST_KV_UPDATES; i++) {
+        Key = i % TEST_KV_KEYS;
+        Value = i;
+        BenchBuffer[0] = (u8)i;
+        OpStart = BenchNowNs();
+        if (((Key < TEST_KV_KEYS - TEST_KV_TABLES) ? PLD_QSPI_KvSet(&Kv, Keys[Key], &Value, sizeof(Value)) :
+             PLD_QSPI_KvSet(&Kv, Keys[Key], BenchBuffer, TEST_KV_TABLE_SIZE)) != XST_SUCCESS) {
+            Errors++;
+        } else {
+            BenchSample(i - Errors, OpStart);
+        }
+        PLD_QSPI_LogService(&Log);
+    }
+    if (PLD_QSPI_LogSync(&Log) != XST_SUCCESS) {
+        xil_printf("# kv_set sync failed\r\n");
     }
+    BenchRow("kv_set", Prescaler, QspiInstancePtr->Flash.ProgramCmd, "update", sizeof(Value),
+             TEST_KV_UPDATES, Errors, BenchNowNs() - Start);
+    Erases = Log.Stats.Erases - Log.SegmentCount;
 
-    xil_printf("Flash ID: 0x%02x 0x%02x 0x%02x\r\n", 
-               ReadBuffer[1], ReadBuffer[2], ReadBuffer[3]);
+    // Saving values that did not change writes nothing
+    Errors = 0;
+    Start = BenchNowNs();
+    for (i = 0; i < BENCH_MAX_OPS; i++) {
+        Key = i % (TEST_KV_KEYS - TEST_KV_TABLES);
+        if (PLD_QSPI_KvGet(&Kv, Keys[Key], &Value, sizeof(Value), NULL) != XST_SUCCESS) {
+            Errors++;
+            continue;
+        }
+        OpStart = BenchNowNs();
+        if (PLD_QSPI_KvSet(&Kv, Keys[Key], &Value, sizeof(Value)) != XST_SUCCESS) {
+            Errors++;
+            continue;
+        }
+        BenchSample(i - Errors, OpStart);
+    }
+    BenchRow("kv_set", Prescaler, QspiInstancePtr->Flash.ProgramCmd, "unchanged", sizeof(Value),
+             BENCH_MAX_OPS, Errors, BenchNowNs() - Start);
 
-    // Determine flash manufacturer
-    switch (ReadBuffer[1]) {
-        case MICRON_ID:
-            QspiFlashMake = MICRON_ID;
-            xil_printf("Flash Manufacturer: MICRON ");
-            break;
-        case SPANSION_ID:
-            QspiFlashMake = SPANSION_ID;
-            xil_printf("Flash Manufacturer: SPANSION ");
-            break;
-        case WINBOND_ID:
-            QspiFlashMake = WINBOND_ID;
-            xil_printf("Flash Manufacturer: WINBOND ");
-            break;
-        case MACRONIX_ID:
-            QspiFlashMake = MACRONIX_ID;
-            xil_printf("Flash Manufacturer: MACRONIX ");
-            break;
-        case ISSI_ID:
-            QspiFlashMake = ISSI_ID;
-            xil_printf("Flash Manufacturer: ISSI ");
-            break;
-        default:
-            QspiFlashMake = ReadBuffer[1];
-            xil_printf("Flash Manufacturer: UNKNOWN (0x%02x) ", ReadBuffer[1]);
-            break;
+    // Small values from the hash table, tables from flash, then the raw read gets replace
+    for (Mode = 0; Mode < 3; Mode++) {
+        Size = (Mode == 1) ? TEST_KV_TABLE_SIZE : sizeof(Value);
+        Errors = 0;
+        Start = BenchNowNs();
+        for (i = 0; i < BENCH_MAX_OPS; i++) {
+            Seed = Seed * 1103515245U + 12345U;
+            Key = (Mode == 1) ? TEST_KV_KEYS - TEST_KV_TABLES + (Seed >> 8) % TEST_KV_TABLES :
+                                (Seed >> 8) % (TEST_KV_KEYS - TEST_KV_TABLES);
+            OpStart = BenchNowNs();
+            if (((Mode == 2) ? PLD_QSPI_Read(QspiInstancePtr, BENCH_REGION_ADDRESS + Key * sizeof(Value),
+                                             BenchBuffer, sizeof(Value)) :
+                               PLD_QSPI_KvGet(&Kv, Keys[Key], BenchBuffer, Size, NULL)) != XST_SUCCESS) {
+                Errors++;
+                continue;
+            }
+            BenchSample(i - Errors, OpStart);
+        }
+        BenchRow("kv_get", Prescaler, QspiInstancePtr->Flash.ReadCmd, Names[Mode], Size,
+                 BENCH_MAX_OPS, Errors, BenchNowNs() - Start);
     }
 
-    // Deduce flash size
-    switch (ReadBuffer[3]) {
-        case FLASH_SIZE_ID_8M:
-            QspiFlashSize = FLASH_SIZE_8M;
-            xil_printf("8M Bits\r\n");
-            break;
-        case FLASH_SIZE_ID_16M:
-            QspiFlashSize = FLASH_SIZE_16M;
-            xil_printf("16M Bits\r\n");
-            break;
-        case FLASH_SIZE_ID_32M:
-            QspiFlashSize = FLASH_SIZE_32M;
-            xil_printf("32M Bits\r\n");
-            break;
-        case FLASH_SIZE_ID_64M:
-            QspiFlashSize = FLASH_SIZE_64M;
-            xil_printf("64M Bits\r\n");
-            break;
-        case FLASH_SIZE_ID_128M:
-            QspiFlashSize = FLASH_SIZE_128M;
-            xil_printf("128M Bits\r\n");
-            break;
-        case FLASH_SIZE_ID_256M:
-            QspiFlashSize = FLASH_SIZE_256M;
-            xil_printf("256M Bits\r\n");
-            break;
-        case FLASH_SIZE_ID_512M:
-            QspiFlashSize = FLASH_SIZE_512M;
-            xil_printf("512M Bits\r\n");
-            break;
-        case FLASH_SIZE_ID_1G:
-            QspiFlashSize = FLASH_SIZE_1G;
-            xil_printf("1G Bits\r\n");
-            break;
-        case FLASH_SIZE_ID_2G:
-            QspiFlashSize = FLASH_SIZE_2G;
-            xil_printf("2G Bits\r\n");
-            break;
-        default:
-            QspiFlashSize = FLASH_SIZE_16M; // Default assumption
-            xil_printf("Unknown size (0x%02x), assuming 16M Bits\r\n", ReadBuffer[3]);
-            break;
+    // Boot: mount the record store, then rebuild the hash table
+    Start = BenchNowNs();
+    if (PLD_QSPI_LogMount(&Log, QspiInstancePtr, BENCH_REGION_ADDRESS, BENCH_REGION_SIZE, SegmentSize,
+                          Segments, Index, TEST_KV_SLOTS) != XST_SUCCESS ||
+        PLD_QSPI_KvOpen(&Kv, &Log, Slots) != XST_SUCCESS) {
+        xil_printf("# kv reopen failed\r\n");
+        return;
     }
+    OpenNs = BenchNowNs() - Start;
 
-    return XST_SUCCESS;
+    // Every key must come back as it was last set, through the copies compaction made of it
+    Errors = 0;
+    for (Key = 0; Key < TEST_KV_KEYS; Key++) {
+        i = Key + ((TEST_KV_UPDATES - 1U - Key) / TEST_KV_KEYS) * TEST_KV_KEYS;
+        if (Key < TEST_KV_KEYS - TEST_KV_TABLES) {
+            if (PLD_QSPI_KvGet(&Kv, Keys[Key], &Value, sizeof(Value), NULL) != XST_SUCCESS || Value != i) {
+                Errors++;
+            }
+            continue;
+        }
+        for (Size = 0; Size < TEST_KV_TABLE_SIZE; Size++) {
+            BenchBuffer[Size] = (u8)(Size * 3U);
+        }
+        BenchBuffer[0] = (u8)i;
+        if (PLD_QSPI_KvGet(&Kv, Keys[Key], &BenchBuffer[TEST_KV_TABLE_SIZE], TEST_KV_TABLE_SIZE, &Size) != XST_SUCCESS ||
+            Size != TEST_KV_TABLE_SIZE || memcmp(BenchBuffer, &BenchBuffer[TEST_KV_TABLE_SIZE], Size) != 0) {
+            Errors++;
+        }
+    }
+
+    xil_printf("# kv: %d erases per %d updates, %d keys reopened in %d.%03d ms, %d not as last set\r\n", Erases,
+               TEST_KV_UPDATES, Kv.Count, (u32)(OpenNs / 1000000ULL), (u32)((OpenNs / 1000ULL) % 1000ULL), Errors);
 }
 
 /**
- * Function to perform QSPI flash read using polled transfer
- * Based on the reference implementation
+ * Time the compression stage on a synthetic detector stream: block coding
+ * and decoding with and without the delta pass, logging through the
+ * pipeline against the uncompressed stream, and reading blocks back. The
+ * closing # line gives the ratio and the pages each write programmed.
  */
-u32 FlashPolledRead(PLD_QSPI_t *QspiInstancePtr, u32 Address, u32 ByteCount, u8 *ReadBuffer)
+void BenchCompress(PLD_QSPI_t *QspiInstancePtr, u32 Prescaler)
 {
-    u32 Status;
-    u8 WriteBuffer[OVERHEAD_SIZE];
+    static const char *Names[2] = { "lz", "delta_lz" };
+    static s16 Samples[TEST_COMP_BYTES / 2U];
+    static u8 Frames[TEST_COMP_BYTES + (TEST_COMP_BYTES / TEST_COMP_BLOCK) * PLD_QSPI_COMP_HEADER];
+    static u16 Arena[PLD_QSPI_COMP_ARENA_SIZE(TEST_COMP_BLOCK) / 2U]; // Halfwords, the hash table needs them aligned
+    static u8 PipeArena[TEST_PIPE_BUFFER * TEST_PIPE_BUFFERS];
+    static PLD_QSPI_Comp_t Comp;
+    PLD_QSPI_CompHeader_t Header;
+    PLD_QSPI_Pipe_t Pipe;
+    u8 *Stream = (u8 *)Samples;
+    u32 Blocks = TEST_COMP_BYTES / TEST_COMP_BLOCK;
+    u32 Ratio100[2] = { 0, 0 };
+    u32 Pages[2] = { 0, 0 };
+    u32 Stored = 0;
+    u32 Pulse = 0;
+    u32 Seed = 1;
+    u32 Offset;
+    u32 Length;
+    u32 Address;
+    u32 Errors;
+    u32 Mode;
+    u32 i;
+    u64 Start;
+    u64 OpStart;
+    u64 WriteNs[2] = { 0, 0 };
+
+    for (i = 0; i < TEST_COMP_BYTES / 2U; i++) {
+        Seed = Seed * 1103515245U + 12345U;
+        if ((Seed >> 8) % TEST_COMP_PULSE_EVERY == 0) {
+            Pulse = 2000U + (Seed >> 16) % 3000U;
+        }
+        Pulse -= Pulse / 16U;
+        Samples[i] = (s16)(TEST_COMP_BASELINE + Pulse + (Seed >> 12) % TEST_COMP_NOISE - TEST_COMP_NOISE / 2);
+    }
 
-    // Prepare the read command with address
-    WriteBuffer[COMMAND_OFFSET]   = QUAD_READ_CMD;  // Use quad read for better performance
-    WriteBuffer[ADDRESS_1_OFFSET] = (u8)((Address & 0xFF0000) >> 16);
-    WriteBuffer[ADDRESS_2_OFFSET] = (u8)((Address & 0xFF00) >> 8);
-    WriteBuffer[ADDRESS_3_OFFSET] = (u8)(Address & 0xFF);
+    // Block coding in RAM, plain LZ and then with the delta pass over 16-bit samples
+    for (Mode = 0; Mode < 2; Mode++) {
+        if (PLD_QSPI_CompInit(&Comp, QspiInstancePtr, NULL, (u8 *)Arena, sizeof(Arena), TEST_COMP_BLOCK,
+                              (Mode == 0) ? 0U : 2U) != XST_SUCCESS) {
+            xil_printf("# comp setup failed\r\n");
+            return;
+        }
 
-    // Add dummy byte count for quad read
-    ByteCount += DUMMY_SIZE;
+        Offset = 0;
+        Start = BenchNowNs();
+        for (i = 0; i < Blocks; i++) {
+            OpStart = BenchNowNs();
+            Length = PLD_QSPI_CompPack(&Comp, &Stream[i * TEST_COMP_BLOCK], TEST_COMP_BLOCK);
+            BenchSample(i, OpStart);
+            memcpy(&Frames[Offset], Comp.Frame, Length);
+            Offset += Length;
+        }
+        BenchRow("comp_encode", Prescaler, 0, Names[Mode], TEST_COMP_BLOCK, Blocks, 0, BenchNowNs() - Start);
+        Ratio100[Mode] = (u32)((Comp.Stats.BytesIn * 100ULL) / Comp.Stats.BytesOut);
+        Stored = Comp.Stats.StoredBlocks;
 
-    // Execute polled transfer
-    Status = XQspiPs_PolledTransfer(QspiInstancePtr, WriteBuffer, ReadBuffer,
-                                     ByteCount + OVERHEAD_SIZE);
-    
-    // CHECK WHERE EXACTLY THE REAL DATA STARTS IN OUR BUFFER + MAKE SURE FLASH CONTAINS DATA, for normal read we should see 0x6B 0x00 * 3 0xFF [data].., for empty flash we shoould see 0x6B 0x00*3, 0xFF ...
-    xil_printf("Raw read buffer dump (first 10 bytes): ");
-    for (int j = 0; j < 10; j++) {
-        xil_printf("0x%02x ", ReadBuffer[j]);
+        Errors = 0;
+        Offset = 0;
+        Start = BenchNowNs();
+        for (i = 0; i < Blocks; i++) {
+            OpStart = BenchNowNs();
+            if (PLD_QSPI_CompUnpack(&Comp, &Frames[Offset], BenchBuffer, TEST_COMP_BLOCK, &Length) != XST_SUCCESS ||
+                memcmp(BenchBuffer, &Stream[i * TEST_COMP_BLOCK], TEST_COMP_BLOCK) != 0) {
+                Errors++;
+            } else {
+                BenchSample(i - Errors, OpStart);
+            }
+            memcpy(&Header, &Frames[Offset], sizeof(Header));
+            Offset += PLD_QSPI_COMP_HEADER + Header.Length;
+        }
+        BenchRow("comp_decode", Prescaler, 0, Names[Mode], TEST_COMP_BLOCK, Blocks, Errors, BenchNowNs() - Start);
     }
-    xil_printf("\r\n");
 
-    if (Status != XST_SUCCESS) {
-        xil_printf("Flash read failed at address 0x%08x\r\n", Address);
-        return XST_FAILURE;
+    // Log the stream through the pipeline, uncompressed and then compressed, waiting for room
+    for (Mode = 0; Mode < 2; Mode++) {
+        if (PLD_QSPI_EraseRange(QspiInstancePtr, BENCH_REGION_ADDRESS, TEST_COMP_BYTES) != XST_SUCCESS ||
+            PLD_QSPI_PipeInit(&Pipe, QspiInstancePtr, PipeArena, TEST_PIPE_BUFFER, TEST_PIPE_BUFFERS,
+                              BENCH_REGION_ADDRESS, TEST_COMP_BYTES) != XST_SUCCESS ||
+            PLD_QSPI_CompInit(&Comp, QspiInstancePtr, &Pipe, (u8 *)Arena, sizeof(Arena), TEST_COMP_BLOCK, 2U) != XST_SUCCESS) {
+            xil_printf("# comp_write setup failed\r\n");
+            return;
+        }
+
+        Errors = 0;
+        Start = BenchNowNs();
+        for (i = 0; i < TEST_COMP_BYTES / TEST_COMP_CHUNK; i++) {
+            OpStart = BenchNowNs();
+            if (((Mode == 0) ? PLD_QSPI_PipeWrite(&Pipe, &Stream[i * TEST_COMP_CHUNK], TEST_COMP_CHUNK, 1) :
+                               PLD_QSPI_CompWrite(&Comp, &Stream[i * TEST_COMP_CHUNK], TEST_COMP_CHUNK, 1)) != XST_SUCCESS) {
+                Errors++;
+                continue;
+            }
+            BenchSample(i - Errors, OpStart);
+        }
+        if (((Mode == 0) ? PLD_QSPI_PipeFlush(&Pipe) : PLD_QSPI_CompFlush(&Comp)) != XST_SUCCESS) {
+            xil_printf("# comp_write flush failed\r\n");
+        }
+        WriteNs[Mode] = BenchNowNs() - Start;
+        Pages[Mode] = Pipe.Stats.PagesProgrammed;
+        BenchRow("comp_write", Prescaler, QspiInstancePtr->Flash.ProgramCmd, (Mode == 0) ? "off" : Names[1],
+                 TEST_COMP_CHUNK, TEST_COMP_BYTES / TEST_COMP_CHUNK, Errors, WriteNs[Mode]);
     }
 
-    return XST_SUCCESS;
+    // Walk the logged blocks back from the start of the region
+    Errors = 0;
+    Address = BENCH_REGION_ADDRESS;
+    Start = BenchNowNs();
+    for (i = 0; i < Blocks; i++) {
+        OpStart = BenchNowNs();
+        if (PLD_QSPI_CompRead(&Comp, Address, BenchBuffer, TEST_COMP_BLOCK, &Length, &Address) != XST_SUCCESS ||
+            memcmp(BenchBuffer, &Stream[i * TEST_COMP_BLOCK], TEST_COMP_BLOCK) != 0) {
+            Errors++;
+            break;
+        }
+        BenchSample(i, OpStart);
+    }
+    BenchRow("comp_read", Prescaler, QspiInstancePtr->Flash.ReadCmd, Names[1], TEST_COMP_BLOCK, (Errors == 0) ? Blocks : i + 1U,
+             Errors, BenchNowNs() - Start);
+
+    xil_printf("# comp: ratio %d.%02d lz, %d.%02d delta_lz, %d of %d blocks stored, %d pages programmed against %d, "
+               "write %d.%02dx faster\r\n", Ratio100[0] / 100, Ratio100[0] % 100, Ratio100[1] / 100, Ratio100[1] % 100,
+               Stored, Blocks, Pages[1], Pages[0],
+               (WriteNs[1] != 0) ? (u32)((WriteNs[0] * 100ULL) / WriteNs[1]) / 100 : 0,
+               (WriteNs[1] != 0) ? (u32)((WriteNs[0] * 100ULL) / WriteNs[1]) % 100 : 0);
 }
 
 /**
- * Test QSPI peripheral functionality without requiring flash
- * This tests if the QSPI driver and peripheral are working correctly
+ * Time loading a boot image from a cold start. The baseline reads the
+ * image 256 bytes at a time and checks its CRC afterwards, at the opening
+ * clock and at the tuned one. PLD_QSPI_BootLoad then loads the primary
+ * copy, and the redundant copy once the primary is corrupted. The closing
+ * # line gives the time to ready for each.
  */
-u32 TestQSPIPeripheral(PLD_QSPI_t *QspiInstancePtr)
+void BenchBoot(PLD_QSPI_t *QspiInstancePtr, u32 Prescaler)
 {
-    u32 Status;
-    u8 WriteBuffer[8] = {0xAA, 0xBB, 0xCC, 0xDD, 0xEE, 0xFF, 0x11, 0x22};
-    u8 ReadBuffer[8] = {0};
+    static u8 Image[TEST_BOOT_SIZE];
+    static u8 Loaded[TEST_BOOT_SIZE];
+    static const u32 Copies[2] = { TEST_BOOT_PRIMARY, TEST_BOOT_SECONDARY };
+    static const char *Names[2] = { "primary", "fallback" };
+    PLD_QSPI_BootHeader_t Header;
+    PLD_QSPI_BootStats_t Stats[2];
+    char Name[16];
+    u32 Seed = 1;
+    u32 Errors;
+    u32 Mode;
+    u32 i;
+    u64 Start;
+    u64 OpStart;
+    u8 Clock;
+    u8 Byte;
 
-    xil_printf("Testing QSPI peripheral (no flash needed)...\r\n");
+    if (TEST_BOOT_SECONDARY + TEST_BOOT_SPAN > QspiInstancePtr->Flash.Size) {
+        xil_printf("# boot copies run past the end of the flash\r\n");
+        return;
+    }
 
-    // Test: Can we send data through QSPI?
-    Status = PLD_QSPI_Transfer(QspiInstancePtr, WriteBuffer, ReadBuffer, 4);
-    
-    xil_printf("QSPI Transfer Test:\r\n");
-    xil_printf("Sent:     ");
-    for(int i = 0; i < 4; i++) {
-        xil_printf("0x%02x ", WriteBuffer[i]);
+    for (i = 0; i < TEST_BOOT_SIZE; i++) {
+        Seed = Seed * 1103515245U + 12345U;
+        Image[i] = (u8)(Seed >> 16);
     }
-    xil_printf("\r\nReceived: ");
-    for(int i = 0; i < 4; i++) {
-        xil_printf("0x%02x ", ReadBuffer[i]);
+    PLD_QSPI_BootMakeHeader(&Header, Image, TEST_BOOT_SIZE, 1, 0, 0, 0);
+
+    for (i = 0; i < 2; i++) {
+        if (PLD_QSPI_EraseRange(QspiInstancePtr, Copies[i], TEST_BOOT_SPAN) != XST_SUCCESS ||
+            PLD_QSPI_Write(QspiInstancePtr, Copies[i], (u8 *)&Header, sizeof(Header)) != XST_SUCCESS ||
+            PLD_QSPI_Write(QspiInstancePtr, Copies[i] + PLD_QSPI_BOOT_HEADER, Image, TEST_BOOT_SIZE) != XST_SUCCESS) {
+            xil_printf("# boot image setup failed\r\n");
+            return;
+        }
     }
-    xil_printf("\r\n");
 
-    if (Status == XST_SUCCESS) {
-        xil_printf("QSPI peripheral transfer: SUCCESS\r\n");
-        
-        // Analyze what we received
-        if (ReadBuffer[0] == 0xAA) {
-            xil_printf("-> First byte matches sent data (loopback or echo)\r\n");
-        } else if (ReadBuffer[0] == 0xFF) {
-            xil_printf("-> Received 0xFF (normal when no device connected - bus pulled high)\r\n");
-        } else if (ReadBuffer[0] == 0x00) {
-            xil_printf("-> Received 0x00 (normal when no device connected - bus pulled low)\r\n");
+    // The chained loader: header, small reads into DDR, then a CRC pass
+    for (Mode = 0; Mode < 2; Mode++) {
+        Clock = (Mode == 0) ? TEST_SAFE_PRESCALER : (u8)Prescaler;
+        if (PLD_QSPI_SetClockPrescalar(QspiInstancePtr, Clock) != XST_SUCCESS) {
+            continue;
+        }
+
+        Errors = 0;
+        memset(Loaded, 0, sizeof(Loaded));
+        Start = BenchNowNs();
+        if (PLD_QSPI_BootCheckHeader(QspiInstancePtr, TEST_BOOT_PRIMARY, &Header) != XST_SUCCESS) {
+            xil_printf("# boot_chain header check failed at /%d\r\n", 2 << Clock);
+        }
+        for (i = 0; i < TEST_BOOT_SIZE / TEST_BOOT_CHAIN; i++) {
+            OpStart = BenchNowNs();
+            if (PLD_QSPI_Read(QspiInstancePtr, TEST_BOOT_PRIMARY + PLD_QSPI_BOOT_HEADER + i * TEST_BOOT_CHAIN,
+                              &Loaded[i * TEST_BOOT_CHAIN], TEST_BOOT_CHAIN) != XST_SUCCESS) {
+                Errors++;
+                continue;
+            }
+            BenchSample(i - Errors, OpStart);
+        }
+        if (PLD_QSPI_Crc32c(0, Loaded, TEST_BOOT_SIZE) != Header.Crc) {
+            xil_printf("# boot_chain CRC mismatch at /%d\r\n", 2 << Clock);
+        }
+        snprintf(Name, sizeof(Name), "chain%lu", (unsigned long)TEST_BOOT_CHAIN);
+        BenchRow("boot_chain", Clock, QspiInstancePtr->Flash.ReadCmd, Name, TEST_BOOT_CHAIN,
+                 TEST_BOOT_SIZE / TEST_BOOT_CHAIN, Errors, BenchNowNs() - Start);
+    }
+
+    // The loader from a cold start, then again with a bit of the primary's payload cleared
+    for (Mode = 0; Mode < 2; Mode++) {
+        if (Mode == 1) {
+            if (PLD_QSPI_Read(QspiInstancePtr, TEST_BOOT_PRIMARY + PLD_QSPI_BOOT_HEADER + TEST_BOOT_SIZE / 2U,
+                              &Byte, 1) != XST_SUCCESS) {
+                continue;
+            }
+            Byte = (Byte != 0) ? (u8)(Byte & (Byte - 1U)) : 0;
+            if (PLD_QSPI_Write(QspiInstancePtr, TEST_BOOT_PRIMARY + PLD_QSPI_BOOT_HEADER + TEST_BOOT_SIZE / 2U,
+                               &Byte, 1) != XST_SUCCESS) {
+                continue;
+            }
+        }
+
+        // Power on state: the opening clock, not tuned yet
+        if (PLD_QSPI_SetClockPrescalar(QspiInstancePtr, TEST_SAFE_PRESCALER) != XST_SUCCESS) {
+            continue;
+        }
+        QspiInstancePtr->Tune.Tuned = 0;
+
+        Errors = 0;
+        memset(Loaded, 0, sizeof(Loaded));
+        Start = BenchNowNs();
+        if (PLD_QSPI_BootLoad(QspiInstancePtr, Copies, 2, Loaded, sizeof(Loaded), &Header, &Stats[Mode]) != XST_SUCCESS ||
+            memcmp(Loaded, Image, TEST_BOOT_SIZE) != 0) {
+            Errors++;
         } else {
-            xil_printf("-> Unexpected data pattern: 0x%02x\r\n", ReadBuffer[0]);
+            BenchSample(0, Start);
         }
-        
-        return XST_SUCCESS;
-    } else {
-        xil_printf("QSPI peripheral transfer: FAILED (Status: %d)\r\n", Status);
-        return XST_FAILURE;
+        BenchRow("boot_load", Stats[Mode].Prescaler, QspiInstancePtr->Flash.ReadCmd, Names[Mode], TEST_BOOT_SIZE,
+                 1, Errors, BenchNowNs() - Start);
     }
+
+    xil_printf("# boot: %d KB ready in %d.%03d ms at /%d (tune %d.%03d ms, load %d.%03d ms), "
+               "from copy %d in %d.%03d ms after %d bad image\r\n", TEST_BOOT_SIZE / 1024,
+               Stats[0].ReadyUs / 1000, Stats[0].ReadyUs % 1000, 2 << Stats[0].Prescaler,
+               Stats[0].TuneUs / 1000, Stats[0].TuneUs % 1000, Stats[0].LoadUs / 1000, Stats[0].LoadUs % 1000,
+               Stats[1].Copy, Stats[1].ReadyUs / 1000, Stats[1].ReadyUs % 1000, Stats[1].BadImages);
+
+    PLD_QSPI_SetClockPrescalar(QspiInstancePtr, (u8)Prescaler);
 }
 
 /**
- * Test QSPI with flash-like commands (but don't expect valid responses)
- * This tests command formatting and transmission
+ * Erase consecutive blocks with each erase size the part supports
  */
-u32 TestQSPICommands(PLD_QSPI_t *QspiInstancePtr)
+void BenchErases(PLD_QSPI_t *QspiInstancePtr, u32 Prescaler)
 {
-    u32 Status;
-    u8 WriteBuffer[8];
-    u8 ReadBuffer[8];
+    PLD_QSPI_EraseType_t *Type;
+    u32 Level;
+    u32 Ops;
+    u32 Errors;
+    u32 i;
+    u64 Start;
+    u64 OpStart;
 
-    xil_printf("\r\nTesting QSPI command transmission...\r\n");
+    for (Level = 0; Level < QspiInstancePtr->Flash.EraseTypes; Level++) {
+        Type = &QspiInstancePtr->Flash.Erase[Level];
+        Ops = BENCH_REGION_SIZE / Type->Size;
+        if (Ops > BENCH_ERASE_OPS) {
+            Ops = BENCH_ERASE_OPS;
+        }
+        if (Ops == 0) {
+            continue;
+        }
+        Errors = 0;
 
-    // Test READ ID command (even without flash)
-    WriteBuffer[0] = READ_ID_CMD;  // 0x9F
-    WriteBuffer[1] = 0x00;
-    WriteBuffer[2] = 0x00;
-    WriteBuffer[3] = 0x00;
+        Start = BenchNowNs();
+        for (i = 0; i < Ops; i++) {
+            OpStart = BenchNowNs();
+            if (PLD_QSPI_EraseRange(QspiInstancePtr, BENCH_REGION_ADDRESS + i * Type->Size, Type->Size) != XST_SUCCESS) {
+                Errors++;
+                continue;
+            }
+            BenchSample(i - Errors, OpStart);
+        }
 
-    Status = PLD_QSPI_Transfer(QspiInstancePtr, WriteBuffer, ReadBuffer, 4);
-    
-    xil_printf("READ_ID Command Test:\r\n");
-    xil_printf("Sent READ_ID (0x9F): ");
-    for(int i = 0; i < 4; i++) {
-        xil_printf("0x%02x ", WriteBuffer[i]);
+        BenchRow("erase", Prescaler, Type->Cmd, BenchPatternNames[BENCH_SEQUENTIAL], Type->Size,
+                 Ops, Errors, BenchNowNs() - Start);
     }
-    xil_printf("\r\nReceived:             ");
-    for(int i = 0; i < 4; i++) {
-        xil_printf("0x%02x ", ReadBuffer[i]);
+}
+
+/**
+ * Replay a synthetic read trace straight from flash, then through the read
+ * cache. The trace mixes repeated reads of a few calibration / config tables
+ * with scattered one-off reads, like the firmware's steady state.
+ */
+void BenchCacheTrace(PLD_QSPI_t *QspiInstancePtr, u32 Prescaler)
+{
+    static PLD_QSPI_CacheLine_t CacheArena[TEST_CACHE_LINES];
+    static const u32 HotLength[TEST_TRACE_HOT_TABLES] = { 64, 128, 512, 96, 1024, 32 };
+    PLD_QSPI_Cache_t Cache;
+    XStatus Status;
+    u64 Start;
+    u64 OpStart;
+    u64 Bytes;
+    u32 Seed;
+    u32 Address;
+    u32 Length;
+    u32 Errors;
+    u32 Pass;
+    u32 i;
+
+    if (PLD_QSPI_CacheInit(&Cache, QspiInstancePtr, CacheArena, TEST_CACHE_LINES) != XST_SUCCESS) {
+        xil_printf("# cache init failed\r\n");
+        return;
     }
-    xil_printf("\r\n");
 
-    if (Status == XST_SUCCESS) {
-        xil_printf("Command transmission: SUCCESS\r\n");
-        
-        // Analyze response
-        if (ReadBuffer[0] == 0x9F) {
-            xil_printf("-> Command echoed back (expected with no flash)\r\n");
-        } else if (ReadBuffer[0] == 0xFF || ReadBuffer[0] == 0x00) {
-            xil_printf("-> No echo (QSPI configured in different mode)\r\n");
-        }
-        
-        return XST_SUCCESS;
-    } else {
-        xil_printf("Command transmission: FAILED (Status: %d)\r\n", Status);
-        return XST_FAILURE;
+    // Pass 0 reads straight from flash, pass 1 through the cache, same trace
+    for (Pass = 0; Pass < 2; Pass++) {
+        Seed = 12345;
+        Bytes = 0;
+        Errors = 0;
+
+        Start = BenchNowNs();
+        for (i = 0; i < TEST_TRACE_READS; i++) {
+            Seed = Seed * 1103515245U + 12345U;
+            if ((Seed >> 16) % 100 < TEST_TRACE_HOT_PERCENT) {
+                Address = BENCH_REGION_ADDRESS + ((Seed >> 8) % TEST_TRACE_HOT_TABLES) * 0x1000;
+                Length = HotLength[(Seed >> 8) % TEST_TRACE_HOT_TABLES];
+            } else {
+                Address = BENCH_REGION_ADDRESS + (Seed >> 4) % BENCH_REGION_SIZE;
+                Address &= ~63U;
+                Length = 64;
+            }
+
+            OpStart = BenchNowNs();
+            if (Pass == 0) {
+                Status = PLD_QSPI_Read(QspiInstancePtr, Address, BenchBuffer, Length);
+            } else {
+                Status = PLD_QSPI_CacheRead(&Cache, Address, BenchBuffer, Length);
+            }
+            if (Status != XST_SUCCESS) {
+                Errors++;
+                continue;
+            }
+            BenchSample(i - Errors, OpStart);
+            Bytes += Length;
+        }
+
+        // Rows carry the mean read size, so bytes and MB/s come out right
+        BenchRow((Pass == 0) ? "trace_read" : "trace_cached", Prescaler, QspiInstancePtr->Flash.ReadCmd, "trace",
+                 (TEST_TRACE_READS > Errors) ? (u32)(Bytes / (TEST_TRACE_READS - Errors)) : 0,
+                 TEST_TRACE_READS, Errors, BenchNowNs() - Start);
     }
+
+    // The driver would keep calling into a cache that goes out of scope
+    PLD_QSPI_SetModifyCallback(QspiInstancePtr, NULL, NULL);
+
+    xil_printf("# cache %d lines: %d hits, %d misses, %d evictions, hit rate %d%%\r\n", TEST_CACHE_LINES,
+               Cache.Stats.Hits, Cache.Stats.Misses, Cache.Stats.Evictions,
+               (Cache.Stats.Hits * 100) / (Cache.Stats.Hits + Cache.Stats.Misses + 1));
 }
 
 /**
- * Test QSPI options and configuration
+ * Queue completion callback, records the request's submit to done latency
  */
-u32 TestQSPIConfiguration(PLD_QSPI_t *QspiInstancePtr)
-{
-    u32 options;
-    
-    xil_printf("\r\nTesting QSPI configuration...\r\n");
-    
-    // Read current options
-    options = XQspiPs_GetOptions(QspiInstancePtr);
-    xil_printf("Current QSPI Options: 0x%08x\r\n", options);
-    
-    // Check specific options
-    if (options & XQSPIPS_FORCE_SSELECT_OPTION) {
-        xil_printf("-> Manual chip select: ENABLED\r\n");
-    } else {
-        xil_printf("-> Manual chip select: DISABLED\r\n");
-    }
-    
-    if (options & XQSPIPS_HOLD_B_DRIVE_OPTION) {
-        xil_printf("-> HOLD_B drive: ENABLED\r\n");
-    } else {
-        xil_printf("-> HOLD_B drive: DISABLED\r\n");
+static void BenchQueueDone(void *CallbackRef, XStatus Status, u32 ByteCount)
+{
+    BenchQueueSlot_t *Slot = (BenchQueueSlot_t *)CallbackRef;
+    u64 Ns = BenchNowNs() - Slot->SubmitNs;
+
+    (void)ByteCount;
+    if (Status != XST_SUCCESS) {
+        BenchQueueErrors[Slot->Class]++;
+        return;
     }
-    
-    if (options & XQSPIPS_MANUAL_START_OPTION) {
-        xil_printf("-> Manual start: ENABLED\r\n");
-    } else {
-        xil_printf("-> Manual start: DISABLED\r\n");
+
+    BenchQueueSamples[Slot->Class][BenchQueueGood[Slot->Class]++] = (Ns > 0xFFFFFFFFULL) ? 0xFFFFFFFFU : (u32)Ns;
+}
+
+/**
+ * Submit a request from a free slot of its class, skipped if all are in flight
+ */
+static void BenchQueueSubmit(PLD_QSPI_Queue_t *QueuePtr, u32 Class, u8 Op, u8 Priority, u32 Address,
+                             u32 Length, u8 *Data, u32 DeadlineUs)
+{
+    BenchQueueSlot_t *Slot;
+    u32 i;
+
+    for (i = 0; i < TEST_QUEUE_SLOTS; i++) {
+        Slot = &BenchQueueSlots[Class][i];
+        if (Slot->Req.Status == XST_DEVICE_BUSY) {
+            continue;
+        }
+
+        Slot->Class = Class;
+        Slot->Req.Op = Op;
+        Slot->Req.Priority = Priority;
+        Slot->Req.Address = Address;
+        Slot->Req.Length = Length;
+        Slot->Req.Data = (Data != NULL) ? Data : Slot->Data;
+        Slot->Req.DeadlineUs = DeadlineUs;
+        Slot->Req.Callback = BenchQueueDone;
+        Slot->Req.CallbackRef = Slot;
+        Slot->SubmitNs = BenchNowNs();
+        if (PLD_QSPI_QueueSubmit(QueuePtr, &Slot->Req) != XST_SUCCESS) {
+            BenchQueueErrors[Class]++;
+        }
+        return;
     }
-    
-    return XST_SUCCESS;
 }
 
-int main()
+/**
+ * Run the mixed load through the request queue, with priorities and the
+ * urgent reads' deadline, or with every request equal (plain FIFO order)
+ */
+void BenchQueue(PLD_QSPI_t *QspiInstancePtr, u32 Prescaler, u32 Prioritized)
 {
-    int Status;
-    PLD_QSPI_t QspiInstance;        // QSPI driver instance
-    u8 ReadBuffer[BUFFER_SIZE + OVERHEAD_SIZE + DUMMY_SIZE];  // Read buffer (with extra space for overhead)
+    static const char *ClassNames[BENCH_QUEUE_CLASSES] = { "queue_urgent", "queue_bulk", "queue_log" };
+    static const u32 ClassSizes[BENCH_QUEUE_CLASSES] = { TEST_QUEUE_URGENT_SIZE, TEST_QUEUE_BULK_SIZE, TEST_QUEUE_LOG_SIZE };
+    PLD_QSPI_Queue_t Queue;
+    PLD_QSPI_QueueStats_t *Stats = &Queue.Stats;
+    u32 BulkAddress = BENCH_REGION_ADDRESS + BENCH_REGION_SIZE / 4;
+    u32 LogAddress = BENCH_REGION_ADDRESS;
+    u32 Seed = 12345;
+    u32 Class;
+    u32 Step;
     u32 i;
+    u64 Start;
+    u64 Elapsed;
 
-    init_platform();
+    for (i = 0; i < TEST_QUEUE_LOG_SIZE; i++) {
+        BenchBuffer[i] = (u8)(i * 13 + 1);
+    }
 
-    xil_printf("QSPI Test Application\r\n");
-    xil_printf("====================\r\n");
+    if (PLD_QSPI_EraseRange(QspiInstancePtr, BENCH_REGION_ADDRESS, BENCH_PROGRAM_SPAN) != XST_SUCCESS ||
+        PLD_QSPI_QueueInit(&Queue, QspiInstancePtr) != XST_SUCCESS) {
+        xil_printf("# queue: setup failed\r\n");
+        return;
+    }
 
-    // Step 1: Initialize the QSPI driver
-    xil_printf("Initializing QSPI driver...\r\n");
-#ifndef SDT
-    Status = PLD_QSPI_Open(&QspiInstance, XPAR_XQSPIPS_0_DEVICE_ID);
-#else
-    Status = PLD_QSPI_Open(&QspiInstance, XPAR_XQSPIPS_0_BASEADDR);
-#endif
+    memset(BenchQueueSlots, 0, sizeof(BenchQueueSlots));
+    memset(BenchQueueGood, 0, sizeof(BenchQueueGood));
+    memset(BenchQueueErrors, 0, sizeof(BenchQueueErrors));
 
-    if (Status != XST_SUCCESS) {
-        xil_printf("QSPI driver initialization failed\r\n");
-        cleanup_platform();
-        return XST_FAILURE;
+    Start = BenchNowNs();
+    for (Step = 0; Step < TEST_QUEUE_STEPS; Step++) {
+        if (Step % TEST_QUEUE_LOG_EVERY == 0) {
+            BenchQueueSubmit(&Queue, BENCH_QUEUE_LOG, PLD_QSPI_QUEUE_WRITE, Prioritized ? 3 : 0,
+                             LogAddress, TEST_QUEUE_LOG_SIZE, BenchBuffer, 0);
+            LogAddress += TEST_QUEUE_LOG_SIZE;
+        }
+
+        if (Step % TEST_QUEUE_BURST_EVERY == 0) {
+            for (i = 0; i < TEST_QUEUE_BURST_READS; i++) {
+                BenchQueueSubmit(&Queue, BENCH_QUEUE_BULK, PLD_QSPI_QUEUE_READ, Prioritized ? 2 : 0,
+                                 BulkAddress, TEST_QUEUE_BULK_SIZE, NULL, 0);
+                BulkAddress += TEST_QUEUE_BULK_SIZE;
+            }
+        }
+
+        if (Step % TEST_QUEUE_URGENT_EVERY == 0) {
+            Seed = Seed * 1103515245U + 12345U;
+            BenchQueueSubmit(&Queue, BENCH_QUEUE_URGENT, PLD_QSPI_QUEUE_READ, 0,
+                             BENCH_REGION_ADDRESS + BENCH_REGION_SIZE / 2 + ((Seed >> 8) % 1024) * TEST_QUEUE_URGENT_SIZE,
+                             TEST_QUEUE_URGENT_SIZE, NULL, Prioritized ? TEST_QUEUE_URGENT_DEADLINE_US : 0);
+        }
+
+        PLD_QSPI_QueueService(&Queue);
     }
-    xil_printf("QSPI driver initialized successfully\r\n");
+    PLD_QSPI_QueueDrain(&Queue);
+    Elapsed = BenchNowNs() - Start;
 
-    // Step 2: Configure QSPI settings
-    xil_printf("Configuring QSPI settings...\r\n");
-    
-    // Set clock prescaler
-    Status = PLD_QSPI_SetClockPrescalar(&QspiInstance, XQSPIPS_CLK_PRESCALE_8);
-    if (Status != XST_SUCCESS) {
-        xil_printf("Failed to set clock prescaler\r\n");
-        PLD_QSPI_Close(&QspiInstance);
-        cleanup_platform();
-        return XST_FAILURE;
+    for (Class = 0; Class < BENCH_QUEUE_CLASSES; Class++) {
+        memcpy(BenchSamples, BenchQueueSamples[Class], BenchQueueGood[Class] * sizeof(BenchSamples[0]));
+        BenchRow(ClassNames[Class], Prescaler,
+                 (Class == BENCH_QUEUE_LOG) ? QspiInstancePtr->Flash.ProgramCmd : QspiInstancePtr->Flash.ReadCmd,
+                 Prioritized ? "priority" : "fifo", ClassSizes[Class],
+                 BenchQueueGood[Class] + BenchQueueErrors[Class], BenchQueueErrors[Class], Elapsed);
     }
 
-    // Set manual chip select and drive HOLD_B high (following reference pattern)
-    Status = PLD_QSPI_SetOptionsManually(&QspiInstance, 
-                                        XQSPIPS_FORCE_SSELECT_OPTION | 
-                                        XQSPIPS_HOLD_B_DRIVE_OPTION);
+    xil_printf("# queue %s: %d commands, %d merged reads, %d preemptions, depth max %d mean %d.%02d, "
+               "wait max %d us, %d deadlines missed\r\n", Prioritized ? "priority" : "fifo",
+               Stats->Commands, Stats->Merged, Stats->Preemptions, Stats->MaxDepth,
+               (u32)(Stats->DepthSum / Stats->Commands), (u32)((Stats->DepthSum * 100) / Stats->Commands) % 100,
+               Stats->WaitMaxUs, Stats->DeadlinesMissed);
+}
+
+/**
+ * Identify the flash and describe it in comment lines
+ */
+u32 FlashIdentify(PLD_QSPI_t *QspiInstancePtr)
+{
+    u32 Status;
+    PLD_QSPI_Flash_t *Flash = &QspiInstancePtr->Flash;
+    u32 Index;
 
+    Status = PLD_QSPI_Identify(QspiInstancePtr);
     if (Status != XST_SUCCESS) {
-        xil_printf("Failed to set QSPI options\r\n");
-        PLD_QSPI_Close(&QspiInstance);
-        cleanup_platform();
+        xil_printf("# Failed to identify flash (Status: %d)\r\n", Status);
         return XST_FAILURE;
     }
 
-    // Set slave select (chip select)
-    Status = XQspiPs_SetSlaveSelect(&QspiInstance);
-    if (Status != XST_SUCCESS) {
-        xil_printf("Failed to set slave select\r\n");
-        PLD_QSPI_Close(&QspiInstance);
-        cleanup_platform();
-        return XST_FAILURE;
+    xil_printf("# Flash ID: 0x%02x 0x%02x 0x%02x (%s)\r\n",
+               Flash->JedecId[0], Flash->JedecId[1], Flash->JedecId[2], Flash->Name);
+
+    if (QspiInstancePtr->ConnectionMode == PLD_QSPI_CONNECTION_PARALLEL) {
+        xil_printf("# Connection: dual parallel, 2 x %d bytes\r\n", QspiInstancePtr->DeviceSize);
+    } else if (QspiInstancePtr->ConnectionMode == PLD_QSPI_CONNECTION_STACKED) {
+        xil_printf("# Connection: dual stacked, 2 x %d bytes\r\n", QspiInstancePtr->DeviceSize);
     }
 
-    xil_printf("QSPI configuration complete\r\n");
+    xil_printf("# Size: %d bytes, page: %d bytes, SFDP %d.%d\r\n", Flash->Size, Flash->PageSize,
+               Flash->SfdpRevision >> 8, Flash->SfdpRevision & 0xFF);
+    xil_printf("# I/O read: 0x%02x + %d dummy, tPP: %d us\r\n",
+               Flash->ReadCmd, Flash->ReadDummyBytes, Flash->ProgramTimeUs);
 
-    // === PERIPHERAL TESTS (No Flash Required) ===
-    xil_printf("\r\n=== PERIPHERAL TESTS (No Flash Required) ===\r\n");
-    
-    Status = TestQSPIPeripheral(&QspiInstance);
-    if (Status != XST_SUCCESS) {
-        xil_printf("WARNING: QSPI peripheral test failed - driver may have issues\r\n");
+    for (Index = 0; Index < Flash->EraseTypes; Index++) {
+        xil_printf("# Erase %d KB: 0x%02x, %d ms\r\n", Flash->Erase[Index].Size / 1024,
+                   Flash->Erase[Index].Cmd, Flash->Erase[Index].TimeUs / 1000);
     }
 
-    Status = TestQSPICommands(&QspiInstance);
-    if (Status != XST_SUCCESS) {
-        xil_printf("WARNING: QSPI command test failed - transfer function may have issues\r\n");
+    return XST_SUCCESS;
+}
+
+// Compare one field of a parsed SFDP dump against its expected description
+#define SFDP_CHECK(Field) \
+    if (Flash.Field != Expected->Field) { \
+        xil_printf("# SFDP %s: " #Field " %d, expected %d\r\n", Expected->Name, Flash.Field, Expected->Field); \
+        Wrong++; \
+    }
+
+/**
+ * Parse the recorded SFDP dumps and report every field that comes out wrong
+ */
+void SfdpCheck(void)
+{
+    const TestSfdpDump_t *Dump;
+    const PLD_QSPI_Flash_t *Expected;
+    const PLD_QSPI_Flash_t *Part;
+    PLD_QSPI_Flash_t Flash;
+    u32 Wrong;
+    u32 i;
+    u32 Index;
+
+    for (i = 0; i < sizeof(TestSfdpDumps) / sizeof(TestSfdpDumps[0]); i++) {
+        Dump = &TestSfdpDumps[i];
+        Expected = &Dump->Flash;
+        Wrong = 0;
+
+        Part = PLD_QSPI_FindPart(Expected->JedecId);
+        if (Part == NULL) {
+            xil_printf("# SFDP %s: not in the part table\r\n", Expected->Name);
+            continue;
+        }
+
+        Flash = *Part;
+        if (PLD_QSPI_ParseSfdp(Dump->Sfdp, Dump->Length, &Flash) != XST_SUCCESS) {
+            xil_printf("# SFDP %s: dump not parsed\r\n", Expected->Name);
+            continue;
+        }
+
+        SFDP_CHECK(SfdpRevision);
+        SFDP_CHECK(Size);
+        SFDP_CHECK(PageSize);
+        SFDP_CHECK(ReadCmd);
+        SFDP_CHECK(ReadDummyBytes);
+        SFDP_CHECK(LinearReadCmd);
+        SFDP_CHECK(LinearDummyBytes);
+        SFDP_CHECK(AddressMode);
+        SFDP_CHECK(ProgramCmd);
+        SFDP_CHECK(ProgramTimeUs);
+        SFDP_CHECK(ProgramTimeMaxUs);
+        SFDP_CHECK(EraseTypes);
+        for (Index = 0; Index < Expected->EraseTypes; Index++) {
+            SFDP_CHECK(Erase[Index].Size);
+            SFDP_CHECK(Erase[Index].Cmd);
+            SFDP_CHECK(Erase[Index].TimeUs);
+            SFDP_CHECK(Erase[Index].TimeMaxUs);
+        }
+        SFDP_CHECK(ChipEraseTimeUs);
+        SFDP_CHECK(ChipEraseTimeMaxUs);
+        SFDP_CHECK(SuspendCmd);
+        SFDP_CHECK(ResumeCmd);
+        SFDP_CHECK(SuspendTimeUs);
+        SFDP_CHECK(ResumeIntervalUs);
+
+        xil_printf("# SFDP %s dump: %s\r\n", Expected->Name, (Wrong == 0) ? "ok" : "wrong");
+    }
+}
+
+#ifdef PLD_QSPI_STATS
+/**
+ * Print the driver statistics block: counts, bytes, latency and the
+ * occupied histogram buckets of each operation class
+ */
+void PrintDriverStats(PLD_QSPI_t *QspiInstancePtr)
+{
+    static const char *OpNames[PLD_QSPI_OP_COUNT] = { "transfer", "read", "program", "erase", "status" };
+    PLD_QSPI_Stats_t Stats;
+    PLD_QSPI_OpStats_t *OpPtr;
+    u32 Good;
+    u32 Op;
+    u32 Bucket;
+
+    if (PLD_QSPI_GetStats(QspiInstancePtr, &Stats) != XST_SUCCESS) {
+        return;
+    }
+
+    xil_printf("# Driver statistics:\r\n");
+    for (Op = 0; Op < PLD_QSPI_OP_COUNT; Op++) {
+        OpPtr = &Stats.Op[Op];
+        if (OpPtr->Count == 0) {
+            continue;
+        }
+
+        Good = OpPtr->Count - OpPtr->Errors;
+        xil_printf("# %s: %d ops, %d errors (last %d), %d KB, avg %d ns, max %d ns\r\n",
+                   OpNames[Op], OpPtr->Count, OpPtr->Errors, OpPtr->LastError, (u32)(OpPtr->Bytes / 1024),
+                   (Good != 0) ? (u32)(OpPtr->TotalNs / Good) : 0, (u32)OpPtr->MaxNs);
+
+        for (Bucket = 0; Bucket < PLD_QSPI_STATS_BUCKETS; Bucket++) {
+            if (OpPtr->Histogram[Bucket] != 0) {
+                xil_printf("#   < 2^%d ns: %d\r\n", Bucket, OpPtr->Histogram[Bucket]);
+            }
+        }
     }
+}
+#endif
+
+int main()
+{
+    static const u8 Prescalers[] = { BENCH_PRESCALERS };
+    int Status;
+    PLD_QSPI_t QspiInstance;        // QSPI driver instance
+    PLD_QSPI_Config_t QspiConfig;   // Open-time configuration
+    u8 Tuned;                       // Prescaler programs, erases and the trace run at
+    u32 i;
 
-    TestQSPIConfiguration(&QspiInstance);
-    
-    xil_printf("\r\n=== FLASH TESTS (Requires Flash Device) ===\r\n");
+    init_platform();
+
+    xil_printf("# QSPI Benchmark\r\n");
+
+    // Initialize the driver at a clock every board reads reliably
+    PLD_QSPI_ConfigDefaults(&QspiConfig);
+    QspiConfig.ConnectionMode = TEST_CONNECTION_MODE;
+    QspiConfig.Prescaler = TEST_SAFE_PRESCALER;
+#ifndef SDT
+    Status = PLD_QSPI_Open(&QspiInstance, XPAR_XQSPIPS_0_DEVICE_ID, &QspiConfig);
+#else
+    Status = PLD_QSPI_Open(&QspiInstance, XPAR_XQSPIPS_0_BASEADDR, &QspiConfig);
+#endif
+
+    if (Status != XST_SUCCESS) {
+        xil_printf("# QSPI driver initialization failed\r\n");
+        cleanup_platform();
+        return XST_FAILURE;
+    }
 
-    // Step 3: Read flash ID and characteristics
-    xil_printf("Reading flash identification...\r\n");
-    Status = FlashReadID_TEMP(&QspiInstance);
+    Status = FlashIdentify(&QspiInstance);
     if (Status != XST_SUCCESS) {
-        xil_printf("Failed to read flash ID\r\n");
         PLD_QSPI_Close(&QspiInstance);
         cleanup_platform();
         return XST_FAILURE;
     }
 
-    // Clear read buffer
-    memset(ReadBuffer, 0, sizeof(ReadBuffer));
+    // The parser needs no hardware, wrong fields are reported and the benchmark goes on
+    SfdpCheck();
 
-    // Step 4: Read data from flash (assuming data exists at test address)
-    xil_printf("Reading data from flash at address 0x%08x...\r\n", TEST_ADDRESS);
-    Status = FlashPolledRead(&QspiInstance, TEST_ADDRESS, BUFFER_SIZE, ReadBuffer);
-    
-    if (Status != XST_SUCCESS) {
-        xil_printf("Flash read operation failed\r\n");
+    if (BENCH_REGION_ADDRESS + BENCH_REGION_SIZE > QspiInstance.Flash.Size) {
+        xil_printf("# Benchmark region runs past the end of the flash\r\n");
         PLD_QSPI_Close(&QspiInstance);
         cleanup_platform();
         return XST_FAILURE;
     }
-    xil_printf("Flash read completed successfully\r\n");
 
-    // Step 5: Display read data (first few bytes for verification)
-    xil_printf("First 16 bytes read from flash:\r\n");
-    for (i = 0; i < 16; i++) {
-        xil_printf("0x%02x ", ReadBuffer[DATA_OFFSET + DUMMY_SIZE + i]);
-        if ((i + 1) % 8 == 0) {
-            xil_printf("\r\n");
-        }
+    Status = PLD_QSPI_AutoTune(&QspiInstance, TEST_TUNE_ADDRESS, TEST_TUNE_SIZE, TEST_TUNE_PASSES);
+    if (Status == XST_SUCCESS) {
+        xil_printf("# AutoTune: SCLK /%d (fastest clean /%d), loopback %s\r\n",
+                   2 << QspiInstance.Tune.Prescaler, 2 << QspiInstance.Tune.FastestPrescaler,
+                   QspiInstance.Tune.Loopback ? "on" : "off");
+    } else {
+        xil_printf("# AutoTune failed (Status: %d), staying at /%d\r\n", Status, 2 << TEST_SAFE_PRESCALER);
     }
-    xil_printf("\r\n");
-    
-    // Step 6: Optional - Test pattern verification (will likely fail if pattern not written)
-    xil_printf("Testing pattern verification (may fail if pattern not in flash)...\r\n");
-    u32 mismatch_count = 0;
-    
-    for (i = 0; i < 16; i++) {  // Check only first 16 bytes
-        u8 expected = (u8)(TEST_PATTERN_START + i);
-        u8 actual = ReadBuffer[DATA_OFFSET + DUMMY_SIZE + i];
-        if (actual != expected) {
-            if (mismatch_count < 3) {  // Show only first 3 mismatches
-                xil_printf("Mismatch at byte %lu: Expected 0x%02x, Got 0x%02x\r\n", 
-                          i, expected, actual);
-            }
-            mismatch_count++;
+    Tuned = XQspiPs_GetClkPrescaler(&QspiInstance.Qspi);
+
+    xil_printf("op,prescaler,opcode,pattern,size,ops,errors,bytes,mb_per_s,ops_per_s,p50_ns,p99_ns\r\n");
+
+    // Flash busy time dominates programs and erases, so they run once
+    BenchErases(&QspiInstance, Tuned);
+    BenchPrograms(&QspiInstance, Tuned);
+    BenchCommands(&QspiInstance, Tuned);
+    BenchStaging(&QspiInstance, Tuned);
+    BenchCrc(&QspiInstance, Tuned);
+    BenchBlank(&QspiInstance, Tuned);
+    BenchUpdate(&QspiInstance, Tuned);
+    BenchEraseReads(&QspiInstance, Tuned);
+    BenchPipeline(&QspiInstance, Tuned);
+    BenchLog(&QspiInstance, Tuned);
+    BenchKv(&QspiInstance, Tuned);
+    BenchCompress(&QspiInstance, Tuned);
+    BenchBoot(&QspiInstance, Tuned);
+    BenchCacheTrace(&QspiInstance, Tuned);
+    BenchQueue(&QspiInstance, Tuned, 0);
+    BenchQueue(&QspiInstance, Tuned, 1);
+
+    for (i = 0; i < sizeof(Prescalers); i++) {
+        Status = PLD_QSPI_SetClockPrescalar(&QspiInstance, Prescalers[i]);
+        if (Status != XST_SUCCESS) {
+            xil_printf("# Prescaler %d rejected (Status: %d)\r\n", 2 << Prescalers[i], Status);
+            continue;
         }
-    }
 
-    if (mismatch_count == 0) {
-        xil_printf("Pattern verification successful!\r\n");
-    } else {
-        xil_printf("Pattern mismatches found (%lu total). This is normal if test pattern wasn't written.\r\n", mismatch_count);
+        BenchReads(&QspiInstance, Prescalers[i]);
     }
-    
-    xil_printf("\r\nTest Summary:\r\n");
-    xil_printf("- QSPI initialization: SUCCESS\r\n");
-    xil_printf("- Flash ID read: SUCCESS\r\n");
-    xil_printf("- Flash data read: SUCCESS\r\n");
-    xil_printf("- Flash size: %lu bytes\r\n", QspiFlashSize);
-    xil_printf("- Flash manufacturer ID: 0x%02x\r\n", QspiFlashMake);
 
-    // Step 7: Clean up - TESTING NOW
+#ifdef PLD_QSPI_STATS
+    PrintDriverStats(&QspiInstance);
+#endif
+
     PLD_QSPI_Close(&QspiInstance);
     cleanup_platform();
 
-    xil_printf("QSPI test application completed successfully\r\n");
     return XST_SUCCESS;
-}
\ No newline at end of file
+}